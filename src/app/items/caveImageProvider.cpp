@@ -0,0 +1,31 @@
+#include "caveImageProvider.h"
+
+#include <QtEndian>
+#include <cstring>
+#include <vector>
+
+CaveImageProvider::CaveImageProvider(CaveEngine* engine)
+    : QQuickImageProvider(QQuickImageProvider::Image), engine_(engine) {}
+
+QImage CaveImageProvider::requestImage(const QString&, QSize* size,
+                                       const QSize&) {
+  if (!engine_ || engine_->grid().isEmpty()) {
+    if (size) *size = {};
+    return {};
+  }
+
+  const CaveGrid& grid = engine_->grid();
+  // MonoLSB keeps cell c in bit c % 8 of byte c / 8, as the grid does
+  QImage image(grid.cols(), grid.rows(), QImage::Format_MonoLSB);
+  image.setColorTable({floorColor_.rgb(), rockColor_.rgb()});
+
+  std::vector<quint64> words(grid.wordsPerRow());
+  size_t lineBytes = size_t(image.bytesPerLine());
+  for (int r = 0; r < grid.rows(); ++r) {
+    qToLittleEndian<quint64>(grid.row(r), grid.wordsPerRow(), words.data());
+    std::memcpy(image.scanLine(r), words.data(), lineBytes);
+  }
+
+  if (size) *size = image.size();
+  return image;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QColor>
+#include <QPointer>
+#include <QQuickImageProvider>
+
+#include "src/lib/service/cave/caveEngine.h"
+
+// Serves the engine's current cave as "image://cave/<anything>", one pixel
+// per cell. The grid's words are copied straight into a 1-bit image, so a
+// 4096x4096 cave costs a 2 MB copy per frame; views change the id (e.g. to
+// the generation) to fetch a new one.
+class CaveImageProvider : public QQuickImageProvider {
+ public:
+  explicit CaveImageProvider(CaveEngine* engine);
+
+  QImage requestImage(const QString& id, QSize* size,
+                      const QSize& requestedSize) override;
+
+ private:
+  QPointer<CaveEngine> engine_;
+  QColor floorColor_{0x2e, 0x2e, 0x33};
+  QColor rockColor_{0xd9, 0xd9, 0xd9};
+};
@@ -0,0 +1,699 @@
+#include "mazeItem.h"
+
+#include <QMatrix4x4>
+#include <QQuickWindow>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGImageNode>
+#include <QSGTransformNode>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+constexpr int kVerticesPerRun = 6;  // two triangles
+constexpr qreal kMaxCellPixels = 64.0;
+constexpr int kLevelBias = 64;
+
+quint64 tilePos(int tileRow, int tileCol) {
+  return (quint64(tileRow) << 24) | quint64(tileCol);
+}
+
+quint64 tileKey(int level, int tileRow, int tileCol) {
+  return (quint64(level + kLevelBias) << 48) | tilePos(tileRow, tileCol);
+}
+
+void appendQuad(std::vector<QSGGeometry::Point2D>& out, float left, float top,
+                float right, float bottom) {
+  QSGGeometry::Point2D v[kVerticesPerRun];
+  v[0].set(left, top);
+  v[1].set(right, top);
+  v[2].set(left, bottom);
+  v[3].set(right, top);
+  v[4].set(right, bottom);
+  v[5].set(left, bottom);
+  out.insert(out.end(), v, v + kVerticesPerRun);
+}
+
+// Wall quads of one tile in cell units, from a wallBits() snapshot of the
+// tile. Collinear walls are merged into runs (clipped at the tile edge);
+// border walls are drawn by the widget frame and skipped. Walls hug the
+// right/bottom edge of their cell.
+std::vector<QSGGeometry::Point2D> buildTileMesh(const QByteArray& bits,
+                                                int mazeRows, int mazeCols,
+                                                int tileRow, int tileCol,
+                                                float thicknessX,
+                                                float thicknessY) {
+  int rowBegin = tileRow * MazeItem::kTileCells;
+  int colBegin = tileCol * MazeItem::kTileCells;
+  int rowEnd = std::min(mazeRows, rowBegin + MazeItem::kTileCells);
+  int colEnd = std::min(mazeCols, colBegin + MazeItem::kTileCells);
+  int width = colEnd - colBegin;
+  if (bits.size() < qsizetype(rowEnd - rowBegin) * width) return {};
+
+  auto wall = [&](int r, int c, quint8 bit) {
+    return (bits[(r - rowBegin) * width + (c - colBegin)] & bit) != 0;
+  };
+
+  std::vector<QSGGeometry::Point2D> mesh;
+
+  // horizontal runs of bottom walls
+  for (int r = rowBegin; r < std::min(rowEnd, mazeRows - 1); ++r) {
+    for (int c = colBegin; c < colEnd;) {
+      if (!wall(r, c, MazeModel::kBottomWallBit)) {
+        ++c;
+        continue;
+      }
+      int start = c;
+      while (c < colEnd && wall(r, c, MazeModel::kBottomWallBit)) ++c;
+      float y = static_cast<float>(r + 1);
+      appendQuad(mesh, start, y - thicknessY, c, y);
+    }
+  }
+
+  // vertical runs of right walls
+  for (int c = colBegin; c < std::min(colEnd, mazeCols - 1); ++c) {
+    for (int r = rowBegin; r < rowEnd;) {
+      if (!wall(r, c, MazeModel::kRightWallBit)) {
+        ++r;
+        continue;
+      }
+      int start = r;
+      while (r < rowEnd && wall(r, c, MazeModel::kRightWallBit)) ++r;
+      float x = static_cast<float>(c + 1);
+      appendQuad(mesh, x - thicknessX, start, x, r);
+    }
+  }
+
+  return mesh;
+}
+
+// cells per overview texel, so the longer side fits kOverviewMaxSide
+int overviewBlock(const MazeData& maze) {
+  int longest = std::max(maze.rows, maze.cols);
+  return (longest + MazeItem::kOverviewMaxSide - 1) /
+         MazeItem::kOverviewMaxSide;
+}
+
+// texel rows [yBegin, yEnd) of an overview, darker where walls are denser;
+// rows from readyRows on are still being generated and count as walled
+// without being read. False when cancelled.
+bool fillOverview(const MazeData& maze, int readyRows, QImage& image,
+                  int yBegin, int yEnd, const CancellationToken& cancel) {
+  int block = overviewBlock(maze);
+  int width = image.width();
+  std::vector<int> sums(width);
+  int maxSum = 2 * block * block;
+
+  for (int y = yBegin; y < yEnd; ++y) {
+    if (cancel.isCancelled()) return false;
+    std::fill(sums.begin(), sums.end(), 0);
+    for (int r = y * block; r < std::min(maze.rows, (y + 1) * block); ++r) {
+      if (r >= readyRows) {
+        for (int c = 0; c < maze.cols; ++c) sums[c / block] += 2;
+        continue;
+      }
+      const auto& row = maze.cells[r];
+      for (int c = 0; c < maze.cols; ++c) {
+        sums[c / block] += row[c].rightWall + row[c].bottomWall;
+      }
+    }
+    uchar* line = image.scanLine(y);
+    for (int x = 0; x < width; ++x) {
+      line[x] = static_cast<uchar>(255 - 200 * sums[x] / maxSum);
+    }
+  }
+  return true;
+}
+
+// one texel per block of cells
+QImage buildOverview(const MazeData& maze, int readyRows,
+                     const CancellationToken& cancel) {
+  int block = overviewBlock(maze);
+  int width = (maze.cols + block - 1) / block;
+  int height = (maze.rows + block - 1) / block;
+
+  QImage image(width, height, QImage::Format_Grayscale8);
+  if (!fillOverview(maze, readyRows, image, 0, height, cancel)) return {};
+  return image;
+}
+
+class TileNode : public QSGGeometryNode {
+ public:
+  TileNode() : geometry_(QSGGeometry::defaultAttributes_Point2D(), 0) {
+    geometry_.setDrawingMode(QSGGeometry::DrawTriangles);
+    geometry_.setVertexDataPattern(QSGGeometry::StaticPattern);
+    setGeometry(&geometry_);
+    setMaterial(&material_);
+  }
+
+  void setMesh(
+      std::shared_ptr<const std::vector<QSGGeometry::Point2D>> mesh) {
+    if (mesh_ == mesh) return;
+    mesh_ = std::move(mesh);
+    geometry_.allocate(static_cast<int>(mesh_->size()));
+    std::memcpy(geometry_.vertexDataAsPoint2D(), mesh_->data(),
+                mesh_->size() * sizeof(QSGGeometry::Point2D));
+    markDirty(QSGNode::DirtyGeometry);
+  }
+
+  void setColor(const QColor& color) {
+    material_.setColor(color);
+    markDirty(QSGNode::DirtyMaterial);
+  }
+
+ private:
+  QSGGeometry geometry_;
+  QSGFlatColorMaterial material_;
+  std::shared_ptr<const std::vector<QSGGeometry::Point2D>> mesh_;
+};
+
+// owns the per-tile nodes, so they go away with the scene graph
+class MazeRootNode : public QSGTransformNode {
+ public:
+  void clearTiles() {
+    for (TileNode* node : tiles) {
+      removeChildNode(node);
+      delete node;
+    }
+    tiles.clear();
+  }
+
+  void clearOverview() {
+    if (!overview) return;
+    removeChildNode(overview);
+    delete overview;
+    overview = nullptr;
+  }
+
+  ~MazeRootNode() override {
+    clearTiles();
+    clearOverview();
+  }
+
+  QHash<quint64, TileNode*> tiles;
+  QSGImageNode* overview{nullptr};
+};
+}  // namespace
+
+MazeItem::MazeItem(QQuickItem* parent) : QQuickItem(parent) {
+  setFlag(ItemHasContents, true);
+  setClip(true);
+  setAcceptedMouseButtons(Qt::LeftButton);
+}
+
+MazeItem::~MazeItem() { cancelJobs(); }
+
+MazeModel* MazeItem::model() const { return model_; }
+
+void MazeItem::setModel(MazeModel* model) {
+  if (model_ == model) return;
+
+  cancelJobs();
+  for (const auto& connection : modelConnections_) disconnect(connection);
+  modelConnections_.clear();
+
+  model_ = model;
+  if (model) {
+    // a reset replaces the grid, nothing may still be reading it
+    modelConnections_ << connect(model, &MazeModel::modelAboutToBeReset, this,
+                                 &MazeItem::onMazeAboutToChange);
+    modelConnections_ << connect(model, &MazeModel::modelReset, this,
+                                 &MazeItem::onMazeReset);
+    // only the overview reads the maze in place, tiles work on copies and
+    // keep running through edits
+    modelConnections_ << connect(model, &MazeModel::wallsAboutToChange, this,
+                                 &MazeItem::cancelOverview);
+    // generated rows stream in, the grid itself is already laid out; the
+    // overview never reads rows that are not done, so it keeps running
+    modelConnections_ << connect(model, &MazeModel::rowsGenerated, this,
+                                 [this](int firstRow, int endRow) {
+                                   invalidateCells(QRect(0, firstRow,
+                                                         model_->cols(),
+                                                         endRow - firstRow));
+                                 });
+    modelConnections_ << connect(model, &MazeModel::wallsChanged, this,
+                                 &MazeItem::invalidateCells);
+  }
+
+  onMazeReset();
+  emit modelChanged();
+}
+
+QColor MazeItem::wallColor() const { return wallColor_; }
+
+void MazeItem::setWallColor(const QColor& color) {
+  if (wallColor_ == color) return;
+  wallColor_ = color;
+  materialDirty_ = true;
+  update();
+  emit wallColorChanged();
+}
+
+qreal MazeItem::wallWidth() const { return wallWidth_; }
+
+void MazeItem::setWallWidth(qreal width) {
+  if (qFuzzyCompare(wallWidth_, width)) return;
+  wallWidth_ = width;
+  invalidateTiles();
+  emit wallWidthChanged();
+}
+
+qreal MazeItem::minCellPixels() const { return minCellPixels_; }
+
+void MazeItem::setMinCellPixels(qreal pixels) {
+  if (qFuzzyCompare(minCellPixels_, pixels)) return;
+  minCellPixels_ = pixels;
+  requestVisibleTiles();
+  update();
+  emit minCellPixelsChanged();
+  emit viewChanged();
+}
+
+qreal MazeItem::zoom() const { return zoom_; }
+
+void MazeItem::setZoom(qreal zoom) {
+  zoomAt(width() / 2, height() / 2, zoom / zoom_);
+}
+
+qreal MazeItem::panX() const { return panX_; }
+qreal MazeItem::panY() const { return panY_; }
+
+qreal MazeItem::cellWidth() const {
+  if (!model_ || model_->cols() == 0) return 0;
+  return width() / model_->cols() * zoom_;
+}
+
+qreal MazeItem::cellHeight() const {
+  if (!model_ || model_->rows() == 0) return 0;
+  return height() / model_->rows() * zoom_;
+}
+
+bool MazeItem::overviewActive() const {
+  if (!hasCells()) return false;
+  return std::min(cellWidth(), cellHeight()) < minCellPixels_;
+}
+
+void MazeItem::zoomAt(qreal x, qreal y, qreal factor) {
+  if (!hasCells() || factor <= 0) return;
+
+  qreal baseCell =
+      std::min(width() / model_->cols(), height() / model_->rows());
+  qreal maxZoom = std::max(1.0, kMaxCellPixels / baseCell);
+  qreal zoom = std::clamp(zoom_ * factor, 1.0, maxZoom);
+  if (qFuzzyCompare(zoom, zoom_)) return;
+
+  // keep the cell under (x, y) in place
+  qreal cellX = (x - panX_) / cellWidth();
+  qreal cellY = (y - panY_) / cellHeight();
+  zoom_ = zoom;
+  panX_ = x - cellX * cellWidth();
+  panY_ = y - cellY * cellHeight();
+  clampPan();
+
+  requestVisibleTiles();
+  update();
+  emit viewChanged();
+}
+
+void MazeItem::panBy(qreal dx, qreal dy) {
+  qreal oldX = panX_, oldY = panY_;
+  panX_ += dx;
+  panY_ += dy;
+  clampPan();
+  if (qFuzzyCompare(oldX, panX_) && qFuzzyCompare(oldY, panY_)) return;
+
+  requestVisibleTiles();
+  update();
+  emit viewChanged();
+}
+
+void MazeItem::resetView() {
+  zoom_ = 1.0;
+  panX_ = panY_ = 0.0;
+  requestVisibleTiles();
+  update();
+  emit viewChanged();
+}
+
+QPoint MazeItem::cellAt(qreal x, qreal y) const {
+  if (!hasCells()) return {-1, -1};
+
+  int row = static_cast<int>(std::floor((y - panY_) / cellHeight()));
+  int col = static_cast<int>(std::floor((x - panX_) / cellWidth()));
+  if (row < 0 || row >= model_->rows() || col < 0 || col >= model_->cols()) {
+    return {-1, -1};
+  }
+  return {row, col};
+}
+
+void MazeItem::geometryChange(const QRectF& newGeometry,
+                              const QRectF& oldGeometry) {
+  QQuickItem::geometryChange(newGeometry, oldGeometry);
+  if (newGeometry.size() == oldGeometry.size()) return;
+
+  // wall thickness is baked into cached tiles in cell units
+  clampPan();
+  invalidateTiles();
+  emit viewChanged();
+}
+
+void MazeItem::wheelEvent(QWheelEvent* event) {
+  QPointF pos = event->position();
+  zoomAt(pos.x(), pos.y(), std::pow(2.0, event->angleDelta().y() / 240.0));
+  event->accept();
+}
+
+void MazeItem::mousePressEvent(QMouseEvent* event) {
+  lastMousePos_ = event->position();
+  event->accept();
+}
+
+void MazeItem::mouseMoveEvent(QMouseEvent* event) {
+  QPointF pos = event->position();
+  panBy(pos.x() - lastMousePos_.x(), pos.y() - lastMousePos_.y());
+  lastMousePos_ = pos;
+  event->accept();
+}
+
+void MazeItem::mouseDoubleClickEvent(QMouseEvent* event) {
+  resetView();
+  event->accept();
+}
+
+void MazeItem::onMazeAboutToChange() { cancelJobs(); }
+
+bool MazeItem::hasCells() const { return model_ && model_->rows() > 0; }
+
+void MazeItem::onMazeReset() {
+  zoom_ = 1.0;
+  panX_ = panY_ = 0.0;
+  nodesStale_ = true;
+  invalidateTiles();
+  emit viewChanged();
+}
+
+void MazeItem::invalidateTiles() {
+  ++generation_;
+  tiles_.clear();
+  lruOrder_.clear();
+  // results of jobs still in flight are dropped by the generation check
+  pendingTiles_.clear();
+  pendingOverview_ = nullptr;
+  overview_ = {};
+  overviewDirty_ = true;
+
+  requestVisibleTiles();
+  update();
+}
+
+void MazeItem::invalidateCells(const QRect& cells) {
+  int rowBegin = cells.top() / kTileCells;
+  int rowEnd = cells.bottom() / kTileCells;
+  int colBegin = cells.left() / kTileCells;
+  int colEnd = cells.right() / kTileCells;
+
+  // every zoom level of the touched tiles, meshes on screen stay until
+  // their replacements arrive
+  for (auto it = lruOrder_.begin(); it != lruOrder_.end();) {
+    int tr = static_cast<int>((*it >> 24) & 0xFFFFFF);
+    int tc = static_cast<int>(*it & 0xFFFFFF);
+    if (tr < rowBegin || tr > rowEnd || tc < colBegin || tc > colEnd) {
+      ++it;
+      continue;
+    }
+    tiles_.remove(*it);
+    it = lruOrder_.erase(it);
+  }
+  for (auto it = pendingTiles_.begin(); it != pendingTiles_.end();) {
+    int tr = static_cast<int>((it.key() >> 24) & 0xFFFFFF);
+    int tc = static_cast<int>(it.key() & 0xFFFFFF);
+    if (tr < rowBegin || tr > rowEnd || tc < colBegin || tc > colEnd) {
+      ++it;
+      continue;
+    }
+    it = pendingTiles_.erase(it);
+  }
+
+  // a few texel rows redone in place, not the whole overview; one still
+  // being built catches up when it arrives
+  if (!overview_.isNull()) {
+    const MazeData& maze = model_->mazeData();
+    int block = overviewBlock(maze);
+    fillOverview(maze, model_->generatedRows(), overview_,
+                 cells.top() / block, cells.bottom() / block + 1,
+                 CancellationToken());
+    overviewDirty_ = true;
+  }
+
+  requestVisibleTiles();
+  update();
+}
+
+void MazeItem::cancelOverview() {
+  if (!pendingOverview_) return;
+  overviewCancel_.cancel();
+  pendingOverview_->waitForFinished();
+  // its result is dropped, the next request starts over
+  pendingOverview_ = nullptr;
+  overviewCancel_ = CancellationToken();
+}
+
+void MazeItem::cancelJobs() {
+  cancel_.cancel();
+  overviewCancel_.cancel();
+  for (auto* watcher : std::as_const(runningJobs_)) watcher->waitForFinished();
+  runningJobs_.clear();
+  pendingTiles_.clear();
+  pendingOverview_ = nullptr;
+  cancel_ = CancellationToken();
+  overviewCancel_ = CancellationToken();
+  ++generation_;
+}
+
+void MazeItem::clampPan() {
+  qreal contentW = model_ ? model_->cols() * cellWidth() : 0;
+  qreal contentH = model_ ? model_->rows() * cellHeight() : 0;
+  panX_ = std::clamp(panX_, std::min(0.0, width() - contentW), 0.0);
+  panY_ = std::clamp(panY_, std::min(0.0, height() - contentH), 0.0);
+}
+
+int MazeItem::zoomLevel() const {
+  return static_cast<int>(std::lround(std::log2(zoom_)));
+}
+
+MazeItem::VisibleTiles MazeItem::visibleTiles() const {
+  if (!hasCells() || cellWidth() <= 0 || cellHeight() <= 0) {
+    return {};
+  }
+
+  auto range = [](qreal pan, qreal extent, qreal cell, int cells) {
+    int first = std::clamp(static_cast<int>(std::floor(-pan / cell)), 0, cells);
+    int last = std::clamp(static_cast<int>(std::ceil((extent - pan) / cell)),
+                          0, cells);
+    return std::make_pair(first / kTileCells,
+                          (last + kTileCells - 1) / kTileCells);
+  };
+
+  auto [rowBegin, rowEnd] =
+      range(panY_, height(), cellHeight(), model_->rows());
+  auto [colBegin, colEnd] = range(panX_, width(), cellWidth(), model_->cols());
+  return {rowBegin, rowEnd, colBegin, colEnd};
+}
+
+MazeItem::TileMesh MazeItem::cachedTile(quint64 key) {
+  auto it = tiles_.find(key);
+  if (it == tiles_.end()) return nullptr;
+  lruOrder_.splice(lruOrder_.begin(), lruOrder_, it->second);
+  return it->first;
+}
+
+void MazeItem::storeTile(quint64 key, TileMesh mesh) {
+  lruOrder_.push_front(key);
+  tiles_.insert(key, {std::move(mesh), lruOrder_.begin()});
+
+  while (static_cast<int>(lruOrder_.size()) > kMaxCachedTiles) {
+    tiles_.remove(lruOrder_.back());
+    lruOrder_.pop_back();
+  }
+}
+
+void MazeItem::requestVisibleTiles() {
+  if (!hasCells()) return;
+
+  if (overviewActive()) {
+    requestOverview();
+    return;
+  }
+
+  int level = zoomLevel();
+  qreal scale = std::pow(2.0, level);
+  auto thicknessX = static_cast<float>(
+      wallWidth_ / (width() / model_->cols() * scale));
+  auto thicknessY = static_cast<float>(
+      wallWidth_ / (height() / model_->rows() * scale));
+  int mazeRows = model_->rows();
+  int mazeCols = model_->cols();
+  VisibleTiles visible = visibleTiles();
+
+  for (int tr = visible.rowBegin; tr < visible.rowEnd; ++tr) {
+    for (int tc = visible.colBegin; tc < visible.colEnd; ++tc) {
+      quint64 key = tileKey(level, tr, tc);
+      if (tiles_.contains(key) || pendingTiles_.contains(key)) continue;
+
+      auto* watcher = new QFutureWatcher<TileMesh>(this);
+      connect(watcher, &QFutureWatcher<TileMesh>::finished, this,
+              [this, watcher, key, generation = generation_]() {
+                runningJobs_.removeOne(watcher);
+                // superseded when the tile was invalidated meanwhile
+                bool current = pendingTiles_.value(key) == watcher;
+                if (current) pendingTiles_.remove(key);
+                TileMesh mesh = watcher->result();
+                if (current && generation == generation_ && mesh) {
+                  storeTile(key, std::move(mesh));
+                  update();
+                }
+                watcher->deleteLater();
+              });
+
+      // workers get a copy of the tile, edits don't have to wait for them
+      QByteArray bits =
+          model_->wallBits(tr * kTileCells, tc * kTileCells, kTileCells,
+                           kTileCells);
+
+      pendingTiles_.insert(key, watcher);
+      runningJobs_.append(watcher);
+      watcher->setFuture(TaskScheduler::instance().run(
+          TaskScheduler::Priority::Render,
+          [bits, mazeRows, mazeCols, tr, tc, thicknessX,
+           thicknessY]() -> TileMesh {
+            return std::make_shared<const std::vector<QSGGeometry::Point2D>>(
+                buildTileMesh(bits, mazeRows, mazeCols, tr, tc, thicknessX,
+                              thicknessY));
+          },
+          cancel_));
+    }
+  }
+}
+
+void MazeItem::requestOverview() {
+  if (!overview_.isNull() || pendingOverview_) return;
+
+  const MazeData* maze = &model_->mazeData();
+  int readyRows = model_->generatedRows();
+  auto* watcher = new QFutureWatcher<QImage>(this);
+  connect(watcher, &QFutureWatcher<QImage>::finished, this,
+          [this, watcher, readyRows, generation = generation_]() {
+            runningJobs_.removeOne(watcher);
+            // superseded when it was cancelled for an edit
+            bool current = pendingOverview_ == watcher;
+            if (current) pendingOverview_ = nullptr;
+            if (current && generation == generation_) {
+              overview_ = watcher->result();
+              // rows streamed in while it was built
+              int rows = model_->generatedRows();
+              if (!overview_.isNull() && rows > readyRows) {
+                invalidateCells(
+                    QRect(0, readyRows, model_->cols(), rows - readyRows));
+              }
+              overviewDirty_ = true;
+              update();
+            }
+            watcher->deleteLater();
+          });
+
+  pendingOverview_ = watcher;
+  runningJobs_.append(watcher);
+  watcher->setFuture(TaskScheduler::instance().run(
+      TaskScheduler::Priority::Render,
+      [maze, readyRows, cancel = overviewCancel_]() {
+        return buildOverview(*maze, readyRows, cancel);
+      },
+      overviewCancel_));
+}
+
+QSGNode* MazeItem::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*) {
+  auto* root = static_cast<MazeRootNode*>(oldNode);
+  if (!root) {
+    root = new MazeRootNode;
+    overviewDirty_ = true;
+  }
+
+  // the GUI thread is blocked during sync, so reading GUI state is safe
+  if (nodesStale_) {
+    root->clearTiles();
+    root->clearOverview();
+    nodesStale_ = false;
+  }
+
+  if (!hasCells()) {
+    root->clearTiles();
+    root->clearOverview();
+    return root;
+  }
+
+  QMatrix4x4 matrix;
+  matrix.translate(static_cast<float>(panX_), static_cast<float>(panY_));
+  matrix.scale(static_cast<float>(cellWidth()),
+               static_cast<float>(cellHeight()));
+  root->setMatrix(matrix);
+
+  if (overviewActive()) {
+    root->clearTiles();
+    if (overviewDirty_ && !overview_.isNull()) {
+      root->clearOverview();
+      root->overview = window()->createImageNode();
+      root->overview->setTexture(window()->createTextureFromImage(overview_));
+      root->overview->setOwnsTexture(true);
+      root->overview->setFiltering(QSGTexture::Linear);
+      root->overview->setRect(QRectF(0, 0, model_->cols(), model_->rows()));
+      root->appendChildNode(root->overview);
+      overviewDirty_ = false;
+    }
+    return root;
+  }
+
+  root->clearOverview();
+  overviewDirty_ = true;
+
+  // drop nodes that scrolled out of view
+  VisibleTiles visible = visibleTiles();
+  for (auto it = root->tiles.begin(); it != root->tiles.end();) {
+    int tr = static_cast<int>(it.key() >> 24);
+    int tc = static_cast<int>(it.key() & 0xFFFFFF);
+    if (tr >= visible.rowBegin && tr < visible.rowEnd &&
+        tc >= visible.colBegin && tc < visible.colEnd) {
+      ++it;
+      continue;
+    }
+    root->removeChildNode(it.value());
+    delete it.value();
+    it = root->tiles.erase(it);
+  }
+
+  // tiles still being rebuilt for a new zoom level keep their old mesh
+  int level = zoomLevel();
+  for (int tr = visible.rowBegin; tr < visible.rowEnd; ++tr) {
+    for (int tc = visible.colBegin; tc < visible.colEnd; ++tc) {
+      TileMesh mesh = cachedTile(tileKey(level, tr, tc));
+      if (!mesh) continue;
+
+      TileNode*& node = root->tiles[tilePos(tr, tc)];
+      if (!node) {
+        node = new TileNode;
+        node->setColor(wallColor_);
+        root->appendChildNode(node);
+      }
+      node->setMesh(std::move(mesh));
+    }
+  }
+
+  if (materialDirty_) {
+    for (TileNode* node : std::as_const(root->tiles)) {
+      node->setColor(wallColor_);
+    }
+    materialDirty_ = false;
+  }
+
+  return root;
+}
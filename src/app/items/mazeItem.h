@@ -0,0 +1,149 @@
+#pragma once
+
+#include <QColor>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QImage>
+#include <QPointer>
+#include <QQuickItem>
+#include <QSGGeometry>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+
+// Zoomable, pannable maze view rendered straight into the scene graph.
+//
+// The maze is cut into square tiles of cells. Wall geometry for a tile is
+// built on a worker thread from a wallBits() copy of its cells (collinear
+// walls merged into runs, emitted as thin quads in cell units) and kept in
+// an LRU cache keyed by tile and zoom level; edits rebuild only the tiles
+// they touch; only tiles intersecting the viewport get scene-graph nodes.
+// When cells shrink below minCellPixels the view switches to a
+// pre-rasterized overview texture of the whole maze instead.
+class MazeItem : public QQuickItem {
+  Q_OBJECT
+
+  Q_PROPERTY(MazeModel* model READ model WRITE setModel NOTIFY modelChanged)
+  Q_PROPERTY(QColor wallColor READ wallColor WRITE setWallColor NOTIFY
+                 wallColorChanged)
+  Q_PROPERTY(qreal wallWidth READ wallWidth WRITE setWallWidth NOTIFY
+                 wallWidthChanged)
+  Q_PROPERTY(qreal minCellPixels READ minCellPixels WRITE setMinCellPixels
+                 NOTIFY minCellPixelsChanged)
+  Q_PROPERTY(qreal zoom READ zoom WRITE setZoom NOTIFY viewChanged)
+  Q_PROPERTY(qreal panX READ panX NOTIFY viewChanged)
+  Q_PROPERTY(qreal panY READ panY NOTIFY viewChanged)
+  Q_PROPERTY(qreal cellWidth READ cellWidth NOTIFY viewChanged)
+  Q_PROPERTY(qreal cellHeight READ cellHeight NOTIFY viewChanged)
+  Q_PROPERTY(bool overviewActive READ overviewActive NOTIFY viewChanged)
+
+ public:
+  static constexpr int kTileCells = 64;
+  static constexpr int kMaxCachedTiles = 256;
+  static constexpr int kOverviewMaxSide = 2048;
+
+  explicit MazeItem(QQuickItem* parent = nullptr);
+  ~MazeItem() override;
+
+  MazeModel* model() const;
+  void setModel(MazeModel* model);
+
+  QColor wallColor() const;
+  void setWallColor(const QColor& color);
+
+  qreal wallWidth() const;
+  void setWallWidth(qreal width);
+
+  qreal minCellPixels() const;
+  void setMinCellPixels(qreal pixels);
+
+  qreal zoom() const;
+  void setZoom(qreal zoom);
+  qreal panX() const;
+  qreal panY() const;
+
+  // size of one cell in item pixels at the current zoom
+  qreal cellWidth() const;
+  qreal cellHeight() const;
+  bool overviewActive() const;
+
+  // zooms by factor keeping the item point (x, y) fixed
+  Q_INVOKABLE void zoomAt(qreal x, qreal y, qreal factor);
+  Q_INVOKABLE void panBy(qreal dx, qreal dy);
+  Q_INVOKABLE void resetView();
+  // {row, col} of the cell under an item point, {-1, -1} outside the maze
+  Q_INVOKABLE QPoint cellAt(qreal x, qreal y) const;
+
+ signals:
+  void modelChanged();
+  void wallColorChanged();
+  void wallWidthChanged();
+  void minCellPixelsChanged();
+  void viewChanged();
+
+ protected:
+  QSGNode* updatePaintNode(QSGNode* oldNode,
+                           UpdatePaintNodeData* data) override;
+  void geometryChange(const QRectF& newGeometry,
+                      const QRectF& oldGeometry) override;
+  void wheelEvent(QWheelEvent* event) override;
+  void mousePressEvent(QMouseEvent* event) override;
+  void mouseMoveEvent(QMouseEvent* event) override;
+  void mouseDoubleClickEvent(QMouseEvent* event) override;
+
+ private:
+  using TileMesh = std::shared_ptr<const std::vector<QSGGeometry::Point2D>>;
+
+  struct VisibleTiles {
+    int rowBegin{0};
+    int rowEnd{0};
+    int colBegin{0};
+    int colEnd{0};
+  };
+
+  void onMazeAboutToChange();
+  void onMazeReset();
+  // cells are laid out as soon as generation starts, before any row is done
+  bool hasCells() const;
+  void invalidateTiles();
+  // drops cached tiles overlapping a block of cells (x = col, y = row)
+  void invalidateCells(const QRect& cells);
+  // waits for the overview job only, the one reading the maze in place
+  void cancelOverview();
+  void cancelJobs();
+  void clampPan();
+  void requestVisibleTiles();
+  void requestOverview();
+
+  int zoomLevel() const;
+  VisibleTiles visibleTiles() const;
+  TileMesh cachedTile(quint64 key);
+  void storeTile(quint64 key, TileMesh mesh);
+
+  QPointer<MazeModel> model_;
+  QList<QMetaObject::Connection> modelConnections_;
+  QColor wallColor_{Qt::black};
+  qreal wallWidth_{2.0};
+  qreal minCellPixels_{2.0};
+  qreal zoom_{1.0};
+  qreal panX_{0.0};
+  qreal panY_{0.0};
+  QPointF lastMousePos_;
+
+  // GUI-thread state shared with the render thread during sync
+  QHash<quint64, std::pair<TileMesh, std::list<quint64>::iterator>> tiles_;
+  std::list<quint64> lruOrder_;  // most recently used first
+  QHash<quint64, QFutureWatcher<TileMesh>*> pendingTiles_;
+  QFutureWatcher<QImage>* pendingOverview_{nullptr};
+  QList<QFutureWatcherBase*> runningJobs_;  // every job still reading the maze
+  QImage overview_;
+  CancellationToken cancel_;
+  CancellationToken overviewCancel_;
+  int generation_{0};
+  bool materialDirty_{true};
+  bool overviewDirty_{false};
+  bool nodesStale_{true};
+};
@@ -0,0 +1,197 @@
+#include "pathItem.h"
+
+#include <QMatrix4x4>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+#include <algorithm>
+#include <bit>
+
+namespace {
+// a shrunk path keeps its buffer unless it drops below a quarter of it
+constexpr size_t kShrinkFactor = 4;
+
+class PolylineNode : public QSGGeometryNode {
+ public:
+  PolylineNode() : geometry_(QSGGeometry::defaultAttributes_Point2D(), 0) {
+    geometry_.setDrawingMode(QSGGeometry::DrawLineStrip);
+    geometry_.setVertexDataPattern(QSGGeometry::DynamicPattern);
+    setGeometry(&geometry_);
+    setMaterial(&material_);
+  }
+
+  QSGGeometry geometry_;
+  QSGFlatColorMaterial material_;
+};
+
+class PathRootNode : public QSGTransformNode {
+ public:
+  PathRootNode() { appendChildNode(&polyline); }
+  ~PathRootNode() override { removeChildNode(&polyline); }
+
+  PolylineNode polyline;
+};
+
+void setCenter(QSGGeometry::Point2D& vertex, const QPoint& cell) {
+  // QPoint holds {row, col}
+  vertex.set(cell.y() + 0.5f, cell.x() + 0.5f);
+}
+}  // namespace
+
+PathItem::PathItem(QQuickItem* parent) : QQuickItem(parent) {
+  setFlag(ItemHasContents, true);
+}
+
+Solver* PathItem::solver() const { return solver_; }
+
+void PathItem::setSolver(Solver* solver) {
+  if (solver_ == solver) return;
+
+  if (solverConnection_) disconnect(solverConnection_);
+  solver_ = solver;
+  if (solver) {
+    solverConnection_ = connect(solver, &Solver::pathChanged, this,
+                                &PathItem::onPathChanged);
+  }
+
+  onPathChanged();
+  emit solverChanged();
+}
+
+AgentTrainer* PathItem::agent() const { return agent_; }
+
+void PathItem::setAgent(AgentTrainer* agent) {
+  if (agent_ == agent) return;
+
+  if (agentConnection_) disconnect(agentConnection_);
+  agent_ = agent;
+  if (agent) {
+    agentConnection_ = connect(agent, &AgentTrainer::routeChanged, this,
+                               &PathItem::onPathChanged);
+  }
+
+  onPathChanged();
+  emit agentChanged();
+}
+
+MazeItem* PathItem::view() const { return view_; }
+
+void PathItem::setView(MazeItem* view) {
+  if (view_ == view) return;
+
+  if (viewConnection_) disconnect(viewConnection_);
+  view_ = view;
+  if (view) {
+    viewConnection_ = connect(view, &MazeItem::viewChanged, this,
+                              &PathItem::onViewChanged);
+  }
+
+  onViewChanged();
+  emit viewChanged();
+}
+
+QColor PathItem::color() const { return color_; }
+
+void PathItem::setColor(const QColor& color) {
+  if (color_ == color) return;
+  color_ = color;
+  materialDirty_ = true;
+  update();
+  emit colorChanged();
+}
+
+qreal PathItem::lineWidth() const { return lineWidth_; }
+
+void PathItem::setLineWidth(qreal width) {
+  if (qFuzzyCompare(lineWidth_, width)) return;
+  lineWidth_ = width;
+  materialDirty_ = true;
+  update();
+  emit lineWidthChanged();
+}
+
+void PathItem::onPathChanged() {
+  pathDirty_ = true;
+  update();
+}
+
+void PathItem::onViewChanged() {
+  transformDirty_ = true;
+  update();
+}
+
+QSGNode* PathItem::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*) {
+  auto* root = static_cast<PathRootNode*>(oldNode);
+  if (!root) {
+    root = new PathRootNode;
+    drawnPath_.clear();
+    pathDirty_ = transformDirty_ = materialDirty_ = true;
+  }
+  PolylineNode& node = root->polyline;
+
+  if (transformDirty_) {
+    QMatrix4x4 matrix;
+    if (view_) {
+      matrix.translate(static_cast<float>(view_->panX()),
+                       static_cast<float>(view_->panY()));
+      matrix.scale(static_cast<float>(view_->cellWidth()),
+                   static_cast<float>(view_->cellHeight()));
+    }
+    root->setMatrix(matrix);
+    transformDirty_ = false;
+  }
+
+  if (materialDirty_) {
+    node.material_.setColor(color_);
+    node.geometry_.setLineWidth(static_cast<float>(lineWidth_));
+    node.markDirty(QSGNode::DirtyMaterial | QSGNode::DirtyGeometry);
+    materialDirty_ = false;
+  }
+
+  if (!pathDirty_) return root;
+  pathDirty_ = false;
+
+  // the GUI thread is blocked during sync, so reading the source is safe
+  static const std::vector<QPoint> kNoPath;
+  const std::vector<QPoint>& path = agent_    ? agent_->currentRoute()
+                                    : solver_ ? solver_->currentPath()
+                                              : kNoPath;
+  QSGGeometry& geometry = node.geometry_;
+
+  if (path.size() < 2) {
+    geometry.allocate(0);
+    drawnPath_.clear();
+    node.markDirty(QSGNode::DirtyGeometry);
+    return root;
+  }
+
+  size_t capacity = static_cast<size_t>(geometry.vertexCount());
+  size_t common = std::mismatch(drawnPath_.begin(), drawnPath_.end(),
+                                path.begin(), path.end())
+                      .first -
+                  drawnPath_.begin();
+  if (common == path.size() && common == drawnPath_.size()) return root;
+
+  // grows geometrically, so appending to the tail rarely reallocates
+  if (path.size() > capacity || path.size() * kShrinkFactor < capacity) {
+    capacity = std::bit_ceil(path.size());
+    geometry.allocate(static_cast<int>(capacity));
+    common = 0;
+  }
+
+  QSGGeometry::Point2D* vertices = geometry.vertexDataAsPoint2D();
+  for (size_t i = common; i < path.size(); ++i) {
+    setCenter(vertices[i], path[i]);
+  }
+  // spare slots collapse onto the end point
+  std::fill(vertices + path.size(), vertices + capacity,
+            vertices[path.size() - 1]);
+
+  drawnPath_.resize(path.size());
+  std::copy(path.begin() + static_cast<std::ptrdiff_t>(common), path.end(),
+            drawnPath_.begin() + static_cast<std::ptrdiff_t>(common));
+
+  geometry.markVertexDataDirty();
+  node.markDirty(QSGNode::DirtyGeometry);
+  return root;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QColor>
+#include <QPoint>
+#include <QPointer>
+#include <QQuickItem>
+#include <vector>
+
+#include "src/app/items/mazeItem.h"
+#include "src/lib/service/agent/agentTrainer.h"
+#include "src/lib/service/solver/solver.h"
+
+// Solver path, or the route of a trained agent, drawn as one line-strip
+// node in cell units, positioned by the MazeItem view transform, so
+// panning and zooming never touch the vertices. When a new path shares a
+// prefix with the drawn one, only the diverging tail is rewritten; vertex
+// storage grows geometrically and unused slots repeat the last point
+// (zero-length segments).
+class PathItem : public QQuickItem {
+  Q_OBJECT
+
+  Q_PROPERTY(Solver* solver READ solver WRITE setSolver NOTIFY solverChanged)
+  // drawn instead of the solver path when set
+  Q_PROPERTY(
+      AgentTrainer* agent READ agent WRITE setAgent NOTIFY agentChanged)
+  Q_PROPERTY(MazeItem* view READ view WRITE setView NOTIFY viewChanged)
+  Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+  Q_PROPERTY(qreal lineWidth READ lineWidth WRITE setLineWidth NOTIFY
+                 lineWidthChanged)
+
+ public:
+  explicit PathItem(QQuickItem* parent = nullptr);
+
+  Solver* solver() const;
+  void setSolver(Solver* solver);
+
+  AgentTrainer* agent() const;
+  void setAgent(AgentTrainer* agent);
+
+  MazeItem* view() const;
+  void setView(MazeItem* view);
+
+  QColor color() const;
+  void setColor(const QColor& color);
+
+  qreal lineWidth() const;
+  void setLineWidth(qreal width);
+
+ signals:
+  void solverChanged();
+  void agentChanged();
+  void viewChanged();
+  void colorChanged();
+  void lineWidthChanged();
+
+ protected:
+  QSGNode* updatePaintNode(QSGNode* oldNode,
+                           UpdatePaintNodeData* data) override;
+
+ private:
+  void onPathChanged();
+  void onViewChanged();
+
+  QPointer<Solver> solver_;
+  QPointer<AgentTrainer> agent_;
+  QPointer<MazeItem> view_;
+  QMetaObject::Connection solverConnection_;
+  QMetaObject::Connection agentConnection_;
+  QMetaObject::Connection viewConnection_;
+  QColor color_{"#E74C3C"};
+  qreal lineWidth_{2.0};
+
+  std::vector<QPoint> drawnPath_;  // what the vertex buffer holds
+  bool pathDirty_{true};
+  bool transformDirty_{true};
+  bool materialDirty_{true};
+};
@@ -0,0 +1,262 @@
+#include "searchItem.h"
+
+#include <QMatrix4x4>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+#include <algorithm>
+#include <vector>
+
+namespace {
+constexpr int kVerticesPerCell = 6;
+// squares leave the walls uncovered
+constexpr float kInset = 0.1f;
+
+class CellsNode : public QSGGeometryNode {
+ public:
+  CellsNode() : geometry_(QSGGeometry::defaultAttributes_Point2D(), 0) {
+    geometry_.setDrawingMode(QSGGeometry::DrawTriangles);
+    geometry_.setVertexDataPattern(QSGGeometry::DynamicPattern);
+    setGeometry(&geometry_);
+    setMaterial(&material_);
+  }
+
+  void setColor(const QColor& color) {
+    material_.setColor(color);
+    markDirty(QSGNode::DirtyMaterial);
+  }
+
+  void touch() {
+    geometry_.markVertexDataDirty();
+    markDirty(QSGNode::DirtyGeometry);
+  }
+
+  // slot i of the geometry shows cell id, or nothing for a negative id
+  void setCell(int slot, qint64 id, int cols) {
+    QSGGeometry::Point2D* v =
+        geometry_.vertexDataAsPoint2D() + slot * kVerticesPerCell;
+    if (id < 0) {
+      std::fill(v, v + kVerticesPerCell, QSGGeometry::Point2D{0, 0});
+      return;
+    }
+    const float left = float(id % cols) + kInset;
+    const float top = float(id / cols) + kInset;
+    const float right = left + 1 - 2 * kInset;
+    const float bottom = top + 1 - 2 * kInset;
+    v[0].set(left, top);
+    v[1].set(right, top);
+    v[2].set(left, bottom);
+    v[3].set(right, top);
+    v[4].set(right, bottom);
+    v[5].set(left, bottom);
+  }
+
+  QSGGeometry geometry_;
+  QSGFlatColorMaterial material_;
+};
+
+// a chunk holds kChunkCells consecutive cells of the trace; the one being
+// filled has its unused slots collapsed
+class SearchRootNode : public QSGTransformNode {
+ public:
+  SearchRootNode() {
+    appendChildNode(&visited);
+    appendChildNode(&frontier);
+  }
+  ~SearchRootNode() override {
+    removeChildNode(&visited);
+    removeChildNode(&frontier);
+  }
+
+  void dropChunks(size_t keep) {
+    while (chunks.size() > keep) {
+      visited.removeChildNode(chunks.back());
+      delete chunks.back();
+      chunks.pop_back();
+    }
+  }
+
+  QSGNode visited;  // owns the chunks
+  CellsNode frontier;
+  std::vector<CellsNode*> chunks;
+  quint32 begin{0};  // sequence number of the first cell
+  quint32 drawnEnd{0};
+};
+}  // namespace
+
+SearchItem::SearchItem(QQuickItem* parent) : QQuickItem(parent) {
+  setFlag(ItemHasContents, true);
+}
+
+Solver* SearchItem::solver() const { return solver_; }
+
+void SearchItem::setSolver(Solver* solver) {
+  if (solver_ == solver) return;
+
+  if (solverConnection_) disconnect(solverConnection_);
+  solver_ = solver;
+  if (solver) {
+    solverConnection_ = connect(solver, &Solver::searchTraceChanged, this,
+                                &SearchItem::onTraceChanged);
+  }
+
+  onTraceChanged();
+  emit solverChanged();
+}
+
+MazeItem* SearchItem::view() const { return view_; }
+
+void SearchItem::setView(MazeItem* view) {
+  if (view_ == view) return;
+
+  if (viewConnection_) disconnect(viewConnection_);
+  view_ = view;
+  if (view) {
+    viewConnection_ = connect(view, &MazeItem::viewChanged, this,
+                              &SearchItem::onViewChanged);
+  }
+
+  onViewChanged();
+  emit viewChanged();
+}
+
+int SearchItem::layer() const { return layer_; }
+
+void SearchItem::setLayer(int layer) {
+  layer = std::clamp(layer, 0, layerCount_);
+  if (layer_ == layer) return;
+  layer_ = layer;
+  layerDirty_ = true;
+  update();
+  emit layerChanged();
+}
+
+int SearchItem::layerCount() const { return layerCount_; }
+
+QColor SearchItem::color() const { return color_; }
+
+void SearchItem::setColor(const QColor& color) {
+  if (color_ == color) return;
+  color_ = color;
+  materialDirty_ = true;
+  update();
+  emit colorChanged();
+}
+
+QColor SearchItem::frontierColor() const { return frontierColor_; }
+
+void SearchItem::setFrontierColor(const QColor& color) {
+  if (frontierColor_ == color) return;
+  frontierColor_ = color;
+  materialDirty_ = true;
+  update();
+  emit colorChanged();
+}
+
+void SearchItem::onTraceChanged() {
+  traceDirty_ = true;
+  update();
+
+  int count = solver_ ? solver_->searchLayers() : 0;
+  if (count != layerCount_) {
+    layerCount_ = count;
+    emit layerCountChanged();
+  }
+  if (layer_ > layerCount_) {
+    layer_ = layerCount_;
+    emit layerChanged();
+  }
+}
+
+void SearchItem::onViewChanged() {
+  transformDirty_ = true;
+  update();
+}
+
+QSGNode* SearchItem::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*) {
+  auto* root = static_cast<SearchRootNode*>(oldNode);
+  if (!root) {
+    root = new SearchRootNode;
+    traceDirty_ = transformDirty_ = materialDirty_ = true;
+  }
+
+  if (transformDirty_) {
+    QMatrix4x4 matrix;
+    if (view_) {
+      matrix.translate(static_cast<float>(view_->panX()),
+                       static_cast<float>(view_->panY()));
+      matrix.scale(static_cast<float>(view_->cellWidth()),
+                   static_cast<float>(view_->cellHeight()));
+    }
+    root->setMatrix(matrix);
+    transformDirty_ = false;
+  }
+
+  if (materialDirty_) {
+    for (CellsNode* chunk : root->chunks) chunk->setColor(color_);
+    root->frontier.setColor(frontierColor_);
+    materialDirty_ = false;
+  }
+
+  // the GUI thread is blocked during sync, so reading the trace is safe
+  static const SearchTrace kNoTrace;
+  const SearchTrace& trace = solver_ ? solver_->searchTrace() : kNoTrace;
+  // the solver may have changed it before the signal got here
+  const int layer = std::min(layer_, trace.layerCount());
+
+  if (traceDirty_) {
+    root->dropChunks(0);
+    root->begin = root->drawnEnd = trace.isEmpty() ? 0 : trace.layerBegin(0);
+    traceDirty_ = false;
+    layerDirty_ = true;
+  }
+  if (!layerDirty_) return root;
+  layerDirty_ = false;
+
+  // layers before the newest shown one, then the newest one itself
+  const quint32 begin = root->begin;
+  const quint32 visitedEnd = layer > 0 ? trace.layerBegin(layer - 1) : begin;
+  const quint32 frontierEnd = layer > 0 ? trace.layerEnd(layer - 1) : begin;
+  const int cols = trace.cols();
+  auto chunkOf = [&](quint32 seq) { return (seq - begin) / kChunkCells; };
+  auto slotOf = [&](quint32 seq) { return int((seq - begin) % kChunkCells); };
+
+  if (visitedEnd > root->drawnEnd) {
+    for (quint32 seq = root->drawnEnd; seq < visitedEnd; ++seq) {
+      if (chunkOf(seq) == root->chunks.size()) {
+        auto* chunk = new CellsNode;
+        QSGGeometry& geometry = chunk->geometry_;
+        geometry.allocate(kChunkCells * kVerticesPerCell);
+        std::fill_n(geometry.vertexDataAsPoint2D(), geometry.vertexCount(),
+                    QSGGeometry::Point2D{0, 0});
+        chunk->setColor(color_);
+        root->visited.appendChildNode(chunk);
+        root->chunks.push_back(chunk);
+      }
+      root->chunks[chunkOf(seq)]->setCell(slotOf(seq), trace.cell(seq), cols);
+    }
+    for (size_t i = chunkOf(root->drawnEnd); i < root->chunks.size(); ++i) {
+      root->chunks[i]->touch();
+    }
+  } else if (visitedEnd < root->drawnEnd) {
+    root->dropChunks((visitedEnd - begin + kChunkCells - 1) / kChunkCells);
+    const quint32 end = std::min<quint32>(
+        root->drawnEnd, begin + quint32(root->chunks.size()) * kChunkCells);
+    for (quint32 seq = visitedEnd; seq < end; ++seq) {
+      root->chunks[chunkOf(seq)]->setCell(slotOf(seq), -1, cols);
+    }
+    if (visitedEnd < end) {
+      root->chunks[chunkOf(visitedEnd)]->touch();
+    }
+  }
+  root->drawnEnd = visitedEnd;
+
+  // the frontier is rebuilt, it is a single layer
+  QSGGeometry& frontier = root->frontier.geometry_;
+  frontier.allocate(int(frontierEnd - visitedEnd) * kVerticesPerCell);
+  for (quint32 seq = visitedEnd; seq < frontierEnd; ++seq) {
+    root->frontier.setCell(int(seq - visitedEnd), trace.cell(seq), cols);
+  }
+  root->frontier.touch();
+  return root;
+}
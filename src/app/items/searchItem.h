@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QColor>
+#include <QPointer>
+#include <QQuickItem>
+
+#include "src/app/items/mazeItem.h"
+#include "src/lib/service/solver/solver.h"
+
+// Playback of the solver's recorded search: the cells of the first
+// `layer` BFS layers as filled squares, the newest layer in frontierColor.
+//
+// Visited cells are kept in fixed-size chunk nodes in cell units,
+// positioned by the MazeItem view transform. Moving the layer writes only
+// the cells between the old and the new position, so only the chunks
+// holding them upload again; scrubbing stays cheap on a large trace.
+class SearchItem : public QQuickItem {
+  Q_OBJECT
+
+  Q_PROPERTY(Solver* solver READ solver WRITE setSolver NOTIFY solverChanged)
+  Q_PROPERTY(MazeItem* view READ view WRITE setView NOTIFY viewChanged)
+  // layers shown, 0 to layerCount
+  Q_PROPERTY(int layer READ layer WRITE setLayer NOTIFY layerChanged)
+  Q_PROPERTY(int layerCount READ layerCount NOTIFY layerCountChanged)
+  Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+  Q_PROPERTY(QColor frontierColor READ frontierColor WRITE setFrontierColor
+                 NOTIFY colorChanged)
+
+ public:
+  static constexpr int kChunkCells = 4096;
+
+  explicit SearchItem(QQuickItem* parent = nullptr);
+
+  Solver* solver() const;
+  void setSolver(Solver* solver);
+
+  MazeItem* view() const;
+  void setView(MazeItem* view);
+
+  int layer() const;
+  void setLayer(int layer);
+  int layerCount() const;
+
+  QColor color() const;
+  void setColor(const QColor& color);
+  QColor frontierColor() const;
+  void setFrontierColor(const QColor& color);
+
+ signals:
+  void solverChanged();
+  void viewChanged();
+  void layerChanged();
+  void layerCountChanged();
+  void colorChanged();
+
+ protected:
+  QSGNode* updatePaintNode(QSGNode* oldNode,
+                           UpdatePaintNodeData* data) override;
+
+ private:
+  void onTraceChanged();
+  void onViewChanged();
+
+  QPointer<Solver> solver_;
+  QPointer<MazeItem> view_;
+  QMetaObject::Connection solverConnection_;
+  QMetaObject::Connection viewConnection_;
+  QColor color_{"#AED6F1"};
+  QColor frontierColor_{"#2E86C1"};
+  int layer_{0};
+  int layerCount_{0};
+
+  bool traceDirty_{true};
+  bool layerDirty_{true};
+  bool transformDirty_{true};
+  bool materialDirty_{true};
+};
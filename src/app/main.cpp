@@ -3,8 +3,16 @@
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
 
+#include "src/app/items/caveImageProvider.h"
+#include "src/app/items/mazeItem.h"
+#include "src/app/items/pathItem.h"
+#include "src/app/items/searchItem.h"
 #include "src/lib/model/maze.h"
+#include "src/lib/service/agent/agentTrainer.h"
+#include "src/lib/service/analytics/analyticsReporter.h"
+#include "src/lib/service/cave/caveEngine.h"
 #include "src/lib/service/ioParser/asyncIOParser.h"
+#include "src/lib/service/metrics/metricsReporter.h"
 #include "src/lib/service/solver/solver.h"
 
 int main(int argc, char* argv[]) {
@@ -15,12 +23,58 @@ int main(int argc, char* argv[]) {
   MazeModel mazeModel;
   AsyncIOParser parser;
   Solver solver;
+  AgentTrainer agent;
+  AnalyticsReporter analytics;
+  CaveEngine caveEngine;
+  MetricsReporter metrics;
+
+  // MAZE_METRICS_DUMP=<prefix> rewrites <prefix>.json and <prefix>.trace.json
+  // every MAZE_METRICS_INTERVAL_MS (default 1000)
+  if (qEnvironmentVariableIsSet("MAZE_METRICS_INTERVAL_MS")) {
+    metrics.setIntervalMs(
+        qEnvironmentVariableIntValue("MAZE_METRICS_INTERVAL_MS"));
+  }
+  metrics.setDumpPath(qEnvironmentVariable("MAZE_METRICS_DUMP"));
 
   // connect solver to maze data
   QObject::connect(&mazeModel, &MazeModel::mazeChanged, [&]() {
-    solver.setMazeData(&mazeModel.mazeData());
+    solver.setMazeModel(&mazeModel);
     solver.clearPath();
+    agent.setMazeModel(&mazeModel);
+    agent.clear();
+    analytics.setMazeModel(&mazeModel);
   });
+  // the solver reads the model's maze in place, single walls are repaired
+  QObject::connect(&mazeModel, &MazeModel::wallEdited, &solver,
+                   [&](int row, int col, MazeModel::Wall wall, bool present) {
+                     QPoint neighbour = wall == MazeModel::RightWall
+                                            ? QPoint(row, col + 1)
+                                            : QPoint(row + 1, col);
+                     solver.repairPath(QPoint(row, col), neighbour, present);
+                   });
+  QObject::connect(&mazeModel, &MazeModel::regionEdited, &solver,
+                   &Solver::resolve);
+  // a learned route is only valid for the walls it was trained on
+  QObject::connect(&mazeModel, &MazeModel::wallEdited, &agent,
+                   &AgentTrainer::clear);
+  QObject::connect(&mazeModel, &MazeModel::regionEdited, &agent,
+                   &AgentTrainer::clear);
+  QObject::connect(&mazeModel, &MazeModel::wallEdited, &analytics,
+                   &AnalyticsReporter::invalidate);
+  QObject::connect(&mazeModel, &MazeModel::regionEdited, &analytics,
+                   &AnalyticsReporter::invalidate);
+
+  qmlRegisterType<MazeItem>("s21_maze.items", 1, 0, "MazeItem");
+  qmlRegisterType<PathItem>("s21_maze.items", 1, 0, "PathItem");
+  qmlRegisterType<SearchItem>("s21_maze.items", 1, 0, "SearchItem");
+  qmlRegisterUncreatableType<MazeModel>("s21_maze.items", 1, 0, "MazeModel",
+                                        "provided by the application");
+  qmlRegisterUncreatableType<Solver>("s21_maze.items", 1, 0, "Solver",
+                                     "provided by the application");
+  qmlRegisterUncreatableType<AgentTrainer>(
+      "s21_maze.items", 1, 0, "AgentTrainer", "provided by the application");
+  qmlRegisterUncreatableType<CaveEngine>("s21_maze.items", 1, 0, "CaveEngine",
+                                         "provided by the application");
 
   QQmlApplicationEngine engine;
   QObject::connect(
@@ -30,6 +84,12 @@ int main(int argc, char* argv[]) {
   engine.rootContext()->setContextProperty("mazeModel", &mazeModel);
   engine.rootContext()->setContextProperty("mazeParser", &parser);
   engine.rootContext()->setContextProperty("mazeSolver", &solver);
+  engine.rootContext()->setContextProperty("mazeAgent", &agent);
+  engine.rootContext()->setContextProperty("mazeMetrics", &metrics);
+  engine.rootContext()->setContextProperty("mazeAnalytics", &analytics);
+  engine.rootContext()->setContextProperty("caveEngine", &caveEngine);
+  // the engine owns the provider
+  engine.addImageProvider("cave", new CaveImageProvider(&caveEngine));
   engine.loadFromModule("s21_maze", "Main");
 
   return app.exec();
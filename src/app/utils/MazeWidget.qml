@@ -1,5 +1,6 @@
 import QtQuick
 import QtQuick.Controls
+import s21_maze.items
 
 Rectangle {
     id: _mazeWindow
@@ -10,137 +11,132 @@ Rectangle {
     border.width: 2
     radius: 12
 
-    property real cellWidth: (width - 4) / mazeModel.cols
-    property real cellHeight: (height - 4) / mazeModel.rows
+    // layers of the recorded search shown, scrubbed by the maze window
+    property alias searchLayer: _searchItem.layer
+    readonly property alias searchLayers: _searchItem.layerCount
 
-    Repeater {
+    // zoomable view: wheel to zoom, drag to pan, double click to reset
+    MazeItem {
+        id: _mazeItem
+        anchors.fill: parent
+        anchors.margins: 2
         model: mazeModel
-
-        delegate: Item {
-            id: _cellDelegate
-
-            property int row: Math.floor(index / mazeModel.cols)
-            property int col: index % mazeModel.cols
-
-            x: 2 + col * _mazeWindow.cellWidth
-            y: 2 + row * _mazeWindow.cellHeight
-            width: _mazeWindow.cellWidth
-            height: _mazeWindow.cellHeight
-
-            Rectangle {
-                x: parent.width / 2 - width / 2
-                y: parent.height / 2 - height / 2
-                width: parent.width - 5
-                height: parent.height - 5
-                radius: width / 2
-                color: {
-                    if (_cellDelegate.row === startRow
-                            && _cellDelegate.col === startCol)
-                        return "#90EE90" // light green
-                    if (_cellDelegate.row === endRow
-                            && _cellDelegate.col === endCol)
-                        return "#FFB6C1" // light pink
-                    return "transparent"
-                }
-            }
-
-            Rectangle {
-                visible: rightWall && _cellDelegate.col < mazeModel.cols - 1
-                width: 2
-                height: parent.height
-                anchors.right: parent.right
-                color: "black"
-            }
-
-            Rectangle {
-                visible: bottomWall && _cellDelegate.row < mazeModel.rows - 1
-                height: 2
-                width: parent.width
-                anchors.bottom: parent.bottom
-                color: "black"
-            }
+        wallColor: "black"
+        wallWidth: 2
+        minCellPixels: 2
+
+        component CellMarker: Rectangle {
+            property int row: -1
+            property int col: -1
+
+            visible: row >= 0 && col >= 0 && !_mazeItem.overviewActive
+            x: _mazeItem.panX + col * _mazeItem.cellWidth + 2.5
+            y: _mazeItem.panY + row * _mazeItem.cellHeight + 2.5
+            width: _mazeItem.cellWidth - 5
+            height: _mazeItem.cellHeight - 5
+            radius: width / 2
         }
-    }
-
-    Canvas {
-        id: _pathCanvas
-        anchors.fill: parent
-        visible: mazeSolver.hasSolution
-
-        onPaint: {
-            var ctx = getContext("2d")
-            ctx.clearRect(0, 0, width, height)
 
-            var path = mazeSolver.path
-            if (path.length < 2)
-                return
-
-            ctx.strokeStyle = "#E74C3C" // red
-            ctx.lineWidth = 2
-            ctx.lineCap = "round"
-            ctx.lineJoin = "round"
-
-            ctx.beginPath()
-
-            var cellW = _mazeWindow.cellWidth
-            var cellH = _mazeWindow.cellHeight
+        // the search behind the path, under the markers
+        SearchItem {
+            id: _searchItem
+            anchors.fill: parent
+            visible: mazeSolver.recordSearch && !_mazeItem.overviewActive
+            solver: mazeSolver
+            view: _mazeItem
+            color: "#AED6F1" // pale blue
+            frontierColor: "#2E86C1" // blue
+        }
 
-            // offset for border
-            var offsetX = 2
-            var offsetY = 2
+        CellMarker {
+            row: startRow
+            col: startCol
+            color: "#90EE90" // light green
+        }
 
-            for (var i = 0; i < path.length; i++) {
-                var centerX = offsetX + path[i].col * cellW + cellW / 2
-                var centerY = offsetY + path[i].row * cellH + cellH / 2
+        CellMarker {
+            row: endRow
+            col: endCol
+            color: "#FFB6C1" // light pink
+        }
 
-                if (i === 0) {
-                    ctx.moveTo(centerX, centerY)
-                } else {
-                    ctx.lineTo(centerX, centerY)
-                }
-            }
+        PathItem {
+            anchors.fill: parent
+            visible: mazeSolver.hasSolution
+            solver: mazeSolver
+            view: _mazeItem
+            color: "#E74C3C" // red
+            lineWidth: 2
+        }
 
-            ctx.stroke()
+        // the route learned by the agent, over the solver path
+        PathItem {
+            anchors.fill: parent
+            visible: mazeAgent.routeLength > 1
+            agent: mazeAgent
+            view: _mazeItem
+            color: "#3498DB" // blue
+            lineWidth: 2
         }
 
-        Connections {
-            target: mazeSolver
-            function onPathChanged() {
-                _pathCanvas.requestPaint()
+        MouseArea {
+            anchors.fill: parent
+            enabled: selectingStart || selectingEnd || editingWalls
+
+            // toggles the interior wall nearest to the click
+            function toggleNearestWall(x, y) {
+                var fx = (x - _mazeItem.panX) / _mazeItem.cellWidth
+                var fy = (y - _mazeItem.panY) / _mazeItem.cellHeight
+                var col = Math.floor(fx)
+                var row = Math.floor(fy)
+                var dx = fx - col
+                var dy = fy - row
+                var edge = Math.min(dx, 1 - dx, dy, 1 - dy)
+
+                if (edge === 1 - dx)
+                    mazeModel.toggleWall(row, col, MazeModel.RightWall)
+                else if (edge === dx)
+                    mazeModel.toggleWall(row, col - 1, MazeModel.RightWall)
+                else if (edge === 1 - dy)
+                    mazeModel.toggleWall(row, col, MazeModel.BottomWall)
+                else
+                    mazeModel.toggleWall(row - 1, col, MazeModel.BottomWall)
             }
-        }
-    }
 
-    MouseArea {
-        anchors.fill: parent
-        enabled: selectingStart || selectingEnd
-
-        onClicked: function (mouse) {
-            var cellW = _mazeWindow.cellWidth
-            var cellH = _mazeWindow.cellHeight
-            var col = Math.floor((mouse.x - 2) / cellW)
-            var row = Math.floor((mouse.y - 2) / cellH)
-
-            if (row < 0 || row >= mazeModel.rows || col < 0
-                    || col >= mazeModel.cols)
-                return
-
-            if (selectingStart) {
-                startRow = row
-                startCol = col
-                selectingStart = false
-
-                // re-solve if end already set
-                if (endRow >= 0) {
-                    mazeSolver.solveMaze(startRow, startCol, endRow, endCol)
+            onClicked: function (mouse) {
+                if (editingWalls) {
+                    toggleNearestWall(mouse.x, mouse.y)
+                    return
                 }
-            } else if (selectingEnd) {
-                endRow = row
-                endCol = col
-                selectingEnd = false
 
-                if (startRow >= 0) {
-                    mazeSolver.solveMaze(startRow, startCol, endRow, endCol)
+                var cell = _mazeItem.cellAt(mouse.x, mouse.y)
+                var row = cell.x
+                var col = cell.y
+
+                if (row < 0 || col < 0)
+                    return
+
+                if (selectingStart) {
+                    startRow = row
+                    startCol = col
+                    selectingStart = false
+                    mazeAgent.clear()
+
+                    // re-solve if end already set
+                    if (endRow >= 0) {
+                        mazeSolver.solveMazeAsync(startRow, startCol, endRow,
+                                                  endCol)
+                    }
+                } else if (selectingEnd) {
+                    endRow = row
+                    endCol = col
+                    selectingEnd = false
+                    mazeAgent.clear()
+
+                    if (startRow >= 0) {
+                        mazeSolver.solveMazeAsync(startRow, startCol, endRow,
+                                                  endCol)
+                    }
                 }
             }
         }
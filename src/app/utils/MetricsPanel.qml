@@ -0,0 +1,88 @@
+import QtQuick
+import QtQuick.Controls
+
+// live counters, timers and rates from mazeMetrics
+Rectangle {
+    id: _panel
+    width: 240
+    height: _content.height + 20
+    radius: 12
+    color: "#E61D1D1D"
+
+    function formatNumber(value) {
+        if (value >= 1e9)
+            return (value / 1e9).toFixed(2) + "G"
+        if (value >= 1e6)
+            return (value / 1e6).toFixed(2) + "M"
+        if (value >= 1e3)
+            return (value / 1e3).toFixed(1) + "k"
+        return Math.round(value).toString()
+    }
+
+    Column {
+        id: _content
+        x: 10
+        y: 10
+        width: parent.width - 20
+        spacing: 4
+
+        component Line: Label {
+            width: parent.width
+            color: "#FFFFFF"
+            font.pixelSize: 11
+            font.family: "monospace"
+            elide: Text.ElideRight
+        }
+
+        Line {
+            text: "rows/s  " + formatNumber(mazeMetrics.rates.generatedRowsPerSec)
+        }
+        Line {
+            text: "bytes/s " + formatNumber(mazeMetrics.rates.parsedBytesPerSec)
+        }
+        Line {
+            text: "nodes/s " + formatNumber(mazeMetrics.rates.nodesExpandedPerSec)
+        }
+
+        Item {
+            width: parent.width
+            height: 6
+        }
+
+        Repeater {
+            model: Object.keys(mazeMetrics.counters)
+            Line {
+                text: modelData + " " + formatNumber(
+                          mazeMetrics.counters[modelData])
+            }
+        }
+
+        Item {
+            width: parent.width
+            height: 6
+        }
+
+        Repeater {
+            model: Object.keys(mazeMetrics.timers)
+            Line {
+                property var timer: mazeMetrics.timers[modelData]
+                text: modelData + " x" + timer.count + " avg "
+                      + timer.avgMs.toFixed(2) + " max " + timer.maxMs.toFixed(
+                          2) + " ms"
+            }
+        }
+
+        TextButton {
+            height: 18
+            pixelSize: 12
+            enabledColor: "#414040"
+            pressedColor: "#414040"
+            disabledColor: "#414040"
+            enabledTextColor: "#FFFFFF"
+            pressedTextColor: "#FFFFFF"
+            disabledTextColor: "#717177"
+            text: "Reset"
+            onClicked: mazeMetrics.reset()
+        }
+    }
+}
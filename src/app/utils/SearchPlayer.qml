@@ -0,0 +1,78 @@
+import QtQuick
+import QtQuick.Controls
+
+// replays the search recorded by mazeSolver on a MazeWidget, a layer per
+// frame at 60 fps; long searches are sped up to fit in maxDuration
+Rectangle {
+    id: _player
+    height: 40
+    radius: 12
+    color: "#E61D1D1D"
+
+    property Item widget
+    property int maxDuration: 8000
+
+    function play() {
+        _playback.stop()
+        var layers = mazeSolver.searchLayers
+        if (layers === 0)
+            return
+        _playback.to = layers
+        _playback.duration = Math.min(layers * 1000 / 60, maxDuration)
+        _playback.start()
+    }
+
+    NumberAnimation {
+        id: _playback
+        target: widget
+        property: "searchLayer"
+        from: 0
+    }
+
+    // every new search plays from the start
+    Connections {
+        target: mazeSolver
+
+        function onSearchTraceChanged() {
+            _player.play()
+        }
+    }
+
+    Label {
+        id: _replay
+        x: 12
+        anchors.verticalCenter: parent.verticalCenter
+        color: "#FFFFFF"
+        text: _playback.running ? "Stop" : "Replay"
+
+        MouseArea {
+            anchors.fill: parent
+            onClicked: _playback.running ? _playback.stop() : _player.play()
+        }
+    }
+
+    Slider {
+        anchors.left: _replay.right
+        anchors.right: _layerLabel.left
+        anchors.margins: 8
+        anchors.verticalCenter: parent.verticalCenter
+        from: 0
+        to: widget.searchLayers
+        stepSize: 1
+        value: widget.searchLayer
+        onMoved: {
+            _playback.stop()
+            widget.searchLayer = value
+        }
+    }
+
+    Label {
+        id: _layerLabel
+        anchors.right: parent.right
+        anchors.rightMargin: 12
+        anchors.verticalCenter: parent.verticalCenter
+        color: "#FFFFFF"
+        font.family: "monospace"
+        text: widget.searchLayer + " / " + widget.searchLayers
+    }
+}
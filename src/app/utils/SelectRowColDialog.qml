@@ -15,6 +15,9 @@ Dialog {
     property bool colsError: false
     property bool isValid: false
 
+    // generator names to pick from, the picker is hidden when empty
+    property var algorithms: []
+
     function validate() {
         var r = parseInt(_rowsField.text)
         var c = parseInt(_colsField.text)
@@ -25,7 +28,9 @@ Dialog {
         isValid = !rowsError && !colsError
     }
 
-    signal acceptClicked(int rows, int cols)
+    // seed is -1 when left empty, for a random maze; algorithm is empty
+    // without a picker
+    signal acceptClicked(int rows, int cols, real seed, string algorithm)
 
     x: parent.width / 2 - width / 2
     y: parent.height / 2 - height / 2
@@ -90,14 +95,14 @@ Dialog {
                                 top: maxValue
                             }
 
-                            placeholderText: "Rows (5–50)"
+                            placeholderText: "Rows (" + minValue + "–" + maxValue + ")"
                             placeholderTextColor: "#9DA4AE"
                         }
                     }
 
                     Label {
                         visible: rowsError
-                        text: "Enter number from 5 to 50"
+                        text: "Enter number from " + minValue + " to " + maxValue
                         color: "#FF4D4D"
                         font.pixelSize: 10
                     }
@@ -129,19 +134,54 @@ Dialog {
                                 bottom: minValue
                                 top: maxValue
                             }
-                            placeholderText: "Columns (5–50)"
+                            placeholderText: "Columns (" + minValue + "–" + maxValue + ")"
                             placeholderTextColor: "#9DA4AE"
                         }
                     }
 
                     Label {
                         visible: colsError
-                        text: "Enter number from 5 to 50"
+                        text: "Enter number from " + minValue + " to " + maxValue
                         color: "#FF4D4D"
                         font.pixelSize: 10
                     }
                 }
 
+                Rectangle {
+                    x: 12
+                    width: parent.width - 24
+                    height: 32
+                    radius: 6
+                    border.width: 1
+                    border.color: "#707070"
+                    color: "#2E2E33"
+
+                    TextField {
+                        id: _seedField
+                        anchors.fill: parent
+                        anchors.margins: 6
+
+                        background: null
+                        color: "#FFFFFF"
+
+                        inputMethodHints: Qt.ImhDigitsOnly
+                        validator: IntValidator {
+                            bottom: 0
+                        }
+                        placeholderText: "Seed (optional)"
+                        placeholderTextColor: "#9DA4AE"
+                    }
+                }
+
+                ComboBox {
+                    id: _algorithmBox
+                    x: 12
+                    width: parent.width - 24
+                    height: 32
+                    visible: _dialog.algorithms.length > 0
+                    model: _dialog.algorithms
+                }
+
                 Row {
                     spacing: 40
                     anchors.horizontalCenter: parent.horizontalCenter
@@ -163,8 +203,13 @@ Dialog {
                             if (!isValid)
                                 return
 
+                            var seed = parseInt(_seedField.text)
                             _dialog.acceptClicked(parseInt(_rowsField.text),
-                                                  parseInt(_colsField.text))
+                                                  parseInt(_colsField.text),
+                                                  isNaN(seed) ? -1 : seed,
+                                                  _algorithmBox.visible
+                                                  ? _algorithmBox.currentText
+                                                  : "")
                         }
                     }
 
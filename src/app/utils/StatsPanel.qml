@@ -0,0 +1,75 @@
+import QtQuick
+import QtQuick.Controls
+
+// structure statistics of the current maze from mazeAnalytics
+Rectangle {
+    id: _panel
+    width: 240
+    height: _content.height + 20
+    radius: 12
+    color: "#E61D1D1D"
+
+    property var stats: mazeAnalytics.stats
+    property var solutions: stats.solutions || {}
+
+    Column {
+        id: _content
+        x: 10
+        y: 10
+        width: parent.width - 20
+        spacing: 4
+
+        component Line: Label {
+            width: parent.width
+            color: "#FFFFFF"
+            font.pixelSize: 11
+            font.family: "monospace"
+            elide: Text.ElideRight
+        }
+
+        Line {
+            visible: stats.rows === undefined
+            text: mazeAnalytics.analyzing ? "analyzing..." : "no maze"
+        }
+        Line {
+            visible: stats.rows !== undefined
+            text: "dead ends  " + stats.deadEnds + "  junctions " + stats.junctions
+        }
+        Line {
+            visible: stats.rows !== undefined
+            text: "corridors  " + stats.corridors + "  longest " + stats.longestCorridor
+        }
+        Line {
+            visible: stats.rows !== undefined
+            text: "diameter   " + stats.diameter + (stats.perfect ? "" : " (at least)")
+        }
+        Line {
+            visible: stats.rows !== undefined && solutions.samples > 0
+            text: "solutions  mean " + (solutions.mean || 0).toFixed(1) + " p50 "
+                  + solutions.p50 + " p90 " + solutions.p90 + " max " + solutions.max
+        }
+
+        // solution lengths of the random pairs, 1 to diameter left to right
+        Row {
+            id: _histogram
+            visible: stats.rows !== undefined && solutions.samples > 0
+            width: parent.width
+            height: 40
+            spacing: 1
+
+            property var buckets: solutions.histogram || []
+            property real peak: Math.max(1, ...buckets)
+
+            Repeater {
+                model: _histogram.buckets
+                Rectangle {
+                    anchors.bottom: parent.bottom
+                    width: (_histogram.width - (_histogram.buckets.length - 1))
+                           / _histogram.buckets.length
+                    height: Math.max(1, _histogram.height * modelData / _histogram.peak)
+                    color: "#3498DB"
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,189 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Dialogs
+
+import "../utils"
+
+Item {
+    id: caveWindow
+
+    Rectangle {
+        id: _buttenBlock
+        x: 20
+        y: parent.height / 2 - height / 2
+        width: 200
+        height: 500
+        radius: 12
+        color: "#1D1D1D"
+
+        Column {
+            x: parent.width / 2 - width / 2
+            y: parent.height / 2 - height / 2
+            spacing: 18
+
+            TextButton {
+                height: 32
+                enabledColor: "#414040"
+                pressedColor: "#414040"
+                disabledColor: "#414040"
+                enabledTextColor: "#FFFFFF"
+                pressedTextColor: "#FFFFFF"
+                disabledTextColor: "#717177"
+                text: "Back"
+                onClicked: {
+                    caveEngine.running = false
+                    stackView.pop()
+                }
+            }
+
+            TextButton {
+                height: 32
+                enabledColor: "#414040"
+                pressedColor: "#414040"
+                disabledColor: "#414040"
+                enabledTextColor: "#FFFFFF"
+                pressedTextColor: "#FFFFFF"
+                disabledTextColor: "#717177"
+                text: "Save"
+                onClicked: _saveDialog.open()
+            }
+
+            TextButton {
+                height: 32
+                enabledColor: "#414040"
+                pressedColor: "#414040"
+                disabledColor: "#414040"
+                enabledTextColor: "#FFFFFF"
+                pressedTextColor: "#FFFFFF"
+                disabledTextColor: "#717177"
+                text: "Step"
+                onClicked: caveEngine.step()
+            }
+
+            TextButton {
+                height: 32
+                enabledColor: "#414040"
+                pressedColor: "#414040"
+                disabledColor: "#414040"
+                enabledTextColor: "#FFFFFF"
+                pressedTextColor: "#FFFFFF"
+                disabledTextColor: "#717177"
+                text: caveEngine.running ? "Pause" : "Run"
+                onClicked: caveEngine.running = !caveEngine.running
+            }
+
+            Label {
+                text: caveEngine.stepsPerSecond + " steps/s"
+                color: "#FFFFFF"
+            }
+
+            Slider {
+                width: 160
+                from: 1
+                to: 1000
+                value: caveEngine.stepsPerSecond
+                onMoved: caveEngine.stepsPerSecond = value
+            }
+
+            Rectangle {
+                width: 160
+                height: 32
+                radius: 6
+                border.width: 1
+                border.color: "#707070"
+                color: "#2E2E33"
+
+                TextField {
+                    anchors.fill: parent
+                    anchors.margins: 6
+
+                    background: null
+                    color: "#FFFFFF"
+                    text: caveEngine.rule
+                    placeholderText: "Rule, e.g. B678/S345678"
+                    placeholderTextColor: "#9DA4AE"
+                    // malformed rules are ignored by the engine
+                    onEditingFinished: {
+                        caveEngine.rule = text
+                        text = Qt.binding(() => caveEngine.rule)
+                    }
+                }
+            }
+        }
+    }
+
+    Rectangle {
+        id: _caveView
+        x: _buttenBlock.width + 40
+        y: 20
+        width: parent.width - x - 20
+        height: parent.height - 60
+        radius: 12
+        color: "#1D1D1D"
+
+        Image {
+            id: _caveImage
+            // bumped on every change, a new id fetches the new cave
+            property int version: 0
+
+            anchors.fill: parent
+            anchors.margins: 10
+            fillMode: Image.PreserveAspectFit
+            smooth: false
+            cache: false
+            source: caveEngine.rows > 0 ? "image://cave/" + version : ""
+        }
+
+        Connections {
+            target: caveEngine
+
+            function onStepped() {
+                _caveImage.version++
+            }
+        }
+    }
+
+    FileDialog {
+        id: _saveDialog
+        title: "Save cave"
+        fileMode: FileDialog.SaveFile
+        nameFilters: ["Cave files (*.cave)", "All files (*)"]
+        onAccepted: {
+            mazeParser.saveCaveAsync(selectedFile, caveEngine)
+        }
+    }
+
+    Connections {
+        target: mazeParser
+
+        function onCaveSavingFinished(success, errorMsg) {
+            if (!success) {
+                saveErrorDialog.text = errorMsg
+                saveErrorDialog.open()
+            }
+        }
+    }
+
+    Dialog {
+        id: saveErrorDialog
+        title: "Error saving cave"
+        property alias text: saveErrorLabel.text
+        standardButtons: Dialog.Ok
+        anchors.centerIn: parent
+
+        Label {
+            id: saveErrorLabel
+        }
+    }
+
+    Label {
+        anchors.bottom: parent.bottom
+        anchors.horizontalCenter: parent.horizontalCenter
+        anchors.margins: 10
+        text: "Generation " + caveEngine.generation + ", "
+              + (caveEngine.rows * caveEngine.cols > 0
+                 ? Math.round(100 * caveEngine.rockCount / (caveEngine.rows * caveEngine.cols))
+                 : 0) + "% rock"
+        color: "gray"
+    }
+}
@@ -13,6 +13,9 @@ Item {
     property int endCol: -1
     property bool selectingStart: false
     property bool selectingEnd: false
+    property bool editingWalls: false
+    property bool showMetrics: false
+    property bool showStats: false
 
     Rectangle {
         id: _buttenBlock
@@ -26,7 +29,7 @@ Item {
         Column {
             x: parent.width / 2 - width / 2
             y: parent.height / 2 - height / 2
-            spacing: 24
+            spacing: 18
 
             TextButton {
                 height: 32
@@ -39,6 +42,9 @@ Item {
                 text: "Back"
                 onClicked: {
                     mazeSolver.clearPath()
+                    mazeSolver.recordSearch = false
+                    mazeAgent.clear()
+                    showStats = false
                     stackView.pop()
                 }
             }
@@ -67,6 +73,7 @@ Item {
                 onClicked: {
                     selectingStart = !selectingStart
                     selectingEnd = false
+                    editingWalls = false
                 }
             }
 
@@ -82,6 +89,23 @@ Item {
                 onClicked: {
                     selectingEnd = !selectingEnd
                     selectingStart = false
+                    editingWalls = false
+                }
+            }
+
+            TextButton {
+                height: 32
+                enabledColor: "#414040"
+                pressedColor: "#414040"
+                disabledColor: "#414040"
+                enabledTextColor: "#FFFFFF"
+                pressedTextColor: "#FFFFFF"
+                disabledTextColor: "#717177"
+                text: editingWalls ? "Done editing" : "Edit walls"
+                onClicked: {
+                    editingWalls = !editingWalls
+                    selectingStart = false
+                    selectingEnd = false
                 }
             }
 
@@ -100,23 +124,116 @@ Item {
                     endRow = -1
                     endCol = -1
                     mazeSolver.clearPath()
+                    mazeAgent.clear()
+                }
+            }
+
+            TextButton {
+                height: 32
+                enabledColor: "#414040"
+                pressedColor: "#414040"
+                disabledColor: "#414040"
+                enabledTextColor: "#FFFFFF"
+                pressedTextColor: "#FFFFFF"
+                disabledTextColor: "#717177"
+                enabled: startRow >= 0 && endRow >= 0
+                text: mazeAgent.training ? "Stop training" : "Train agent"
+                onClicked: {
+                    if (mazeAgent.training)
+                        mazeAgent.cancel()
+                    else
+                        mazeAgent.train(startRow, startCol, endRow, endCol)
+                }
+            }
+
+            TextButton {
+                height: 32
+                enabledColor: "#414040"
+                pressedColor: "#414040"
+                disabledColor: "#414040"
+                enabledTextColor: "#FFFFFF"
+                pressedTextColor: "#FFFFFF"
+                disabledTextColor: "#717177"
+                visible: mazeMetrics.enabled
+                text: showMetrics ? "Hide metrics" : "Metrics"
+                onClicked: showMetrics = !showMetrics
+            }
+
+            TextButton {
+                height: 32
+                enabledColor: "#414040"
+                pressedColor: "#414040"
+                disabledColor: "#414040"
+                enabledTextColor: "#FFFFFF"
+                pressedTextColor: "#FFFFFF"
+                disabledTextColor: "#717177"
+                text: showStats ? "Hide stats" : "Stats"
+                onClicked: showStats = !showStats
+            }
+
+            TextButton {
+                height: 32
+                enabledColor: "#414040"
+                pressedColor: "#414040"
+                disabledColor: "#414040"
+                enabledTextColor: "#FFFFFF"
+                pressedTextColor: "#FFFFFF"
+                disabledTextColor: "#717177"
+                text: mazeSolver.recordSearch ? "Hide search" : "Show search"
+                onClicked: {
+                    mazeSolver.recordSearch = !mazeSolver.recordSearch
+                    // solved again to record the search for the current path
+                    if (mazeSolver.recordSearch)
+                        mazeSolver.resolve()
                 }
             }
         }
     }
 
     MazeWidget {
+        id: _mazeWidget
         x: _buttenBlock.width + 40
         y: 20
     }
 
+    MetricsPanel {
+        anchors.top: _mazeWidget.top
+        anchors.right: _mazeWidget.right
+        anchors.margins: 12
+        visible: showMetrics
+    }
+
+    StatsPanel {
+        anchors.top: _mazeWidget.top
+        anchors.left: _mazeWidget.left
+        anchors.margins: 12
+        visible: showStats
+    }
+
+    SearchPlayer {
+        anchors.bottom: _mazeWidget.bottom
+        anchors.left: _mazeWidget.left
+        anchors.right: _mazeWidget.right
+        anchors.margins: 12
+        widget: _mazeWidget
+        visible: mazeSolver.recordSearch && _mazeWidget.searchLayers > 0
+    }
+
+    // analysed again on every maze change only while the panel is open
+    Binding {
+        target: mazeAnalytics
+        property: "active"
+        value: showStats
+    }
+
     FileDialog {
         id: _saveDialog
         title: "Save maze"
         fileMode: FileDialog.SaveFile
-        nameFilters: ["Maze files (*.txt)", "All files (*)"]
+        nameFilters: ["Maze files (*.txt)", "Maze archives (*.mza)",
+            "Images with the path (*.png *.svg)", "All files (*)"]
         onAccepted: {
-            mazeParser.saveMazeAsync(selectedFile, mazeModel)
+            mazeParser.saveMazeAsync(selectedFile, mazeModel, mazeSolver)
         }
     }
 
@@ -152,13 +269,27 @@ Item {
                 return "Click a cell to set START point"
             if (selectingEnd)
                 return "Click a cell to set END point"
+            if (mazeAgent.training)
+                return "Training agent..."
+            if (mazeAgent.routeLength > 0) {
+                var report = mazeAgent.report
+                return (mazeAgent.reachedGoal ? "Agent route: " + mazeAgent.routeLength
+                                                + " cells (shortest " + report.shortestLength + ")"
+                                              : "Agent has not learned a route yet")
+                        + ", " + (report.stepsPerSecond / 1e6).toFixed(1) + "M steps/s"
+            }
+            if (mazeSolver.solving)
+                return "Solving..."
             if (mazeSolver.hasSolution)
-                return "Path found: " + mazeSolver.path.length + " cells"
+                return "Path found: " + mazeSolver.pathLength + " cells"
             if (startRow >= 0 && endRow >= 0)
                 return "No path exists!"
+            // the same seed brings this maze back from the cache
+            if (mazeModel.seed >= 0)
+                return "Seed " + mazeModel.seed
             return ""
         }
-        color: mazeSolver.hasSolution ? "green" : (startRow >= 0
-                                                   && endRow >= 0 ? "red" : "gray")
+        color: mazeSolver.hasSolution ? "green" : (startRow >= 0 && endRow >= 0
+                                                   && !mazeSolver.solving ? "red" : "gray")
     }
 }
@@ -10,15 +10,33 @@ Item {
     FileDialog {
         id: _fileDialog
         title: "Select maze file"
-        nameFilters: ["Maze files (*.txt)", "All files (*)"]
+        nameFilters: ["Maze files (*.txt)", "Maze archives (*.mza)", "All files (*)"]
         onAccepted: {
             mazeParser.loadMazeAsync(selectedFile, mazeModel)
         }
     }
 
+    FileDialog {
+        id: _caveFileDialog
+        title: "Select cave file"
+        nameFilters: ["Cave files (*.cave)", "All files (*)"]
+        onAccepted: {
+            mazeParser.loadCaveAsync(selectedFile, caveEngine)
+        }
+    }
+
     Connections {
         target: mazeParser
 
+        function onCaveLoadingFinished(success, errorMsg) {
+            if (success) {
+                _stackView.push("CaveWindow.qml")
+            } else {
+                _errorDialog.massegeText = errorMsg
+                _errorDialog.open()
+            }
+        }
+
         function onLoadingFinished(success, errorMsg) {
             if (success) {
                 _stackView.push("MazeWindow.qml")
@@ -36,13 +54,26 @@ Item {
 
     SelectRowColDialog {
         id: _selectRowColDialog
-        onAcceptClicked: function (rows, cols) {
-            mazeModel.generate(rows, cols)
+        maxValue: mazeModel.maxSide
+        algorithms: mazeModel.algorithms
+        onAcceptClicked: function (rows, cols, seed, algorithm) {
+            mazeModel.generate(rows, cols, seed, algorithm)
             _selectRowColDialog.reject()
             _stackView.push("MazeWindow.qml")
         }
     }
 
+    SelectRowColDialog {
+        id: _selectCaveSizeDialog
+        minValue: 16
+        maxValue: 16384
+        onAcceptClicked: function (rows, cols, seed) {
+            caveEngine.generate(rows, cols, 45, seed)
+            _selectCaveSizeDialog.reject()
+            _stackView.push("CaveWindow.qml")
+        }
+    }
+
     Column {
         anchors.centerIn: parent
         spacing: 20
@@ -56,5 +87,15 @@ Item {
             text: "Load from file"
             onClicked: () => _fileDialog.open()
         }
+
+        Button {
+            text: "Generate cave"
+            onClicked: () => _selectCaveSizeDialog.open()
+        }
+
+        Button {
+            text: "Load cave"
+            onClicked: () => _caveFileDialog.open()
+        }
     }
 }
@@ -0,0 +1,585 @@
+#include "src/cli/commands.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <algorithm>
+#include <vector>
+
+#include "src/cli/common.h"
+#include "src/core/textCodec.h"
+#include "src/core/validator.h"
+#include "src/lib/model/maze.h"
+#include "src/lib/service/analytics/mazeAnalytics.h"
+#include "src/lib/service/cache/mazeCache.h"
+#include "src/lib/service/generator/generator.h"
+#include "src/lib/service/ioParser/asyncIOParser.h"
+#include "src/lib/service/ioParser/mazeImage.h"
+#include "src/lib/service/ioParser/pathResults.h"
+#include "src/lib/service/metrics/metrics.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+#include "src/lib/service/solver/outOfCoreSolver.h"
+#include "src/lib/service/solver/solver.h"
+
+namespace cli {
+namespace {
+
+// queries read and solved together; output keeps their order
+constexpr int kQueryBatch = 4096;
+
+struct GenerateJob {
+  int index{0};
+  MazeData maze;
+  SaveResult result;
+};
+
+struct Query {
+  quint64 index{0};  // among the valid queries, from 0
+  QPoint start;
+  QPoint end;
+  PackedPath path;
+  bool cached{false};
+};
+
+QJsonObject mazeStats(const MazeData& maze, const MazeValidation& validation,
+                      const MazeAnalyticsOptions& options) {
+  QJsonObject stats = MazeAnalytics::analyze(maze, options).toJson();
+  stats.insert("components", validation.components);
+  stats.insert("loops", validation.loops);
+  stats.insert("unreachableCells", validation.unreachableCells);
+  stats.insert("perfect", validation.isPerfect());
+  return stats;
+}
+
+}  // namespace
+
+int runGenerate(const QStringList& arguments) {
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Generate perfect mazes.");
+  parser.addOptions({
+      {"rows", "Rows per maze.", "n"},
+      {"cols", "Columns per maze.", "n"},
+      {"count", "Number of mazes (default 1).", "n", "1"},
+      {"seed", "Seed of the first maze, maze i uses seed + i.", "s"},
+      {"algorithm",
+       Generator::algorithmNames().join(", ") + " (default " +
+           Generator::kAlgorithm + ").",
+       "name", Generator::kAlgorithm},
+      {"format", "txt or mza (default txt).", "format", "txt"},
+      {"output", "Directory for maze_<i>.<format>, - for stdout.", "dir", "."},
+  });
+  if (!parseArguments(parser, arguments)) return 2;
+
+  int rows = 0, cols = 0, count = 0;
+  if (!intOption(parser, "rows", 1, &rows) ||
+      !intOption(parser, "cols", 1, &cols) ||
+      !intOption(parser, "count", 1, &count)) {
+    return 2;
+  }
+  QString format = parser.value("format");
+  QString output = parser.value("output");
+  bool toStdout = output == "-";
+  const auto algorithm =
+      MazeGenerator::parse(parser.value("algorithm").toStdString());
+  if (!algorithm) {
+    err() << "invalid --algorithm: " << parser.value("algorithm") << Qt::endl;
+    return 2;
+  }
+  if (format != "txt" && format != "mza") {
+    err() << "invalid --format: " << format << Qt::endl;
+    return 2;
+  }
+  if (toStdout && (format != "txt" || count != 1)) {
+    err() << "stdout takes a single maze in the text format" << Qt::endl;
+    return 2;
+  }
+  if (format == "txt" &&
+      (rows > TextCodec::kMaxSide || cols > TextCodec::kMaxSide)) {
+    err() << "note: text mazes above " << TextCodec::kMaxSide << "x"
+          << TextCodec::kMaxSide << " can't be loaded back, use --format mza"
+          << Qt::endl;
+  }
+  // printed with the summary so any run can be repeated
+  quint32 seed = QRandomGenerator::global()->generate();
+  if (parser.isSet("seed") && !seedOption(parser, "seed", &seed)) return 2;
+  if (!toStdout && !QDir().mkpath(output)) {
+    err() << "cannot create directory: " << output << Qt::endl;
+    return 1;
+  }
+
+  int digits = QString::number(count - 1).size();
+  auto pathFor = [&](int index) {
+    return QString("%1/maze_%2.%3")
+        .arg(output)
+        .arg(index, digits, 10, QChar('0'))
+        .arg(format);
+  };
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // a few mazes per thread in flight, each written by its own worker
+  TaskScheduler& scheduler = TaskScheduler::instance();
+  int window = scheduler.threadCount() * 2;
+  int failures = 0;
+  for (int first = 0; first < count; first += window) {
+    std::vector<GenerateJob> jobs(std::min(window, count - first));
+    for (size_t i = 0; i < jobs.size(); ++i) jobs[i].index = first + int(i);
+
+    scheduler.parallelFor(qsizetype(jobs.size()), [&](qsizetype i) {
+      GenerateJob& job = jobs[i];
+      Generator gen(*algorithm);
+      gen.setSeed(seed + quint32(job.index));
+      gen.generate(job.maze, rows, cols);
+      if (!toStdout) {
+        job.result = saveMaze(pathFor(job.index), job.maze);
+        job.maze = {};
+      }
+    });
+
+    for (GenerateJob& job : jobs) {
+      if (toStdout) job.result = saveMaze(output, job.maze);
+      if (!job.result.isValid()) {
+        err() << "maze " << job.index << ": " << job.result.error << Qt::endl;
+        ++failures;
+      }
+    }
+  }
+
+  reportSummary(parser, "generate", count, qint64(count) * rows * cols, timer,
+                {{"seed", qint64(seed)},
+                 {"algorithm", MazeGenerator::name(*algorithm)},
+                 {"failures", failures}});
+  return failures ? 1 : 0;
+}
+
+int runSolve(const QStringList& arguments) {
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Answer shortest-path queries, one `startRow startCol endRow endCol`\n"
+      "per line. Prints the query, the path length in cells (0 = no path)\n"
+      "and, with --path, the cells as row,col; or writes the answers to a\n"
+      "path results file with --output, see `results`. With --memory the\n"
+      "archive is searched tile by tile instead of loaded.");
+  parser.addPositionalArgument("maze", "Maze file (.txt, .mza or -).");
+  parser.addOptions({
+      {"queries", "Query file, - for stdin (default).", "file", "-"},
+      {"path", "Print the path cells too."},
+      {"output", "Write the answers to a path results file (.mzr).",
+       "file"},
+      {"memory", "Solve out of core in this many MiB (.mza mazes).", "mib"},
+  });
+  if (!parseArguments(parser, arguments)) return 2;
+  if (parser.positionalArguments().size() != 1) {
+    err() << "solve takes exactly one maze" << Qt::endl;
+    return 2;
+  }
+
+  QString mazePath = parser.positionalArguments().first();
+  QString queriesPath = parser.value("queries");
+  if (mazePath == "-" && queriesPath == "-") {
+    err() << "maze and queries can't both come from stdin" << Qt::endl;
+    return 2;
+  }
+  bool withPath = parser.isSet("path");
+  bool toFile = parser.isSet("output");
+  bool outOfCore = parser.isSet("memory");
+  int memory = 0;
+  if (outOfCore && !intOption(parser, "memory", 1, &memory)) return 2;
+  if (outOfCore && !mazePath.endsWith(".mza", Qt::CaseInsensitive)) {
+    err() << "--memory needs a tiled archive (.mza)" << Qt::endl;
+    return 2;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // out of core the maze stays on disk; its fingerprint would take a
+  // pass over all of it, so it is 0 and the cache is not used
+  OutOfCoreSolver external(qint64(memory) << 20);
+  ParseResult loaded;
+  if (outOfCore) {
+    if (!external.open(mazePath)) {
+      err() << mazePath << ": " << external.error() << Qt::endl;
+      return 1;
+    }
+  } else {
+    loaded = loadMaze(mazePath);
+    if (!loaded.isValid()) {
+      err() << mazePath << ": " << loaded.error << Qt::endl;
+      return 1;
+    }
+  }
+  const MazeData& maze = loaded.data;
+  const int rows = outOfCore ? external.rows() : maze.rows;
+  const int cols = outOfCore ? external.cols() : maze.cols;
+  quint64 fingerprint = outOfCore ? 0 : MazeCache::fingerprint(maze);
+
+  PathResultWriter writer;
+  if (toFile) {
+    SaveResult opened =
+        writer.open(parser.value("output"), rows, cols, fingerprint);
+    if (!opened.isValid()) {
+      err() << opened.error << Qt::endl;
+      return 1;
+    }
+  }
+
+  QFile queryFile;
+  bool opened = false;
+  if (queriesPath == "-") {
+    opened = queryFile.open(stdin, QIODevice::ReadOnly);
+  } else {
+    queryFile.setFileName(queriesPath);
+    opened = queryFile.open(QIODevice::ReadOnly);
+  }
+  if (!opened) {
+    err() << "cannot read queries: " << queriesPath << Qt::endl;
+    return 1;
+  }
+  QTextStream in(&queryFile);
+  QTextStream out(stdout);
+
+  qint64 answered = 0;
+  quint64 parsed = 0;
+  qint64 pathCells = 0;
+  int failures = 0;
+  std::vector<Query> batch;
+  batch.reserve(kQueryBatch);
+
+  MazeCache& cache = MazeCache::instance();
+  auto solveBatch = [&]() {
+    if (outOfCore) {
+      // one search at a time, the budget is for all of it
+      PathResultBlock block;
+      for (Query& query : batch) {
+        if (!external.solve(query.start, query.end, &query.path)) {
+          err() << mazePath << ": " << external.error() << Qt::endl;
+          ++failures;
+        }
+        if (toFile) {
+          block.add(query.index, query.start, query.end, query.path);
+          if (block.isFull()) writer.append(block);
+        } else {
+          writeAnswer(out, query.start, query.end, query.path, withPath);
+        }
+        pathCells += qint64(query.path.cells);
+      }
+      if (toFile) writer.append(block);
+      out.flush();
+      answered += qint64(batch.size());
+      batch.clear();
+      return;
+    }
+
+    // repeated queries are answered from the cache, only misses are solved;
+    // paths stay packed throughout
+    std::vector<Query*> misses;
+    for (Query& query : batch) {
+      query.cached = cache.findPackedPath(fingerprint, query.start, query.end,
+                                          &query.path);
+      if (!query.cached) misses.push_back(&query);
+    }
+
+    // contiguous slices keep one Solver per task instead of per query;
+    // with --output every slice appends its own answers to the file, so
+    // the slices cover the whole batch
+    std::vector<Query*> work;
+    if (toFile) {
+      for (Query& query : batch) work.push_back(&query);
+    } else {
+      work.swap(misses);
+    }
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    size_t slices =
+        std::min<size_t>(work.size(), size_t(scheduler.threadCount()));
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (size_t i = 0; i < slices; ++i) {
+      ranges.emplace_back(work.size() * i / slices,
+                          work.size() * (i + 1) / slices);
+    }
+    scheduler.parallelFor(qsizetype(ranges.size()), [&](qsizetype slice) {
+      // timed per slice, one trace event per thread and batch
+      MAZE_SCOPED_TIMER(SolveBatch);
+      const std::pair<size_t, size_t>& r = ranges[slice];
+      Solver solver;
+      PathResultBlock block;
+      for (size_t i = r.first; i < r.second; ++i) {
+        Query& query = *work[i];
+        if (!query.cached) {
+          solver.solve(maze, query.start, query.end, &query.path);
+        }
+        if (!toFile) continue;
+        block.add(query.index, query.start, query.end, query.path);
+        if (block.isFull()) writer.append(block);
+      }
+      if (toFile) writer.append(block);
+    });
+
+    for (Query& query : batch) {
+      if (!toFile) {
+        writeAnswer(out, query.start, query.end, query.path, withPath);
+      }
+      pathCells += qint64(query.path.cells);
+      if (!query.cached) {
+        cache.insertPackedPath(fingerprint, query.start, query.end,
+                               std::move(query.path));
+      }
+    }
+    out.flush();
+    answered += qint64(batch.size());
+    batch.clear();
+  };
+
+  QString line;
+  for (int lineNumber = 1; in.readLineInto(&line); ++lineNumber) {
+    line = line.trimmed();
+    if (line.isEmpty() || line.startsWith('#')) continue;
+
+    Query query;
+    query.index = parsed;
+    if (!parseQuery(line, &query.start, &query.end)) {
+      err() << queriesPath << ":" << lineNumber
+            << ": expected startRow startCol endRow endCol" << Qt::endl;
+      ++failures;
+      continue;
+    }
+
+    ++parsed;
+    batch.push_back(std::move(query));
+    if (batch.size() == kQueryBatch) solveBatch();
+  }
+  if (!batch.empty()) solveBatch();
+  if (toFile) {
+    SaveResult closed = writer.close();
+    if (!closed.isValid()) {
+      err() << parser.value("output") << ": " << closed.error << Qt::endl;
+      ++failures;
+    }
+  }
+
+  reportSummary(parser, "solve", answered, qint64(rows) * cols,
+                timer, {{"pathCells", pathCells}, {"failures", failures}});
+  return failures ? 1 : 0;
+}
+
+int runResults(const QStringList& arguments) {
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Print a path results file written by `solve --output`, one answer\n"
+      "per line in file order, each led by its query number.");
+  parser.addPositionalArgument("results", "Path results file (.mzr).");
+  parser.addOptions({{"path", "Print the path cells too."}});
+  if (!parseArguments(parser, arguments)) return 2;
+  if (parser.positionalArguments().size() != 1) {
+    err() << "results takes exactly one file" << Qt::endl;
+    return 2;
+  }
+
+  QString resultsPath = parser.positionalArguments().first();
+  bool withPath = parser.isSet("path");
+
+  QElapsedTimer timer;
+  timer.start();
+
+  PathResultReader reader;
+  if (!reader.open(resultsPath)) {
+    err() << resultsPath << ": " << reader.error() << Qt::endl;
+    return 1;
+  }
+
+  QTextStream out(stdout);
+  qint64 answers = 0;
+  qint64 pathCells = 0;
+  PathResult result;
+  while (reader.next(&result)) {
+    out << result.query << ' ';
+    writeAnswer(out, result.start, result.end, result.path, withPath);
+    ++answers;
+    pathCells += qint64(result.path.cells);
+  }
+  out.flush();
+
+  // a torn tail still leaves every answer before it
+  int failures = 0;
+  if (!reader.error().isEmpty()) {
+    err() << resultsPath << ": " << reader.error() << Qt::endl;
+    failures = 1;
+  }
+
+  reportSummary(parser, "results", answers,
+                qint64(reader.rows()) * reader.cols(), timer,
+                {{"pathCells", pathCells}, {"failures", failures}});
+  return failures;
+}
+
+int runConvert(const QStringList& arguments) {
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Convert between the text format and the tiled archive (.mza).");
+  parser.addPositionalArgument("input", "Source maze (.txt, .mza or -).");
+  parser.addPositionalArgument("output", "Target maze (.txt, .mza or -).");
+  if (!parseArguments(parser, arguments)) return 2;
+  if (parser.positionalArguments().size() != 2) {
+    err() << "convert takes an input and an output" << Qt::endl;
+    return 2;
+  }
+
+  QString input = parser.positionalArguments().at(0);
+  QString output = parser.positionalArguments().at(1);
+
+  QElapsedTimer timer;
+  timer.start();
+
+  ParseResult loaded = loadMaze(input);
+  if (!loaded.isValid()) {
+    err() << input << ": " << loaded.error << Qt::endl;
+    return 1;
+  }
+  SaveResult saved = saveMaze(output, loaded.data);
+  if (!saved.isValid()) {
+    err() << output << ": " << saved.error << Qt::endl;
+    return 1;
+  }
+
+  reportSummary(parser, "convert", 1,
+                qint64(loaded.data.rows) * loaded.data.cols, timer);
+  return 0;
+}
+
+int runRender(const QStringList& arguments) {
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Draw a maze as a PNG or SVG image, optionally with a solved path.");
+  parser.addPositionalArgument("maze", "Maze file (.txt, .mza or -).");
+  parser.addPositionalArgument("image", "Target image (.png or .svg).");
+  parser.addOptions({
+      {"cell", "Pixels per cell, walls included (default 8).", "px", "8"},
+      {"wall", "Wall thickness in pixels (default 1).", "px", "1"},
+      {"path-width", "Path thickness in pixels (default a third of a cell).",
+       "px", "0"},
+      {"solve", "Draw the shortest path, `startRow startCol endRow endCol`.",
+       "query"},
+  });
+  if (!parseArguments(parser, arguments)) return 2;
+  if (parser.positionalArguments().size() != 2) {
+    err() << "render takes a maze and an image" << Qt::endl;
+    return 2;
+  }
+  QString mazePath = parser.positionalArguments().at(0);
+  QString imagePath = parser.positionalArguments().at(1);
+  if (!MazeImage::isImagePath(imagePath)) {
+    err() << "image must be a .png or .svg file: " << imagePath << Qt::endl;
+    return 2;
+  }
+  MazeImageOptions options;
+  if (!intOption(parser, "cell", 2, &options.cellSize) ||
+      !intOption(parser, "wall", 1, &options.wallWidth) ||
+      !intOption(parser, "path-width", 0, &options.pathWidth)) {
+    return 2;
+  }
+  QPoint start, end;
+  bool solve = parser.isSet("solve");
+  if (solve && !parseQuery(parser.value("solve"), &start, &end)) {
+    err() << "invalid --solve: " << parser.value("solve") << Qt::endl;
+    return 2;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  ParseResult loaded = loadMaze(mazePath);
+  if (!loaded.isValid()) {
+    err() << mazePath << ": " << loaded.error << Qt::endl;
+    return 1;
+  }
+  const MazeData& maze = loaded.data;
+  if (solve) {
+    Solver().solve(maze, start, end, &options.path);
+    if (options.path.empty()) {
+      err() << "note: no path for --solve " << parser.value("solve")
+            << Qt::endl;
+    }
+  }
+
+  SaveResult saved = MazeImage::write(imagePath, maze, options);
+  if (!saved.isValid()) {
+    err() << imagePath << ": " << saved.error << Qt::endl;
+    return 1;
+  }
+
+  reportSummary(parser, "render", 1, qint64(maze.rows) * maze.cols, timer,
+                {{"pathLength", qint64(options.path.size())}});
+  return 0;
+}
+
+int runStats(const QStringList& arguments) {
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Print one JSON line of structure statistics per maze.");
+  parser.addPositionalArgument("mazes", "Maze files (.txt, .mza or -).",
+                               "MAZE...");
+  parser.addOptions({
+      {"samples",
+       "Random start/end pairs for the solution lengths (default 1000).",
+       "n", "1000"},
+      {"seed", "Seed of the random pairs (default 1).", "s", "1"},
+  });
+  if (!parseArguments(parser, arguments)) return 2;
+  QStringList files = parser.positionalArguments();
+  if (files.isEmpty()) {
+    err() << "stats takes at least one maze" << Qt::endl;
+    return 2;
+  }
+  MazeAnalyticsOptions options;
+  int seed = 0;
+  if (!intOption(parser, "samples", 0, &options.samples) ||
+      !intOption(parser, "seed", 0, &seed)) {
+    return 2;
+  }
+  options.seed = quint32(seed);
+
+  QElapsedTimer timer;
+  timer.start();
+
+  QTextStream out(stdout);
+  qint64 cells = 0;
+  int failures = 0;
+
+  // bounded window so only a few parsed mazes live at once
+  TaskScheduler& scheduler = TaskScheduler::instance();
+  int window = scheduler.threadCount() * 2;
+  for (qsizetype first = 0; first < files.size(); first += window) {
+    QStringList chunk = files.mid(first, window);
+    std::vector<QJsonObject> results(chunk.size());
+    scheduler.parallelFor(chunk.size(), [&](qsizetype i) {
+      ParseResult loaded = loadMaze(chunk[i]);
+      results[i] = loaded.isValid()
+                       ? mazeStats(loaded.data, loaded.validation, options)
+                       : QJsonObject{{"error", loaded.error}};
+      results[i].insert("file", chunk[i]);
+    });
+
+    for (const QJsonObject& result : results) {
+      if (result.contains("error")) {
+        ++failures;
+      } else {
+        cells += qint64(result.value("rows").toInt()) *
+                 result.value("cols").toInt();
+      }
+      out << QJsonDocument(result).toJson(QJsonDocument::Compact) << '\n';
+    }
+    out.flush();
+  }
+
+  reportSummary(parser, "stats", files.size(), cells, timer,
+                {{"failures", failures}});
+  return failures ? 1 : 0;
+}
+
+}  // namespace cli
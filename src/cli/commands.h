@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QStringList>
+
+// Subcommands of maze_cli. Each parses its own arguments (without the
+// program and command names), streams results to stdout, prints a JSON
+// throughput summary to stderr and returns the process exit code.
+namespace cli {
+
+int runGenerate(const QStringList& arguments);
+int runSolve(const QStringList& arguments);
+int runResults(const QStringList& arguments);
+int runConvert(const QStringList& arguments);
+int runRender(const QStringList& arguments);
+int runStats(const QStringList& arguments);
+
+// local service, see src/lib/service/server
+int runServe(const QStringList& arguments);
+int runClient(const QStringList& arguments);
+int runLoad(const QStringList& arguments);
+
+}  // namespace cli
@@ -0,0 +1,158 @@
+#include "src/cli/common.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+#include "src/lib/service/cache/mazeCache.h"
+#include "src/lib/service/metrics/metrics.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+
+namespace cli {
+
+QTextStream& err() {
+  static QTextStream stream(stderr);
+  return stream;
+}
+
+bool parseArguments(QCommandLineParser& parser, const QStringList& arguments) {
+  parser.addOptions({
+      {"threads", "Worker threads (default: all cores).", "n"},
+      {"metrics", "Write hot-path metrics JSON to this file on exit.", "file"},
+  });
+  // QCommandLineParser expects the program name first
+  if (!parser.parse(QStringList{QCoreApplication::applicationName()} +
+                    arguments)) {
+    err() << parser.errorText() << Qt::endl;
+    return false;
+  }
+  if (parser.isSet("threads")) {
+    int threads = parser.value("threads").toInt();
+    if (threads <= 0) {
+      err() << "invalid --threads: " << parser.value("threads") << Qt::endl;
+      return false;
+    }
+    if (!TaskScheduler::setDefaultThreadCount(threads)) {
+      err() << "--threads comes too late, the scheduler is running"
+            << Qt::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool intOption(const QCommandLineParser& parser, const QString& name,
+               int minimum, int* value) {
+  bool ok = false;
+  *value = parser.value(name).toInt(&ok);
+  if (!ok || *value < minimum) {
+    err() << "invalid --" << name << ": " << parser.value(name) << Qt::endl;
+    return false;
+  }
+  return true;
+}
+
+bool seedOption(const QCommandLineParser& parser, const QString& name,
+                quint32* value) {
+  bool ok = false;
+  *value = parser.value(name).toUInt(&ok);
+  if (!ok) {
+    err() << "invalid --" << name << ": " << parser.value(name) << Qt::endl;
+    return false;
+  }
+  return true;
+}
+
+void reportSummary(const QCommandLineParser& parser, const QString& command,
+                   qint64 items, qint64 cells, const QElapsedTimer& timer,
+                   QJsonObject extra) {
+  double seconds = timer.nsecsElapsed() / 1e9;
+  extra.insert("command", command);
+  extra.insert("items", items);
+  extra.insert("cells", cells);
+  extra.insert("threads", TaskScheduler::instance().threadCount());
+  extra.insert("elapsedMs", seconds * 1e3);
+  extra.insert("itemsPerSec", seconds > 0 ? items / seconds : 0.0);
+  extra.insert("cellsPerSec", seconds > 0 ? cells / seconds : 0.0);
+  extra.insert("cache", MazeCache::instance().toJson());
+  extra.insert("scheduler", TaskScheduler::instance().toJson());
+  err() << QJsonDocument(extra).toJson(QJsonDocument::Compact) << Qt::endl;
+
+  if (parser.isSet("metrics")) {
+    QSaveFile file(parser.value("metrics"));
+    if (file.open(QIODevice::WriteOnly)) {
+      file.write(QJsonDocument(Metrics::instance().toJson()).toJson());
+    }
+    if (!file.commit()) {
+      err() << "cannot write metrics: " << parser.value("metrics")
+            << Qt::endl;
+    }
+  }
+}
+
+ParseResult loadMaze(const QString& path) {
+  if (path == "-") {
+    QFile in;
+    if (!in.open(stdin, QIODevice::ReadOnly | QIODevice::Text)) {
+      return {{}, "cannot read stdin"};
+    }
+    return AsyncIOParser::parseMaze(in);
+  }
+  if (AsyncIOParser::isArchivePath(path)) {
+    return AsyncIOParser::parseMazeArchive(path);
+  }
+  return AsyncIOParser::parseMazeFile(path);
+}
+
+SaveResult saveMaze(const QString& path, const MazeData& maze) {
+  if (path == "-") {
+    QFile out;
+    if (!out.open(stdout, QIODevice::WriteOnly | QIODevice::Text)) {
+      return {"cannot write stdout"};
+    }
+    return AsyncIOParser::writeMaze(out, maze);
+  }
+  if (AsyncIOParser::isArchivePath(path)) {
+    return AsyncIOParser::writeMazeArchive(path, maze);
+  }
+  return AsyncIOParser::writeMazeFile(path, maze);
+}
+
+bool parseQuery(const QString& line, QPoint* start, QPoint* end) {
+  QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+  if (fields.size() != 4) return false;
+  int values[4];
+  bool ok = true;
+  for (int i = 0; ok && i < 4; ++i) values[i] = fields[i].toInt(&ok);
+  if (!ok) return false;
+  *start = {values[0], values[1]};
+  *end = {values[2], values[3]};
+  return true;
+}
+
+void writeAnswer(QTextStream& out, QPoint start, QPoint end,
+                 const std::vector<QPoint>& path, bool withPath) {
+  out << start.x() << ' ' << start.y() << ' ' << end.x() << ' ' << end.y()
+      << ' ' << qint64(path.size());
+  if (withPath) {
+    for (const QPoint& p : path) out << ' ' << p.x() << ',' << p.y();
+  }
+  out << '\n';
+}
+
+void writeAnswer(QTextStream& out, QPoint start, QPoint end,
+                 const PackedPath& path, bool withPath) {
+  if (!withPath) {
+    out << start.x() << ' ' << start.y() << ' ' << end.x() << ' ' << end.y()
+        << ' ' << qint64(path.cells) << '\n';
+    return;
+  }
+  // one decode buffer per thread, reused answer to answer
+  thread_local std::vector<QPoint> cells;
+  PathCodec::decode(path, &cells);
+  writeAnswer(out, start, end, cells, true);
+}
+
+}  // namespace cli
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QPoint>
+#include <QTextStream>
+#include <vector>
+
+#include "src/core/packedPath.h"
+#include "src/lib/service/ioParser/asyncIOParser.h"
+
+class QCommandLineParser;
+
+// helpers shared by the maze_cli commands
+namespace cli {
+
+QTextStream& err();
+
+// adds --threads and --metrics, false after printing the error
+bool parseArguments(QCommandLineParser& parser, const QStringList& arguments);
+
+// reads an int option, false after printing the error
+bool intOption(const QCommandLineParser& parser, const QString& name,
+               int minimum, int* value);
+// reads a 32-bit seed, false after printing the error
+bool seedOption(const QCommandLineParser& parser, const QString& name,
+                quint32* value);
+
+// one JSON line on stderr, stdout carries the results
+void reportSummary(const QCommandLineParser& parser, const QString& command,
+                   qint64 items, qint64 cells, const QElapsedTimer& timer,
+                   QJsonObject extra = {});
+
+// `-` is the text format on stdin/stdout, *.mza the tiled archive
+ParseResult loadMaze(const QString& path);
+SaveResult saveMaze(const QString& path, const MazeData& maze);
+
+// `startRow startCol endRow endCol`; the caller skips blanks and comments
+bool parseQuery(const QString& line, QPoint* start, QPoint* end);
+// the query, the path length in cells (0 = no path) and optionally the
+// cells as row,col
+void writeAnswer(QTextStream& out, QPoint start, QPoint end,
+                 const std::vector<QPoint>& path, bool withPath);
+void writeAnswer(QTextStream& out, QPoint start, QPoint end,
+                 const PackedPath& path, bool withPath);
+
+}  // namespace cli
@@ -0,0 +1,55 @@
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include "src/cli/commands.h"
+
+namespace {
+const char kUsage[] =
+    "usage: maze_cli <command> [options]\n"
+    "\n"
+    "commands:\n"
+    "  generate  --rows R --cols C [--count N] [--seed S] [--format txt|mza]\n"
+    "            [--algorithm NAME] [--output DIR|-]\n"
+    "  solve     MAZE [--queries FILE|-] [--path] [--output FILE.mzr]\n"
+    "            [--memory MIB]\n"
+    "  results   FILE.mzr [--path]\n"
+    "  convert   INPUT OUTPUT      (format by extension, .mza is binary)\n"
+    "  render    MAZE IMAGE.png|svg [--cell PX] [--wall PX] [--path-width PX]\n"
+    "            [--solve \"SR SC ER EC\"]\n"
+    "  stats     MAZE... [--samples N] [--seed S]\n"
+    "  serve     [--name NAME] [--resident-cells N] [--report-ms MS]\n"
+    "  client    --rows R --cols C [--seed S] [--queries FILE|-] [--path]\n"
+    "  load      [--name NAME] [--clients N] [--requests N] [--batch N]\n"
+    "            [--mazes N] [--rows R] [--cols C]\n"
+    "\n"
+    "common options: --threads N, --metrics FILE\n"
+    "`-` stands for stdin/stdout in the text format.\n";
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("maze_cli");
+
+  QStringList arguments = QCoreApplication::arguments().mid(1);
+  if (arguments.isEmpty()) {
+    QTextStream(stderr) << kUsage;
+    return 2;
+  }
+
+  QString command = arguments.takeFirst();
+  if (command == "generate") return cli::runGenerate(arguments);
+  if (command == "solve") return cli::runSolve(arguments);
+  if (command == "results") return cli::runResults(arguments);
+  if (command == "convert") return cli::runConvert(arguments);
+  if (command == "render") return cli::runRender(arguments);
+  if (command == "stats") return cli::runStats(arguments);
+  if (command == "serve") return cli::runServe(arguments);
+  if (command == "client") return cli::runClient(arguments);
+  if (command == "load") return cli::runLoad(arguments);
+
+  QTextStream(stderr) << (command == "help" || command == "--help"
+                              ? ""
+                              : "unknown command: " + command + "\n")
+                      << kUsage;
+  return command == "help" || command == "--help" ? 0 : 2;
+}
@@ -0,0 +1,320 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "src/cli/commands.h"
+#include "src/cli/common.h"
+#include "src/lib/service/server/latencyStats.h"
+#include "src/lib/service/server/mazeClient.h"
+#include "src/lib/service/server/mazeServer.h"
+
+namespace cli {
+namespace {
+
+const char kDefaultServerName[] = "s21_maze";
+
+// queries per Solve request sent by the client command
+constexpr int kClientBatch = 4096;
+
+struct LoadResult {
+  LatencyStats latency;
+  qint64 requests{0};
+  qint64 queries{0};
+  int failures{0};
+  QString error;
+};
+
+}  // namespace
+
+int runServe(const QStringList& arguments) {
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Serve generate and solve requests on a local socket until killed.");
+  parser.addOptions({
+      {"name", "Socket name (default s21_maze).", "name", kDefaultServerName},
+      {"resident-cells", "Cells of generated mazes kept resident.", "n",
+       QString::number(MazeServer::kDefaultResidentCells)},
+      {"report-ms", "Print stats to stderr this often, 0 to stay quiet.",
+       "ms", "10000"},
+  });
+  if (!parseArguments(parser, arguments)) return 2;
+
+  int reportMs = 0;
+  if (!intOption(parser, "report-ms", 0, &reportMs)) return 2;
+  bool ok = false;
+  qint64 residentCells = parser.value("resident-cells").toLongLong(&ok);
+  if (!ok || residentCells <= 0) {
+    err() << "invalid --resident-cells: " << parser.value("resident-cells")
+          << Qt::endl;
+    return 2;
+  }
+
+  MazeServer server;
+  server.setResidentCells(residentCells);
+  if (!server.listen(parser.value("name"))) {
+    err() << "cannot listen on " << parser.value("name") << ": "
+          << server.errorString() << Qt::endl;
+    return 1;
+  }
+  err() << "listening on " << server.fullServerName() << Qt::endl;
+
+  QTimer report;
+  if (reportMs > 0) {
+    QObject::connect(&report, &QTimer::timeout, [&]() {
+      err() << QJsonDocument(server.stats()).toJson(QJsonDocument::Compact)
+            << Qt::endl;
+    });
+    report.start(reportMs);
+  }
+  return QCoreApplication::exec();
+}
+
+int runClient(const QStringList& arguments) {
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Solve queries through a running server, output as for solve.");
+  parser.addOptions({
+      {"name", "Socket name (default s21_maze).", "name", kDefaultServerName},
+      {"rows", "Rows of the maze to query.", "n"},
+      {"cols", "Columns of the maze to query.", "n"},
+      {"seed", "Seed of the maze (default 1).", "s", "1"},
+      {"queries", "Query file, - for stdin (default).", "file", "-"},
+      {"path", "Print the path cells too."},
+  });
+  if (!parseArguments(parser, arguments)) return 2;
+
+  int rows = 0, cols = 0;
+  quint32 seed = 0;
+  if (!intOption(parser, "rows", 1, &rows) ||
+      !intOption(parser, "cols", 1, &cols) ||
+      !seedOption(parser, "seed", &seed)) {
+    return 2;
+  }
+  bool withPath = parser.isSet("path");
+  QString queriesPath = parser.value("queries");
+
+  QFile queryFile;
+  bool opened = false;
+  if (queriesPath == "-") {
+    opened = queryFile.open(stdin, QIODevice::ReadOnly);
+  } else {
+    queryFile.setFileName(queriesPath);
+    opened = queryFile.open(QIODevice::ReadOnly);
+  }
+  if (!opened) {
+    err() << "cannot read queries: " << queriesPath << Qt::endl;
+    return 1;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  MazeClient client;
+  quint32 mazeId = 0;
+  if (client.connectToServer(parser.value("name"))) {
+    mazeId = client.generate(rows, cols, seed);
+  }
+  if (!mazeId) {
+    err() << client.error() << Qt::endl;
+    return 1;
+  }
+
+  QTextStream in(&queryFile);
+  QTextStream out(stdout);
+  qint64 answered = 0;
+  int failures = 0;
+  std::vector<protocol::Query> batch;
+  std::vector<std::vector<QPoint>> paths;
+
+  auto solveBatch = [&]() {
+    if (!client.solve(mazeId, batch, &paths)) {
+      err() << client.error() << Qt::endl;
+      return false;
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+      writeAnswer(out, batch[i].start, batch[i].end, paths[i], withPath);
+    }
+    out.flush();
+    answered += qint64(batch.size());
+    batch.clear();
+    return true;
+  };
+
+  QString line;
+  for (int lineNumber = 1; in.readLineInto(&line); ++lineNumber) {
+    line = line.trimmed();
+    if (line.isEmpty() || line.startsWith('#')) continue;
+
+    protocol::Query query;
+    if (!parseQuery(line, &query.start, &query.end)) {
+      err() << queriesPath << ":" << lineNumber
+            << ": expected startRow startCol endRow endCol" << Qt::endl;
+      ++failures;
+      continue;
+    }
+    batch.push_back(query);
+    if (batch.size() == kClientBatch && !solveBatch()) return 1;
+  }
+  if (!batch.empty() && !solveBatch()) return 1;
+
+  reportSummary(parser, "client", answered, qint64(rows) * cols, timer,
+                {{"mazeId", qint64(mazeId)}, {"failures", failures}});
+  return failures ? 1 : 0;
+}
+
+int runLoad(const QStringList& arguments) {
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Drive a server with concurrent clients and report latency.\n"
+      "Without --name an in-process server is started.");
+  parser.addOptions({
+      {"name", "Socket name of a running server.", "name"},
+      {"clients", "Concurrent connections (default 8).", "n", "8"},
+      {"requests", "Solve requests per client (default 200).", "n", "200"},
+      {"batch", "Queries per request (default 16).", "n", "16"},
+      {"mazes", "Distinct mazes to spread requests over (default 4).", "n",
+       "4"},
+      {"rows", "Rows per maze (default 256).", "n", "256"},
+      {"cols", "Columns per maze (default 256).", "n", "256"},
+      {"seed", "Seed of the first maze and the queries (default 1).", "s",
+       "1"},
+  });
+  if (!parseArguments(parser, arguments)) return 2;
+
+  int clients = 0, requests = 0, batchSize = 0, mazes = 0, rows = 0, cols = 0;
+  quint32 seed = 0;
+  if (!intOption(parser, "clients", 1, &clients) ||
+      !intOption(parser, "requests", 1, &requests) ||
+      !intOption(parser, "batch", 1, &batchSize) ||
+      !intOption(parser, "mazes", 1, &mazes) ||
+      !intOption(parser, "rows", 1, &rows) ||
+      !intOption(parser, "cols", 1, &cols) ||
+      !seedOption(parser, "seed", &seed)) {
+    return 2;
+  }
+
+  // the in-process server answers on this thread's event loop below
+  std::unique_ptr<MazeServer> server;
+  QString name = parser.value("name");
+  if (name.isEmpty()) {
+    name = QString("s21_maze_load_%1").arg(QCoreApplication::applicationPid());
+    server = std::make_unique<MazeServer>();
+    if (!server->listen(name)) {
+      err() << "cannot listen on " << name << ": " << server->errorString()
+            << Qt::endl;
+      return 1;
+    }
+  }
+
+  QElapsedTimer timer;
+  std::vector<LoadResult> results(clients);
+  std::vector<quint32> mazeIds;
+  QString setupError;
+
+  QThreadPool clientPool;
+  clientPool.setMaxThreadCount(clients);
+  QFuture<void> done = QtConcurrent::run([&]() {
+    MazeClient setup;
+    if (!setup.connectToServer(name)) {
+      setupError = setup.error();
+      return;
+    }
+    for (int i = 0; i < mazes; ++i) {
+      quint32 id = setup.generate(rows, cols, seed + quint32(i));
+      if (!id) {
+        setupError = setup.error();
+        return;
+      }
+      mazeIds.push_back(id);
+    }
+
+    timer.start();
+    std::vector<int> indices(clients);
+    std::iota(indices.begin(), indices.end(), 0);
+    QtConcurrent::blockingMap(&clientPool, indices, [&](int index) {
+      LoadResult& result = results[index];
+      QRandomGenerator random(seed + quint32(index));
+      MazeClient client;
+      if (!client.connectToServer(name)) {
+        result.error = client.error();
+        return;
+      }
+
+      std::vector<protocol::Query> queries(batchSize);
+      std::vector<std::vector<QPoint>> paths;
+      QElapsedTimer latency;
+      for (int r = 0; r < requests; ++r) {
+        for (protocol::Query& query : queries) {
+          query.start = {random.bounded(rows), random.bounded(cols)};
+          query.end = {random.bounded(rows), random.bounded(cols)};
+        }
+        quint32 mazeId = mazeIds[random.bounded(mazes)];
+
+        latency.start();
+        if (!client.solve(mazeId, queries, &paths)) {
+          ++result.failures;
+          result.error = client.error();
+          if (!client.connectToServer(name)) return;
+          continue;
+        }
+        result.latency.record(latency.nsecsElapsed());
+        ++result.requests;
+        result.queries += batchSize;
+      }
+    });
+  });
+
+  QFutureWatcher<void> watcher;
+  QEventLoop loop;
+  QObject::connect(&watcher, &QFutureWatcher<void>::finished, &loop,
+                   &QEventLoop::quit);
+  watcher.setFuture(done);
+  if (!done.isFinished()) loop.exec();
+
+  if (!setupError.isEmpty()) {
+    err() << setupError << Qt::endl;
+    return 1;
+  }
+
+  LoadResult total;
+  for (const LoadResult& result : results) {
+    total.latency.merge(result.latency);
+    total.requests += result.requests;
+    total.queries += result.queries;
+    total.failures += result.failures;
+    if (!result.error.isEmpty()) err() << result.error << Qt::endl;
+  }
+
+  // server-side view: queueing and batching as seen by the server
+  QJsonObject serverStats;
+  if (server) {
+    serverStats = server->stats();
+  } else {
+    MazeClient client;
+    if (client.connectToServer(name)) serverStats = client.stats();
+  }
+
+  double seconds = timer.nsecsElapsed() / 1e9;
+  reportSummary(parser, "load", total.requests,
+                qint64(mazes) * rows * cols, timer,
+                {{"clients", clients},
+                 {"queries", total.queries},
+                 {"queriesPerSec", seconds > 0 ? total.queries / seconds : 0.0},
+                 {"latency", total.latency.toJson()},
+                 {"failures", total.failures},
+                 {"server", serverStats}});
+  return total.failures || total.requests == 0 ? 1 : 0;
+}
+
+}  // namespace cli
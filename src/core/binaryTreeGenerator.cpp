@@ -0,0 +1,30 @@
+#include "binaryTreeGenerator.h"
+
+#include "src/core/mazeData.h"
+
+void BinaryTreeGenerator::generate(MazeData& maze, int rows, int cols,
+                                   const RowDone& rowDone) {
+  resetGrid(maze, rows, cols, {true, true});
+  maze.isGenerated = true;
+  if (rows <= 0 || cols <= 0) return;
+  MazeRandom& rng = random();
+
+  for (int row = 0; row < rows; ++row) {
+    MazeCell* cells = maze.cells[row].data();
+    if (row == rows - 1) {
+      for (int col = 0; col + 1 < cols; ++col) cells[col].rightWall = false;
+    } else {
+      for (int col = 0; col + 1 < cols; ++col) {
+        const bool right = rng.bounded(2);
+        cells[col].rightWall = !right;
+        cells[col].bottomWall = right;
+      }
+      cells[cols - 1].bottomWall = false;
+    }
+
+    if (rowDone && !rowDone(row)) {
+      maze.isGenerated = false;
+      return;
+    }
+  }
+}
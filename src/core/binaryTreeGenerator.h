@@ -0,0 +1,13 @@
+#pragma once
+
+#include "src/core/mazeGenerator.h"
+
+// Binary tree: every cell opens right or down at random, the last row
+// only right and the last column only down. No state beyond the grid, so
+// rows stream out as they are drawn; the maze is biased, with open
+// corridors along the bottom row and the right column.
+class BinaryTreeGenerator : public MazeGenerator {
+ public:
+  void generate(MazeData& maze, int rows, int cols,
+                const RowDone& rowDone = {}) override;
+};
@@ -0,0 +1,114 @@
+#include "ellerGenerator.h"
+
+#include <algorithm>
+
+#include "src/core/fixedKernels.h"
+#include "src/core/mazeData.h"
+
+void EllerGenerator::generate(MazeData& maze, int rows, int cols,
+                              const RowDone& rowDone) {
+  if (withFixedSize(rows, cols, [&](auto kernel) {
+        kernel.generate(maze, random(), rowDone);
+      })) {
+    return;
+  }
+
+  resetGrid(maze, rows, cols, {true, true});
+  maze.isGenerated = true;
+
+  sets_.clear();
+  nextSetId_ = 1;
+
+  for (int row = 0; row < rows; ++row) {
+    assignNewSets(cols);
+
+    if (row == rows - 1) {
+      // last row: merge all adjacent cells of different sets
+      for (int col = 0; col < cols - 1; ++col) {
+        if (sets_[col] != sets_[col + 1]) {
+          maze.cells[row][col].rightWall = false;
+          int oldSet = sets_[col + 1];
+          int newSet = sets_[col];
+          for (int c = 0; c < cols; ++c) {
+            if (sets_[c] == oldSet) sets_[c] = newSet;
+          }
+        }
+      }
+      // last row always has bottom walls
+    } else {
+      mergeRandomRight(maze, row);
+      createBottomPassages(maze, row);
+      prepareNextRow(maze, row);
+    }
+
+    // Eller's never revisits a finished row
+    if (rowDone && !rowDone(row)) {
+      maze.isGenerated = false;
+      return;
+    }
+  }
+}
+
+void EllerGenerator::assignNewSets(int cols) {
+  sets_.resize(cols);
+  for (int c = 0; c < cols; ++c) {
+    if (sets_[c] == 0) {
+      sets_[c] = nextSetId_++;
+    }
+  }
+}
+
+void EllerGenerator::mergeRandomRight(MazeData& maze, int row) {
+  int cols = maze.cols;
+
+  for (int col = 0; col < cols - 1; ++col) {
+    if (sets_[col] != sets_[col + 1] &&
+        random().bounded(2)) {
+      maze.cells[row][col].rightWall = false;
+      int oldSet = sets_[col + 1];
+      int newSet = sets_[col];
+      for (int c = 0; c < cols; ++c) {
+        if (sets_[c] == oldSet) sets_[c] = newSet;
+      }
+    }
+  }
+}
+
+void EllerGenerator::createBottomPassages(MazeData& maze, int row) {
+  int cols = maze.cols;
+
+  // columns grouped by set; kept across rows and mazes, so no allocation
+  // once it has grown to the widest row
+  members_.resize(cols);
+  for (int c = 0; c < cols; ++c) members_[c] = c;
+  std::sort(members_.begin(), members_.end(), [this](int a, int b) {
+    return sets_[a] != sets_[b] ? sets_[a] < sets_[b] : a < b;
+  });
+
+  for (int first = 0; first < cols;) {
+    int last = first + 1;
+    while (last < cols && sets_[members_[last]] == sets_[members_[first]]) {
+      ++last;
+    }
+
+    // one random member always opens down, the others half the time
+    int opened = first + random().bounded(last - first);
+    for (int i = first; i < last; ++i) {
+      if (i == opened || random().bounded(2)) {
+        maze.cells[row][members_[i]].bottomWall = false;
+      }
+    }
+    first = last;
+  }
+}
+
+void EllerGenerator::prepareNextRow(const MazeData& maze, int row) {
+  int cols = maze.cols;
+
+  // cells with bottom wall start fresh (set = 0), others keep their set
+  for (int c = 0; c < cols; ++c) {
+    if (maze.cells[row][c].bottomWall) {
+      sets_[c] = 0;
+    }
+  }
+}
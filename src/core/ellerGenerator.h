@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+#include "src/core/mazeGenerator.h"
+
+// Eller's algorithm: perfect mazes one row at a time, keeping only the
+// set of every cell of the current row.
+class EllerGenerator : public MazeGenerator {
+ public:
+  void generate(MazeData& maze, int rows, int cols,
+                const RowDone& rowDone = {}) override;
+
+ private:
+  void assignNewSets(int cols);
+  void mergeRandomRight(MazeData& maze, int row);
+  void createBottomPassages(MazeData& maze, int row);
+  void prepareNextRow(const MazeData& maze, int row);
+
+  std::vector<int> sets_;  // set id for each cell in current row
+  std::vector<int> members_;  // columns of the current row, by set
+  int nextSetId_ = 1;
+};
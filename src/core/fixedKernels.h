@@ -0,0 +1,193 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+#include "src/core/mazeData.h"
+#include "src/core/mazeRandom.h"
+#include "src/core/packedPath.h"
+
+// Generate and search kernels for the sizes most mazes come in, with the
+// dimensions known at compile time: divisions by the width become
+// multiplies, row loops have constant trip counts the compiler unrolls,
+// and all state lives in fixed arrays on the stack (set ids and cell
+// ids fit 16 bits). Results are identical to EllerGenerator and
+// MazeBfs, draw for draw and cell for cell; withFixedSize() picks the
+// kernel at run time.
+template <int Rows, int Cols>
+class FixedKernel {
+ public:
+  static constexpr int kRows = Rows;
+  static constexpr int kCols = Cols;
+  static constexpr int kCells = Rows * Cols;
+  static_assert(kCells < INT16_MAX && Cols <= INT8_MAX,
+                "ids must fit 16 bits, columns 8");
+
+  // Eller's algorithm, see EllerGenerator::generate. Sets are a
+  // union-find over set ids whose roots are the ids the row relabelling
+  // would give, and a row's sets are visited in id order through a bit
+  // mask of the ids present instead of a sort.
+  static void generate(MazeData& maze, MazeRandom& random,
+                       const std::function<bool(int row)>& rowDone) {
+    resetGrid(maze, Rows, Cols, {true, true});
+    maze.isGenerated = true;
+
+    // every cell gets at most one id, so ids stay within [1, kCells]
+    constexpr int kWords = (kCells + 1 + 63) / 64;
+    std::array<std::int16_t, kCells + 1> root;
+    std::array<std::int16_t, kCells + 1> first;  // lowest column per id
+    std::array<std::int8_t, Cols> next;  // the next column of the same set
+    std::array<std::uint64_t, kWords> present{};
+    std::array<std::int16_t, Cols> sets{};  // 0 = a cell without a set
+    std::int16_t nextSet = 1;
+
+    auto find = [&](std::int16_t id) {
+      while (root[id] != id) id = root[id] = root[root[id]];
+      return id;
+    };
+    // the right cell's set joins the left one's, keeping the left id
+    auto unite = [&](int col) {
+      std::int16_t left = find(sets[col]), right = find(sets[col + 1]);
+      if (left == right) return false;
+      root[right] = left;
+      sets[col + 1] = left;
+      return true;
+    };
+
+    for (int row = 0; row < Rows; ++row) {
+      MazeCell* cells = maze.cells[row].data();
+      for (int c = 0; c < Cols; ++c) {
+        if (sets[c] == 0) {
+          root[nextSet] = nextSet;
+          sets[c] = nextSet++;
+        }
+      }
+
+      if (row == Rows - 1) {
+        // last row: merge all adjacent cells of different sets
+        for (int col = 0; col < Cols - 1; ++col) {
+          if (unite(col)) cells[col].rightWall = false;
+        }
+      } else {
+        for (int col = 0; col < Cols - 1; ++col) {
+          const std::int16_t left = find(sets[col]);
+          const std::int16_t right = find(sets[col + 1]);
+          if (left == right) continue;
+          // taken or not at random, so selects instead of a branch
+          const bool merge = random.bounded(2);
+          root[right] = merge ? left : right;
+          sets[col + 1] = merge ? left : sets[col + 1];
+          cells[col].rightWall = !merge;
+        }
+
+        // columns grouped by set, sets in id order, columns ascending
+        for (int c = Cols - 1; c >= 0; --c) {
+          const std::int16_t id = sets[c] = find(sets[c]);
+          const std::uint64_t bit = std::uint64_t(1) << (id & 63);
+          next[c] = present[id >> 6] & bit ? std::int8_t(first[id]) : -1;
+          first[id] = std::int16_t(c);
+          present[id >> 6] |= bit;
+        }
+        for (int word = 0; word < kWords; ++word) {
+          for (; present[word]; present[word] &= present[word] - 1) {
+            const int id = word * 64 + std::countr_zero(present[word]);
+            int size = 0;
+            for (int c = first[id]; c >= 0; c = next[c]) ++size;
+            // one random member always opens down, the others half the
+            // time
+            int opened = random.bounded(size);
+            int i = 0;
+            for (int c = first[id]; c >= 0; c = next[c], ++i) {
+              cells[c].bottomWall = !(i == opened || random.bounded(2));
+            }
+          }
+        }
+
+        // cells with a bottom wall start the next row without a set
+        for (int c = 0; c < Cols; ++c) {
+          if (cells[c].bottomWall) sets[c] = 0;
+        }
+      }
+
+      if (rowDone && !rowDone(row)) {
+        maze.isGenerated = false;
+        return;
+      }
+    }
+  }
+
+  // breadth-first from start until target, see MazeBfs::search; the path
+  // goes into out as Point(row, col) or packed, false without one
+  template <class Out, class Visit>
+  static bool findPath(const MazeData& maze, int start, int target, Out* out,
+                       Visit&& visit) {
+    std::array<const MazeCell*, Rows> rows;
+    for (int r = 0; r < Rows; ++r) rows[r] = maze.cells[r].data();
+    std::array<std::int16_t, kCells> parent;
+    parent.fill(-2);
+    std::array<std::int16_t, kCells> queue;
+
+    int tail = 0;
+    queue[tail++] = std::int16_t(start);
+    parent[start] = -1;
+    for (int head = 0; head < tail; ++head) {
+      const int cell = queue[head];
+      visit(cell, size_t(tail - head));
+      if (cell == target) {
+        tracePath(parent, cell, out);
+        return true;
+      }
+
+      const int r = cell / Cols, c = cell % Cols;
+      auto reach = [&](int next) {
+        if (parent[next] != -2) return;
+        parent[next] = std::int16_t(cell);
+        queue[tail++] = std::int16_t(next);
+      };
+      if (c + 1 < Cols && !rows[r][c].rightWall) reach(cell + 1);
+      if (c > 0 && !rows[r][c - 1].rightWall) reach(cell - 1);
+      if (r + 1 < Rows && !rows[r][c].bottomWall) reach(cell + Cols);
+      if (r > 0 && !rows[r - 1][c].bottomWall) reach(cell - Cols);
+    }
+    out->clear();
+    return false;
+  }
+
+ private:
+  template <class Point>
+  static void tracePath(const std::array<std::int16_t, kCells>& parent,
+                        int cell, std::vector<Point>* out) {
+    size_t length = 0;
+    for (int at = cell; at >= 0; at = parent[at]) ++length;
+    out->resize(length);
+    for (int at = cell; at >= 0; at = parent[at]) {
+      (*out)[--length] = Point(at / Cols, at % Cols);
+    }
+  }
+  static void tracePath(const std::array<std::int16_t, kCells>& parent,
+                        int cell, PackedPath* out) {
+    PathCodec::fromParents(parent, Cols, cell, out);
+  }
+};
+
+// the sizes with a kernel, the common request sizes up to the text
+// format's limit
+using FixedKernels =
+    std::tuple<FixedKernel<10, 10>, FixedKernel<20, 20>, FixedKernel<50, 50>>;
+
+// calls fn(FixedKernel<rows, cols>{}) when there is one, false otherwise
+template <class Fn>
+bool withFixedSize(int rows, int cols, Fn&& fn) {
+  return std::apply(
+      [&](auto... kernels) {
+        return ((rows == decltype(kernels)::kRows &&
+                 cols == decltype(kernels)::kCols && (fn(kernels), true)) ||
+                ...);
+      },
+      FixedKernels{});
+}
@@ -0,0 +1,148 @@
+#include "kruskalGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
+#include "src/core/mazeData.h"
+
+namespace {
+constexpr std::uint64_t kNone = ~std::uint64_t(0);
+// edges per parallelFor item
+constexpr std::uint32_t kChunkEdges = 1 << 15;
+
+using Ref32 = std::atomic_ref<std::uint32_t>;
+using Ref64 = std::atomic_ref<std::uint64_t>;
+
+// splitmix64, a distinct weight per edge from the maze's salt
+std::uint64_t weigh(std::uint64_t salt, std::uint32_t edge) {
+  std::uint64_t z = salt + (std::uint64_t(edge) + 1) * 0x9e3779b97f4a7c15u;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+  z ^= z >> 31;
+  // the edge in the low half breaks ties
+  return (z & 0xffffffff00000000u) | edge;
+}
+}  // namespace
+
+std::uint32_t KruskalGenerator::find(std::uint32_t cell) {
+  // halving only ever points a cell further up its own tree, so racing
+  // writes leave a valid forest
+  for (;;) {
+    std::uint32_t up = Ref32(parent_[cell]).load(std::memory_order_relaxed);
+    if (up == cell) return cell;
+    std::uint32_t upper = Ref32(parent_[up]).load(std::memory_order_relaxed);
+    if (upper != up) {
+      Ref32(parent_[cell]).store(upper, std::memory_order_relaxed);
+    }
+    cell = upper;
+  }
+}
+
+bool KruskalGenerator::unite(std::uint32_t a, std::uint32_t b) {
+  for (;;) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    // the larger root goes under the smaller, if it still is a root
+    if (a < b) std::swap(a, b);
+    std::uint32_t expected = a;
+    if (Ref32(parent_[a]).compare_exchange_weak(expected, b,
+                                                std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+}
+
+void KruskalGenerator::generate(MazeData& maze, int rows, int cols,
+                                const RowDone& rowDone) {
+  resetGrid(maze, rows, cols, {true, true});
+  maze.isGenerated = true;
+  if (rows <= 0 || cols <= 0) return;
+
+  const std::uint32_t cells = std::uint32_t(rows) * std::uint32_t(cols);
+  const std::uint32_t across = std::uint32_t(rows) * std::uint32_t(cols - 1);
+  const std::uint32_t edges = across + std::uint32_t(rows - 1) * cols;
+  MazeRandom& rng = random();
+  const std::uint64_t salt = std::uint64_t(rng.generate()) << 32 |
+                             rng.generate();
+
+  parent_.resize(cells);
+  std::iota(parent_.begin(), parent_.end(), 0u);
+  lightest_.assign(cells, kNone);
+  const int chunks = int(std::max<std::uint32_t>(
+      1, (edges + kChunkEdges - 1) / kChunkEdges));
+  chunks_.resize(size_t(chunks));
+  parallelFor(chunks, [&](int i) {
+    auto& chunk = chunks_[size_t(i)];
+    chunk.resize(std::min(edges, std::uint32_t(i + 1) * kChunkEdges) -
+                 std::uint32_t(i) * kChunkEdges);
+    std::iota(chunk.begin(), chunk.end(), std::uint32_t(i) * kChunkEdges);
+  });
+
+  // right edges first, then down edges
+  auto ends = [&](std::uint32_t edge) {
+    if (edge < across) {
+      std::uint32_t cell = edge / (cols - 1) * cols + edge % (cols - 1);
+      return std::pair{cell, cell + 1};
+    }
+    std::uint32_t cell = edge - across;
+    return std::pair{cell, cell + std::uint32_t(cols)};
+  };
+
+  // cells per parallelFor item in the joining step
+  const std::uint32_t span = (cells + chunks - 1) / chunks;
+  std::atomic<bool> joined{true};
+  while (joined.load()) {
+    joined = false;
+    // every component's lightest way out; edges inside one are dropped
+    parallelFor(chunks, [&](int i) {
+      auto& chunk = chunks_[size_t(i)];
+      size_t kept = 0;
+      for (std::uint32_t edge : chunk) {
+        auto [a, b] = ends(edge);
+        a = find(a);
+        b = find(b);
+        if (a == b) continue;
+        chunk[kept++] = edge;
+        const std::uint64_t weight = weigh(salt, edge);
+        for (std::uint32_t root : {a, b}) {
+          Ref64 lightest(lightest_[root]);
+          std::uint64_t current = lightest.load(std::memory_order_relaxed);
+          while (weight < current &&
+                 !lightest.compare_exchange_weak(current, weight,
+                                                 std::memory_order_relaxed)) {
+          }
+        }
+      }
+      chunk.resize(kept);
+    });
+
+    // join along them; an edge both sides chose is carved once
+    parallelFor(chunks, [&](int i) {
+      const std::uint32_t end = std::min(cells, (std::uint32_t(i) + 1) * span);
+      for (std::uint32_t root = std::uint32_t(i) * span; root < end; ++root) {
+        if (lightest_[root] == kNone) continue;
+        const std::uint32_t edge = std::uint32_t(lightest_[root]);
+        lightest_[root] = kNone;
+        auto [a, b] = ends(edge);
+        if (!unite(a, b)) continue;
+        MazeCell& cell = maze.cells[a / cols][a % cols];
+        if (edge < across) {
+          cell.rightWall = false;
+        } else {
+          cell.bottomWall = false;
+        }
+        joined.store(true, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  // rows are only final once every round is done
+  for (int row = 0; row < rows; ++row) {
+    if (rowDone && !rowDone(row)) {
+      maze.isGenerated = false;
+      return;
+    }
+  }
+}
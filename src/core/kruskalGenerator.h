@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "src/core/mazeGenerator.h"
+
+// Randomized Kruskal: the minimum spanning tree under random edge
+// weights. With distinct weights that tree is unique, so it is built in
+// Borůvka rounds instead of one sorted pass: every component takes its
+// lightest outgoing edge, and all of them are joined at once through a
+// lock-free union-find (CAS linking, path halving). Rounds run on
+// parallelFor over chunks of the remaining edges; each round at least
+// halves the components and drops edges inside one. The result does not
+// depend on the thread count or timing. Buffers are kept across mazes.
+class KruskalGenerator : public MazeGenerator {
+ public:
+  void generate(MazeData& maze, int rows, int cols,
+                const RowDone& rowDone = {}) override;
+
+ private:
+  std::uint32_t find(std::uint32_t cell);
+  // false when a and b are already joined
+  bool unite(std::uint32_t a, std::uint32_t b);
+
+  std::vector<std::uint32_t> parent_;  // union-find, by std::atomic_ref
+  std::vector<std::uint64_t> lightest_;  // per root: weight << 32 | edge
+  std::vector<std::vector<std::uint32_t>> chunks_;  // edges still between
+                                                    // components
+};
@@ -0,0 +1,28 @@
+#include "mazeBfs.h"
+
+bool MazeBfs::canMove(const MazeData& maze, int fromRow, int fromCol,
+                      int toRow, int toCol) {
+  // bounds check
+  if (toRow < 0 || toRow >= maze.rows || toCol < 0 || toCol >= maze.cols) {
+    return false;
+  }
+
+  // moving right: check right wall of current cell
+  if (toRow == fromRow && toCol == fromCol + 1) {
+    return !maze.cells[fromRow][fromCol].rightWall;
+  }
+  // moving left: check right wall of target cell
+  if (toRow == fromRow && toCol == fromCol - 1) {
+    return !maze.cells[toRow][toCol].rightWall;
+  }
+  // moving down: check bottom wall of current cell
+  if (toCol == fromCol && toRow == fromRow + 1) {
+    return !maze.cells[fromRow][fromCol].bottomWall;
+  }
+  // moving up: check bottom wall of target cell
+  if (toCol == fromCol && toRow == fromRow - 1) {
+    return !maze.cells[toRow][toCol].bottomWall;
+  }
+
+  return false;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "src/core/fixedKernels.h"
+#include "src/core/mazeData.h"
+#include "src/core/packedPath.h"
+
+// Breadth-first search over the cells of a maze by flat id
+// (row * cols + col). The state lives in vectors of the caller, so a
+// caller with an arena searches without touching the heap.
+class MazeBfs {
+ public:
+  // false for walls and cells outside the maze; to must be adjacent
+  static bool canMove(const MazeData& maze, int fromRow, int fromCol,
+                      int toRow, int toCol);
+
+  // Expands cells in breadth-first order from start, neighbours right,
+  // left, down, up. parent[cell] is -2 unseen, -1 for start, else the
+  // cell it was reached from. visit(cell, frontier) runs as a cell is
+  // expanded, with the number of cells queued; true stops the search.
+  template <class Visit>
+  static void search(const MazeData& maze, int start,
+                     std::pmr::vector<int>& parent,
+                     std::pmr::vector<int>& queue, Visit&& visit) {
+    const int cols = maze.cols;
+    parent.assign(static_cast<size_t>(maze.rows) * cols, -2);
+    queue.clear();
+    queue.reserve(parent.size());  // every cell enters once, it never grows
+    queue.push_back(start);
+    parent[start] = -1;
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+      const int cell = queue[head];
+      if (visit(cell, queue.size() - head)) return;
+      const int r = cell / cols, c = cell % cols;
+      const MazeCell& here = maze.cells[r][c];
+      auto reach = [&](int next) {
+        if (parent[next] != -2) return;
+        parent[next] = cell;
+        queue.push_back(next);
+      };
+      if (c + 1 < cols && !here.rightWall) reach(cell + 1);
+      if (c > 0 && !maze.cells[r][c - 1].rightWall) reach(cell - 1);
+      if (r + 1 < maze.rows && !here.bottomWall) reach(cell + cols);
+      if (r > 0 && !maze.cells[r - 1][c].bottomWall) reach(cell - cols);
+    }
+  }
+
+  // shortest path from start to target into out, a std::vector of
+  // Point(row, col) or a PackedPath; false and empty without one.
+  // visit(cell, frontier) sees every expansion. Sizes with a FixedKernel
+  // search on the stack, the others in parent and queue.
+  template <class Out, class Visit>
+  static bool findPath(const MazeData& maze, int start, int target,
+                       std::pmr::vector<int>& parent,
+                       std::pmr::vector<int>& queue, Out* out, Visit&& visit) {
+    bool found = false;
+    if (withFixedSize(maze.rows, maze.cols, [&](auto kernel) {
+          found = kernel.findPath(maze, start, target, out, visit);
+        })) {
+      return found;
+    }
+    search(maze, start, parent, queue, [&](int cell, size_t frontier) {
+      visit(cell, frontier);
+      found = cell == target;
+      return found;
+    });
+    if (found) {
+      path(parent, maze.cols, target, out);
+    } else {
+      out->clear();
+    }
+    return found;
+  }
+
+  // the cells from the start to cell after a search, as Point(row, col);
+  // out is resized, not reallocated when it is large enough
+  template <class Point>
+  static void path(const std::pmr::vector<int>& parent, int cols, int cell,
+                   std::vector<Point>* out) {
+    size_t length = 0;
+    for (int at = cell; at >= 0; at = parent[at]) ++length;
+    out->resize(length);
+    for (int at = cell; at >= 0; at = parent[at]) {
+      (*out)[--length] = Point(at / cols, at % cols);
+    }
+  }
+  // the same, packed straight from the parent links
+  static void path(const std::pmr::vector<int>& parent, int cols, int cell,
+                   PackedPath* out) {
+    PathCodec::fromParents(parent, cols, cell, out);
+  }
+};
@@ -0,0 +1,238 @@
+#include "mazeCApi.h"
+
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "src/core/ellerGenerator.h"
+#include "src/core/mazeBfs.h"
+#include "src/core/mazeData.h"
+#include "src/core/textCodec.h"
+#include "src/core/validator.h"
+
+namespace {
+struct Cell {
+  int row{0};
+  int col{0};
+
+  Cell() = default;
+  Cell(int r, int c) : row(r), col(c) {}
+};
+}  // namespace
+
+struct maze {
+  MazeData data;
+  EllerGenerator generator;
+  // search state kept between solves, so same-size solves don't allocate
+  std::pmr::vector<int> parent;
+  std::pmr::vector<int> queue;
+  std::vector<Cell> path;
+  mutable std::string error;
+};
+
+namespace {
+maze_status fail(const maze_t* maze, maze_status status,
+                 const std::string& message) {
+  maze->error = message;
+  return status;
+}
+
+maze_status ok(const maze_t* maze) {
+  maze->error.clear();
+  return MAZE_OK;
+}
+
+bool inside(const MazeData& data, int row, int col) {
+  return row >= 0 && row < data.rows && col >= 0 && col < data.cols;
+}
+
+// exceptions never cross the C boundary
+template <class Call>
+maze_status guarded(const maze_t* maze, Call call) {
+  try {
+    return call();
+  } catch (const std::bad_alloc&) {
+    return fail(maze, MAZE_ERROR_MEMORY, "out of memory");
+  } catch (const std::exception& e) {
+    return fail(maze, MAZE_ERROR_ARGUMENT, e.what());
+  }
+}
+
+maze_status parse(maze_t* maze, std::istream& in) {
+  // into a scratch grid, a failed parse leaves the maze as it was
+  MazeData parsed;
+  std::string error = TextCodec::parse(in, parsed);
+  if (!error.empty()) return fail(maze, MAZE_ERROR_FORMAT, error);
+  maze->data = std::move(parsed);
+  return ok(maze);
+}
+}  // namespace
+
+extern "C" {
+
+int maze_api_version(void) { return MAZE_API_VERSION; }
+
+maze_t* maze_create(void) { return new (std::nothrow) maze(); }
+
+void maze_destroy(maze_t* maze) { delete maze; }
+
+maze_status maze_generate(maze_t* maze, int rows, int cols, uint32_t seed) {
+  if (!maze) return MAZE_ERROR_ARGUMENT;
+  if (rows <= 0 || cols <= 0 || rows > INT_MAX / cols) {
+    return fail(maze, MAZE_ERROR_ARGUMENT,
+                "invalid dimensions: " + std::to_string(rows) + "x" +
+                    std::to_string(cols));
+  }
+  return guarded(maze, [&] {
+    maze->generator.setSeed(seed);
+    maze->generator.generate(maze->data, rows, cols);
+    return ok(maze);
+  });
+}
+
+int maze_rows(const maze_t* maze) {
+  return maze && maze->data.isGenerated ? maze->data.rows : 0;
+}
+
+int maze_cols(const maze_t* maze) {
+  return maze && maze->data.isGenerated ? maze->data.cols : 0;
+}
+
+int maze_has_wall(const maze_t* maze, int row, int col, maze_wall wall) {
+  if (!maze || !maze->data.isGenerated || !inside(maze->data, row, col)) {
+    return -1;
+  }
+  const MazeCell& cell = maze->data.cells[row][col];
+  return (wall == MAZE_WALL_RIGHT ? cell.rightWall : cell.bottomWall) ? 1 : 0;
+}
+
+maze_status maze_set_wall(maze_t* maze, int row, int col, maze_wall wall,
+                          int closed) {
+  if (!maze) return MAZE_ERROR_ARGUMENT;
+  if (!maze->data.isGenerated) {
+    return fail(maze, MAZE_ERROR_EMPTY, "no maze data");
+  }
+  if (!inside(maze->data, row, col)) {
+    return fail(maze, MAZE_ERROR_ARGUMENT, "cell outside the maze");
+  }
+  MazeCell& cell = maze->data.cells[row][col];
+  (wall == MAZE_WALL_RIGHT ? cell.rightWall : cell.bottomWall) = closed != 0;
+  return ok(maze);
+}
+
+int maze_is_perfect(const maze_t* maze) {
+  if (!maze || !maze->data.isGenerated) return -1;
+  try {
+    return MazeValidator::validate(maze->data).isPerfect() ? 1 : 0;
+  } catch (const std::exception&) {
+    return -1;
+  }
+}
+
+maze_status maze_solve(maze_t* maze, int start_row, int start_col,
+                       int end_row, int end_col, int32_t* cells,
+                       size_t capacity, size_t* length) {
+  if (!maze) return MAZE_ERROR_ARGUMENT;
+  if (length) *length = 0;
+  if (!length || (!cells && capacity > 0)) {
+    return fail(maze, MAZE_ERROR_ARGUMENT, "null output");
+  }
+  const MazeData& data = maze->data;
+  if (!data.isGenerated) return fail(maze, MAZE_ERROR_EMPTY, "no maze data");
+  if (!inside(data, start_row, start_col) || !inside(data, end_row, end_col)) {
+    return fail(maze, MAZE_ERROR_ARGUMENT, "cell outside the maze");
+  }
+
+  return guarded(maze, [&] {
+    if (!MazeBfs::findPath(data, start_row * data.cols + start_col,
+                           end_row * data.cols + end_col, maze->parent,
+                           maze->queue, &maze->path, [](int, size_t) {})) {
+      return fail(maze, MAZE_ERROR_NO_PATH, "no path");
+    }
+
+    *length = maze->path.size();
+    if (maze->path.size() > capacity) {
+      return fail(maze, MAZE_ERROR_BUFFER,
+                  "path needs " + std::to_string(maze->path.size()) +
+                      " cells");
+    }
+    for (size_t i = 0; i < maze->path.size(); ++i) {
+      cells[i] = maze->path[i].row * data.cols + maze->path[i].col;
+    }
+    return ok(maze);
+  });
+}
+
+maze_status maze_load_text(maze_t* maze, const char* path) {
+  if (!maze) return MAZE_ERROR_ARGUMENT;
+  if (!path) return fail(maze, MAZE_ERROR_ARGUMENT, "null path");
+  return guarded(maze, [&] {
+    std::ifstream in(path);
+    if (!in) {
+      return fail(maze, MAZE_ERROR_IO, std::string("file not found: ") + path);
+    }
+    return parse(maze, in);
+  });
+}
+
+maze_status maze_save_text(const maze_t* maze, const char* path) {
+  if (!maze) return MAZE_ERROR_ARGUMENT;
+  if (!path) return fail(maze, MAZE_ERROR_ARGUMENT, "null path");
+  if (!maze->data.isGenerated) {
+    return fail(maze, MAZE_ERROR_EMPTY, "no maze data to save");
+  }
+  return guarded(maze, [&] {
+    std::ofstream out(path);
+    if (!out) {
+      return fail(maze, MAZE_ERROR_IO,
+                  std::string("cannot open file for writing: ") + path);
+    }
+    std::string error = TextCodec::write(out, maze->data);
+    if (!error.empty()) return fail(maze, MAZE_ERROR_IO, error);
+    return ok(maze);
+  });
+}
+
+maze_status maze_parse_text(maze_t* maze, const char* text, size_t size) {
+  if (!maze) return MAZE_ERROR_ARGUMENT;
+  if (!text && size > 0) return fail(maze, MAZE_ERROR_ARGUMENT, "null text");
+  return guarded(maze, [&] {
+    std::istringstream in(std::string(text ? text : "", size));
+    return parse(maze, in);
+  });
+}
+
+maze_status maze_format_text(const maze_t* maze, char* buffer,
+                             size_t capacity, size_t* length) {
+  if (!maze) return MAZE_ERROR_ARGUMENT;
+  if (length) *length = 0;
+  if (!length || (!buffer && capacity > 0)) {
+    return fail(maze, MAZE_ERROR_ARGUMENT, "null output");
+  }
+  if (!maze->data.isGenerated) {
+    return fail(maze, MAZE_ERROR_EMPTY, "no maze data to save");
+  }
+  return guarded(maze, [&] {
+    std::ostringstream out;
+    std::string error = TextCodec::write(out, maze->data);
+    if (!error.empty()) return fail(maze, MAZE_ERROR_IO, error);
+    const std::string text = out.str();
+    *length = text.size();
+    if (text.size() > capacity) {
+      return fail(maze, MAZE_ERROR_BUFFER,
+                  "text needs " + std::to_string(text.size()) + " bytes");
+    }
+    std::memcpy(buffer, text.data(), text.size());
+    if (text.size() < capacity) buffer[text.size()] = '\0';
+    return ok(maze);
+  });
+}
+
+const char* maze_last_error(const maze_t* maze) {
+  return maze ? maze->error.c_str() : "null handle";
+}
+
+}  // extern "C"
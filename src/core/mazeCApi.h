@@ -0,0 +1,90 @@
+#pragma once
+
+// C interface to the maze engine for embedding from C, Python (ctypes,
+// cffi), Rust or anything else with a C FFI. Handles are opaque; one
+// handle is used by one thread at a time, separate handles are
+// independent. Cells on paths are flat ids, row * cols + col.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(MAZE_C_BUILD)
+#define MAZE_API __declspec(dllexport)
+#else
+#define MAZE_API __declspec(dllimport)
+#endif
+#else
+#define MAZE_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// bumped on incompatible changes of the functions below
+#define MAZE_API_VERSION 1
+
+typedef struct maze maze_t;
+
+typedef enum maze_status {
+  MAZE_OK = 0,
+  MAZE_ERROR_ARGUMENT = 1,  // null handle, bad size or a cell outside
+  MAZE_ERROR_EMPTY = 2,     // nothing generated or loaded yet
+  MAZE_ERROR_NO_PATH = 3,
+  MAZE_ERROR_BUFFER = 4,    // too small, *length holds the size needed
+  MAZE_ERROR_IO = 5,
+  MAZE_ERROR_FORMAT = 6,
+  MAZE_ERROR_MEMORY = 7
+} maze_status;
+
+typedef enum maze_wall { MAZE_WALL_RIGHT = 0, MAZE_WALL_BOTTOM = 1 } maze_wall;
+
+// MAZE_API_VERSION of the library actually loaded
+MAZE_API int maze_api_version(void);
+
+// NULL when out of memory
+MAZE_API maze_t* maze_create(void);
+MAZE_API void maze_destroy(maze_t* maze);
+
+// a perfect maze by Eller's algorithm; same seed, same maze
+MAZE_API maze_status maze_generate(maze_t* maze, int rows, int cols,
+                                   uint32_t seed);
+
+// 0 while empty
+MAZE_API int maze_rows(const maze_t* maze);
+MAZE_API int maze_cols(const maze_t* maze);
+
+// 1 for a wall, 0 for a passage, -1 for a cell outside the maze
+MAZE_API int maze_has_wall(const maze_t* maze, int row, int col,
+                           maze_wall wall);
+MAZE_API maze_status maze_set_wall(maze_t* maze, int row, int col,
+                                   maze_wall wall, int closed);
+
+// 1 when every cell is reachable and there are no loops, 0 otherwise,
+// -1 while empty
+MAZE_API int maze_is_perfect(const maze_t* maze);
+
+// shortest path, start and end included, into cells; *length is set to
+// the path's length, also when capacity is too small
+MAZE_API maze_status maze_solve(maze_t* maze, int start_row, int start_col,
+                                int end_row, int end_col, int32_t* cells,
+                                size_t capacity, size_t* length);
+
+// the text format of the application's .txt files (at most 50x50)
+MAZE_API maze_status maze_load_text(maze_t* maze, const char* path);
+MAZE_API maze_status maze_save_text(const maze_t* maze, const char* path);
+MAZE_API maze_status maze_parse_text(maze_t* maze, const char* text,
+                                     size_t size);
+// *length is the text's size without a terminator, which is written
+// when it fits
+MAZE_API maze_status maze_format_text(const maze_t* maze, char* buffer,
+                                      size_t capacity, size_t* length);
+
+// message of the last failed call on this handle, "" after a success;
+// valid until the next call
+MAZE_API const char* maze_last_error(const maze_t* maze);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,9 @@
+#include "mazeData.h"
+
+void resetGrid(MazeData& maze, int rows, int cols, MazeCell fill) {
+  maze.rows = rows;
+  maze.cols = cols;
+  maze.isGenerated = false;
+  maze.cells.resize(rows);
+  for (auto& row : maze.cells) row.assign(cols, fill);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+
+struct MazeCell {
+  bool rightWall;
+  bool bottomWall;
+};
+
+struct MazeData {
+  int rows{0};
+  int cols{0};
+  bool isGenerated{false};
+
+  std::vector<std::vector<MazeCell>> cells;
+};
+
+// resizes the grid in place, keeping the row buffers it already has
+void resetGrid(MazeData& maze, int rows, int cols, MazeCell fill);
@@ -0,0 +1,60 @@
+#include "mazeGenerator.h"
+
+#include "src/core/binaryTreeGenerator.h"
+#include "src/core/ellerGenerator.h"
+#include "src/core/kruskalGenerator.h"
+#include "src/core/sidewinderGenerator.h"
+#include "src/core/wilsonGenerator.h"
+
+std::unique_ptr<MazeGenerator> MazeGenerator::create(MazeAlgorithm algorithm) {
+  switch (algorithm) {
+    case MazeAlgorithm::Kruskal:
+      return std::make_unique<KruskalGenerator>();
+    case MazeAlgorithm::Wilson:
+      return std::make_unique<WilsonGenerator>();
+    case MazeAlgorithm::BinaryTree:
+      return std::make_unique<BinaryTreeGenerator>();
+    case MazeAlgorithm::Sidewinder:
+      return std::make_unique<SidewinderGenerator>();
+    case MazeAlgorithm::Eller:
+      break;
+  }
+  return std::make_unique<EllerGenerator>();
+}
+
+const char* MazeGenerator::name(MazeAlgorithm algorithm) {
+  switch (algorithm) {
+    case MazeAlgorithm::Kruskal:
+      return "kruskal";
+    case MazeAlgorithm::Wilson:
+      return "wilson";
+    case MazeAlgorithm::BinaryTree:
+      return "binary-tree";
+    case MazeAlgorithm::Sidewinder:
+      return "sidewinder";
+    case MazeAlgorithm::Eller:
+      break;
+  }
+  return "eller";
+}
+
+std::optional<MazeAlgorithm> MazeGenerator::parse(std::string_view name) {
+  for (MazeAlgorithm algorithm : kAlgorithms) {
+    if (name == MazeGenerator::name(algorithm)) return algorithm;
+  }
+  return std::nullopt;
+}
+
+MazeRandom& MazeGenerator::random() {
+  static thread_local MazeRandom unseeded;
+  return seeded_ ? *seeded_ : unseeded;
+}
+
+void MazeGenerator::parallelFor(int count,
+                                const std::function<void(int)>& body) const {
+  if (parallelFor_) {
+    parallelFor_(count, body);
+    return;
+  }
+  for (int i = 0; i < count; ++i) body(i);
+}
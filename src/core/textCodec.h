@@ -0,0 +1,27 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+
+struct MazeData;
+struct MazeValidation;
+
+// The text maze format: "rows cols", the right walls matrix, a blank line
+// and the bottom walls matrix, one 0/1 per cell separated by spaces.
+// Errors come back as messages, empty on success.
+class TextCodec {
+ public:
+  static constexpr int kMaxSide = 50;
+
+  // the "rows cols" line, checked against kMaxSide
+  static std::string parseHeader(std::istream& in, int* rows, int* cols);
+  // both matrices into a maze already sized by the header; connectivity
+  // is tracked as passages are read when validation is given
+  static std::string parseWalls(std::istream& in, MazeData& maze,
+                                MazeValidation* validation = nullptr);
+  // header and walls into a fresh grid
+  static std::string parse(std::istream& in, MazeData& maze,
+                           MazeValidation* validation = nullptr);
+
+  static std::string write(std::ostream& out, const MazeData& maze);
+};
@@ -0,0 +1,202 @@
+#include "tileCodec.h"
+
+#include <array>
+
+#include "src/core/mazeData.h"
+
+namespace {
+constexpr int kProbBits = 11;
+constexpr std::uint32_t kProbInit = 1u << (kProbBits - 1);
+constexpr int kMoveBits = 5;
+constexpr std::uint32_t kTopValue = 1u << 24;
+
+constexpr std::uint32_t kFnvOffset = 2166136261u;
+constexpr std::uint32_t kFnvPrime = 16777619u;
+
+// up to 6 neighbour bits + 1 border flag per wall kind
+constexpr int kContextCount = 128;
+
+struct Model {
+  std::array<std::uint16_t, kContextCount> right;
+  std::array<std::uint16_t, kContextCount> bottom;
+
+  Model() {
+    right.fill(kProbInit);
+    bottom.fill(kProbInit);
+  }
+};
+
+class RangeEncoder {
+ public:
+  explicit RangeEncoder(std::vector<std::uint8_t>& out) : out_(out) {}
+
+  void encode(std::uint16_t& prob, bool bit) {
+    std::uint32_t bound = (range_ >> kProbBits) * prob;
+    if (!bit) {
+      range_ = bound;
+      prob += ((1u << kProbBits) - prob) >> kMoveBits;
+    } else {
+      low_ += bound;
+      range_ -= bound;
+      prob -= prob >> kMoveBits;
+    }
+    while (range_ < kTopValue) {
+      range_ <<= 8;
+      shiftLow();
+    }
+  }
+
+  void flush() {
+    for (int i = 0; i < 5; ++i) shiftLow();
+  }
+
+ private:
+  void shiftLow() {
+    if (static_cast<std::uint32_t>(low_) < 0xFF000000u || (low_ >> 32) != 0) {
+      std::uint8_t carry = static_cast<std::uint8_t>(low_ >> 32);
+      std::uint8_t temp = cache_;
+      do {
+        out_.push_back(static_cast<std::uint8_t>(temp + carry));
+        temp = 0xFF;
+      } while (--cacheSize_ != 0);
+      cache_ = static_cast<std::uint8_t>(low_ >> 24);
+    }
+    ++cacheSize_;
+    low_ = (low_ & 0x00FFFFFFu) << 8;
+  }
+
+  std::vector<std::uint8_t>& out_;
+  std::uint64_t low_ = 0;
+  std::uint32_t range_ = 0xFFFFFFFFu;
+  std::uint8_t cache_ = 0;
+  std::uint64_t cacheSize_ = 1;
+};
+
+class RangeDecoder {
+ public:
+  RangeDecoder(const std::uint8_t* data, std::size_t size)
+      : data_(data), size_(size) {
+    for (int i = 0; i < 5; ++i) code_ = (code_ << 8) | nextByte();
+  }
+
+  bool decode(std::uint16_t& prob) {
+    std::uint32_t bound = (range_ >> kProbBits) * prob;
+    bool bit;
+    if (code_ < bound) {
+      range_ = bound;
+      prob += ((1u << kProbBits) - prob) >> kMoveBits;
+      bit = false;
+    } else {
+      code_ -= bound;
+      range_ -= bound;
+      prob -= prob >> kMoveBits;
+      bit = true;
+    }
+    while (range_ < kTopValue) {
+      range_ <<= 8;
+      code_ = (code_ << 8) | nextByte();
+    }
+    return bit;
+  }
+
+ private:
+  // reading past the end yields zeros, a corrupt tile is caught by checksum
+  std::uint32_t nextByte() { return pos_ < size_ ? data_[pos_++] : 0; }
+
+  const std::uint8_t* data_;
+  std::size_t size_;
+  std::size_t pos_ = 0;
+  std::uint32_t code_ = 0;
+  std::uint32_t range_ = 0xFFFFFFFFu;
+};
+
+// neighbours outside the tile count as walls so tiles stay self-contained
+template <typename CellAt>
+int rightContext(const CellAt& cellAt, int r, int c, int cols, bool lastCol) {
+  bool left = c > 0 ? cellAt(r, c - 1).rightWall : true;
+  bool leftBottom = c > 0 ? cellAt(r, c - 1).bottomWall : true;
+  bool up = r > 0 ? cellAt(r - 1, c).bottomWall : true;
+  bool upRight = r > 0 ? cellAt(r - 1, c).rightWall : true;
+  bool upNext = r > 0 && c + 1 < cols ? cellAt(r - 1, c + 1).bottomWall : true;
+  return left | (leftBottom << 1) | (up << 2) | (upRight << 3) |
+         (upNext << 4) | (lastCol << 5);
+}
+
+template <typename CellAt>
+int bottomContext(const CellAt& cellAt, int r, int c, bool right,
+                  bool lastRow) {
+  bool left = c > 0 ? cellAt(r, c - 1).rightWall : true;
+  bool leftBottom = c > 0 ? cellAt(r, c - 1).bottomWall : true;
+  bool up = r > 0 ? cellAt(r - 1, c).bottomWall : true;
+  return right | (left << 1) | (leftBottom << 2) | (up << 3) | (lastRow << 4);
+}
+
+std::uint32_t hashCell(std::uint32_t hash, const MazeCell& cell) {
+  hash ^= static_cast<std::uint32_t>(cell.rightWall) |
+          (static_cast<std::uint32_t>(cell.bottomWall) << 1);
+  return hash * kFnvPrime;
+}
+}  // namespace
+
+std::vector<std::uint8_t> TileCodec::encode(const MazeData& maze,
+                                            const TileRect& tile,
+                                            std::uint32_t* checksum) {
+  std::vector<std::uint8_t> out;
+  // perfect mazes land well under one byte per four cells
+  out.reserve(static_cast<std::size_t>(tile.rows) * tile.cols / 4 + 16);
+
+  auto cellAt = [&](int r, int c) -> const MazeCell& {
+    return maze.cells[tile.row + r][tile.col + c];
+  };
+
+  Model model;
+  RangeEncoder encoder(out);
+  std::uint32_t hash = kFnvOffset;
+
+  for (int r = 0; r < tile.rows; ++r) {
+    bool lastRow = tile.row + r == maze.rows - 1;
+    for (int c = 0; c < tile.cols; ++c) {
+      bool lastCol = tile.col + c == maze.cols - 1;
+      const MazeCell& cell = cellAt(r, c);
+
+      int rightCtx = rightContext(cellAt, r, c, tile.cols, lastCol);
+      encoder.encode(model.right[rightCtx], cell.rightWall);
+      int bottomCtx = bottomContext(cellAt, r, c, cell.rightWall, lastRow);
+      encoder.encode(model.bottom[bottomCtx], cell.bottomWall);
+      hash = hashCell(hash, cell);
+    }
+  }
+  encoder.flush();
+
+  if (checksum) *checksum = hash;
+  return out;
+}
+
+bool TileCodec::decode(const std::uint8_t* data, std::size_t size,
+                       const TileRect& tile, int mazeRows, int mazeCols,
+                       std::uint32_t checksum, MazeData& dest, int destRow,
+                       int destCol) {
+  auto cellAt = [&](int r, int c) -> MazeCell& {
+    return dest.cells[destRow + r][destCol + c];
+  };
+
+  Model model;
+  RangeDecoder decoder(data, size);
+  std::uint32_t hash = kFnvOffset;
+
+  for (int r = 0; r < tile.rows; ++r) {
+    bool lastRow = tile.row + r == mazeRows - 1;
+    for (int c = 0; c < tile.cols; ++c) {
+      bool lastCol = tile.col + c == mazeCols - 1;
+      MazeCell& cell = cellAt(r, c);
+
+      int rightCtx = rightContext(cellAt, r, c, tile.cols, lastCol);
+      cell.rightWall = decoder.decode(model.right[rightCtx]);
+      int bottomCtx = bottomContext(cellAt, r, c, cell.rightWall, lastRow);
+      cell.bottomWall = decoder.decode(model.bottom[bottomCtx]);
+      hash = hashCell(hash, cell);
+    }
+  }
+
+  return hash == checksum;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct MazeData;
+
+// rectangular block of cells in maze coordinates
+struct TileRect {
+  int row{0};
+  int col{0};
+  int rows{0};
+  int cols{0};
+};
+
+// Dependency-free codec for the wall bitplanes of one tile.
+// Every cell is coded as two bits (right, bottom) with an adaptive binary
+// range coder. Probabilities are conditioned on the already coded neighbour
+// walls, which makes perfect-maze invariants (no closed cells, solid outer
+// border) nearly free. Tiles share no state, so they can be coded in
+// parallel and decoded independently.
+class TileCodec {
+ public:
+  // checksum is FNV-1a over the wall bits in row-major order
+  static std::vector<std::uint8_t> encode(const MazeData& maze,
+                                          const TileRect& tile,
+                                          std::uint32_t* checksum = nullptr);
+
+  // decodes tile into dest starting at (destRow, destCol);
+  // returns false if the decoded bits do not match the expected checksum
+  static bool decode(const std::uint8_t* data, std::size_t size,
+                     const TileRect& tile, int mazeRows, int mazeCols,
+                     std::uint32_t checksum, MazeData& dest, int destRow,
+                     int destCol);
+};
@@ -0,0 +1,72 @@
+#include "validator.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "src/core/mazeData.h"
+
+void MazeValidator::begin(int rows, int cols) {
+  rows_ = rows;
+  cols_ = cols;
+  components_ = rows * cols;
+  loops_ = 0;
+  parent_.resize(static_cast<size_t>(rows) * cols);
+  std::iota(parent_.begin(), parent_.end(), 0);
+  size_.assign(parent_.size(), 1);
+}
+
+void MazeValidator::addRightPassage(int row, int col) {
+  if (col + 1 >= cols_) return;  // border
+  int cell = row * cols_ + col;
+  unite(cell, cell + 1);
+}
+
+void MazeValidator::addBottomPassage(int row, int col) {
+  if (row + 1 >= rows_) return;  // border
+  int cell = row * cols_ + col;
+  unite(cell, cell + cols_);
+}
+
+MazeValidation MazeValidator::finish() const {
+  int largest = size_.empty() ? 0 : 1;
+  for (size_t cell = 0; cell < parent_.size(); ++cell) {
+    if (parent_[cell] == static_cast<int>(cell)) {
+      largest = std::max(largest, size_[cell]);
+    }
+  }
+  return {components_, loops_, static_cast<int>(parent_.size()) - largest};
+}
+
+MazeValidation MazeValidator::validate(const MazeData& maze) {
+  MazeValidator validator;
+  validator.begin(maze.rows, maze.cols);
+  for (int r = 0; r < maze.rows; ++r) {
+    for (int c = 0; c < maze.cols; ++c) {
+      if (!maze.cells[r][c].rightWall) validator.addRightPassage(r, c);
+      if (!maze.cells[r][c].bottomWall) validator.addBottomPassage(r, c);
+    }
+  }
+  return validator.finish();
+}
+
+int MazeValidator::find(int cell) {
+  // path halving
+  while (parent_[cell] != cell) {
+    parent_[cell] = parent_[parent_[cell]];
+    cell = parent_[cell];
+  }
+  return cell;
+}
+
+void MazeValidator::unite(int a, int b) {
+  a = find(a);
+  b = find(b);
+  if (a == b) {
+    ++loops_;
+    return;
+  }
+  if (size_[a] < size_[b]) std::swap(a, b);
+  parent_[b] = a;
+  size_[a] += size_[b];
+  --components_;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+struct MazeData;
+
+struct MazeValidation {
+  int components{0};        // connected regions of cells
+  int loops{0};             // passages that close a cycle
+  int unreachableCells{0};  // cells outside the largest region
+
+  bool isConnected() const { return components == 1; }
+  bool isPerfect() const { return components == 1 && loops == 0; }
+};
+
+// Union-find over maze cells, fed one passage at a time so it can run
+// inside a parser while walls are being read. Passages through the outer
+// border are ignored.
+class MazeValidator {
+ public:
+  void begin(int rows, int cols);
+  void addRightPassage(int row, int col);
+  void addBottomPassage(int row, int col);
+  MazeValidation finish() const;
+
+  static MazeValidation validate(const MazeData& maze);
+
+ private:
+  int find(int cell);
+  void unite(int a, int b);
+
+  int rows_{0};
+  int cols_{0};
+  int components_{0};
+  int loops_{0};
+  std::vector<int> parent_;
+  std::vector<int> size_;
+};
@@ -0,0 +1,83 @@
+#include "wilsonGenerator.h"
+
+#include "src/core/mazeData.h"
+
+namespace {
+constexpr std::uint8_t kInMaze = 0xff;
+// right, left, down, up
+enum Direction : std::uint8_t { kRight, kLeft, kDown, kUp };
+}  // namespace
+
+void WilsonGenerator::generate(MazeData& maze, int rows, int cols,
+                               const RowDone& rowDone) {
+  resetGrid(maze, rows, cols, {true, true});
+  maze.isGenerated = true;
+  if (rows <= 0 || cols <= 0) return;
+  MazeRandom& rng = random();
+  const int cells = rows * cols;
+  state_.assign(size_t(cells), 0);
+  state_[rng.bounded(cells)] = kInMaze;
+
+  // a uniformly random neighbour inside the maze
+  auto step = [&](int cell) {
+    const int r = cell / cols, c = cell % cols;
+    Direction ways[4];
+    int count = 0;
+    if (c + 1 < cols) ways[count++] = kRight;
+    if (c > 0) ways[count++] = kLeft;
+    if (r + 1 < rows) ways[count++] = kDown;
+    if (r > 0) ways[count++] = kUp;
+    return ways[rng.bounded(count)];
+  };
+  auto next = [cols](int cell, std::uint8_t way) {
+    switch (way) {
+      case kRight:
+        return cell + 1;
+      case kLeft:
+        return cell - 1;
+      case kDown:
+        return cell + cols;
+      default:
+        return cell - cols;
+    }
+  };
+
+  for (int start = 0; start < cells; ++start) {
+    if (state_[start] == kInMaze) continue;
+    // walk until the maze is hit, remembering the last way out of each cell
+    for (int cell = start; state_[cell] != kInMaze;) {
+      state_[cell] = step(cell);
+      cell = next(cell, state_[cell]);
+    }
+    // the loop-erased path is what the remembered ways lead along
+    for (int cell = start; state_[cell] != kInMaze;) {
+      const std::uint8_t way = state_[cell];
+      const int to = next(cell, way);
+      const int r = cell / cols, c = cell % cols;
+      switch (way) {
+        case kRight:
+          maze.cells[r][c].rightWall = false;
+          break;
+        case kLeft:
+          maze.cells[r][c - 1].rightWall = false;
+          break;
+        case kDown:
+          maze.cells[r][c].bottomWall = false;
+          break;
+        default:
+          maze.cells[r - 1][c].bottomWall = false;
+          break;
+      }
+      state_[cell] = kInMaze;
+      cell = to;
+    }
+  }
+
+  // rows are only final once every walk is done
+  for (int row = 0; row < rows; ++row) {
+    if (rowDone && !rowDone(row)) {
+      maze.isGenerated = false;
+      return;
+    }
+  }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "src/core/mazeGenerator.h"
+
+// Wilson's algorithm: loop-erased random walks from every cell not yet in
+// the maze until they hit it, which draws each spanning tree with the
+// same probability (no bias toward long corridors or short dead ends).
+// A walk only remembers the last direction taken out of each cell, so
+// loops erase themselves as the walk overwrites them; the maze is then
+// carved by following those directions from the walk's start. One byte
+// per cell, kept across mazes.
+class WilsonGenerator : public MazeGenerator {
+ public:
+  void generate(MazeData& maze, int rows, int cols,
+                const RowDone& rowDone = {}) override;
+
+ private:
+  // per cell: kInMaze once carved, else the last direction out, 0-3
+  std::vector<std::uint8_t> state_;
+};
@@ -1,28 +1,47 @@
 #include "maze.h"
+#include "src/lib/service/cache/gridPool.h"
+#include "src/lib/service/cache/mazeCache.h"
 #include "src/lib/service/generator/generator.h"
+#include "src/lib/service/metrics/metrics.h"
+
+#include <QElapsedTimer>
+#include <utility>
 
 MazeModel::MazeModel(QObject *parent)
     : QAbstractListModel(parent)
-{}
+    , maze_(std::make_shared<MazeData>())
+{
+    // edits landing in the same frame go out as one batch
+    flushTimer_.setSingleShot(true);
+    flushTimer_.setInterval(kBatchIntervalMs);
+    connect(&flushTimer_, &QTimer::timeout, this, &MazeModel::flushChanges);
+}
+
+MazeModel::~MazeModel()
+{
+    // the worker posts batches to this object, it must not outlive it
+    cancelGeneration();
+    generationTask_.waitForFinished();
+}
 
 int MazeModel::rowCount(const QModelIndex &) const
 {
-    return maze_.rows * maze_.cols;
+    return generatedRows_ * maze_->cols;
 }
 
 QVariant MazeModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || !maze_.isGenerated)
+    if (!index.isValid() || maze_->cols == 0)
         return {};
 
     int flatIndex = index.row();
-    int r = flatIndex / maze_.cols;
-    int c = flatIndex % maze_.cols;
+    int r = flatIndex / maze_->cols;
+    int c = flatIndex % maze_->cols;
 
-    if (r >= maze_.rows || c >= maze_.cols)
+    if (r >= generatedRows_ || c >= maze_->cols)
         return {};
 
-    const auto &cell = maze_.cells[r][c];
+    const auto &cell = maze_->cells[r][c];
 
     switch (role) {
     case RightWallRole:
@@ -38,30 +57,371 @@ QHash<int, QByteArray> MazeModel::roleNames() const
     return {{RightWallRole, "rightWall"}, {BottomWallRole, "bottomWall"}};
 }
 
-int MazeModel::rows() const { return maze_.rows; }
-int MazeModel::cols() const { return maze_.cols; }
-bool MazeModel::isGenerated() const { return maze_.isGenerated; }
+int MazeModel::rows() const { return maze_->rows; }
+int MazeModel::cols() const { return maze_->cols; }
+bool MazeModel::isGenerated() const { return maze_->isGenerated; }
+bool MazeModel::generating() const { return generating_; }
+int MazeModel::generatedRows() const { return generatedRows_; }
 
-void MazeModel::generate(int rows, int cols)
+qint64 MazeModel::seed() const { return seed_; }
+
+QString MazeModel::algorithm() const { return algorithm_; }
+
+QStringList MazeModel::algorithms() { return Generator::algorithmNames(); }
+
+QByteArray MazeModel::wallBits(int row, int col, int rows, int cols) const
 {
-    beginResetModel();
-    Generator gen;
-    gen.generate(maze_, rows, cols);
-    endResetModel();
+    int rowEnd = std::min(generatedRows_, row + rows);
+    int colEnd = std::min(maze_->cols, col + cols);
+    row = std::max(row, 0);
+    col = std::max(col, 0);
+    if (row >= rowEnd || col >= colEnd)
+        return {};
+
+    int width = colEnd - col;
+    QByteArray bits((rowEnd - row) * width, Qt::Uninitialized);
+    char *out = bits.data();
+    for (int r = row; r < rowEnd; ++r) {
+        const auto &cells = maze_->cells[r];
+        for (int c = col; c < colEnd; ++c) {
+            *out++ = static_cast<char>(
+                (cells[c].rightWall ? kRightWallBit : 0)
+                | (cells[c].bottomWall ? kBottomWallBit : 0));
+        }
+    }
+    return bits;
+}
+
+bool MazeModel::wall(int row, int col, Wall wall) const
+{
+    if (row < 0 || row >= generatedRows_ || col < 0 || col >= maze_->cols)
+        return false;
+
+    const auto &cell = maze_->cells[row][col];
+    return wall == RightWall ? cell.rightWall : cell.bottomWall;
+}
+
+bool MazeModel::setWall(int row, int col, Wall wall, bool present)
+{
+    if (!editable() || row < 0 || row >= maze_->rows || col < 0
+        || col >= maze_->cols)
+        return false;
+    // the outer frame stays closed
+    if ((wall == RightWall && col == maze_->cols - 1)
+        || (wall == BottomWall && row == maze_->rows - 1))
+        return false;
+
+    const auto &cell = maze_->cells[row][col];
+    if ((wall == RightWall ? cell.rightWall : cell.bottomWall) == present)
+        return false;
+
+    emit wallsAboutToChange();
+    auto &edited = writableMaze().cells[row][col];
+    (wall == RightWall ? edited.rightWall : edited.bottomWall) = present;
+    markDirty(QRect(col, row, 1, 1), wall == RightWall ? 0x1 : 0x2);
+    emit wallEdited(row, col, wall, present);
+    return true;
+}
+
+bool MazeModel::toggleWall(int row, int col, Wall wall)
+{
+    return setWall(row, col, wall, !this->wall(row, col, wall));
+}
+
+bool MazeModel::setRegion(int row,
+                          int col,
+                          const std::vector<std::vector<MazeCell>> &cells)
+{
+    if (!editable() || cells.empty() || row < 0 || col < 0)
+        return false;
+
+    int rowEnd = std::min(maze_->rows, row + static_cast<int>(cells.size()));
+    int colEnd = std::min(maze_->cols,
+                          col + static_cast<int>(cells.front().size()));
+    if (row >= rowEnd || col >= colEnd)
+        return false;
+
+    emit wallsAboutToChange();
+    MazeData &maze = writableMaze();
+    for (int r = row; r < rowEnd; ++r) {
+        const auto &src = cells[r - row];
+        int srcEnd = std::min(colEnd, col + static_cast<int>(src.size()));
+        for (int c = col; c < srcEnd; ++c) {
+            auto &cell = maze.cells[r][c];
+            cell.rightWall = c == maze.cols - 1 || src[c - col].rightWall;
+            cell.bottomWall = r == maze.rows - 1 || src[c - col].bottomWall;
+        }
+    }
+    QRect rect(col, row, colEnd - col, rowEnd - row);
+    markDirty(rect, 0x3);
+    emit regionEdited(rect);
+    return true;
+}
+
+bool MazeModel::editable() const
+{
+    return maze_->isGenerated && !generating_;
+}
+
+MazeData &MazeModel::writableMaze()
+{
+    // only this thread hands out references, a unique maze stays unique
+    if (maze_.use_count() > 1)
+        maze_ = std::make_shared<MazeData>(GridPool::instance().copy(*maze_));
+    return *maze_;
+}
+
+void MazeModel::replaceMaze(std::shared_ptr<MazeData> maze)
+{
+    if (maze_.use_count() == 1)
+        GridPool::instance().release(std::move(*maze_));
+    maze_ = std::move(maze);
+}
+
+void MazeModel::markDirty(const QRect &cells, int roleMask)
+{
+    // blocks merge only when their bounding box adds no untouched cells,
+    // so distant edits stay apart
+    auto area = [](const QRect &r) { return qint64(r.width()) * r.height(); };
+    QRect block = cells;
+    for (qsizetype i = 0; i < dirtyCells_.size();) {
+        QRect merged = block.united(dirtyCells_[i]);
+        if (area(merged) > area(block) + area(dirtyCells_[i])) {
+            ++i;
+            continue;
+        }
+        block = merged;
+        dirtyCells_.removeAt(i);
+        i = 0; // the larger block may now join others
+    }
+
+    // too many scattered edits: join the block that grows least
+    if (dirtyCells_.size() == kMaxDirtyBlocks) {
+        auto growth = [&](const QRect &r) {
+            return area(block.united(r)) - area(r);
+        };
+        qsizetype best = 0;
+        for (qsizetype i = 1; i < dirtyCells_.size(); ++i) {
+            if (growth(dirtyCells_[i]) < growth(dirtyCells_[best]))
+                best = i;
+        }
+        block = block.united(dirtyCells_.takeAt(best));
+    }
+    dirtyCells_.append(block);
+
+    dirtyRoles_ |= roleMask;
+    if (!flushTimer_.isActive())
+        flushTimer_.start();
+}
+
+void MazeModel::flushChanges()
+{
+    flushTimer_.stop();
+    if (dirtyCells_.isEmpty())
+        return;
+
+    QList<int> roles;
+    if (dirtyRoles_ & 0x1)
+        roles << RightWallRole;
+    if (dirtyRoles_ & 0x2)
+        roles << BottomWallRole;
+
+    QList<QRect> blocks = std::move(dirtyCells_);
+    dropChanges();
+
+    // flat indices are contiguous only across full-width rows
+    int cols = maze_->cols;
+    for (const QRect &cells : std::as_const(blocks)) {
+        if (cells.width() == cols) {
+            emit dataChanged(index(cells.top() * cols),
+                             index(cells.bottom() * cols + cols - 1),
+                             roles);
+        } else {
+            for (int r = cells.top(); r <= cells.bottom(); ++r) {
+                emit dataChanged(index(r * cols + cells.left()),
+                                 index(r * cols + cells.right()),
+                                 roles);
+            }
+        }
+    }
+    for (const QRect &cells : std::as_const(blocks))
+        emit wallsChanged(cells);
+}
+
+void MazeModel::dropChanges()
+{
+    flushTimer_.stop();
+    dirtyCells_.clear();
+    dirtyRoles_ = 0;
+}
+
+void MazeModel::generate(int rows,
+                         int cols,
+                         qint64 seed,
+                         const QString& algorithm)
+{
+    cancelGeneration();
+    dropChanges();
+
+    if (rows <= 0 || cols <= 0 || rows > kMaxSide || cols > kMaxSide) {
+        clear();
+        return;
+    }
+
+    quint32 mazeSeed = seed >= 0 ? quint32(seed)
+                                 : QRandomGenerator::global()->generate();
+    MazeAlgorithm mazeAlgorithm = MazeGenerator::parse(algorithm.toStdString())
+                                      .value_or(MazeAlgorithm::Eller);
+    algorithm_ = QString::fromLatin1(MazeGenerator::name(mazeAlgorithm));
+    if (auto cached = MazeCache::instance().findMaze(rows, cols, mazeSeed,
+                                                     algorithm_)) {
+        // shared with the cache, the first edit copies it; cached mazes
+        // are never created const
+        resetMaze(std::const_pointer_cast<MazeData>(cached), mazeSeed);
+        emit generationFinished();
+        return;
+    }
+
+    // full-size grid of walls up front, so views can lay out immediately
+    {
+        MAZE_SCOPED_TIMER(ModelReset);
+        MAZE_COUNT(ModelResets, 1);
+        beginResetModel();
+        // a snapshot still being read keeps the old maze
+        if (maze_.use_count() > 1)
+            maze_ = std::make_shared<MazeData>();
+        resetGrid(*maze_, rows, cols, {true, true});
+        generatedRows_ = 0;
+        seed_ = mazeSeed;
+        endResetModel();
+    }
+    setGenerating(true);
     emit mazeChanged();
+
+    int token = generationToken_;
+    CancellationToken cancel = generationCancel_ = CancellationToken();
+
+    auto generateRows = [this, rows, cols, mazeSeed, mazeAlgorithm, token,
+                         cancel]() {
+        Generator gen(mazeAlgorithm);
+        gen.setSeed(mazeSeed);
+        MazeData maze;
+        QElapsedTimer sinceFlush;
+        sinceFlush.start();
+        int firstPending = 0;
+
+        gen.generate(maze, rows, cols, [&](int row) {
+            if (cancel.isCancelled())
+                return false;
+
+            // first row goes out at once, then batches per frame interval
+            bool lastRow = row == rows - 1;
+            if (row > 0 && !lastRow && sinceFlush.elapsed() < kBatchIntervalMs)
+                return true;
+
+            // finished rows are never touched again, hand them over
+            std::vector<std::vector<MazeCell>> batch(
+                std::make_move_iterator(maze.cells.begin() + firstPending),
+                std::make_move_iterator(maze.cells.begin() + row + 1));
+            int firstRow = firstPending;
+            firstPending = row + 1;
+            sinceFlush.restart();
+
+            QMetaObject::invokeMethod(
+                this,
+                [this, token, firstRow, batch = std::move(batch)]() mutable {
+                    appendRows(token, firstRow, std::move(batch));
+                },
+                Qt::QueuedConnection);
+            return true;
+        });
+    };
+    generationTask_ = TaskScheduler::instance().run(
+        TaskScheduler::Priority::Batch, generateRows, cancel);
+}
+
+void MazeModel::appendRows(int token,
+                           int firstRow,
+                           std::vector<std::vector<MazeCell>> rows)
+{
+    if (token != generationToken_)
+        return; // superseded or cancelled
+
+    int endRow = firstRow + static_cast<int>(rows.size());
+
+    MAZE_COUNT(ModelRowsInserted, endRow - firstRow);
+    beginInsertRows({}, firstRow * maze_->cols, endRow * maze_->cols - 1);
+    // rows no snapshot reads yet, so written in place
+    std::move(rows.begin(), rows.end(), maze_->cells.begin() + firstRow);
+    generatedRows_ = endRow;
+    endInsertRows();
+    emit rowsGenerated(firstRow, endRow);
+
+    if (endRow == maze_->rows) {
+        maze_->isGenerated = true;
+        // shared, not copied; the first edit copies it for the model
+        MazeCache::instance().insertMaze(maze_->rows, maze_->cols,
+                                         quint32(seed_), algorithm_, maze_);
+        setGenerating(false);
+        emit mazeChanged();
+        emit generationFinished();
+    }
+}
+
+void MazeModel::cancelGeneration()
+{
+    generationCancel_.cancel();
+    ++generationToken_;
+    setGenerating(false);
+}
+
+void MazeModel::setGenerating(bool generating)
+{
+    if (generating_ == generating)
+        return;
+    generating_ = generating;
+    emit generatingChanged();
 }
 
 void MazeModel::setMazeData(MazeData&& data) {
+    cancelGeneration();
+    resetMaze(std::make_shared<MazeData>(std::move(data)), -1);
+}
+
+void MazeModel::resetMaze(std::shared_ptr<MazeData> maze, qint64 seed)
+{
+    seed_ = seed;
+    if (seed < 0)
+        algorithm_.clear();
+
+    if (editable() && maze->rows == maze_->rows && maze->cols == maze_->cols) {
+        emit wallsAboutToChange();
+        replaceMaze(std::move(maze));
+        markDirty(QRect(0, 0, maze_->cols, maze_->rows), 0x3);
+        flushChanges();
+        emit mazeChanged();
+        return;
+    }
+
+    dropChanges();
+    MAZE_SCOPED_TIMER(ModelReset);
+    MAZE_COUNT(ModelResets, 1);
     beginResetModel();
-    maze_ = std::move(data);
+    replaceMaze(std::move(maze));
+    generatedRows_ = maze_->rows;
     endResetModel();
     emit mazeChanged();
 }
 
 void MazeModel::clear()
 {
+    cancelGeneration();
+    dropChanges();
     beginResetModel();
-    maze_ = {};
+    replaceMaze(std::make_shared<MazeData>());
+    generatedRows_ = 0;
+    seed_ = -1;
+    algorithm_.clear();
     endResetModel();
     emit mazeChanged();
 }
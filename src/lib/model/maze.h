@@ -1,19 +1,16 @@
 #pragma once
 
 #include <QAbstractListModel>
+#include <QByteArray>
+#include <QFuture>
+#include <QList>
+#include <QRect>
+#include <QTimer>
+#include <memory>
+#include <vector>
 
-struct MazeCell {
-  bool rightWall;
-  bool bottomWall;
-};
-
-struct MazeData {
-  int rows{0};
-  int cols{0};
-  bool isGenerated{false};
-
-  std::vector<std::vector<MazeCell>> cells;
-};
+#include "src/core/mazeData.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
 
 class MazeModel : public QAbstractListModel {
   Q_OBJECT
@@ -21,12 +18,36 @@ class MazeModel : public QAbstractListModel {
   Q_PROPERTY(int rows READ rows NOTIFY mazeChanged)
   Q_PROPERTY(int cols READ cols NOTIFY mazeChanged)
   Q_PROPERTY(bool isGenerated READ isGenerated NOTIFY mazeChanged)
+  Q_PROPERTY(bool generating READ generating NOTIFY generatingChanged)
+  Q_PROPERTY(int generatedRows READ generatedRows NOTIFY rowsGenerated)
+  Q_PROPERTY(qint64 seed READ seed NOTIFY mazeChanged)
+  Q_PROPERTY(QString algorithm READ algorithm NOTIFY mazeChanged)
+  Q_PROPERTY(QStringList algorithms READ algorithms CONSTANT)
+  Q_PROPERTY(int maxSide READ maxSide CONSTANT)
 
  public:
   enum Roles { RightWallRole = Qt::UserRole + 1, BottomWallRole };
+  enum Wall { RightWall, BottomWall };
+  Q_ENUM(Wall)
+
+  // generated rows and wall edits are handed to views at most this often
+  static constexpr int kBatchIntervalMs = 16;
+  // disjoint blocks of edited cells kept per batch before they are merged
+  static constexpr int kMaxDirtyBlocks = 32;
+  // largest side generate() accepts, as for MazeServer and TiledArchive
+  static constexpr int kMaxSide = 65536;
+  // per-cell bits returned by wallBits()
+  static constexpr quint8 kRightWallBit = 0x1;
+  static constexpr quint8 kBottomWallBit = 0x2;
 
   explicit MazeModel(QObject* parent = nullptr);
-  const MazeData& mazeData() const { return maze_; }
+  ~MazeModel() override;
+  // read in place on this thread; valid until the next edit or new maze
+  const MazeData& mazeData() const { return *maze_; }
+  // the current maze for workers, never written while they hold it: edits
+  // copy it first and leave the snapshot as it was. Rows past
+  // generatedRows() are still being filled in
+  std::shared_ptr<const MazeData> snapshot() const { return maze_; }
   int rowCount(const QModelIndex& = QModelIndex()) const override;
   QVariant data(const QModelIndex& index, int role) const override;
   QHash<int, QByteArray> roleNames() const override;
@@ -34,14 +55,78 @@ class MazeModel : public QAbstractListModel {
   int rows() const;
   int cols() const;
   bool isGenerated() const;
+  bool generating() const;
+  int generatedRows() const;
+  // of the generated maze, -1 when it was loaded
+  qint64 seed() const;
+  // of the generated maze, empty when it was loaded
+  QString algorithm() const;
+  // what generate() accepts, the default first
+  static QStringList algorithms();
+  static int maxSide() { return kMaxSide; }
 
+  // one byte per cell (kRightWallBit | kBottomWallBit), row-major,
+  // clipped to the maze; lets views copy a whole tile in one call
+  QByteArray wallBits(int row, int col, int rows, int cols) const;
+
+  Q_INVOKABLE bool wall(int row, int col, Wall wall) const;
+  // border walls can't be edited; false if rejected or unchanged
+  Q_INVOKABLE bool setWall(int row, int col, Wall wall, bool present);
+  Q_INVOKABLE bool toggleWall(int row, int col, Wall wall);
+  // overwrites the block of cells starting at (row, col), border walls kept
+  bool setRegion(int row, int col,
+                 const std::vector<std::vector<MazeCell>>& cells);
+
+  // same-sized data is swapped in place with dataChanged, no reset
   void setMazeData(MazeData&& data);
-  Q_INVOKABLE void generate(int rows, int cols);
+  // asynchronous: rows stream in via rowsInserted, a new call or clear()
+  // cancels the generation in flight; a side outside 1..kMaxSide clears
+  // the maze, a negative seed picks one at random, an unknown algorithm
+  // falls back to the default. A maze found in MazeCache is set at once,
+  // finished ones are added
+  Q_INVOKABLE void generate(int rows, int cols, qint64 seed = -1,
+                            const QString& algorithm = QString());
   Q_INVOKABLE void clear();
 
  signals:
   void mazeChanged();
+  void generatingChanged();
+  void rowsGenerated(int firstRow, int endRow);
+  void generationFinished();
+  // before any cell is written in place, for readers on other threads
+  void wallsAboutToChange();
+  // a block of cells touched since the last batch (x = col, y = row), after
+  // dataChanged; once per disjoint block
+  void wallsChanged(const QRect& cells);
+  // emitted right away, for consumers that repair state per edit
+  void wallEdited(int row, int col, MazeModel::Wall wall, bool present);
+  void regionEdited(const QRect& cells);
 
  private:
-  MazeData maze_;
+  void appendRows(int token, int firstRow,
+                  std::vector<std::vector<MazeCell>> rows);
+  void cancelGeneration();
+  void resetMaze(std::shared_ptr<MazeData> maze, qint64 seed);
+  void setGenerating(bool generating);
+  bool editable() const;
+  // maze_ for writing, copied first if a snapshot or MazeCache shares it
+  MazeData& writableMaze();
+  // puts maze in place of maze_, recycling the old grid if nobody shares it
+  void replaceMaze(std::shared_ptr<MazeData> maze);
+  void markDirty(const QRect& cells, int roleMask);
+  void flushChanges();
+  void dropChanges();
+
+  std::shared_ptr<MazeData> maze_;
+  int generatedRows_{0};
+  qint64 seed_{-1};
+  QString algorithm_;
+  bool generating_{false};
+  int generationToken_{0};
+  CancellationToken generationCancel_;
+  QFuture<void> generationTask_;
+
+  QTimer flushTimer_;
+  QList<QRect> dirtyCells_;  // disjoint
+  int dirtyRoles_{0};  // bit 0 right walls, bit 1 bottom walls
 };
@@ -0,0 +1,99 @@
+#include "agentTrainer.h"
+
+#include <QFutureWatcher>
+#include <QRandomGenerator>
+#include <memory>
+
+#include "src/lib/model/maze.h"
+
+AgentTrainer::AgentTrainer(QObject* parent) : QObject(parent) {}
+
+void AgentTrainer::setMazeData(const MazeData* maze) {
+  cancel();
+  maze_ = maze;
+  model_ = nullptr;
+}
+
+void AgentTrainer::setMazeModel(const MazeModel* model) {
+  cancel();
+  maze_ = nullptr;
+  model_ = model;
+}
+
+void AgentTrainer::train(int startRow, int startCol, int endRow, int endCol,
+                         int episodes, qint64 seed) {
+  cancel();
+  route_.clear();
+  report_.clear();
+  emit routeChanged();
+  const MazeData* current = model_ ? &model_->mazeData() : maze_;
+  if (!current || !current->isGenerated) return;
+
+  QLearningOptions options;
+  options.episodes = episodes;
+  options.seed =
+      seed >= 0 ? quint64(seed) : QRandomGenerator::global()->generate64();
+  goal_ = QPoint(endRow, endCol);
+
+  int token = trainToken_;
+  auto* watcher = new QFutureWatcher<Result>(this);
+  connect(watcher, &QFutureWatcher<Result>::finished, this,
+          [this, watcher, token]() {
+            watcher->deleteLater();
+            if (token != trainToken_) return;  // superseded meanwhile
+            Result result = watcher->result();
+            route_ = std::move(result.route);
+            report_ = result.report.toJson().toVariantMap();
+            setTraining(false);
+            emit routeChanged();
+          });
+
+  // the worker gets a snapshot, edits don't have to wait for it
+  std::shared_ptr<const MazeData> maze =
+      model_ ? model_->snapshot() : std::make_shared<const MazeData>(*maze_);
+  setTraining(true);
+  watcher->setFuture(TaskScheduler::instance().run(
+      TaskScheduler::Priority::Batch,
+      [maze, start = QPoint(startRow, startCol), goal = goal_, options,
+       cancel = trainCancel_]() {
+        QLearner learner(*maze, goal);
+        Result result;
+        result.report = learner.train(start, options, cancel);
+        result.route = learner.greedyRoute(start);
+        return result;
+      },
+      trainCancel_));
+}
+
+void AgentTrainer::cancel() {
+  ++trainToken_;
+  trainCancel_.cancel();
+  trainCancel_ = CancellationToken();
+  setTraining(false);
+}
+
+void AgentTrainer::clear() {
+  cancel();
+  if (route_.empty() && report_.isEmpty()) return;
+  route_.clear();
+  report_.clear();
+  emit routeChanged();
+}
+
+QVariantList AgentTrainer::route() const {
+  QVariantList result;
+  for (const auto& p : route_) {
+    result.append(QVariantMap{{"row", p.x()}, {"col", p.y()}});
+  }
+  return result;
+}
+
+bool AgentTrainer::reachedGoal() const {
+  return !route_.empty() && route_.back() == goal_;
+}
+
+void AgentTrainer::setTraining(bool training) {
+  if (training_ == training) return;
+  training_ = training;
+  emit trainingChanged();
+}
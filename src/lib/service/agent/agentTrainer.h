@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QObject>
+#include <QPoint>
+#include <QVariantMap>
+#include <vector>
+
+#include "src/lib/service/agent/qLearner.h"
+
+struct MazeData;
+class MazeModel;
+
+// Trains a QLearner on the current maze for QML and keeps its route.
+//
+// train() learns on a snapshot of the maze (a copy of a bare one) in a
+// Batch task, so the maze can be edited meanwhile; the route arrives with
+// routeChanged. Edits and a new maze make the route stale, the owner calls
+// clear() then.
+class AgentTrainer : public QObject {
+  Q_OBJECT
+
+  Q_PROPERTY(bool training READ training NOTIFY trainingChanged)
+  Q_PROPERTY(QVariantList route READ route NOTIFY routeChanged)
+  Q_PROPERTY(int routeLength READ routeLength NOTIFY routeChanged)
+  Q_PROPERTY(bool reachedGoal READ reachedGoal NOTIFY routeChanged)
+  // QLearningReport::toJson of the last training
+  Q_PROPERTY(QVariantMap report READ report NOTIFY routeChanged)
+
+ public:
+  explicit AgentTrainer(QObject* parent = nullptr);
+
+  // a negative seed picks one
+  Q_INVOKABLE void train(int startRow, int startCol, int endRow, int endCol,
+                         int episodes = 20000, qint64 seed = -1);
+  Q_INVOKABLE void cancel();
+  Q_INVOKABLE void clear();
+
+  bool training() const { return training_; }
+  QVariantList route() const;
+  int routeLength() const { return int(route_.size()); }
+  bool reachedGoal() const;
+  QVariantMap report() const { return report_; }
+
+  // packed {row, col} points for native views, no QVariant conversion
+  const std::vector<QPoint>& currentRoute() const { return route_; }
+
+  void setMazeData(const MazeData* maze);
+  // follows the model's maze through its edits, see MazeModel::snapshot
+  void setMazeModel(const MazeModel* model);
+
+ signals:
+  void trainingChanged();
+  void routeChanged();
+
+ private:
+  struct Result {
+    std::vector<QPoint> route;
+    QLearningReport report;
+  };
+
+  void setTraining(bool training);
+
+  const MazeData* maze_ = nullptr;
+  const MazeModel* model_ = nullptr;  // instead of maze_
+  std::vector<QPoint> route_;
+  QPoint goal_{-1, -1};
+  QVariantMap report_;
+  bool training_ = false;
+  // results of older trainings are dropped
+  int trainToken_ = 0;
+  CancellationToken trainCancel_;
+};
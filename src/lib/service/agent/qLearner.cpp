@@ -0,0 +1,248 @@
+#include "qLearner.h"
+
+#include <QJsonArray>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/metrics/metrics.h"
+#include "src/lib/service/solver/solver.h"
+
+namespace {
+const std::array<QPoint, QTable::kActions> kDirections = {
+    QPoint(0, 1),   // right
+    QPoint(0, -1),  // left
+    QPoint(1, 0),   // down
+    QPoint(-1, 0)   // up
+};
+
+constexpr float kMoveReward = -1.0f;
+
+// splitmix64, one stream per episode so the schedule of the workers
+// doesn't change what an episode explores
+class EpisodeRandom {
+ public:
+  explicit EpisodeRandom(quint64 seed) : state_(seed) {}
+
+  quint64 next() {
+    quint64 z = (state_ += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+  // in [0, 1)
+  float uniform() { return float(next() >> 40) * 0x1.0p-24f; }
+  // in [0, bound)
+  int bounded(int bound) {
+    return int((quint64(quint32(next() >> 32)) * quint64(bound)) >> 32);
+  }
+
+ private:
+  quint64 state_;
+};
+
+// the n-th set bit of open
+int nthOpen(quint8 open, int n) {
+  for (; n > 0; --n) open &= open - 1;
+  return std::countr_zero(unsigned(open));
+}
+}  // namespace
+
+QTable::QTable(int cells)
+    : cells_(cells),
+      values_(std::make_unique<std::atomic<float>[]>(size_t(cells) *
+                                                      kActions)) {}
+
+int QTable::bestAction(int cell, quint8 open) const {
+  int best = -1;
+  float bestValue = -std::numeric_limits<float>::infinity();
+  for (int action = 0; action < kActions; ++action) {
+    if (!(open & (1u << action))) continue;
+    float q = value(action, cell);
+    if (q > bestValue) {
+      best = action;
+      bestValue = q;
+    }
+  }
+  return best;
+}
+
+float QTable::bestValue(int cell, quint8 open) const {
+  int action = bestAction(cell, open);
+  return action >= 0 ? value(action, cell) : 0.0f;
+}
+
+QJsonObject QLearningReport::toJson() const {
+  QJsonArray curve;
+  for (float mean : meanSteps) curve.append(double(mean));
+  return {{"episodes", episodes},
+          {"steps", steps},
+          {"successes", successes},
+          {"elapsedMs", double(elapsedNs) / 1e6},
+          {"stepsPerSecond", stepsPerSecond()},
+          {"convergedAt", convergedAt},
+          {"greedyLength", greedyLength},
+          {"shortestLength", shortestLength},
+          {"meanSteps", curve}};
+}
+
+QLearner::QLearner(const MazeData& maze, QPoint goal)
+    : rows_(maze.isGenerated ? maze.rows : 0),
+      cols_(maze.isGenerated ? maze.cols : 0),
+      goal_(goal),
+      table_(rows_ * cols_) {
+  open_.resize(size_t(rows_) * cols_);
+  for (int r = 0; r < rows_; ++r) {
+    for (int c = 0; c < cols_; ++c) {
+      quint8 open = 0;
+      for (int action = 0; action < QTable::kActions; ++action) {
+        QPoint to = QPoint(r, c) + kDirections[action];
+        if (Solver::canMove(maze, {r, c}, to)) {
+          open |= quint8(1u << action);
+        }
+      }
+      open_[r * cols_ + c] = open;
+    }
+  }
+}
+
+int QLearner::runEpisode(int start, qint64 episode,
+                         const QLearningOptions& options, float epsilon,
+                         int maxSteps, bool* reached) {
+  EpisodeRandom random(options.seed ^
+                       (quint64(episode) * 0xd1b54a32d192ed03ull));
+  const int goal = goal_.x() * cols_ + goal_.y();
+  const std::array<int, QTable::kActions> offsets = {1, -1, cols_, -cols_};
+
+  int cell = start;
+  if (options.randomStarts) cell = random.bounded(int(open_.size()));
+  int steps = 0;
+  while (cell != goal && steps < maxSteps) {
+    quint8 open = open_[cell];
+    if (!open) break;  // a walled-in cell
+    int action = random.uniform() < epsilon
+                     ? nthOpen(open, random.bounded(std::popcount(open)))
+                     : table_.bestAction(cell, open);
+    int next = cell + offsets[action];
+    float target = kMoveReward;
+    if (next != goal) {
+      target += options.gamma * table_.bestValue(next, open_[next]);
+    }
+    float q = table_.value(action, cell);
+    table_.setValue(action, cell, q + options.alpha * (target - q));
+    cell = next;
+    ++steps;
+  }
+  *reached = cell == goal;
+  return steps;
+}
+
+QLearningReport QLearner::train(QPoint start, const QLearningOptions& options,
+                                const CancellationToken& cancel) {
+  QLearningReport report;
+  auto inside = [&](QPoint p) {
+    return p.x() >= 0 && p.x() < rows_ && p.y() >= 0 && p.y() < cols_;
+  };
+  if (!inside(start) || !inside(goal_)) return report;
+
+  report.shortestLength = shortestLength(start);
+
+  const int maxSteps =
+      options.maxSteps > 0 ? options.maxSteps : 4 * int(open_.size());
+  const int startCell = start.x() * cols_ + start.y();
+  std::vector<int> batchSteps(kBatchEpisodes);
+  std::vector<char> batchReached(kBatchEpisodes);
+  qint64 startNs = Metrics::nowNs();
+
+  while (report.episodes < options.episodes && !cancel.isCancelled()) {
+    const qint64 first = report.episodes;
+    const qint64 count = std::min(kBatchEpisodes, options.episodes - first);
+    auto body = [&](qsizetype i) {
+      qint64 episode = first + i;
+      float progress = float(episode) / float(options.episodes);
+      float epsilon = options.epsilonStart +
+                      (options.epsilonEnd - options.epsilonStart) * progress;
+      bool reached = false;
+      batchSteps[i] =
+          runEpisode(startCell, episode, options, epsilon, maxSteps, &reached);
+      batchReached[i] = reached;
+    };
+    if (options.parallel) {
+      TaskScheduler::instance().parallelFor(count, body);
+    } else {
+      for (qsizetype i = 0; i < count; ++i) body(i);
+    }
+
+    qint64 steps = 0;
+    for (qint64 i = 0; i < count; ++i) {
+      steps += batchSteps[i];
+      report.successes += batchReached[i];
+    }
+    MAZE_COUNT(AgentSteps, steps);
+    MAZE_COUNT(AgentEpisodes, count);
+    report.steps += steps;
+    report.episodes += count;
+    report.meanSteps.push_back(float(steps) / float(count));
+
+    if (report.convergedAt < 0) {
+      std::vector<QPoint> route = greedyRoute(start);
+      if (!route.empty() && route.back() == goal_ &&
+          int(route.size()) == report.shortestLength) {
+        report.convergedAt = report.episodes;
+        if (options.stopWhenConverged) break;
+      }
+    }
+  }
+  report.elapsedNs = Metrics::nowNs() - startNs;
+
+  std::vector<QPoint> route = greedyRoute(start);
+  if (!route.empty() && route.back() == goal_) {
+    report.greedyLength = int(route.size());
+  }
+  return report;
+}
+
+int QLearner::shortestLength(QPoint start) const {
+  // bfs over the open masks, the same moves the episodes make
+  const int goal = goal_.x() * cols_ + goal_.y();
+  const std::array<int, QTable::kActions> offsets = {1, -1, cols_, -cols_};
+  std::vector<int> distance(open_.size(), -1);
+  std::vector<int> queue;
+  queue.reserve(open_.size());
+  queue.push_back(start.x() * cols_ + start.y());
+  distance[queue.front()] = 1;
+  for (size_t head = 0; head < queue.size(); ++head) {
+    int cell = queue[head];
+    if (cell == goal) return distance[cell];
+    for (int action = 0; action < QTable::kActions; ++action) {
+      int next = cell + offsets[action];
+      if (!(open_[cell] & (1u << action)) || distance[next] >= 0) continue;
+      distance[next] = distance[cell] + 1;
+      queue.push_back(next);
+    }
+  }
+  return 0;
+}
+
+std::vector<QPoint> QLearner::greedyRoute(QPoint start) const {
+  std::vector<QPoint> route;
+  if (start.x() < 0 || start.x() >= rows_ || start.y() < 0 ||
+      start.y() >= cols_) {
+    return route;
+  }
+  std::vector<char> visited(open_.size(), 0);
+  QPoint at = start;
+  while (true) {
+    int cell = at.x() * cols_ + at.y();
+    if (visited[cell]) break;  // a loop, the values aren't settled
+    visited[cell] = 1;
+    route.push_back(at);
+    if (at == goal_) break;
+    int action = table_.bestAction(cell, open_[cell]);
+    if (action < 0) break;
+    at += kDirections[action];
+  }
+  return route;
+}
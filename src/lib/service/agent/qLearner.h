@@ -0,0 +1,115 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QPoint>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "src/lib/service/scheduler/taskScheduler.h"
+
+struct MazeData;
+
+// Action values of every cell, one float per cell and direction.
+//
+// Struct-of-arrays: all cells of the first action, then all of the second,
+// and so on, so a sweep over one action reads one contiguous array.
+// Values are relaxed atomics: episodes running in parallel read and write
+// without locks, a racing update may be lost but never torn (Hogwild).
+class QTable {
+ public:
+  // same order as the solver: right, left, down, up
+  static constexpr int kActions = 4;
+
+  explicit QTable(int cells = 0);
+
+  int cells() const { return cells_; }
+
+  float value(int action, int cell) const {
+    return values_[size_t(action) * cells_ + cell].load(
+        std::memory_order_relaxed);
+  }
+  void setValue(int action, int cell, float value) {
+    values_[size_t(action) * cells_ + cell].store(value,
+                                                  std::memory_order_relaxed);
+  }
+
+  // among the actions whose bit is set in open, the first on ties;
+  // -1 without any
+  int bestAction(int cell, quint8 open) const;
+  float bestValue(int cell, quint8 open) const;
+
+ private:
+  int cells_{0};
+  std::unique_ptr<std::atomic<float>[]> values_;
+};
+
+struct QLearningOptions {
+  float alpha{0.5f};  // learning rate
+  float gamma{0.99f};
+  // exploration falls linearly from start to end over the episodes
+  float epsilonStart{1.0f};
+  float epsilonEnd{0.05f};
+  qint64 episodes{20000};
+  int maxSteps{0};  // per episode, 0 for 4 * cells
+  quint64 seed{1};
+  // episodes of a batch run on the scheduler; off, they run in order on
+  // the calling thread and the same seed gives the same table
+  bool parallel{true};
+  // episodes begin at random cells rather than at the start, which
+  // spreads the values from the goal over the maze much sooner
+  bool randomStarts{true};
+  // stop after the first batch whose greedy route is a shortest path
+  bool stopWhenConverged{true};
+};
+
+struct QLearningReport {
+  qint64 episodes{0};
+  qint64 steps{0};
+  qint64 successes{0};  // episodes that reached the goal
+  qint64 elapsedNs{0};
+  // episodes trained when the greedy route first was a shortest path
+  qint64 convergedAt{-1};
+  int greedyLength{0};    // cells, 0 if the greedy route misses the goal
+  int shortestLength{0};  // cells, by breadth-first search
+  std::vector<float> meanSteps;  // per batch, the learning curve
+
+  double stepsPerSecond() const {
+    return elapsedNs > 0 ? 1e9 * double(steps) / double(elapsedNs) : 0.0;
+  }
+  QJsonObject toJson() const;
+};
+
+// Tabular Q-learning of the route from any start to one goal cell.
+//
+// Every move costs -1 and the goal ends the episode, so the learned
+// values approach minus the distance to the goal. The open directions of
+// every cell are taken once from Solver::canMove; walls are never tried.
+class QLearner {
+ public:
+  static constexpr qint64 kBatchEpisodes = 256;
+
+  QLearner(const MazeData& maze, QPoint goal);
+
+  QLearningReport train(QPoint start, const QLearningOptions& options,
+                        const CancellationToken& cancel = {});
+
+  // best action from start until the goal; stops at a revisited cell
+  std::vector<QPoint> greedyRoute(QPoint start) const;
+
+  const QTable& table() const { return table_; }
+  QPoint goal() const { return goal_; }
+
+ private:
+  // cells on a shortest route to the goal, 0 without one
+  int shortestLength(QPoint start) const;
+  // steps taken, goal reached or not
+  int runEpisode(int start, qint64 episode, const QLearningOptions& options,
+                 float epsilon, int maxSteps, bool* reached);
+
+  int rows_{0};
+  int cols_{0};
+  QPoint goal_;
+  std::vector<quint8> open_;  // bit per action
+  QTable table_;
+};
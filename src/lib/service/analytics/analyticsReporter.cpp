@@ -0,0 +1,75 @@
+#include "analyticsReporter.h"
+
+#include <QFutureWatcher>
+#include <memory>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+
+AnalyticsReporter::AnalyticsReporter(QObject* parent) : QObject(parent) {}
+
+void AnalyticsReporter::setActive(bool active) {
+  if (active_ == active) return;
+  active_ = active;
+  emit activeChanged();
+  if (active_) refresh();
+}
+
+void AnalyticsReporter::setMazeData(const MazeData* maze) {
+  maze_ = maze;
+  model_ = nullptr;
+  invalidate();
+}
+
+void AnalyticsReporter::setMazeModel(const MazeModel* model) {
+  maze_ = nullptr;
+  model_ = model;
+  invalidate();
+}
+
+void AnalyticsReporter::invalidate() {
+  if (active_) refresh();
+}
+
+void AnalyticsReporter::refresh() {
+  if (analyzing_) {
+    pending_ = true;
+    return;
+  }
+  const MazeData* current = model_ ? &model_->mazeData() : maze_;
+  if (!current || !current->isGenerated) {
+    stats_.clear();
+    emit statsChanged();
+    return;
+  }
+
+  auto* watcher = new QFutureWatcher<MazeAnalysis>(this);
+  connect(watcher, &QFutureWatcher<MazeAnalysis>::finished, this,
+          [this, watcher]() {
+            watcher->deleteLater();
+            stats_ = watcher->result().toJson().toVariantMap();
+            setAnalyzing(false);
+            emit statsChanged();
+            if (pending_) {
+              pending_ = false;
+              invalidate();
+            }
+          });
+
+  // the worker gets a snapshot, edits don't have to wait for it; stats are
+  // background work, behind solves and rendering
+  std::shared_ptr<const MazeData> maze =
+      model_ ? model_->snapshot() : std::make_shared<const MazeData>(*maze_);
+  setAnalyzing(true);
+  watcher->setFuture(TaskScheduler::instance().run(
+      TaskScheduler::Priority::Batch,
+      [maze, options = options_]() {
+        return MazeAnalytics::analyze(*maze, options);
+      }));
+}
+
+void AnalyticsReporter::setAnalyzing(bool analyzing) {
+  if (analyzing_ == analyzing) return;
+  analyzing_ = analyzing;
+  emit analyzingChanged();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QObject>
+#include <QVariantMap>
+
+#include "src/lib/service/analytics/mazeAnalytics.h"
+
+struct MazeData;
+class MazeModel;
+
+// MazeAnalytics of the current maze for a QML stats panel.
+//
+// While active every change of the maze (invalidate) is analysed again
+// by a Batch task, on MazeModel::snapshot or a copy of a bare maze.
+// Changes arriving while one runs are folded into a single rerun once it
+// finishes, so a burst of wall edits costs at most two analyses.
+class AnalyticsReporter : public QObject {
+  Q_OBJECT
+
+  Q_PROPERTY(bool active READ active WRITE setActive NOTIFY activeChanged)
+  Q_PROPERTY(bool analyzing READ analyzing NOTIFY analyzingChanged)
+  // MazeAnalysis::toJson of the last analysis, empty without a maze
+  Q_PROPERTY(QVariantMap stats READ stats NOTIFY statsChanged)
+
+ public:
+  explicit AnalyticsReporter(QObject* parent = nullptr);
+
+  bool active() const { return active_; }
+  void setActive(bool active);
+  bool analyzing() const { return analyzing_; }
+  QVariantMap stats() const { return stats_; }
+
+  void setOptions(const MazeAnalyticsOptions& options) { options_ = options; }
+  void setMazeData(const MazeData* maze);
+  // follows the model's maze through its edits, see MazeModel::snapshot
+  void setMazeModel(const MazeModel* model);
+
+  Q_INVOKABLE void refresh();
+  // the maze changed; analysed again if active
+  void invalidate();
+
+ signals:
+  void activeChanged();
+  void analyzingChanged();
+  void statsChanged();
+
+ private:
+  void setAnalyzing(bool analyzing);
+
+  const MazeData* maze_ = nullptr;
+  const MazeModel* model_ = nullptr;  // instead of maze_
+  MazeAnalyticsOptions options_;
+  QVariantMap stats_;
+  bool active_ = false;
+  bool analyzing_ = false;
+  bool pending_ = false;  // changed while analysing
+};
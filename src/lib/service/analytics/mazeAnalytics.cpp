@@ -0,0 +1,285 @@
+#include "mazeAnalytics.h"
+
+#include <QJsonArray>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/metrics/metrics.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+
+namespace {
+// open directions per cell: right, left, down, up
+constexpr quint8 kRight = 0x1;
+constexpr quint8 kLeft = 0x2;
+constexpr quint8 kDown = 0x4;
+constexpr quint8 kUp = 0x8;
+
+struct Grid {
+  const std::pmr::vector<quint8>& open;
+  std::array<int, 4> offsets;  // to the neighbour in each direction
+};
+
+// breadth-first from one cell: distance in passages (-1 unreached) and
+// parent (the root is its own) per cell; returns the farthest cell
+int sweep(const Grid& grid, int from, std::pmr::vector<int>& distance,
+          std::pmr::vector<int>& parent, std::pmr::vector<int>& queue,
+          qint64* reached) {
+  std::fill(distance.begin(), distance.end(), -1);
+  queue.clear();
+  queue.push_back(from);
+  distance[from] = 0;
+  parent[from] = from;
+  for (size_t head = 0; head < queue.size(); ++head) {
+    int cell = queue[head];
+    for (quint8 open = grid.open[cell]; open; open &= open - 1) {
+      int next = cell + grid.offsets[std::countr_zero(unsigned(open))];
+      if (distance[next] >= 0) continue;
+      distance[next] = distance[cell] + 1;
+      parent[next] = cell;
+      queue.push_back(next);
+    }
+  }
+  *reached = qint64(queue.size());
+  return queue.back();  // bfs order ends at the farthest
+}
+
+// passages between two cells, -1 without a route
+int search(const Grid& grid, int from, int to, std::pmr::vector<int>& distance,
+           std::pmr::vector<int>& queue) {
+  std::fill(distance.begin(), distance.end(), -1);
+  queue.clear();
+  queue.push_back(from);
+  distance[from] = 0;
+  for (size_t head = 0; head < queue.size(); ++head) {
+    int cell = queue[head];
+    if (cell == to) return distance[cell];
+    for (quint8 open = grid.open[cell]; open; open &= open - 1) {
+      int next = cell + grid.offsets[std::countr_zero(unsigned(open))];
+      if (distance[next] >= 0) continue;
+      distance[next] = distance[cell] + 1;
+      queue.push_back(next);
+    }
+  }
+  return -1;
+}
+
+QJsonArray toJsonArray(const std::vector<qint64>& values) {
+  QJsonArray array;
+  for (qint64 value : values) array.append(value);
+  return array;
+}
+}  // namespace
+
+QJsonObject MazeAnalysis::toJson() const {
+  return {{"rows", rows},
+          {"cols", cols},
+          {"passages", passages},
+          {"deadEnds", deadEnds},
+          {"junctions", junctions},
+          {"isolatedCells", isolatedCells},
+          {"corridors", corridors},
+          {"longestCorridor", longestCorridor},
+          {"corridorLengths", toJsonArray(corridorLengths)},
+          {"diameter", diameter},
+          {"diameterStart", QJsonArray{diameterStart.x(), diameterStart.y()}},
+          {"diameterEnd", QJsonArray{diameterEnd.x(), diameterEnd.y()}},
+          {"reachableCells", reachableCells},
+          {"perfect", perfect},
+          {"solutions",
+           QJsonObject{{"samples", samples},
+                       {"unreachable", unreachablePairs},
+                       {"mean", meanSolution},
+                       {"min", minSolution},
+                       {"max", maxSolution},
+                       {"p50", p50Solution},
+                       {"p90", p90Solution},
+                       {"p99", p99Solution},
+                       {"histogram", toJsonArray(solutionHistogram)}}}};
+}
+
+MazeAnalysis MazeAnalytics::analyze(const MazeData& maze,
+                                    const MazeAnalyticsOptions& options) {
+  MAZE_SCOPED_TIMER(Analyze);
+  MazeAnalysis result;
+  result.corridorLengths.assign(MazeAnalysis::kMaxCorridorLength + 1, 0);
+  result.solutionHistogram.assign(MazeAnalysis::kSolutionBuckets, 0);
+  if (!maze.isGenerated || maze.rows <= 0 || maze.cols <= 0) return result;
+
+  const int rows = maze.rows;
+  const int cols = maze.cols;
+  const size_t cells = size_t(rows) * cols;
+  result.rows = rows;
+  result.cols = cols;
+
+  ScratchScope scratch(TaskScheduler::scratch());
+  std::pmr::vector<quint8> open(cells, 0, scratch.resource());
+  const Grid grid{open, {1, -1, cols, -cols}};
+
+  // the one pass over the walls; border walls are never passages
+  for (int r = 0; r < rows; ++r) {
+    const MazeCell* row = maze.cells[r].data();
+    quint8* cell = open.data() + size_t(r) * cols;
+    for (int c = 0; c < cols; ++c) {
+      if (c + 1 < cols && !row[c].rightWall) {
+        cell[c] |= kRight;
+        cell[c + 1] |= kLeft;
+        ++result.passages;
+      }
+      if (r + 1 < rows && !row[c].bottomWall) {
+        cell[c] |= kDown;
+        cell[c + cols] |= kUp;
+        ++result.passages;
+      }
+    }
+    // the previous row has all its passages now
+    if (r > 0) {
+      for (const quint8* p = cell - cols; p != cell; ++p) {
+        int degree = std::popcount(unsigned(*p));
+        result.isolatedCells += degree == 0;
+        result.deadEnds += degree == 1;
+        result.junctions += degree >= 3;
+      }
+    }
+  }
+  for (size_t i = cells - cols; i < cells; ++i) {
+    int degree = std::popcount(unsigned(open[i]));
+    result.isolatedCells += degree == 0;
+    result.deadEnds += degree == 1;
+    result.junctions += degree >= 3;
+  }
+
+  // corridors, every cell of one followed once from where it's first met
+  std::pmr::vector<char> seen(cells, 0, scratch.resource());
+  auto isCorridor = [&](int cell) {
+    return std::popcount(unsigned(open[cell])) == 2;
+  };
+  for (int start = 0; start < int(cells); ++start) {
+    if (seen[start] || !isCorridor(start)) continue;
+    seen[start] = 1;
+    int length = 1;
+    for (quint8 way = open[start]; way; way &= way - 1) {
+      int prev = start;
+      int at = start + grid.offsets[std::countr_zero(unsigned(way))];
+      while (!seen[at] && isCorridor(at)) {
+        seen[at] = 1;
+        ++length;
+        quint8 onward = open[at];
+        int next = at + grid.offsets[std::countr_zero(unsigned(onward))];
+        if (next == prev) {
+          onward &= onward - 1;
+          next = at + grid.offsets[std::countr_zero(unsigned(onward))];
+        }
+        prev = at;
+        at = next;
+      }
+    }
+    ++result.corridors;
+    result.longestCorridor = std::max(result.longestCorridor, length);
+    length = std::min(length, MazeAnalysis::kMaxCorridorLength);
+    ++result.corridorLengths[length];
+  }
+
+  // diameter by two sweeps; the second one's parents also serve the samples
+  std::pmr::vector<int> distance(cells, -1, scratch.resource());
+  std::pmr::vector<int> parent(cells, -1, scratch.resource());
+  std::pmr::vector<int> queue(scratch.resource());
+  queue.reserve(cells);
+  qint64 reached = 0;
+  int far = sweep(grid, 0, distance, parent, queue, &reached);
+  int end = sweep(grid, far, distance, parent, queue, &reached);
+  result.diameter = distance[end] + 1;
+  result.diameterStart = QPoint(far / cols, far % cols);
+  result.diameterEnd = QPoint(end / cols, end % cols);
+  result.reachableCells = reached;
+  result.perfect =
+      reached == qint64(cells) && result.passages == qint64(cells) - 1;
+
+  if (options.samples <= 0) return result;
+
+  // heavy-light chains over the second sweep's tree, so a pair's common
+  // ancestor is O(log n) chain hops away; subtree sizes go into head
+  // first, leaves to root in reverse bfs order
+  std::pmr::vector<int> head(scratch.resource());
+  std::pmr::vector<int> heavy(scratch.resource());
+  if (result.perfect) {
+    head.assign(cells, 1);
+    heavy.assign(cells, -1);
+    for (size_t i = queue.size() - 1; i > 0; --i) {
+      head[parent[queue[i]]] += head[queue[i]];
+    }
+    for (size_t i = 1; i < queue.size(); ++i) {
+      int cell = queue[i];
+      int& child = heavy[parent[cell]];
+      if (child < 0 || head[cell] > head[child]) child = cell;
+    }
+    for (size_t i = 0; i < queue.size(); ++i) {
+      int cell = queue[i];
+      bool onChain = i > 0 && heavy[parent[cell]] == cell;
+      head[cell] = onChain ? head[parent[cell]] : cell;
+    }
+  }
+
+  QRandomGenerator random(options.seed);
+  std::pmr::vector<int> lengths(scratch.resource());
+  lengths.reserve(size_t(options.samples));
+  for (int i = 0; i < options.samples; ++i) {
+    int a = int(random.bounded(quint32(cells)));
+    int b = int(random.bounded(quint32(cells)));
+    int passages = 0;
+    if (result.perfect) {
+      // distance is the depth in the tree
+      int ancestorA = a, ancestorB = b;
+      while (head[ancestorA] != head[ancestorB]) {
+        if (distance[head[ancestorA]] >= distance[head[ancestorB]]) {
+          ancestorA = parent[head[ancestorA]];
+        } else {
+          ancestorB = parent[head[ancestorB]];
+        }
+      }
+      int common = std::min(distance[ancestorA], distance[ancestorB]);
+      passages = distance[a] + distance[b] - 2 * common;
+    } else {
+      passages = search(grid, a, b, distance, queue);
+    }
+    if (passages < 0) {
+      ++result.unreachablePairs;
+    } else {
+      lengths.push_back(passages + 1);
+    }
+  }
+  result.samples = options.samples;
+  if (lengths.empty()) return result;
+
+  std::sort(lengths.begin(), lengths.end());
+  auto percentile = [&](double p) {
+    return lengths[std::min(lengths.size() - 1, size_t(p * lengths.size()))];
+  };
+  qint64 total = 0;
+  for (int length : lengths) {
+    total += length;
+    int bucket = (length - 1) * MazeAnalysis::kSolutionBuckets /
+                 std::max(result.diameter, 1);
+    ++result.solutionHistogram[std::min(bucket,
+                                        MazeAnalysis::kSolutionBuckets - 1)];
+  }
+  result.meanSolution = double(total) / double(lengths.size());
+  result.minSolution = lengths.front();
+  result.maxSolution = lengths.back();
+  result.p50Solution = percentile(0.5);
+  result.p90Solution = percentile(0.9);
+  result.p99Solution = percentile(0.99);
+  return result;
+}
+
+std::vector<MazeAnalysis> MazeAnalytics::analyzeBatch(
+    const std::vector<const MazeData*>& mazes,
+    const MazeAnalyticsOptions& options) {
+  std::vector<MazeAnalysis> results(mazes.size());
+  TaskScheduler::instance().parallelFor(
+      qsizetype(mazes.size()),
+      [&](qsizetype i) { results[i] = analyze(*mazes[i], options); });
+  return results;
+}
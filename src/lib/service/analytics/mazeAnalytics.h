@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QPoint>
+#include <QtGlobal>
+#include <vector>
+
+struct MazeData;
+
+struct MazeAnalyticsOptions {
+  // random start/end pairs for the solution lengths, 0 to skip
+  int samples{1000};
+  quint32 seed{1};
+};
+
+struct MazeAnalysis {
+  // corridors this long or longer share the last histogram slot
+  static constexpr int kMaxCorridorLength = 64;
+  static constexpr int kSolutionBuckets = 16;
+
+  int rows{0};
+  int cols{0};
+  qint64 passages{0};
+  qint64 deadEnds{0};   // cells with one passage
+  qint64 junctions{0};  // three or four
+  qint64 isolatedCells{0};
+  // maximal chains of cells with two passages; [n] counts chains of n
+  // cells, slot 0 unused
+  std::vector<qint64> corridorLengths;
+  qint64 corridors{0};
+  int longestCorridor{0};
+
+  // of the region around the top-left cell, in cells; exact when the
+  // maze is perfect, a lower bound with loops
+  int diameter{0};
+  QPoint diameterStart{-1, -1};
+  QPoint diameterEnd{-1, -1};
+  qint64 reachableCells{0};  // the region around the top-left cell
+  bool perfect{false};
+
+  // shortest routes between random cell pairs, in cells; pairs without
+  // a route are only counted
+  int samples{0};
+  int unreachablePairs{0};
+  double meanSolution{0};
+  int minSolution{0};
+  int maxSolution{0};
+  int p50Solution{0};
+  int p90Solution{0};
+  int p99Solution{0};
+  // kSolutionBuckets equal slots over [1, diameter]
+  std::vector<qint64> solutionHistogram;
+
+  QJsonObject toJson() const;
+};
+
+// Structure statistics of a maze without a solver call per query.
+//
+// One pass over the walls packs each cell's open directions and counts
+// passages, dead ends and junctions, then corridors are followed once.
+// The diameter takes two breadth-first sweeps (the farthest cell from the
+// top-left one, then the farthest from that). In a perfect maze the
+// second sweep's parents form a tree, cut into heavy-light chains once,
+// so a random pair's distance follows from their common ancestor in
+// O(log n) instead of a search; with loops every sample is a search of
+// its own. Working state lives in the thread's scratch arena.
+class MazeAnalytics {
+ public:
+  static MazeAnalysis analyze(const MazeData& maze,
+                              const MazeAnalyticsOptions& options = {});
+  // one maze per scheduler task, results in the order of mazes
+  static std::vector<MazeAnalysis> analyzeBatch(
+      const std::vector<const MazeData*>& mazes,
+      const MazeAnalyticsOptions& options = {});
+};
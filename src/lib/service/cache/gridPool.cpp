@@ -0,0 +1,87 @@
+#include "gridPool.h"
+
+#include <algorithm>
+
+#include "src/core/mazeData.h"
+
+namespace {
+qint64 gridBytes(const MazeData& maze) {
+  return qint64(maze.rows) * qint64(sizeof(std::vector<MazeCell>)) +
+         qint64(maze.rows) * maze.cols * qint64(sizeof(MazeCell));
+}
+}  // namespace
+
+GridPool& GridPool::instance() {
+  static GridPool pool;
+  return pool;
+}
+
+MazeData GridPool::acquire(int rows, int cols, MazeCell fill) {
+  MazeData maze;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // newest first, it is the likeliest to still be in cache
+    auto found = std::find_if(
+        grids_.rbegin(), grids_.rend(), [&](const MazeData& grid) {
+          return grid.rows == rows && grid.cols == cols;
+        });
+    if (found != grids_.rend()) {
+      maze = std::move(*found);
+      grids_.erase(std::next(found).base());
+      stats_.bytes -= gridBytes(maze);
+      ++stats_.reused;
+    } else {
+      ++stats_.allocated;
+    }
+  }
+  resetGrid(maze, rows, cols, fill);
+  return maze;
+}
+
+MazeData GridPool::copy(const MazeData& maze) {
+  MazeData grid = acquire(maze.rows, maze.cols, {true, true});
+  for (int r = 0; r < maze.rows; ++r) {
+    std::copy(maze.cells[r].begin(), maze.cells[r].end(),
+              grid.cells[r].begin());
+  }
+  grid.isGenerated = maze.isGenerated;
+  return grid;
+}
+
+void GridPool::release(MazeData&& maze) {
+  if (maze.rows <= 0 || maze.cols <= 0 ||
+      maze.cells.size() != size_t(maze.rows)) {
+    return;  // moved-from or partial, nothing worth keeping
+  }
+  MazeData grid = std::move(maze);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (gridBytes(grid) > budget_) return;
+  stats_.bytes += gridBytes(grid);
+  grids_.push_back(std::move(grid));
+  trim();
+}
+
+void GridPool::setBudget(qint64 bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  budget_ = bytes;
+  trim();
+}
+
+void GridPool::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  grids_.clear();
+  stats_ = {};
+}
+
+GridPool::Stats GridPool::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void GridPool::trim() {
+  size_t dropped = 0;
+  while (stats_.bytes > budget_ && dropped < grids_.size()) {
+    stats_.bytes -= gridBytes(grids_[dropped++]);
+  }
+  grids_.erase(grids_.begin(), grids_.begin() + dropped);
+}
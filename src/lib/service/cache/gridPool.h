@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QtGlobal>
+#include <mutex>
+#include <vector>
+
+#include "src/core/mazeData.h"
+
+// Released wall grids kept for reuse by the next maze of the same size.
+//
+// Parsing, archive reads and saving each need a full grid for a moment;
+// going through the pool, loading the same size again (or saving the same
+// maze twice) reuses the row buffers instead of allocating rows + 1 new
+// ones. Grids are kept up to a byte budget, oldest dropped first. All calls
+// are thread-safe.
+class GridPool {
+ public:
+  static constexpr qint64 kDefaultBudgetBytes = qint64(64) << 20;
+
+  struct Stats {
+    quint64 reused{0};
+    quint64 allocated{0};
+    qint64 bytes{0};
+  };
+
+  GridPool() = default;
+  static GridPool& instance();
+
+  // a rows x cols grid with every cell set to fill, not yet generated
+  MazeData acquire(int rows, int cols, MazeCell fill);
+  // a copy of maze in a pooled grid
+  MazeData copy(const MazeData& maze);
+  // kept only while it fits the budget
+  void release(MazeData&& maze);
+
+  void setBudget(qint64 bytes);
+  void clear();
+  Stats stats() const;
+
+ private:
+  void trim();
+
+  mutable std::mutex mutex_;
+  std::vector<MazeData> grids_;  // oldest first
+  qint64 budget_{kDefaultBudgetBytes};
+  Stats stats_;
+};
@@ -0,0 +1,178 @@
+#include "mazeCache.h"
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/generator/generator.h"
+#include "src/lib/service/metrics/metrics.h"
+
+namespace {
+qint64 mazeBytes(const MazeData& maze) {
+  return qint64(sizeof(MazeData)) +
+         qint64(maze.rows) * qint64(sizeof(std::vector<MazeCell>)) +
+         qint64(maze.rows) * maze.cols * qint64(sizeof(MazeCell));
+}
+
+qint64 pathBytes(const PackedPath& path) {
+  // key, list node and map node, roughly
+  constexpr qint64 kEntryOverhead = 128;
+  return kEntryOverhead + qint64(path.moves.size());
+}
+
+// splitmix64 finaliser, every input bit reaches every output bit
+quint64 mix(quint64 hash, quint64 value) {
+  hash = (hash ^ value) * 0x9e3779b97f4a7c15ULL;
+  hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+  return hash ^ (hash >> 31);
+}
+}  // namespace
+
+MazeCache& MazeCache::instance() {
+  static MazeCache cache;
+  return cache;
+}
+
+quint64 MazeCache::fingerprint(const MazeData& maze) {
+  quint64 hash = mix(mix(0, quint64(maze.rows)), quint64(maze.cols));
+  for (const auto& row : maze.cells) {
+    // two bits per cell, 32 cells per word
+    quint64 word = 0;
+    int shift = 0;
+    for (const MazeCell& cell : row) {
+      word |= quint64(cell.rightWall | (cell.bottomWall << 1)) << shift;
+      shift += 2;
+      if (shift == 64) {
+        hash = mix(hash, word);
+        word = 0;
+        shift = 0;
+      }
+    }
+    hash = mix(hash, word);
+  }
+  return hash;
+}
+
+std::shared_ptr<const MazeData> MazeCache::findMaze(int rows, int cols,
+                                                    quint32 seed,
+                                                    const QString& algorithm) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = mazes_.find({rows, cols, seed, algorithm});
+  if (!found) {
+    ++stats_.mazeMisses;
+    MAZE_COUNT(CacheMisses, 1);
+    return {};
+  }
+  ++stats_.mazeHits;
+  MAZE_COUNT(CacheHits, 1);
+  return *found;
+}
+
+void MazeCache::insertMaze(int rows, int cols, quint32 seed,
+                           const QString& algorithm,
+                           std::shared_ptr<const MazeData> maze) {
+  qint64 bytes = mazeBytes(*maze);
+  std::lock_guard<std::mutex> lock(mutex_);
+  countEvictions(
+      mazes_.insert({rows, cols, seed, algorithm}, std::move(maze), bytes));
+}
+
+std::shared_ptr<const MazeData> MazeCache::generate(int rows, int cols,
+                                                    quint32 seed,
+                                                    const QString& algorithm) {
+  MazeAlgorithm known = MazeGenerator::parse(algorithm.toStdString())
+                            .value_or(MazeAlgorithm::Eller);
+  QString name = QString::fromLatin1(MazeGenerator::name(known));
+  if (auto maze = findMaze(rows, cols, seed, name)) return maze;
+
+  auto maze = std::make_shared<MazeData>();
+  Generator gen(known);
+  gen.setSeed(seed);
+  gen.generate(*maze, rows, cols);
+  insertMaze(rows, cols, seed, name, maze);
+  return maze;
+}
+
+const PackedPath* MazeCache::lookupPath(quint64 fingerprint, QPoint start,
+                                        QPoint end) {
+  auto found =
+      paths_.find({fingerprint, start.x(), start.y(), end.x(), end.y()});
+  if (!found) {
+    ++stats_.pathMisses;
+    MAZE_COUNT(CacheMisses, 1);
+    return nullptr;
+  }
+  ++stats_.pathHits;
+  MAZE_COUNT(CacheHits, 1);
+  return found;
+}
+
+bool MazeCache::findPath(quint64 fingerprint, QPoint start, QPoint end,
+                         std::vector<QPoint>* path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const PackedPath* found = lookupPath(fingerprint, start, end);
+  if (found) PathCodec::decode(*found, path);
+  return found;
+}
+
+bool MazeCache::findPackedPath(quint64 fingerprint, QPoint start, QPoint end,
+                               PackedPath* path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const PackedPath* found = lookupPath(fingerprint, start, end);
+  if (found) *path = *found;
+  return found;
+}
+
+void MazeCache::insertPath(quint64 fingerprint, QPoint start, QPoint end,
+                           const std::vector<QPoint>& path) {
+  PackedPath packed;
+  // not a path through the maze, nothing to keep
+  if (!PathCodec::encode(path, &packed)) return;
+  insertPackedPath(fingerprint, start, end, std::move(packed));
+}
+
+void MazeCache::insertPackedPath(quint64 fingerprint, QPoint start,
+                                 QPoint end, PackedPath path) {
+  qint64 bytes = pathBytes(path);
+  std::lock_guard<std::mutex> lock(mutex_);
+  countEvictions(
+      paths_.insert({fingerprint, start.x(), start.y(), end.x(), end.y()},
+                    std::move(path), bytes));
+}
+
+void MazeCache::setBudget(qint64 mazeBytes, qint64 pathBytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  mazes_.budget = mazeBytes;
+  paths_.budget = pathBytes;
+  countEvictions(mazes_.trim() + paths_.trim());
+}
+
+void MazeCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  mazes_.clear();
+  paths_.clear();
+  stats_ = {};
+}
+
+MazeCache::Stats MazeCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats = stats_;
+  stats.mazeBytes = mazes_.bytes;
+  stats.pathBytes = paths_.bytes;
+  return stats;
+}
+
+QJsonObject MazeCache::toJson() const {
+  Stats s = stats();
+  return {{"mazeHits", qint64(s.mazeHits)},
+          {"mazeMisses", qint64(s.mazeMisses)},
+          {"pathHits", qint64(s.pathHits)},
+          {"pathMisses", qint64(s.pathMisses)},
+          {"evictions", qint64(s.evictions)},
+          {"mazeBytes", s.mazeBytes},
+          {"pathBytes", s.pathBytes}};
+}
+
+void MazeCache::countEvictions(quint64 evicted) {
+  if (!evicted) return;
+  stats_.evictions += evicted;
+  MAZE_COUNT(CacheEvictions, qint64(evicted));
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QPoint>
+#include <QString>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "src/core/packedPath.h"
+#include "src/lib/service/generator/generator.h"
+
+struct MazeData;
+
+// Bounded cache of generated mazes and solved paths, shared by the app,
+// maze_cli and the server.
+//
+// Mazes are keyed by rows, cols, seed and algorithm; paths by a fingerprint
+// of the walls plus the endpoints, so a path is found again for any maze
+// with the same walls, however it was made. Paths are kept packed, a
+// quarter byte a cell. Each kind has its own byte budget and goes least
+// recently used first. All calls are thread-safe.
+class MazeCache {
+ public:
+  static constexpr qint64 kDefaultMazeBytes = qint64(256) << 20;
+  static constexpr qint64 kDefaultPathBytes = qint64(64) << 20;
+
+  struct Stats {
+    quint64 mazeHits{0};
+    quint64 mazeMisses{0};
+    quint64 pathHits{0};
+    quint64 pathMisses{0};
+    quint64 evictions{0};
+    qint64 mazeBytes{0};
+    qint64 pathBytes{0};
+  };
+
+  MazeCache() = default;
+  static MazeCache& instance();
+
+  // hash of the walls only; a collision would hand out a wrong path, at
+  // 64 bits that is not a practical concern
+  static quint64 fingerprint(const MazeData& maze);
+
+  std::shared_ptr<const MazeData> findMaze(int rows, int cols, quint32 seed,
+                                           const QString& algorithm);
+  // maze must not be a const object: a MazeModel that found it shares it
+  // and edits it in place once the cache has let go
+  void insertMaze(int rows, int cols, quint32 seed, const QString& algorithm,
+                  std::shared_ptr<const MazeData> maze);
+  // the cached maze, or a new one made by Generator and inserted; two
+  // threads missing at once both generate, the mazes are identical.
+  // An unknown algorithm is Generator's default
+  std::shared_ptr<const MazeData> generate(
+      int rows, int cols, quint32 seed,
+      const QString& algorithm = Generator::kAlgorithm);
+
+  // an empty path is a valid answer too: the ends are not connected
+  bool findPath(quint64 fingerprint, QPoint start, QPoint end,
+                std::vector<QPoint>* path);
+  void insertPath(quint64 fingerprint, QPoint start, QPoint end,
+                  const std::vector<QPoint>& path);
+  // the same without unpacking, for batch solves
+  bool findPackedPath(quint64 fingerprint, QPoint start, QPoint end,
+                      PackedPath* path);
+  void insertPackedPath(quint64 fingerprint, QPoint start, QPoint end,
+                        PackedPath path);
+
+  // shrinking evicts right away
+  void setBudget(qint64 mazeBytes, qint64 pathBytes);
+  void clear();
+
+  Stats stats() const;
+  QJsonObject toJson() const;
+
+ private:
+  using MazeKey = std::tuple<int, int, quint32, QString>;
+  using PathKey = std::tuple<quint64, int, int, int, int>;
+
+  // entries in use order with a byte total; evicting is up to the owner
+  template <class Key, class Value>
+  struct Lru {
+    struct Entry {
+      Key key;
+      Value value;
+      qint64 bytes;
+    };
+
+    std::list<Entry> entries;  // most recently used first
+    std::map<Key, typename std::list<Entry>::iterator> index;
+    qint64 bytes{0};
+    qint64 budget{0};
+
+    const Value* find(const Key& key) {
+      auto it = index.find(key);
+      if (it == index.end()) return nullptr;
+      entries.splice(entries.begin(), entries, it->second);
+      return &it->second->value;
+    }
+
+    // returns the number of entries evicted to make room
+    quint64 insert(const Key& key, Value value, qint64 size) {
+      auto it = index.find(key);
+      if (it != index.end()) {
+        bytes -= it->second->bytes;
+        entries.erase(it->second);
+        index.erase(it);
+      }
+      // would push out everything else and still not fit
+      if (size > budget) return 0;
+
+      entries.push_front({key, std::move(value), size});
+      index[key] = entries.begin();
+      bytes += size;
+      return trim();
+    }
+
+    quint64 trim() {
+      quint64 evicted = 0;
+      while (bytes > budget && !entries.empty()) {
+        bytes -= entries.back().bytes;
+        index.erase(entries.back().key);
+        entries.pop_back();
+        ++evicted;
+      }
+      return evicted;
+    }
+
+    void clear() {
+      entries.clear();
+      index.clear();
+      bytes = 0;
+    }
+  };
+
+  void countEvictions(quint64 evicted);
+  // the cached path or nullptr, counting the hit or miss; mutex_ held
+  const PackedPath* lookupPath(quint64 fingerprint, QPoint start, QPoint end);
+
+  mutable std::mutex mutex_;
+  Lru<MazeKey, std::shared_ptr<const MazeData>> mazes_{{}, {}, 0,
+                                                       kDefaultMazeBytes};
+  Lru<PathKey, PackedPath> paths_{{}, {}, 0, kDefaultPathBytes};
+  Stats stats_;
+};
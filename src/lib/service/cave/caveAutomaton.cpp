@@ -0,0 +1,114 @@
+#include "caveAutomaton.h"
+
+#include "src/lib/service/metrics/metrics.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+
+namespace {
+constexpr quint64 kRock = ~quint64(0);
+
+// a row as its neighbours see it: rock outside the grid and past the
+// last column
+struct RowView {
+  const quint64* words;  // null outside the grid
+  int count;
+  quint64 padding;
+
+  quint64 at(int w) const {
+    if (!words || w >= count) return kRock;
+    return w == count - 1 ? words[w] | padding : words[w];
+  }
+};
+
+inline void fullAdd(quint64 a, quint64 b, quint64 c, quint64* sum,
+                    quint64* carry) {
+  quint64 half = a ^ b;
+  *sum = half ^ c;
+  *carry = (a & b) | (half & c);
+}
+
+// the neighbour to the west (east) of every cell, across word boundaries
+inline quint64 west(quint64 word, quint64 before) {
+  return (word << 1) | (before >> 63);
+}
+inline quint64 east(quint64 word, quint64 after) {
+  return (word >> 1) | (after << 63);
+}
+
+// cells whose count, given as bit planes, is one of the counts in set
+inline quint64 countIn(quint16 set, quint64 ones, quint64 twos, quint64 fours,
+                       quint64 eights) {
+  quint64 cells = 0;
+  for (int n = 0; n <= 8; ++n) {
+    if (!(set & (1u << n))) continue;
+    cells |= (n & 1 ? ones : ~ones) & (n & 2 ? twos : ~twos) &
+             (n & 4 ? fours : ~fours) & (n & 8 ? eights : ~eights);
+  }
+  return cells;
+}
+}  // namespace
+
+void CaveAutomaton::step(const CaveGrid& from, CaveGrid* to,
+                         const CaveRule& rule) {
+  MAZE_SCOPED_TIMER(CaveStep);
+  if (to->rows() != from.rows() || to->cols() != from.cols()) {
+    *to = CaveGrid(from.rows(), from.cols());
+  }
+  if (from.isEmpty()) return;
+
+  int bands = (from.rows() + kBandRows - 1) / kBandRows;
+  TaskScheduler::instance().parallelFor(bands, [&](qsizetype band) {
+    int first = int(band) * kBandRows;
+    stepRows(from, to, rule, first, std::min(first + kBandRows, from.rows()));
+  });
+  MAZE_COUNT(CaveCells, qint64(from.rows()) * from.cols());
+}
+
+void CaveAutomaton::stepRows(const CaveGrid& from, CaveGrid* to,
+                             const CaveRule& rule, int rowBegin, int rowEnd) {
+  int words = from.wordsPerRow();
+  quint64 lastMask = from.lastWordMask();
+  auto view = [&](int r) {
+    bool inside = r >= 0 && r < from.rows();
+    return RowView{inside ? from.row(r) : nullptr, words, ~lastMask};
+  };
+
+  for (int r = rowBegin; r < rowEnd; ++r) {
+    RowView up = view(r - 1), mid = view(r), down = view(r + 1);
+    const quint64* self = from.row(r);
+    quint64* out = to->row(r);
+
+    // words w - 1, w and w + 1 of the three rows, rolled along the row
+    quint64 u0 = kRock, u1 = up.at(0);
+    quint64 m0 = kRock, m1 = mid.at(0);
+    quint64 d0 = kRock, d1 = down.at(0);
+    for (int w = 0; w < words; ++w) {
+      quint64 u2 = up.at(w + 1), m2 = mid.at(w + 1), d2 = down.at(w + 1);
+
+      // rows above and below: three neighbours each, 0..3
+      quint64 aboveOnes, aboveTwos, belowOnes, belowTwos;
+      fullAdd(west(u1, u0), u1, east(u1, u2), &aboveOnes, &aboveTwos);
+      fullAdd(west(d1, d0), d1, east(d1, d2), &belowOnes, &belowTwos);
+      // own row: two neighbours, 0..2
+      quint64 left = west(m1, m0), right = east(m1, m2);
+      quint64 sideOnes = left ^ right, sideTwos = left & right;
+
+      // sum the three partial counts into planes of weight 1, 2, 4, 8
+      quint64 ones, carry, twos, fours;
+      fullAdd(aboveOnes, belowOnes, sideOnes, &ones, &carry);
+      fullAdd(aboveTwos, belowTwos, sideTwos, &twos, &fours);
+      quint64 carryFours = twos & carry;
+      twos ^= carry;
+      quint64 eights = fours & carryFours;
+      fours ^= carryFours;
+
+      quint64 rock = self[w];
+      out[w] = (rock & countIn(rule.survival, ones, twos, fours, eights)) |
+               (~rock & countIn(rule.birth, ones, twos, fours, eights));
+
+      u0 = u1, u1 = u2;
+      m0 = m1, m1 = m2;
+      d0 = d1, d1 = d2;
+    }
+    out[words - 1] &= lastMask;
+  }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "src/lib/service/cave/caveGrid.h"
+
+// One generation of a cave automaton over a bit-packed grid.
+//
+// The eight neighbour counts of 64 cells are summed at once: the
+// neighbour words are fed through bit-sliced full and half adders into
+// four count planes (1, 2, 4, 8), and the rule is a boolean function of
+// those planes. Cells outside the grid count as rock, so caves close up
+// at the border. Rows are split into bands that run on the scheduler.
+class CaveAutomaton {
+ public:
+  // rows per band, a few hundred KB of words at the widest caves
+  static constexpr int kBandRows = 64;
+
+  // to is resized to from's size; from and to must differ
+  static void step(const CaveGrid& from, CaveGrid* to, const CaveRule& rule);
+  // the same on the calling thread only, for rows [rowBegin, rowEnd)
+  static void stepRows(const CaveGrid& from, CaveGrid* to,
+                       const CaveRule& rule, int rowBegin, int rowEnd);
+};
@@ -0,0 +1,86 @@
+#include "caveEngine.h"
+
+#include <QRandomGenerator>
+#include <algorithm>
+#include <utility>
+
+#include "src/lib/service/cave/caveAutomaton.h"
+
+CaveEngine::CaveEngine(QObject* parent) : QObject(parent) {
+  connect(&timer_, &QTimer::timeout, this, &CaveEngine::tick);
+}
+
+void CaveEngine::generate(int rows, int cols, int rockPercent, qint64 seed) {
+  rows = std::clamp(rows, 0, CaveGrid::kMaxDimension);
+  cols = std::clamp(cols, 0, CaveGrid::kMaxDimension);
+  quint32 caveSeed =
+      seed >= 0 ? quint32(seed) : QRandomGenerator::global()->generate();
+
+  CaveGrid grid(rows, cols);
+  grid.fillRandom(rockPercent, caveSeed);
+  setGrid(std::move(grid));
+}
+
+void CaveEngine::step(int count) {
+  if (grid_.isEmpty() || count <= 0) return;
+  for (int i = 0; i < count; ++i) {
+    CaveAutomaton::step(grid_, &next_, rule_);
+    std::swap(grid_, next_);
+  }
+  generation_ += count;
+  emit stepped();
+}
+
+void CaveEngine::clear() {
+  setRunning(false);
+  setGrid({});
+}
+
+void CaveEngine::setRule(const QString& rule) {
+  bool ok = false;
+  CaveRule parsed = CaveRule::parse(rule, &ok);
+  if (ok) setCaveRule(parsed);
+}
+
+void CaveEngine::setCaveRule(const CaveRule& rule) {
+  if (rule_ == rule) return;
+  rule_ = rule;
+  emit ruleChanged();
+}
+
+void CaveEngine::setRunning(bool running) {
+  if (running_ == running) return;
+  running_ = running;
+  updateTimer();
+  emit runningChanged();
+}
+
+void CaveEngine::setStepsPerSecond(int stepsPerSecond) {
+  stepsPerSecond = std::max(stepsPerSecond, 1);
+  if (stepsPerSecond_ == stepsPerSecond) return;
+  stepsPerSecond_ = stepsPerSecond;
+  updateTimer();
+  emit stepsPerSecondChanged();
+}
+
+void CaveEngine::setGrid(CaveGrid grid) {
+  grid_ = std::move(grid);
+  next_ = {};
+  generation_ = 0;
+  emit caveChanged();
+  emit stepped();
+}
+
+void CaveEngine::updateTimer() {
+  if (!running_) {
+    timer_.stop();
+    return;
+  }
+  // never faster than a frame, extra steps are batched into the tick
+  timer_.start(std::max(kFrameMs, 1000 / stepsPerSecond_));
+}
+
+void CaveEngine::tick() {
+  int steps = std::max(1, stepsPerSecond_ * timer_.interval() / 1000);
+  step(steps);
+}
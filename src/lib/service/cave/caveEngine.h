@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+
+#include "src/lib/service/cave/caveGrid.h"
+
+// Cave maps grown by a birth/survival automaton, for QML.
+//
+// generate() seeds a random cave, step() runs generations on demand and
+// running steps automatically at stepsPerSecond. Above the frame rate
+// several generations run per frame, so views see one change per frame
+// however fast the cave evolves.
+class CaveEngine : public QObject {
+  Q_OBJECT
+
+  Q_PROPERTY(int rows READ rows NOTIFY caveChanged)
+  Q_PROPERTY(int cols READ cols NOTIFY caveChanged)
+  Q_PROPERTY(int generation READ generation NOTIFY stepped)
+  Q_PROPERTY(qint64 rockCount READ rockCount NOTIFY stepped)
+  Q_PROPERTY(QString rule READ rule WRITE setRule NOTIFY ruleChanged)
+  Q_PROPERTY(bool running READ running WRITE setRunning NOTIFY runningChanged)
+  Q_PROPERTY(int stepsPerSecond READ stepsPerSecond WRITE setStepsPerSecond
+                 NOTIFY stepsPerSecondChanged)
+
+ public:
+  static constexpr int kFrameMs = 16;
+
+  explicit CaveEngine(QObject* parent = nullptr);
+
+  // rockPercent of the cells start as rock; a negative seed picks one
+  Q_INVOKABLE void generate(int rows, int cols, int rockPercent = 45,
+                            qint64 seed = -1);
+  Q_INVOKABLE void step(int count = 1);
+  Q_INVOKABLE void clear();
+
+  int rows() const { return grid_.rows(); }
+  int cols() const { return grid_.cols(); }
+  int generation() const { return generation_; }
+  qint64 rockCount() const { return grid_.rockCount(); }
+
+  QString rule() const { return rule_.toString(); }
+  // malformed rules are ignored
+  void setRule(const QString& rule);
+  const CaveRule& caveRule() const { return rule_; }
+  void setCaveRule(const CaveRule& rule);
+
+  bool running() const { return running_; }
+  void setRunning(bool running);
+  int stepsPerSecond() const { return stepsPerSecond_; }
+  void setStepsPerSecond(int stepsPerSecond);
+
+  const CaveGrid& grid() const { return grid_; }
+  // a loaded cave, generation starts over
+  void setGrid(CaveGrid grid);
+
+ signals:
+  void caveChanged();
+  void stepped();
+  void ruleChanged();
+  void runningChanged();
+  void stepsPerSecondChanged();
+
+ private:
+  void updateTimer();
+  void tick();
+
+  CaveGrid grid_;
+  CaveGrid next_;  // the other buffer, swapped in after each step
+  CaveRule rule_ = CaveRule::classic();
+  int generation_{0};
+  bool running_{false};
+  int stepsPerSecond_{30};
+  QTimer timer_;
+};
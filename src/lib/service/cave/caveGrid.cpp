@@ -0,0 +1,82 @@
+#include "caveGrid.h"
+
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <bit>
+
+CaveRule CaveRule::parse(const QString& text, bool* ok) {
+  static const QRegularExpression pattern(
+      "^\\s*B([0-8]*)\\s*/\\s*S([0-8]*)\\s*$",
+      QRegularExpression::CaseInsensitiveOption);
+  QRegularExpressionMatch match = pattern.match(text);
+  if (ok) *ok = match.hasMatch();
+  if (!match.hasMatch()) return {};
+
+  auto counts = [](const QString& digits) {
+    quint16 mask = 0;
+    for (QChar digit : digits) mask |= quint16(1u << digit.digitValue());
+    return mask;
+  };
+  return {counts(match.captured(1)), counts(match.captured(2))};
+}
+
+QString CaveRule::toString() const {
+  auto digits = [](quint16 mask) {
+    QString text;
+    for (int n = 0; n <= 8; ++n) {
+      if (mask & (1u << n)) text += QChar('0' + n);
+    }
+    return text;
+  };
+  return "B" + digits(birth) + "/S" + digits(survival);
+}
+
+CaveGrid::CaveGrid(int rows, int cols)
+    : rows_(rows),
+      cols_(cols),
+      wordsPerRow_((cols + kWordBits - 1) / kWordBits),
+      bits_(size_t(rows) * wordsPerRow_, 0) {}
+
+bool CaveGrid::rock(int row, int col) const {
+  return (this->row(row)[col / kWordBits] >> (col % kWordBits)) & 1;
+}
+
+void CaveGrid::setRock(int row, int col, bool rock) {
+  quint64 bit = quint64(1) << (col % kWordBits);
+  quint64& word = this->row(row)[col / kWordBits];
+  word = rock ? word | bit : word & ~bit;
+}
+
+void CaveGrid::fillRandom(int rockPercent, quint32 seed) {
+  if (isEmpty()) return;
+  QRandomGenerator random(seed);
+  // 8 cells per draw: one byte of the draw against the threshold each
+  quint32 threshold = quint32(qBound(0, rockPercent, 100)) * 256 / 100;
+  for (int r = 0; r < rows_; ++r) {
+    quint64* words = row(r);
+    for (int w = 0; w < wordsPerRow_; ++w) {
+      quint64 word = 0;
+      for (int bit = 0; bit < kWordBits; bit += 8) {
+        quint64 draw = random.generate64();
+        for (int i = 0; i < 8; ++i) {
+          if (((draw >> (8 * i)) & 0xff) < threshold) {
+            word |= quint64(1) << (bit + i);
+          }
+        }
+      }
+      words[w] = word;
+    }
+    words[wordsPerRow_ - 1] &= lastWordMask();
+  }
+}
+
+qint64 CaveGrid::rockCount() const {
+  qint64 count = 0;
+  for (quint64 word : bits_) count += std::popcount(word);
+  return count;
+}
+
+quint64 CaveGrid::lastWordMask() const {
+  int used = cols_ - (wordsPerRow_ - 1) * kWordBits;
+  return used == kWordBits ? ~quint64(0) : (quint64(1) << used) - 1;
+}
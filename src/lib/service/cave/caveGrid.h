@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+// Birth/survival rule of a cave automaton: bit n of birth (survival) is set
+// when a floor (rock) cell with n rock neighbours becomes (stays) rock.
+// Written as "B678/S345678", the classic smoothing rule for caves.
+struct CaveRule {
+  quint16 birth{0};
+  quint16 survival{0};
+
+  static CaveRule classic() { return {0x1c0, 0x1f8}; }  // B678/S345678
+  // empty rule on a malformed string, ok tells the two apart
+  static CaveRule parse(const QString& text, bool* ok = nullptr);
+  QString toString() const;
+
+  bool operator==(const CaveRule& other) const {
+    return birth == other.birth && survival == other.survival;
+  }
+};
+
+// Bit-packed cave map, one bit per cell, 1 = rock. Each row starts on a
+// 64-bit word, cell c of a row is bit c % 64 of word c / 64; bits past the
+// last column are always zero.
+class CaveGrid {
+ public:
+  static constexpr int kWordBits = 64;
+  static constexpr int kMaxDimension = 16384;
+
+  CaveGrid() = default;
+  CaveGrid(int rows, int cols);
+
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
+  int wordsPerRow() const { return wordsPerRow_; }
+  bool isEmpty() const { return rows_ == 0 || cols_ == 0; }
+
+  bool rock(int row, int col) const;
+  void setRock(int row, int col, bool rock);
+  // about rockPercent of the cells become rock; same seed, same cave
+  void fillRandom(int rockPercent, quint32 seed);
+  qint64 rockCount() const;
+
+  quint64* row(int r) { return bits_.data() + size_t(r) * wordsPerRow_; }
+  const quint64* row(int r) const {
+    return bits_.data() + size_t(r) * wordsPerRow_;
+  }
+  // the bits of the last word of a row that hold cells
+  quint64 lastWordMask() const;
+
+  bool operator==(const CaveGrid& other) const {
+    return rows_ == other.rows_ && cols_ == other.cols_ &&
+           bits_ == other.bits_;
+  }
+
+ private:
+  int rows_{0};
+  int cols_{0};
+  int wordsPerRow_{0};
+  std::vector<quint64> bits_;
+};
@@ -1,19 +1,42 @@
 #pragma once
 
-#include <vector>
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include <memory>
+#include <optional>
+
+#include "src/core/mazeGenerator.h"
 
 struct MazeData;
 
+// A core MazeGenerator with the generation counted in the metrics and
+// parallel work on the TaskScheduler
 class Generator {
  public:
-  void generate(MazeData& maze, int rows, int cols);
+  // names the default algorithm in cache keys
+  static constexpr char kAlgorithm[] = "eller";
 
- private:
-  std::vector<int> sets_;  // set id for each cell in current row
-  int nextSetId_ = 1;
+  // called once a row is final; returning false stops generation early
+  using RowDone = MazeGenerator::RowDone;
+
+  explicit Generator(MazeAlgorithm algorithm = MazeAlgorithm::Eller);
+
+  // every algorithm's name, the default first
+  static QStringList algorithmNames();
+  void setAlgorithm(MazeAlgorithm algorithm);
+  MazeAlgorithm algorithm() const { return algorithm_; }
+  QString algorithmName() const;
 
-  void assignNewSets(int cols);
-  void mergeRandomRight(MazeData& maze, int row);
-  void createBottomPassages(MazeData& maze, int row, bool isLastRow);
-  void prepareNextRow(const MazeData& maze, int row);
+  void generate(MazeData& maze, int rows, int cols,
+                const RowDone& rowDone = {});
+
+  // same seed, same mazes; unseeded generators draw from a source per
+  // thread
+  void setSeed(quint32 seed);
+
+ private:
+  MazeAlgorithm algorithm_;
+  std::optional<quint32> seed_;
+  std::unique_ptr<MazeGenerator> impl_;
 };
@@ -1,11 +1,30 @@
 #include "asyncIOParser.h"
 
+#include <QDataStream>
 #include <QFile>
+#include <QFileInfo>
 #include <QFutureWatcher>
-#include <QTextStream>
-#include <QtConcurrent>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <memory>
+#include <sstream>
 
+#include "src/core/textCodec.h"
 #include "src/lib/model/maze.h"
+#include "src/lib/service/cache/gridPool.h"
+#include "src/lib/service/cave/caveEngine.h"
+#include "src/lib/service/ioParser/mazeImage.h"
+#include "src/lib/service/ioParser/tiledArchive.h"
+#include "src/lib/service/metrics/metrics.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+#include "src/lib/service/solver/solver.h"
+
+namespace {
+constexpr char kCaveMagic[] = "S21CAV";
+constexpr int kCaveMagicSize = 6;
+constexpr quint16 kCaveVersion = 1;
+}  // namespace
 
 AsyncIOParser::AsyncIOParser(QObject* parent) : QObject(parent) {}
 
@@ -14,72 +33,24 @@ ParseResult AsyncIOParser::parseMazeFile(const QString& filePath) {
   if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
     return {{}, "file not found: " + filePath};
   }
+  MAZE_COUNT(ParsedBytes, file.size());
+  return parseMaze(file);
+}
 
-  QTextStream in(&file);
+ParseResult AsyncIOParser::parseMaze(QIODevice& device) {
+  MAZE_SCOPED_TIMER(Parse);
+  QByteArray bytes = device.readAll();
+  std::istringstream in(std::string(bytes.constData(), size_t(bytes.size())));
 
   int rows = 0, cols = 0;
-  in >> rows >> cols;
-
-  if (in.status() != QTextStream::Ok) {
-    return {{}, "failed to read dimensions"};
-  }
-  if (rows <= 0 || cols <= 0 || rows > 50 || cols > 50) {
-    return {
-        {},
-        QString("invalid dimensions: %1x%2 (max 50x50)").arg(rows).arg(cols)};
-  }
-
-  MazeData maze;
-  maze.rows = rows;
-  maze.cols = cols;
-  maze.cells.assign(rows, std::vector<MazeCell>(cols, {false, false}));
-
-  // parse right walls matrix
-  for (int r = 0; r < rows; ++r) {
-    for (int c = 0; c < cols; ++c) {
-      int val;
-      in >> val;
-      if (in.status() != QTextStream::Ok) {
-        return {{},
-                QString("unexpected end of file at right wall [%1,%2]")
-                    .arg(r)
-                    .arg(c)};
-      }
-      if (val != 0 && val != 1) {
-        return {{},
-                QString("invalid value %1 at right wall [%2,%3]")
-                    .arg(val)
-                    .arg(r)
-                    .arg(c)};
-      }
-      maze.cells[r][c].rightWall = (val == 1);
-    }
-  }
-
-  // parse bottom walls matrix
-  for (int r = 0; r < rows; ++r) {
-    for (int c = 0; c < cols; ++c) {
-      int val;
-      in >> val;
-      if (in.status() != QTextStream::Ok) {
-        return {{},
-                QString("unexpected end of file at bottom wall [%1,%2]")
-                    .arg(r)
-                    .arg(c)};
-      }
-      if (val != 0 && val != 1) {
-        return {{},
-                QString("invalid value %1 at bottom wall [%2,%3]")
-                    .arg(val)
-                    .arg(r)
-                    .arg(c)};
-      }
-      maze.cells[r][c].bottomWall = (val == 1);
-    }
-  }
-
-  maze.isGenerated = true;
-  return {maze, {}};
+  std::string error = TextCodec::parseHeader(in, &rows, &cols);
+  if (!error.empty()) return {{}, QString::fromStdString(error)};
+
+  ParseResult result;
+  result.data = GridPool::instance().acquire(rows, cols, {false, false});
+  error = TextCodec::parseWalls(in, result.data, &result.validation);
+  if (!error.empty()) return {{}, QString::fromStdString(error)};
+  return result;
 }
 
 void AsyncIOParser::loadMazeAsync(const QUrl& fileUrl, MazeModel* model) {
@@ -112,7 +83,11 @@ void AsyncIOParser::loadMazeAsync(const QUrl& fileUrl, MazeModel* model) {
             watcher->deleteLater();
           });
 
-  currentLoadTask_ = QtConcurrent::run(&AsyncIOParser::parseMazeFile, filePath);
+  auto parse = isArchivePath(filePath) ? &AsyncIOParser::parseMazeArchive
+                                       : &AsyncIOParser::parseMazeFile;
+  currentLoadTask_ = TaskScheduler::instance().run(
+      TaskScheduler::Priority::BulkIO,
+      [parse, filePath]() { return parse(filePath); });
   watcher->setFuture(currentLoadTask_);
 }
 
@@ -127,39 +102,56 @@ SaveResult AsyncIOParser::writeMazeFile(const QString& filePath,
     return {"cannot open file for writing: " + filePath};
   }
 
-  QTextStream out(&file);
-
-  // write dimensions
-  out << maze.rows << " " << maze.cols << "\n";
+  SaveResult result = writeMaze(file, maze);
+  if (result.isValid()) MAZE_COUNT(WrittenBytes, file.size());
+  return result;
+}
 
-  // write right walls matrix
-  for (int r = 0; r < maze.rows; ++r) {
-    for (int c = 0; c < maze.cols; ++c) {
-      out << (maze.cells[r][c].rightWall ? 1 : 0);
-      if (c < maze.cols - 1) out << " ";
-    }
-    out << "\n";
+SaveResult AsyncIOParser::writeMaze(QIODevice& device, const MazeData& maze) {
+  MAZE_SCOPED_TIMER(Write);
+  if (!maze.isGenerated) {
+    return {"no maze data to save"};
   }
 
-  out << "\n";  // blank line separator
+  std::ostringstream out;
+  std::string error = TextCodec::write(out, maze);
+  if (!error.empty()) return {QString::fromStdString(error)};
 
-  // write bottom walls matrix
-  for (int r = 0; r < maze.rows; ++r) {
-    for (int c = 0; c < maze.cols; ++c) {
-      out << (maze.cells[r][c].bottomWall ? 1 : 0);
-      if (c < maze.cols - 1) out << " ";
-    }
-    out << "\n";
+  const std::string text = out.str();
+  if (device.write(text.data(), qint64(text.size())) != qint64(text.size())) {
+    return {"write error occurred"};
   }
+  return {};
+}
 
-  if (out.status() != QTextStream::Ok) {
-    return {"write error occurred"};
+ParseResult AsyncIOParser::parseMazeArchive(const QString& filePath) {
+  MAZE_SCOPED_TIMER(Parse);
+  TiledArchiveReader reader;
+  if (!reader.open(filePath)) {
+    return {{}, reader.error()};
   }
+  ParseResult result = reader.readAll();
+  MAZE_COUNT(ParsedBytes, QFileInfo(filePath).size());
+  if (result.isValid()) {
+    result.validation = MazeValidator::validate(result.data);
+  }
+  return result;
+}
 
-  return {};
+SaveResult AsyncIOParser::writeMazeArchive(const QString& filePath,
+                                           const MazeData& maze) {
+  MAZE_SCOPED_TIMER(Write);
+  SaveResult result = TiledArchive::write(filePath, maze);
+  if (result.isValid()) MAZE_COUNT(WrittenBytes, QFileInfo(filePath).size());
+  return result;
+}
+
+bool AsyncIOParser::isArchivePath(const QString& filePath) {
+  return QFileInfo(filePath).suffix().toLower() == "mza";
 }
 
-void AsyncIOParser::saveMazeAsync(const QUrl& fileUrl, MazeModel* model) {
+void AsyncIOParser::saveMazeAsync(const QUrl& fileUrl, MazeModel* model,
+                                  Solver* solver) {
   if (!model) {
     emit savingFinished(false, "null model");
     return;
@@ -176,26 +168,20 @@ void AsyncIOParser::saveMazeAsync(const QUrl& fileUrl, MazeModel* model) {
     return;
   }
 
+  // text mazes are only read back up to TextCodec::kMaxSide
+  if (!MazeImage::isImagePath(filePath) && !isArchivePath(filePath) &&
+      (model->rows() > TextCodec::kMaxSide ||
+       model->cols() > TextCodec::kMaxSide)) {
+    emit savingFinished(false, QString("text mazes above %1x%1 can't be "
+                                       "loaded back, save as .mza")
+                                   .arg(TextCodec::kMaxSide));
+    return;
+  }
+
   emit savingStarted();
 
-  // capture maze data for the async task
-  MazeData mazeData;
-  mazeData.rows = model->rows();
-  mazeData.cols = model->cols();
-  mazeData.isGenerated = true;
-  mazeData.cells.resize(mazeData.rows);
-
-  for (int r = 0; r < mazeData.rows; ++r) {
-    mazeData.cells[r].resize(mazeData.cols);
-    for (int c = 0; c < mazeData.cols; ++c) {
-      int idx = r * mazeData.cols + c;
-      QModelIndex modelIdx = model->index(idx);
-      mazeData.cells[r][c].rightWall =
-          model->data(modelIdx, MazeModel::RightWallRole).toBool();
-      mazeData.cells[r][c].bottomWall =
-          model->data(modelIdx, MazeModel::BottomWallRole).toBool();
-    }
-  }
+  // edits made while it is written copy the maze, the task keeps this one
+  std::shared_ptr<const MazeData> maze = model->snapshot();
 
   auto* watcher = new QFutureWatcher<SaveResult>(this);
 
@@ -206,7 +192,169 @@ void AsyncIOParser::saveMazeAsync(const QUrl& fileUrl, MazeModel* model) {
             watcher->deleteLater();
           });
 
-  currentSaveTask_ =
-      QtConcurrent::run(&AsyncIOParser::writeMazeFile, filePath, mazeData);
+  MazeImageOptions image;
+  if (solver) image.path = solver->currentPath();
+  currentSaveTask_ = TaskScheduler::instance().run(
+      TaskScheduler::Priority::BulkIO,
+      [filePath, maze = std::move(maze), image = std::move(image)]() {
+        return MazeImage::isImagePath(filePath)
+                   ? MazeImage::write(filePath, *maze, image)
+               : isArchivePath(filePath) ? writeMazeArchive(filePath, *maze)
+                                         : writeMazeFile(filePath, *maze);
+      });
   watcher->setFuture(currentSaveTask_);
 }
+
+CaveParseResult AsyncIOParser::parseCaveFile(const QString& filePath) {
+  MAZE_SCOPED_TIMER(Parse);
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return {{}, {}, "file not found: " + filePath};
+  }
+
+  QDataStream in(&file);
+  in.setByteOrder(QDataStream::LittleEndian);
+  char magic[kCaveMagicSize];
+  quint16 version = 0;
+  quint32 rows = 0, cols = 0;
+  CaveRule rule;
+  in.readRawData(magic, kCaveMagicSize);
+  in >> version >> rows >> cols >> rule.birth >> rule.survival;
+
+  if (in.status() != QDataStream::Ok ||
+      !std::equal(magic, magic + kCaveMagicSize, kCaveMagic)) {
+    return {{}, {}, "not a cave file"};
+  }
+  if (version != kCaveVersion) {
+    return {{}, {}, QString("unsupported cave version %1").arg(version)};
+  }
+  if (rows == 0 || cols == 0 || rows > CaveGrid::kMaxDimension ||
+      cols > CaveGrid::kMaxDimension || rule.birth > 0x1ff ||
+      rule.survival > 0x1ff) {
+    return {{},
+            {},
+            QString("invalid cave: %1x%2 (max %3x%3)")
+                .arg(rows)
+                .arg(cols)
+                .arg(CaveGrid::kMaxDimension)};
+  }
+
+  // checked before the grid is allocated, a header alone can't claim it
+  qint64 rowBytes = qint64((cols + CaveGrid::kWordBits - 1) /
+                           CaveGrid::kWordBits) *
+                    sizeof(quint64);
+  if (file.size() != file.pos() + rowBytes * rows) {
+    return {{}, {}, "cave file size does not match its dimensions"};
+  }
+  CaveGrid grid(static_cast<int>(rows), static_cast<int>(cols));
+  for (int r = 0; r < grid.rows(); ++r) {
+    quint64* words = grid.row(r);
+    if (in.readRawData(reinterpret_cast<char*>(words), int(rowBytes)) !=
+        rowBytes) {
+      return {{}, {}, QString("unexpected end of file at row %1").arg(r)};
+    }
+    qFromLittleEndian<quint64>(words, grid.wordsPerRow(), words);
+    words[grid.wordsPerRow() - 1] &= grid.lastWordMask();
+  }
+  MAZE_COUNT(ParsedBytes, file.size());
+  return {std::move(grid), rule, {}};
+}
+
+SaveResult AsyncIOParser::writeCaveFile(const QString& filePath,
+                                        const CaveGrid& grid,
+                                        const CaveRule& rule) {
+  MAZE_SCOPED_TIMER(Write);
+  if (grid.isEmpty()) {
+    return {"no cave to save"};
+  }
+
+  QSaveFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return {"cannot open file for writing: " + filePath};
+  }
+
+  QDataStream out(&file);
+  out.setByteOrder(QDataStream::LittleEndian);
+  out.writeRawData(kCaveMagic, kCaveMagicSize);
+  out << kCaveVersion << quint32(grid.rows()) << quint32(grid.cols())
+      << rule.birth << rule.survival;
+
+  std::vector<quint64> words(grid.wordsPerRow());
+  int rowBytes = int(words.size() * sizeof(quint64));
+  for (int r = 0; r < grid.rows(); ++r) {
+    qToLittleEndian<quint64>(grid.row(r), grid.wordsPerRow(), words.data());
+    out.writeRawData(reinterpret_cast<const char*>(words.data()), rowBytes);
+  }
+
+  qint64 written = file.size();
+  if (out.status() != QDataStream::Ok || !file.commit()) {
+    return {"write error occurred"};
+  }
+  MAZE_COUNT(WrittenBytes, written);
+  return {};
+}
+
+void AsyncIOParser::loadCaveAsync(const QUrl& fileUrl, CaveEngine* engine) {
+  if (!engine) {
+    emit caveLoadingFinished(false, "null cave engine");
+    return;
+  }
+
+  QString filePath = fileUrl.toLocalFile();
+  if (filePath.isEmpty()) {
+    emit caveLoadingFinished(false, "invalid file URL");
+    return;
+  }
+
+  emit caveLoadingStarted();
+
+  auto* watcher = new QFutureWatcher<CaveParseResult>(this);
+  connect(watcher, &QFutureWatcher<CaveParseResult>::finished, this,
+          [this, engine, watcher]() {
+            CaveParseResult result = watcher->result();
+            if (result.isValid()) {
+              engine->setCaveRule(result.rule);
+              engine->setGrid(std::move(result.grid));
+              emit caveLoadingFinished(true, {});
+            } else {
+              emit caveLoadingFinished(false, result.error);
+            }
+            watcher->deleteLater();
+          });
+
+  currentCaveLoadTask_ = TaskScheduler::instance().run(
+      TaskScheduler::Priority::BulkIO,
+      [filePath]() { return parseCaveFile(filePath); });
+  watcher->setFuture(currentCaveLoadTask_);
+}
+
+void AsyncIOParser::saveCaveAsync(const QUrl& fileUrl, CaveEngine* engine) {
+  if (!engine || engine->grid().isEmpty()) {
+    emit caveSavingFinished(false, "no cave to save");
+    return;
+  }
+
+  QString filePath = fileUrl.toLocalFile();
+  if (filePath.isEmpty()) {
+    emit caveSavingFinished(false, "invalid file URL");
+    return;
+  }
+
+  emit caveSavingStarted();
+
+  auto* watcher = new QFutureWatcher<SaveResult>(this);
+  connect(watcher, &QFutureWatcher<SaveResult>::finished, this,
+          [this, watcher]() {
+            SaveResult result = watcher->result();
+            emit caveSavingFinished(result.isValid(), result.error);
+            watcher->deleteLater();
+          });
+
+  // the engine keeps stepping meanwhile, the task writes a snapshot
+  currentCaveSaveTask_ = TaskScheduler::instance().run(
+      TaskScheduler::Priority::BulkIO,
+      [filePath, grid = engine->grid(), rule = engine->caveRule()]() {
+        return writeCaveFile(filePath, grid, rule);
+      });
+  watcher->setFuture(currentCaveSaveTask_);
+}
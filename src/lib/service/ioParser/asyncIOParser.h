@@ -5,13 +5,27 @@
 #include <QString>
 #include <QUrl>
 
+#include "src/core/validator.h"
 #include "src/lib/model/maze.h"
+#include "src/lib/service/cave/caveGrid.h"
 
+class CaveEngine;
 class MazeModel;
+class QIODevice;
+class Solver;
 
 struct ParseResult {
   MazeData data;
   QString error;
+  MazeValidation validation;  // filled in while parsing
+
+  bool isValid() const { return error.isEmpty(); }
+};
+
+struct CaveParseResult {
+  CaveGrid grid;
+  CaveRule rule;
+  QString error;
 
   bool isValid() const { return error.isEmpty(); }
 };
@@ -28,20 +42,46 @@ class AsyncIOParser : public QObject {
   explicit AsyncIOParser(QObject* parent = nullptr);
 
   Q_INVOKABLE void loadMazeAsync(const QUrl& fileUrl, MazeModel* model);
-  Q_INVOKABLE void saveMazeAsync(const QUrl& fileUrl, MazeModel* model);
+  // *.png and *.svg save a picture, with the solver's path if given
+  Q_INVOKABLE void saveMazeAsync(const QUrl& fileUrl, MazeModel* model,
+                                 Solver* solver = nullptr);
+  Q_INVOKABLE void loadCaveAsync(const QUrl& fileUrl, CaveEngine* engine);
+  Q_INVOKABLE void saveCaveAsync(const QUrl& fileUrl, CaveEngine* engine);
 
   // sync versions for testing
   static ParseResult parseMazeFile(const QString& filePath);
   static SaveResult writeMazeFile(const QString& filePath,
                                   const MazeData& maze);
+  // text format on an already open device (pipes, sockets, buffers)
+  static ParseResult parseMaze(QIODevice& device);
+  static SaveResult writeMaze(QIODevice& device, const MazeData& maze);
+
+  // tiled compressed archive (*.mza), see tiledArchive.h
+  static ParseResult parseMazeArchive(const QString& filePath);
+  static SaveResult writeMazeArchive(const QString& filePath,
+                                     const MazeData& maze);
+  static bool isArchivePath(const QString& filePath);
+
+  // bit-packed cave (*.cave), all integers little-endian: "S21CAV",
+  // u16 version, u32 rows, u32 cols, u16 birth, u16 survival, then the
+  // grid's 64-bit words row by row
+  static CaveParseResult parseCaveFile(const QString& filePath);
+  static SaveResult writeCaveFile(const QString& filePath,
+                                  const CaveGrid& grid, const CaveRule& rule);
 
  signals:
   void loadingStarted();
   void loadingFinished(bool success, const QString& errorMsg);
   void savingStarted();
   void savingFinished(bool success, const QString& errorMsg);
+  void caveLoadingStarted();
+  void caveLoadingFinished(bool success, const QString& errorMsg);
+  void caveSavingStarted();
+  void caveSavingFinished(bool success, const QString& errorMsg);
 
  private:
   QFuture<ParseResult> currentLoadTask_;
   QFuture<SaveResult> currentSaveTask_;
+  QFuture<CaveParseResult> currentCaveLoadTask_;
+  QFuture<SaveResult> currentCaveSaveTask_;
 };
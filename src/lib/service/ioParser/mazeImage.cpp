@@ -0,0 +1,604 @@
+#include "mazeImage.h"
+
+#include <zlib.h>
+
+#include <QIODevice>
+#include <QSaveFile>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/metrics/metrics.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+
+namespace {
+// palette indices of the PNG
+constexpr std::uint8_t kBackground = 0;
+constexpr std::uint8_t kWall = 1;
+constexpr std::uint8_t kPath = 2;
+constexpr unsigned char kPalette[] = {0xff, 0xff, 0xff, 0x00, 0x00,
+                                      0x00, 0xe7, 0x4c, 0x3c};
+constexpr char kPathColor[] = "#e74c3c";
+
+// uncompressed bytes (PNG) or cells (SVG) per strip, the unit of work
+constexpr qint64 kStripBytes = qint64(1) << 20;
+constexpr qint64 kSvgStripCells = qint64(1) << 17;
+
+// PNG filter types
+constexpr std::uint8_t kFilterNone = 0;
+constexpr std::uint8_t kFilterUp = 2;
+
+// directions the path leaves a cell in
+enum : std::uint8_t { kUp = 1, kDown = 2, kLeft = 4, kRight = 8 };
+
+struct PathCell {
+  qint64 id;  // row * cols + col
+  std::uint8_t exits;
+
+  bool operator<(const PathCell& other) const { return id < other.id; }
+};
+
+// Pixel geometry shared by both formats. Grid line k of either direction
+// starts at k * cell and is wall pixels thick; a cell's inside follows.
+struct Layout {
+  const MazeData& maze;
+  int cell;
+  int wall;
+  int pathWidth;
+  int pathOffset;  // from a grid line to the path square
+  int width;
+  int height;
+
+  Layout(const MazeData& maze, const MazeImageOptions& options)
+      : maze(maze),
+        cell(options.cellSize),
+        wall(options.wallWidth),
+        pathWidth(options.pathWidth > 0
+                      ? options.pathWidth
+                      : std::max(1, (options.cellSize - options.wallWidth) /
+                                        3)),
+        pathOffset(wall + (cell - wall - pathWidth) / 2),
+        width(int(qint64(maze.cols) * cell + wall)),
+        height(int(qint64(maze.rows) * cell + wall)) {}
+
+  // wall on horizontal line `line` (0 top, rows bottom) over column c
+  bool horizontal(int line, int c) const {
+    return line == 0 || line == maze.rows ||
+           maze.cells[line - 1][c].bottomWall;
+  }
+  // wall on vertical line `line` (0 left, cols right) beside row r
+  bool vertical(int r, int line) const {
+    return line == 0 || line == maze.cols ||
+           maze.cells[r][line - 1].rightWall;
+  }
+  // drawn when a wall ends in it, so open crossings stay open
+  bool corner(int hline, int vline) const {
+    return (vline > 0 && horizontal(hline, vline - 1)) ||
+           (vline < maze.cols && horizontal(hline, vline)) ||
+           (hline > 0 && vertical(hline - 1, vline)) ||
+           (hline < maze.rows && vertical(hline, vline));
+  }
+};
+
+QString checkOptions(const MazeData& maze, const MazeImageOptions& options) {
+  if (!maze.isGenerated || maze.rows <= 0 || maze.cols <= 0) {
+    return "no maze data to save";
+  }
+  if (options.cellSize < 2 || options.cellSize > MazeImage::kMaxCellSize) {
+    return QString("invalid cell size: %1 (2 to %2)")
+        .arg(options.cellSize)
+        .arg(MazeImage::kMaxCellSize);
+  }
+  if (options.wallWidth < 1 || options.wallWidth >= options.cellSize) {
+    return QString("invalid wall width: %1 (1 to %2)")
+        .arg(options.wallWidth)
+        .arg(options.cellSize - 1);
+  }
+  if (options.pathWidth < 0 ||
+      options.pathWidth > options.cellSize - options.wallWidth) {
+    return QString("invalid path width: %1 (1 to %2)")
+        .arg(options.pathWidth)
+        .arg(options.cellSize - options.wallWidth);
+  }
+  qint64 side = qint64(std::max(maze.rows, maze.cols)) * options.cellSize +
+                options.wallWidth;
+  if (side > MazeImage::kMaxSide) {
+    return QString("image side of %1 pixels is over %2")
+        .arg(side)
+        .arg(MazeImage::kMaxSide);
+  }
+  for (const QPoint& p : options.path) {
+    if (p.x() < 0 || p.x() >= maze.rows || p.y() < 0 || p.y() >= maze.cols) {
+      return QString("path cell %1,%2 is outside the maze")
+          .arg(p.x())
+          .arg(p.y());
+    }
+  }
+  return {};
+}
+
+// path cells with their exits, sorted by id; consecutive cells that are
+// not neighbours start a new piece
+std::vector<PathCell> pathCells(const std::vector<QPoint>& path, int cols) {
+  std::vector<PathCell> cells;
+  cells.reserve(path.size());
+  for (size_t i = 0; i < path.size(); ++i) {
+    std::uint8_t exits = 0;
+    for (size_t j : {i - 1, i + 1}) {
+      if (j >= path.size()) continue;  // wraps for i - 1 at 0
+      QPoint d = path[j] - path[i];
+      if (d == QPoint(-1, 0)) exits |= kUp;
+      if (d == QPoint(1, 0)) exits |= kDown;
+      if (d == QPoint(0, -1)) exits |= kLeft;
+      if (d == QPoint(0, 1)) exits |= kRight;
+    }
+    cells.push_back({qint64(path[i].x()) * cols + path[i].y(), exits});
+  }
+  std::sort(cells.begin(), cells.end());
+  // a cell visited twice keeps the exits of both visits
+  size_t kept = 0;
+  for (size_t i = 0; i < cells.size(); ++i) {
+    if (kept > 0 && cells[kept - 1].id == cells[i].id) {
+      cells[kept - 1].exits |= cells[i].exits;
+    } else {
+      cells[kept++] = cells[i];
+    }
+  }
+  cells.resize(kept);
+  return cells;
+}
+
+// --- PNG ---
+
+// Pixels of one cell's width in a row: the grid line part and the rest,
+// each wall or background. Cells up to kStampBytes wide are copied with a
+// fixed size, a single store, the tail overwritten by the next cell.
+constexpr int kStampBytes = 16;
+
+struct Stamps {
+  std::uint8_t pixels[4][MazeImage::kMaxCellSize + kStampBytes]{};
+
+  explicit Stamps(const Layout& l) {
+    for (int k = 0; k < 4; ++k) {
+      std::memset(pixels[k], k & 2 ? kWall : kBackground, size_t(l.wall));
+      std::memset(pixels[k] + l.wall, k & 1 ? kWall : kBackground,
+                  size_t(l.cell - l.wall));
+    }
+  }
+};
+
+// one pixel per byte, px has kStampBytes to spare past the padded row;
+// y is a grid line row or inside row r
+void wallRow(const Layout& l, const Stamps& stamps, int y, int padded,
+             std::uint8_t* px) {
+  const int r = y / l.cell;
+  const int cols = l.maze.cols;
+  const bool lineRow = y - r * l.cell < l.wall;
+  auto stamp = [&](auto kind, auto bytes) {
+    for (int c = 0; c < cols; ++c) {
+      std::memcpy(px + qint64(c) * l.cell, stamps.pixels[kind(c)],
+                  size_t(bytes));
+    }
+  };
+  auto kind = [&](int c) {
+    return lineRow ? 2 * l.corner(r, c) + l.horizontal(r, c)
+                   : 2 * l.vertical(r, c);
+  };
+  if (l.cell <= kStampBytes) {
+    stamp(kind, std::integral_constant<int, kStampBytes>());
+  } else {
+    stamp(kind, l.cell);
+  }
+  // the right border, then background up to the padding
+  std::memset(px + qint64(cols) * l.cell, kWall, size_t(l.wall));
+  std::memset(px + l.width, kBackground, size_t(padded - l.width));
+}
+
+// Paints the path over row y: a square in each path cell and arms towards
+// its exits that cross the grid line into the next cell. Cells are those
+// of rows r - 1 and r, whose arms can reach y.
+void pathRow(const Layout& l, const PathCell* first, const PathCell* last,
+             int y, std::uint8_t* px) {
+  const int r = y / l.cell;
+  const bool lineRow = y - r * l.cell < l.wall;
+  auto paint = [&](qint64 x0, qint64 x1) {
+    std::memset(px + x0, kPath, size_t(x1 - x0));
+  };
+  for (const PathCell* p = first; p != last; ++p) {
+    const int row = int(p->id / l.maze.cols);
+    const int col = int(p->id % l.maze.cols);
+    const qint64 x = qint64(col) * l.cell;
+    const qint64 px0 = x + l.pathOffset;
+    const qint64 py0 = qint64(row) * l.cell + l.pathOffset;
+    if (row < r) {
+      if (lineRow && (p->exits & kDown)) paint(px0, px0 + l.pathWidth);
+    } else if (y >= py0 && y < py0 + l.pathWidth) {
+      paint(p->exits & kLeft ? x : px0,
+            p->exits & kRight ? x + l.cell + l.wall : px0 + l.pathWidth);
+    } else if (p->exits & (y < py0 ? kUp : kDown)) {
+      paint(px0, px0 + l.pathWidth);
+    }
+  }
+}
+
+// four pixels of two bits per byte, px padded to a multiple of four
+void packRow(const std::uint8_t* px, int bytes, std::uint8_t* out) {
+  for (int i = 0; i < bytes; ++i, px += 4) {
+    out[i] = std::uint8_t(px[0] << 6 | px[1] << 4 | px[2] << 2 | px[3]);
+  }
+}
+
+struct PngStrip {
+  std::vector<std::uint8_t> raw;  // filter byte and packed pixels per row
+  std::vector<std::uint8_t> deflated;
+  uLong adler{0};
+  bool ok{false};
+};
+
+// Rows [y0, y1) with their filter bytes. The first row is unfiltered so
+// strips don't depend on each other; the rest use the Up filter, which
+// turns a row repeating the one above into zeros whatever its width.
+void renderStrip(const Layout& l, const std::vector<PathCell>& path, int y0,
+                 int y1, std::vector<std::uint8_t>& raw) {
+  const int bytes = (l.width + 3) / 4;
+  const qint64 stride = 1 + qint64(bytes);
+  raw.resize(size_t((y1 - y0) * stride));
+
+  const Stamps stamps(l);
+  std::vector<std::uint8_t> base(size_t(bytes) * 4 + kStampBytes, kBackground);
+  std::vector<std::uint8_t> painted(base.size(), kBackground);
+  std::vector<std::uint8_t> prev(static_cast<size_t>(bytes));
+  std::vector<std::uint8_t> cur(prev.size());
+  int baseKey = -1;  // row kind in base, 2 * r + grid line
+  int prevKey = -1;  // row kind of prev, -1 when it had path pixels
+
+  for (int y = y0; y < y1; ++y) {
+    const int r = y / l.cell;
+    const int key = 2 * r + (y - r * l.cell < l.wall ? 1 : 0);
+    std::uint8_t* out = raw.data() + (y - y0) * stride;
+
+    auto first = std::lower_bound(path.begin(), path.end(),
+                                  PathCell{qint64(r - 1) * l.maze.cols, 0});
+    auto last = std::lower_bound(first, path.end(),
+                                 PathCell{qint64(r + 1) * l.maze.cols, 0});
+    if (first == last && key == prevKey && y > y0) {
+      out[0] = kFilterUp;
+      std::memset(out + 1, 0, size_t(bytes));
+      continue;
+    }
+
+    if (key != baseKey) {
+      wallRow(l, stamps, y, bytes * 4, base.data());
+      baseKey = key;
+    }
+    if (first != last) {
+      std::memcpy(painted.data(), base.data(), base.size());
+      pathRow(l, &*first, &*first + (last - first), y, painted.data());
+      packRow(painted.data(), bytes, cur.data());
+      prevKey = -1;
+    } else {
+      packRow(base.data(), bytes, cur.data());
+      prevKey = key;
+    }
+
+    if (y == y0) {
+      out[0] = kFilterNone;
+      std::memcpy(out + 1, cur.data(), size_t(bytes));
+    } else {
+      out[0] = kFilterUp;
+      for (int i = 0; i < bytes; ++i) {
+        out[1 + i] = std::uint8_t(cur[i] - prev[i]);
+      }
+    }
+    std::swap(prev, cur);
+  }
+}
+
+// raw deflate of one strip, ended on a byte boundary (or the final block)
+bool deflateStrip(PngStrip& strip, bool last) {
+  z_stream stream{};
+  if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return false;
+  }
+  strip.deflated.resize(deflateBound(&stream, uLong(strip.raw.size())) + 16);
+  stream.next_in = strip.raw.data();
+  stream.avail_in = uInt(strip.raw.size());
+  stream.next_out = strip.deflated.data();
+  stream.avail_out = uInt(strip.deflated.size());
+  int status = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+  bool ok = stream.avail_in == 0 &&
+            (last ? status == Z_STREAM_END : status == Z_OK);
+  strip.deflated.resize(strip.deflated.size() - stream.avail_out);
+  deflateEnd(&stream);
+  return ok;
+}
+
+void putBigEndian(std::uint8_t* out, quint32 value) {
+  out[0] = std::uint8_t(value >> 24);
+  out[1] = std::uint8_t(value >> 16);
+  out[2] = std::uint8_t(value >> 8);
+  out[3] = std::uint8_t(value);
+}
+
+bool writeChunk(QIODevice& device, const char type[4],
+                const std::uint8_t* data, size_t size) {
+  std::uint8_t header[8];
+  putBigEndian(header, quint32(size));
+  std::memcpy(header + 4, type, 4);
+  uLong crc = crc32(0, header + 4, 4);
+  // a null buffer would reset the checksum
+  if (size > 0) crc = crc32(crc, data, uInt(size));
+  std::uint8_t trailer[4];
+  putBigEndian(trailer, quint32(crc));
+  return device.write(reinterpret_cast<const char*>(header), 8) == 8 &&
+         device.write(reinterpret_cast<const char*>(data), qint64(size)) ==
+             qint64(size) &&
+         device.write(reinterpret_cast<const char*>(trailer), 4) == 4;
+}
+
+// --- SVG ---
+
+void appendInt(std::string& out, qint64 value) {
+  char buffer[24];
+  auto end = std::to_chars(buffer, buffer + sizeof buffer, value).ptr;
+  out.append(buffer, end);
+}
+
+// half pixels, for centres of odd widths
+void appendHalves(std::string& out, qint64 halves) {
+  appendInt(out, halves / 2);
+  if (halves % 2) out += ".5";
+}
+
+// rectangles as closed subpaths, each moved to relative to the one before
+// (where the previous close left the pen), the first one absolute
+struct RectWriter {
+  std::string& out;
+  bool first{true};
+  qint64 x{0};
+  qint64 y{0};
+
+  void add(qint64 left, qint64 top, qint64 w, qint64 h) {
+    out += first ? 'M' : 'm';
+    appendInt(out, left - x);
+    out += ' ';
+    appendInt(out, top - y);
+    out += 'h';
+    appendInt(out, w);
+    out += 'v';
+    appendInt(out, h);
+    out += 'h';
+    appendInt(out, -w);
+    out += 'z';
+    first = false;
+    x = left;
+    y = top;
+  }
+};
+
+// Walls of cell rows [r0, r1) as rectangles: the horizontal lines above
+// those rows (and the bottom border in the last strip) and the vertical
+// lines beside them, consecutive walls merged into one run each.
+void svgStrip(const Layout& l, int r0, int r1, std::string& out) {
+  const int rows = l.maze.rows;
+  const int cols = l.maze.cols;
+  RectWriter rects{out};
+  for (int line = r0; line < r1 || (line == rows && r1 == rows); ++line) {
+    for (int c = 0; c < cols;) {
+      if (!l.horizontal(line, c)) {
+        ++c;
+        continue;
+      }
+      int start = c;
+      while (c < cols && l.horizontal(line, c)) ++c;
+      rects.add(qint64(start) * l.cell, qint64(line) * l.cell,
+                qint64(c - start) * l.cell + l.wall, l.wall);
+    }
+  }
+  for (int line = 0; line <= cols; ++line) {
+    for (int r = r0; r < r1;) {
+      if (!l.vertical(r, line)) {
+        ++r;
+        continue;
+      }
+      int start = r;
+      while (r < r1 && l.vertical(r, line)) ++r;
+      rects.add(qint64(line) * l.cell, qint64(start) * l.cell, l.wall,
+                qint64(r - start) * l.cell + l.wall);
+    }
+  }
+  out += '\n';
+}
+
+bool writeString(QIODevice& device, const std::string& text) {
+  return device.write(text.data(), qint64(text.size())) ==
+         qint64(text.size());
+}
+
+// the path as one stroke through the centres of its squares, straight
+// stretches as single segments
+bool svgPath(QIODevice& device, const Layout& l,
+             const std::vector<QPoint>& path) {
+  std::string out;
+  out += "<path fill=\"none\" stroke=\"";
+  out += kPathColor;
+  out += "\" stroke-width=\"";
+  appendInt(out, l.pathWidth);
+  out += "\" stroke-linecap=\"square\" d=\"";
+
+  auto centre = [&](int index) {
+    return 2 * qint64(index) * l.cell + 2 * l.pathOffset + l.pathWidth;
+  };
+  for (size_t i = 0; i < path.size(); ++i) {
+    const QPoint p = path[i];
+    const bool joined =
+        i > 0 && (p - path[i - 1]).manhattanLength() == 1;
+    const bool continues =
+        i + 1 < path.size() && (path[i + 1] - p).manhattanLength() == 1;
+    if (!joined) {
+      out += 'M';
+      appendHalves(out, centre(p.y()));
+      out += ' ';
+      appendHalves(out, centre(p.x()));
+      // a lone cell still needs a segment for its square cap
+      if (!continues) out += "h0";
+    } else if (!continues || path[i + 1] - p != p - path[i - 1]) {
+      const bool vertical = p.x() != path[i - 1].x();
+      out += vertical ? 'V' : 'H';
+      appendHalves(out, centre(vertical ? p.x() : p.y()));
+    }
+
+    if (qint64(out.size()) >= kStripBytes) {
+      if (!writeString(device, out)) return false;
+      out.clear();
+    }
+  }
+  out += "\"/>\n";
+  return writeString(device, out);
+}
+
+int windowSize() {
+  return std::max(1, TaskScheduler::instance().threadCount()) * 2;
+}
+}  // namespace
+
+bool MazeImage::isImagePath(const QString& filePath) {
+  return filePath.endsWith(".png", Qt::CaseInsensitive) ||
+         filePath.endsWith(".svg", Qt::CaseInsensitive);
+}
+
+SaveResult MazeImage::write(const QString& filePath, const MazeData& maze,
+                            const MazeImageOptions& options) {
+  MAZE_SCOPED_TIMER(Write);
+  if (!isImagePath(filePath)) {
+    return {"not a .png or .svg file: " + filePath};
+  }
+  QString error = checkOptions(maze, options);
+  if (!error.isEmpty()) return {error};
+
+  QSaveFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return {"cannot open file for writing: " + filePath};
+  }
+  SaveResult result = filePath.endsWith(".png", Qt::CaseInsensitive)
+                          ? writePng(file, maze, options)
+                          : writeSvg(file, maze, options);
+  if (!result.isValid()) return result;
+  qint64 written = file.size();
+  if (!file.commit()) return {"write error occurred"};
+  MAZE_COUNT(WrittenBytes, written);
+  return {};
+}
+
+SaveResult MazeImage::writePng(QIODevice& device, const MazeData& maze,
+                               const MazeImageOptions& options) {
+  QString error = checkOptions(maze, options);
+  if (!error.isEmpty()) return {error};
+  const Layout layout(maze, options);
+  const std::vector<PathCell> path = pathCells(options.path, maze.cols);
+
+  static constexpr std::uint8_t kSignature[] = {0x89, 'P',  'N',  'G',
+                                                '\r', '\n', 0x1a, '\n'};
+  std::uint8_t header[13];
+  putBigEndian(header, quint32(layout.width));
+  putBigEndian(header + 4, quint32(layout.height));
+  header[8] = 2;  // bits per pixel
+  header[9] = 3;  // palette
+  header[10] = header[11] = header[12] = 0;
+  // zlib header: deflate with a 32K window, no dictionary
+  static constexpr std::uint8_t kZlibHeader[] = {0x78, 0x01};
+  if (device.write(reinterpret_cast<const char*>(kSignature), 8) != 8 ||
+      !writeChunk(device, "IHDR", header, sizeof header) ||
+      !writeChunk(device, "PLTE", kPalette, sizeof kPalette) ||
+      !writeChunk(device, "IDAT", kZlibHeader, sizeof kZlibHeader)) {
+    return {"write error occurred"};
+  }
+
+  const qint64 stride = 1 + qint64(layout.width + 3) / 4;
+  const int stripRows =
+      int(std::clamp<qint64>(kStripBytes / stride, 1, layout.height));
+  const int strips = (layout.height + stripRows - 1) / stripRows;
+  std::vector<PngStrip> window(size_t(std::min(windowSize(), strips)));
+  const uLong kAdlerStart = adler32(0, nullptr, 0);
+  uLong adler = kAdlerStart;
+
+  for (int first = 0; first < strips; first += int(window.size())) {
+    const int count = std::min(int(window.size()), strips - first);
+    TaskScheduler::instance().parallelFor(count, [&](qsizetype i) {
+      const int s = first + int(i);
+      PngStrip& strip = window[i];
+      const int y0 = s * stripRows;
+      renderStrip(layout, path, y0, std::min(y0 + stripRows, layout.height),
+                  strip.raw);
+      strip.adler = adler32(kAdlerStart, strip.raw.data(),
+                            uInt(strip.raw.size()));
+      strip.ok = deflateStrip(strip, s == strips - 1);
+    });
+
+    for (int i = 0; i < count; ++i) {
+      const PngStrip& strip = window[i];
+      if (!strip.ok) return {"compression failed"};
+      adler = adler32_combine(adler, strip.adler, z_off_t(strip.raw.size()));
+      if (!writeChunk(device, "IDAT", strip.deflated.data(),
+                      strip.deflated.size())) {
+        return {"write error occurred"};
+      }
+    }
+  }
+
+  std::uint8_t trailer[4];
+  putBigEndian(trailer, quint32(adler));
+  if (!writeChunk(device, "IDAT", trailer, sizeof trailer) ||
+      !writeChunk(device, "IEND", nullptr, 0)) {
+    return {"write error occurred"};
+  }
+  return {};
+}
+
+SaveResult MazeImage::writeSvg(QIODevice& device, const MazeData& maze,
+                               const MazeImageOptions& options) {
+  QString error = checkOptions(maze, options);
+  if (!error.isEmpty()) return {error};
+  const Layout layout(maze, options);
+
+  std::string head = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"";
+  appendInt(head, layout.width);
+  head += "\" height=\"";
+  appendInt(head, layout.height);
+  head += "\" viewBox=\"0 0 ";
+  appendInt(head, layout.width);
+  head += ' ';
+  appendInt(head, layout.height);
+  head += "\" shape-rendering=\"crispEdges\">\n<rect width=\"100%\" "
+          "height=\"100%\" fill=\"#fff\"/>\n<path fill=\"#000\" d=\"\n";
+  if (!writeString(device, head)) return {"write error occurred"};
+
+  const int stripRows =
+      int(std::clamp<qint64>(kSvgStripCells / maze.cols, 1, maze.rows));
+  const int strips = (maze.rows + stripRows - 1) / stripRows;
+  std::vector<std::string> window(size_t(std::min(windowSize(), strips)));
+
+  for (int first = 0; first < strips; first += int(window.size())) {
+    const int count = std::min(int(window.size()), strips - first);
+    TaskScheduler::instance().parallelFor(count, [&](qsizetype i) {
+      const int r0 = (first + int(i)) * stripRows;
+      window[i].clear();
+      svgStrip(layout, r0, std::min(r0 + stripRows, maze.rows), window[i]);
+    });
+    for (int i = 0; i < count; ++i) {
+      if (!writeString(device, window[i])) return {"write error occurred"};
+    }
+  }
+
+  if (!writeString(device, "\"/>\n") ||
+      (!options.path.empty() && !svgPath(device, layout, options.path)) ||
+      !writeString(device, "</svg>\n")) {
+    return {"write error occurred"};
+  }
+  return {};
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QPoint>
+#include <QString>
+#include <vector>
+
+#include "src/lib/service/ioParser/asyncIOParser.h"
+
+class QIODevice;
+
+struct MazeImageOptions {
+  int cellSize{8};  // pixels from one wall line to the next
+  int wallWidth{1};
+  int pathWidth{0};  // 0 picks a third of the space between walls
+  // {row, col} cells as the solver returns them, drawn over the maze
+  std::vector<QPoint> path;
+};
+
+// Pictures of a maze: a 2-bit palette PNG or an SVG of filled wall runs.
+//
+// Both are produced in horizontal strips straight from the walls, a
+// window of strips at a time on the scheduler, and written in order as
+// they finish, so memory stays bounded by the window however large the
+// image. PNG strips are deflated independently and flushed to a byte
+// boundary, which lets them be joined into one zlib stream; the Adler-32
+// checksums are combined in order.
+class MazeImage {
+ public:
+  static constexpr int kMaxCellSize = 256;
+  static constexpr int kMaxSide = 1 << 24;  // pixels
+
+  // *.png or *.svg
+  static bool isImagePath(const QString& filePath);
+  // the format follows the extension
+  static SaveResult write(const QString& filePath, const MazeData& maze,
+                          const MazeImageOptions& options = {});
+
+  static SaveResult writePng(QIODevice& device, const MazeData& maze,
+                             const MazeImageOptions& options = {});
+  static SaveResult writeSvg(QIODevice& device, const MazeData& maze,
+                             const MazeImageOptions& options = {});
+};
@@ -0,0 +1,219 @@
+#include "pathResults.h"
+
+#include <zlib.h>
+
+#include <QDataStream>
+#include <QtEndian>
+#include <algorithm>
+
+#include "src/lib/service/ioParser/tiledArchive.h"
+
+namespace {
+constexpr char kMagic[] = "S21MZR";
+constexpr int kMagicSize = 6;
+constexpr char kBlockMagic[] = "MZRB";
+constexpr int kBlockMagicSize = 4;
+constexpr quint16 kVersion = 1;
+
+constexpr qint64 kHeaderSize = kMagicSize + 2 + 4 * 2 + 8;
+constexpr qint64 kBlockHeaderSize = kBlockMagicSize + 4 * 3;
+constexpr qsizetype kRecordHeaderSize = 8 + 4 * 4 + 4;
+
+quint32 checksum(const QByteArray& payload) {
+  return quint32(crc32(0, reinterpret_cast<const Bytef*>(payload.data()),
+                       uInt(payload.size())));
+}
+}  // namespace
+
+void PathResultBlock::add(quint64 query, QPoint start, QPoint end,
+                          const PackedPath& path) {
+  const qsizetype at = payload_.size();
+  payload_.resize(at + kRecordHeaderSize + qsizetype(path.moves.size()));
+  char* p = payload_.data() + at;
+  qToLittleEndian<quint64>(query, p);
+  qToLittleEndian<qint32>(start.x(), p + 8);
+  qToLittleEndian<qint32>(start.y(), p + 12);
+  qToLittleEndian<qint32>(end.x(), p + 16);
+  qToLittleEndian<qint32>(end.y(), p + 20);
+  qToLittleEndian<quint32>(path.cells, p + 24);
+  std::copy(path.moves.begin(), path.moves.end(), p + kRecordHeaderSize);
+  ++records_;
+}
+
+void PathResultBlock::clear() {
+  payload_.clear();
+  records_ = 0;
+}
+
+SaveResult PathResultWriter::open(const QString& filePath, int rows, int cols,
+                                  quint64 fingerprint) {
+  std::lock_guard lock(mutex_);
+  file_.close();
+  file_.setFileName(filePath);
+  error_.clear();
+  if (!file_.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return {"cannot open file for writing: " + filePath};
+  }
+
+  QDataStream out(&file_);
+  out.setByteOrder(QDataStream::LittleEndian);
+  out.writeRawData(kMagic, kMagicSize);
+  out << kVersion << quint32(rows) << quint32(cols) << fingerprint;
+  if (out.status() != QDataStream::Ok) {
+    error_ = "write error occurred";
+    file_.close();
+    return {error_};
+  }
+  return {};
+}
+
+bool PathResultWriter::append(PathResultBlock& block) {
+  if (block.isEmpty()) return true;
+
+  char header[kBlockHeaderSize];
+  std::copy(kBlockMagic, kBlockMagic + kBlockMagicSize, header);
+  qToLittleEndian<quint32>(block.records_, header + 4);
+  qToLittleEndian<quint32>(quint32(block.payload_.size()), header + 8);
+  qToLittleEndian<quint32>(checksum(block.payload_), header + 12);
+
+  std::lock_guard lock(mutex_);
+  bool written = error_.isEmpty() && file_.isOpen() &&
+                 file_.write(header, kBlockHeaderSize) == kBlockHeaderSize &&
+                 file_.write(block.payload_) == block.payload_.size();
+  if (!written && error_.isEmpty()) error_ = "write error occurred";
+  block.clear();
+  return written;
+}
+
+SaveResult PathResultWriter::close() {
+  std::lock_guard lock(mutex_);
+  if (file_.isOpen() && !file_.flush() && error_.isEmpty()) {
+    error_ = "write error occurred";
+  }
+  file_.close();
+  return {error_};
+}
+
+bool PathResultReader::open(const QString& filePath) {
+  file_.close();
+  file_.setFileName(filePath);
+  error_.clear();
+  block_.clear();
+  at_ = 0;
+  left_ = 0;
+
+  if (!file_.open(QIODevice::ReadOnly)) {
+    error_ = "file not found: " + filePath;
+    return false;
+  }
+  if (file_.size() < kHeaderSize) {
+    error_ = "file too small for path results";
+    return false;
+  }
+
+  QDataStream in(&file_);
+  in.setByteOrder(QDataStream::LittleEndian);
+
+  char magic[kMagicSize];
+  quint16 version = 0;
+  quint32 rows = 0, cols = 0;
+  in.readRawData(magic, kMagicSize);
+  in >> version >> rows >> cols >> fingerprint_;
+
+  if (in.status() != QDataStream::Ok ||
+      !std::equal(magic, magic + kMagicSize, kMagic)) {
+    error_ = "not a path results file";
+    return false;
+  }
+  if (version != kVersion) {
+    error_ = QString("unsupported results version %1").arg(version);
+    return false;
+  }
+  if (rows == 0 || cols == 0 || rows > TiledArchive::kMaxDimension ||
+      cols > TiledArchive::kMaxDimension) {
+    error_ = QString("invalid dimensions: %1x%2 (max %3x%3)")
+                 .arg(rows)
+                 .arg(cols)
+                 .arg(TiledArchive::kMaxDimension);
+    return false;
+  }
+
+  rows_ = int(rows);
+  cols_ = int(cols);
+  return true;
+}
+
+bool PathResultReader::readBlock() {
+  const qint64 offset = file_.pos();
+  char header[kBlockHeaderSize];
+  const qint64 got = file_.read(header, kBlockHeaderSize);
+  if (got == 0) return false;
+  if (got != kBlockHeaderSize ||
+      !std::equal(header, header + kBlockMagicSize, kBlockMagic)) {
+    error_ = QString("damaged block at offset %1").arg(offset);
+    return false;
+  }
+
+  const quint32 records = qFromLittleEndian<quint32>(header + 4);
+  const quint32 size = qFromLittleEndian<quint32>(header + 8);
+  if (qint64(size) > file_.size() - file_.pos()) {
+    error_ = QString("truncated block at offset %1").arg(offset);
+    return false;
+  }
+  block_ = file_.read(size);
+  if (block_.size() != qsizetype(size) ||
+      checksum(block_) != qFromLittleEndian<quint32>(header + 12)) {
+    error_ = QString("damaged block at offset %1").arg(offset);
+    return false;
+  }
+
+  at_ = 0;
+  left_ = records;
+  return true;
+}
+
+bool PathResultReader::next(PathResult* result) {
+  if (!file_.isOpen() || !error_.isEmpty()) return false;
+  while (left_ == 0) {
+    if (at_ != block_.size()) {
+      error_ = "corrupt block payload";
+      return false;
+    }
+    if (!readBlock()) return false;
+  }
+
+  // the checksum passed, but the sizes are still checked so a writer bug
+  // can't read past the block
+  const char* p = block_.constData() + at_;
+  const qsizetype rest = block_.size() - at_;
+  if (rest < kRecordHeaderSize) {
+    error_ = "corrupt block payload";
+    return false;
+  }
+  const quint32 cells = qFromLittleEndian<quint32>(p + 24);
+  const qsizetype moves = qsizetype(PackedPath::moveBytes(cells));
+  if (moves > rest - kRecordHeaderSize) {
+    error_ = "corrupt block payload";
+    return false;
+  }
+
+  result->query = qFromLittleEndian<quint64>(p);
+  result->start = QPoint(qFromLittleEndian<qint32>(p + 8),
+                         qFromLittleEndian<qint32>(p + 12));
+  result->end = QPoint(qFromLittleEndian<qint32>(p + 16),
+                       qFromLittleEndian<qint32>(p + 20));
+  PackedPath& path = result->path;
+  path.clear();
+  if (cells > 0) {
+    path.startRow = result->start.x();
+    path.startCol = result->start.y();
+  }
+  path.cells = cells;
+  const auto* bytes =
+      reinterpret_cast<const std::uint8_t*>(p + kRecordHeaderSize);
+  path.moves.assign(bytes, bytes + moves);
+
+  at_ += kRecordHeaderSize + moves;
+  --left_;
+  return true;
+}
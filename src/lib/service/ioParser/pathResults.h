@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QPoint>
+#include <QString>
+#include <mutex>
+
+#include "src/core/packedPath.h"
+#include "src/lib/service/ioParser/asyncIOParser.h"
+
+// Batch path results (*.mzr), all integers little-endian:
+//
+//   header   "S21MZR" u16 version, u32 rows, u32 cols, u64 fingerprint
+//   blocks   "MZRB" u32 records, u32 payloadSize, u32 crc32, records
+//   record   u64 query, i32 startRow, startCol, endRow, endCol, u32 cells,
+//            PackedPath::moveBytes(cells) move bytes
+//
+// A path begins at its query's start. Every block is self-contained and
+// goes to the file under one lock, so solver threads append theirs in any
+// order; the query number ties a record back to its input. Readers stream
+// a block at a time and stop before a torn or damaged one, which is all a
+// crashed writer leaves behind.
+struct PathResult {
+  quint64 query{0};
+  QPoint start;
+  QPoint end;
+  PackedPath path;
+};
+
+// records collected by one thread, appended to the file in one piece
+class PathResultBlock {
+ public:
+  // worth appending from about this size on
+  static constexpr qsizetype kTargetBytes = 1 << 20;
+
+  // path is empty or starts at start
+  void add(quint64 query, QPoint start, QPoint end, const PackedPath& path);
+  void clear();
+
+  quint32 records() const { return records_; }
+  qsizetype bytes() const { return payload_.size(); }
+  bool isEmpty() const { return records_ == 0; }
+  bool isFull() const { return payload_.size() >= kTargetBytes; }
+
+ private:
+  friend class PathResultWriter;
+
+  QByteArray payload_;
+  quint32 records_{0};
+};
+
+class PathResultWriter {
+ public:
+  SaveResult open(const QString& filePath, int rows, int cols,
+                  quint64 fingerprint);
+  // thread-safe, clears the block; false after a write error, which
+  // close() reports
+  bool append(PathResultBlock& block);
+  SaveResult close();
+
+ private:
+  std::mutex mutex_;
+  QFile file_;
+  QString error_;
+};
+
+class PathResultReader {
+ public:
+  bool open(const QString& filePath);
+  const QString& error() const { return error_; }
+
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
+  quint64 fingerprint() const { return fingerprint_; }
+
+  // the next record in file order; false at the end of the file, or with
+  // error() set at a torn or damaged block
+  bool next(PathResult* result);
+
+ private:
+  bool readBlock();
+
+  QFile file_;
+  QString error_;
+  int rows_{0};
+  int cols_{0};
+  quint64 fingerprint_{0};
+  QByteArray block_;
+  qsizetype at_{0};
+  quint32 left_{0};  // records of block_ not read yet
+};
@@ -0,0 +1,310 @@
+#include "tiledArchive.h"
+
+#include <QDataStream>
+#include <QSaveFile>
+#include <algorithm>
+#include <atomic>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/cache/gridPool.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+
+namespace {
+constexpr char kMagic[] = "S21MZA";
+constexpr int kMagicSize = 6;
+constexpr char kIndexMagic[] = "MZAI";
+constexpr int kIndexMagicSize = 4;
+constexpr quint16 kVersion = 1;
+
+constexpr qint64 kHeaderSize = kMagicSize + 2 + 4 * 3;
+constexpr qint64 kEntrySize = 8 + 4 + 4;
+constexpr qint64 kTrailerSize = 8 + 4 + kIndexMagicSize;
+
+int tilesAlong(int cells, int tileSize) {
+  return (cells + tileSize - 1) / tileSize;
+}
+}  // namespace
+
+SaveResult TiledArchive::write(const QString& filePath, const MazeData& maze,
+                               int tileSize) {
+  if (!maze.isGenerated) {
+    return {"no maze data to save"};
+  }
+  if (tileSize <= 0) {
+    return {QString("invalid tile size: %1").arg(tileSize)};
+  }
+  // the reader refuses anything larger
+  if (maze.rows > kMaxDimension || maze.cols > kMaxDimension) {
+    return {QString("invalid dimensions: %1x%2 (max %3x%3)")
+                .arg(maze.rows)
+                .arg(maze.cols)
+                .arg(kMaxDimension)};
+  }
+
+  QSaveFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return {"cannot open file for writing: " + filePath};
+  }
+
+  QDataStream out(&file);
+  out.setByteOrder(QDataStream::LittleEndian);
+
+  out.writeRawData(kMagic, kMagicSize);
+  out << kVersion << quint32(maze.rows) << quint32(maze.cols)
+      << quint32(tileSize);
+
+  int tileRows = tilesAlong(maze.rows, tileSize);
+  int tileCols = tilesAlong(maze.cols, tileSize);
+
+  std::vector<ArchiveTileEntry> index;
+  index.reserve(static_cast<size_t>(tileRows) * tileCols);
+  quint64 offset = kHeaderSize;
+
+  // one band of tiles at a time keeps memory bounded by a single tile row
+  std::vector<std::vector<std::uint8_t>> blobs(tileCols);
+  std::vector<quint32> checksums(tileCols);
+
+  for (int tr = 0; tr < tileRows; ++tr) {
+    int row = tr * tileSize;
+    int rows = std::min(tileSize, maze.rows - row);
+
+    TaskScheduler::instance().parallelFor(tileCols, [&](qsizetype tc) {
+      int col = int(tc) * tileSize;
+      TileRect tile{row, col, rows, std::min(tileSize, maze.cols - col)};
+      blobs[tc] = TileCodec::encode(maze, tile, &checksums[tc]);
+    });
+
+    for (int tc = 0; tc < tileCols; ++tc) {
+      const auto& blob = blobs[tc];
+      out.writeRawData(reinterpret_cast<const char*>(blob.data()),
+                       static_cast<int>(blob.size()));
+      index.push_back({offset, quint32(blob.size()), checksums[tc]});
+      offset += blob.size();
+    }
+  }
+
+  for (const auto& entry : index) {
+    out << entry.offset << entry.size << entry.checksum;
+  }
+  out << quint64(offset) << quint32(index.size());
+  out.writeRawData(kIndexMagic, kIndexMagicSize);
+
+  if (out.status() != QDataStream::Ok || !file.commit()) {
+    return {"write error occurred"};
+  }
+
+  return {};
+}
+
+bool TiledArchiveReader::open(const QString& filePath) {
+  file_.close();
+  file_.setFileName(filePath);
+  map_ = nullptr;
+  index_.clear();
+  error_.clear();
+
+  if (!file_.open(QIODevice::ReadOnly)) {
+    error_ = "file not found: " + filePath;
+    return false;
+  }
+
+  qint64 fileSize = file_.size();
+  if (fileSize < kHeaderSize + kTrailerSize) {
+    error_ = "file too small for a maze archive";
+    return false;
+  }
+
+  QDataStream in(&file_);
+  in.setByteOrder(QDataStream::LittleEndian);
+
+  char magic[kMagicSize];
+  quint16 version = 0;
+  quint32 rows = 0, cols = 0, tileSize = 0;
+  in.readRawData(magic, kMagicSize);
+  in >> version >> rows >> cols >> tileSize;
+
+  if (in.status() != QDataStream::Ok ||
+      !std::equal(magic, magic + kMagicSize, kMagic)) {
+    error_ = "not a maze archive";
+    return false;
+  }
+  if (version != kVersion) {
+    error_ = QString("unsupported archive version %1").arg(version);
+    return false;
+  }
+  if (rows == 0 || cols == 0 || rows > TiledArchive::kMaxDimension ||
+      cols > TiledArchive::kMaxDimension || tileSize == 0) {
+    error_ = QString("invalid dimensions: %1x%2 (max %3x%3)")
+                 .arg(rows)
+                 .arg(cols)
+                 .arg(TiledArchive::kMaxDimension);
+    return false;
+  }
+
+  rows_ = static_cast<int>(rows);
+  cols_ = static_cast<int>(cols);
+  // a tile never needs to be larger than the maze itself
+  tileSize_ = static_cast<int>(std::min(tileSize, std::max(rows, cols)));
+  tileRows_ = tilesAlong(rows_, tileSize_);
+  tileCols_ = tilesAlong(cols_, tileSize_);
+
+  file_.seek(fileSize - kTrailerSize);
+  quint64 indexOffset = 0;
+  quint32 tileCount = 0;
+  char indexMagic[kIndexMagicSize];
+  in >> indexOffset >> tileCount;
+  in.readRawData(indexMagic, kIndexMagicSize);
+
+  qint64 expectedTiles = static_cast<qint64>(tileRows_) * tileCols_;
+  if (in.status() != QDataStream::Ok ||
+      !std::equal(indexMagic, indexMagic + kIndexMagicSize, kIndexMagic) ||
+      tileCount != expectedTiles ||
+      indexOffset + tileCount * kEntrySize + kTrailerSize !=
+          static_cast<quint64>(fileSize)) {
+    error_ = "corrupt archive index";
+    return false;
+  }
+
+  file_.seek(static_cast<qint64>(indexOffset));
+  index_.resize(tileCount);
+  for (auto& entry : index_) {
+    in >> entry.offset >> entry.size >> entry.checksum;
+    // offset + size could wrap on a crafted index
+    if (entry.offset < kHeaderSize || entry.size > indexOffset ||
+        entry.offset > indexOffset - entry.size) {
+      error_ = "corrupt archive index";
+      return false;
+    }
+  }
+
+  if (in.status() != QDataStream::Ok) {
+    error_ = "unexpected end of file in archive index";
+    return false;
+  }
+
+  // address space only; the pages are clean and the kernel drops them
+  // under pressure
+  map_ = file_.map(0, fileSize);
+  return true;
+}
+
+TileRect TiledArchiveReader::tileRect(int tileRow, int tileCol) const {
+  int row = tileRow * tileSize_;
+  int col = tileCol * tileSize_;
+  return {row, col, std::min(tileSize_, rows_ - row),
+          std::min(tileSize_, cols_ - col)};
+}
+
+ParseResult TiledArchiveReader::readRegion(int row, int col, int rows,
+                                           int cols) {
+  if (!file_.isOpen() || index_.empty()) {
+    return {{}, error_.isEmpty() ? QString("archive is not open") : error_};
+  }
+
+  int rowEnd = std::min(rows_, row + rows);
+  int colEnd = std::min(cols_, col + cols);
+  row = std::max(0, row);
+  col = std::max(0, col);
+  if (row >= rowEnd || col >= colEnd) {
+    return {{}, "region is outside the maze"};
+  }
+
+  struct Job {
+    TileRect tile;
+    QByteArray blob;
+    quint32 checksum;
+  };
+
+  // read payloads sequentially in file order, decode them in parallel
+  std::vector<Job> jobs;
+  for (int tr = row / tileSize_; tr <= (rowEnd - 1) / tileSize_; ++tr) {
+    for (int tc = col / tileSize_; tc <= (colEnd - 1) / tileSize_; ++tc) {
+      const auto& entry = index_[static_cast<size_t>(tr) * tileCols_ + tc];
+      file_.seek(static_cast<qint64>(entry.offset));
+      QByteArray blob = file_.read(entry.size);
+      if (blob.size() != static_cast<qsizetype>(entry.size)) {
+        return {{}, QString("unexpected end of file at tile [%1,%2]")
+                        .arg(tr)
+                        .arg(tc)};
+      }
+      jobs.push_back({tileRect(tr, tc), std::move(blob), entry.checksum});
+    }
+  }
+
+  GridPool& pool = GridPool::instance();
+  MazeData maze = pool.acquire(rowEnd - row, colEnd - col, {true, true});
+
+  std::atomic<bool> intact{true};
+  auto decode = [&](qsizetype i) {
+    Job& job = jobs[i];
+    const TileRect& t = job.tile;
+    const auto* data = reinterpret_cast<const std::uint8_t*>(job.blob.data());
+    bool inside = t.row >= row && t.col >= col && t.row + t.rows <= rowEnd &&
+                  t.col + t.cols <= colEnd;
+
+    if (inside) {
+      if (!TileCodec::decode(data, job.blob.size(), t, rows_, cols_,
+                             job.checksum, maze, t.row - row, t.col - col)) {
+        intact = false;
+      }
+      return;
+    }
+
+    // edge tile: decode whole tile, copy the overlap
+    MazeData scratch = pool.acquire(t.rows, t.cols, {true, true});
+    if (!TileCodec::decode(data, job.blob.size(), t, rows_, cols_,
+                           job.checksum, scratch, 0, 0)) {
+      intact = false;
+      pool.release(std::move(scratch));
+      return;
+    }
+    for (int r = std::max(t.row, row); r < std::min(t.row + t.rows, rowEnd);
+         ++r) {
+      for (int c = std::max(t.col, col); c < std::min(t.col + t.cols, colEnd);
+           ++c) {
+        maze.cells[r - row][c - col] = scratch.cells[r - t.row][c - t.col];
+      }
+    }
+    pool.release(std::move(scratch));
+  };
+  TaskScheduler::instance().parallelFor(qsizetype(jobs.size()), decode);
+
+  if (!intact) {
+    pool.release(std::move(maze));
+    return {{}, "archive tile checksum mismatch"};
+  }
+
+  maze.isGenerated = true;
+  return {std::move(maze), {}};
+}
+
+bool TiledArchiveReader::readTile(int tileRow, int tileCol, MazeData* tile) {
+  if (!file_.isOpen() || index_.empty() || tileRow < 0 ||
+      tileRow >= tileRows_ || tileCol < 0 || tileCol >= tileCols_) {
+    return false;
+  }
+
+  const auto& entry =
+      index_[static_cast<size_t>(tileRow) * tileCols_ + tileCol];
+  const uchar* data = nullptr;
+  if (map_) {
+    data = map_ + entry.offset;
+  } else {
+    file_.seek(static_cast<qint64>(entry.offset));
+    blob_.resize(entry.size);
+    if (file_.read(blob_.data(), entry.size) != qint64(entry.size)) {
+      return false;
+    }
+    data = reinterpret_cast<const uchar*>(blob_.constData());
+  }
+
+  TileRect rect = tileRect(tileRow, tileCol);
+  resetGrid(*tile, rect.rows, rect.cols, {true, true});
+  tile->isGenerated = true;
+  return TileCodec::decode(data, entry.size, rect, rows_, cols_,
+                           entry.checksum, *tile, 0, 0);
+}
+
+ParseResult TiledArchiveReader::readAll() {
+  return readRegion(0, 0, rows_, cols_);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <vector>
+
+#include "src/core/tileCodec.h"
+#include "src/lib/service/ioParser/asyncIOParser.h"
+
+// Tiled maze archive (*.mza), all integers little-endian:
+//
+//   header   "S21MZA" u16 version, u32 rows, u32 cols, u32 tileSize
+//   tiles    TileCodec payloads, row-major by tile
+//   index    per tile: u64 offset, u32 size, u32 checksum
+//   trailer  u64 indexOffset, u32 tileCount, "MZAI"
+//
+// The index sits in a footer so the writer can stream tiles without
+// knowing their sizes up front, and readers can seek straight to the
+// tiles a viewport or solver needs.
+struct ArchiveTileEntry {
+  quint64 offset{0};
+  quint32 size{0};
+  quint32 checksum{0};
+};
+
+class TiledArchive {
+ public:
+  static constexpr int kDefaultTileSize = 256;
+  static constexpr int kMaxDimension = 65536;
+
+  // tiles are compressed in parallel, then written in index order
+  static SaveResult write(const QString& filePath, const MazeData& maze,
+                          int tileSize = kDefaultTileSize);
+};
+
+class TiledArchiveReader {
+ public:
+  bool open(const QString& filePath);
+  const QString& error() const { return error_; }
+
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
+  int tileSize() const { return tileSize_; }
+  int tileRows() const { return tileRows_; }
+  int tileCols() const { return tileCols_; }
+  TileRect tileRect(int tileRow, int tileCol) const;
+
+  // decodes only the tiles overlapping the region (clamped to the maze),
+  // the result is a standalone maze of the region's size
+  ParseResult readRegion(int row, int col, int rows, int cols);
+  ParseResult readAll();
+  // one tile into tile, resized to tileRect; from the memory-mapped file
+  // when the map succeeded, so no read calls. Not thread-safe.
+  bool readTile(int tileRow, int tileCol, MazeData* tile);
+
+ private:
+  QFile file_;
+  const uchar* map_{nullptr};  // the whole file, unmapped by close
+  QByteArray blob_;            // readTile's buffer without a map
+  QString error_;
+  int rows_{0};
+  int cols_{0};
+  int tileSize_{0};
+  int tileRows_{0};
+  int tileCols_{0};
+  std::vector<ArchiveTileEntry> index_;
+};
@@ -0,0 +1,155 @@
+#include "metrics.h"
+
+#include <QJsonArray>
+#include <QThread>
+#include <chrono>
+
+namespace {
+const char* const kCounterNames[] = {
+    "generatedRows", "generatedCells", "nodesExpanded",
+    "queueHighWater", "pathRepairs",   "parsedBytes",
+    "writtenBytes",  "modelResets",    "modelRowsInserted",
+    "cacheHits",     "cacheMisses",    "cacheEvictions",
+    "scheduledTasks", "stolenTasks",   "caveCells",
+    "agentSteps",    "agentEpisodes"};
+
+const char* const kTimerNames[] = {"generate",   "solve",    "solveBatch",
+                                   "repairPath", "parse",    "write",
+                                   "modelReset", "caveStep", "analyze"};
+
+static_assert(std::size(kCounterNames) == size_t(Metrics::Counter::Count));
+static_assert(std::size(kTimerNames) == size_t(Metrics::Timer::Count));
+
+void storeMax(std::atomic<quint64>& target, quint64 value) {
+  quint64 current = target.load(std::memory_order_relaxed);
+  while (current < value &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+}  // namespace
+
+// the whole ring up front, timed code never sees it grow
+Metrics::Metrics() : trace_(new TraceSlot[kMaxTraceEvents]) {}
+
+Metrics& Metrics::instance() {
+  static Metrics metrics;
+  return metrics;
+}
+
+const char* Metrics::name(Counter counter) {
+  return kCounterNames[size_t(counter)];
+}
+
+const char* Metrics::name(Timer timer) { return kTimerNames[size_t(timer)]; }
+
+qint64 Metrics::nowNs() {
+  static const auto epoch = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch)
+      .count();
+}
+
+void Metrics::add(Counter counter, qint64 amount) {
+  counters_[size_t(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void Metrics::raise(Counter counter, qint64 value) {
+  auto& target = counters_[size_t(counter)];
+  qint64 current = target.load(std::memory_order_relaxed);
+  while (current < value &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+void Metrics::record(Timer timer, qint64 startNs, qint64 durationNs) {
+  auto& stats = timers_[size_t(timer)];
+  stats.count.fetch_add(1, std::memory_order_relaxed);
+  stats.totalNs.fetch_add(durationNs, std::memory_order_relaxed);
+  storeMax(stats.maxNs, durationNs);
+
+  // a seqlock per slot: marked unwritten, filled, then stamped with the
+  // claim; a dump skips slots whose stamp is not the claim it expects
+  const quint64 claim = traceClaimed_.fetch_add(1, std::memory_order_relaxed);
+  TraceSlot& slot = trace_[claim % kMaxTraceEvents];
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.timer.store(int(timer), std::memory_order_relaxed);
+  slot.thread.store(
+      quint64(reinterpret_cast<quintptr>(QThread::currentThreadId())),
+      std::memory_order_relaxed);
+  slot.startNs.store(startNs, std::memory_order_relaxed);
+  slot.durationNs.store(durationNs, std::memory_order_relaxed);
+  slot.sequence.store(claim + 1, std::memory_order_release);
+}
+
+qint64 Metrics::value(Counter counter) const {
+  return counters_[size_t(counter)].load(std::memory_order_relaxed);
+}
+
+Metrics::TimerStats Metrics::stats(Timer timer) const {
+  const auto& stats = timers_[size_t(timer)];
+  return {stats.count.load(std::memory_order_relaxed),
+          stats.totalNs.load(std::memory_order_relaxed),
+          stats.maxNs.load(std::memory_order_relaxed)};
+}
+
+void Metrics::reset() {
+  for (auto& counter : counters_) counter.store(0);
+  for (auto& timer : timers_) {
+    timer.count.store(0);
+    timer.totalNs.store(0);
+    timer.maxNs.store(0);
+  }
+  // scopes still closing on other threads may leave a stray event
+  traceClaimed_.store(0);
+  for (size_t i = 0; i < kMaxTraceEvents; ++i) trace_[i].sequence.store(0);
+}
+
+QJsonObject Metrics::toJson() const {
+  QJsonObject counters;
+  for (size_t i = 0; i < size_t(Counter::Count); ++i) {
+    counters.insert(kCounterNames[i], value(Counter(i)));
+  }
+
+  QJsonObject timers;
+  for (size_t i = 0; i < size_t(Timer::Count); ++i) {
+    TimerStats s = stats(Timer(i));
+    timers.insert(kTimerNames[i],
+                  QJsonObject{{"count", qint64(s.count)},
+                              {"totalNs", qint64(s.totalNs)},
+                              {"maxNs", qint64(s.maxNs)}});
+  }
+
+  return {{"timestampNs", nowNs()}, {"counters", counters}, {"timers", timers}};
+}
+
+QJsonObject Metrics::toChromeTrace() const {
+  QJsonArray events;
+  // oldest first once the ring has wrapped; slots being written or already
+  // overwritten by a newer claim are left out
+  const quint64 claimed = traceClaimed_.load(std::memory_order_acquire);
+  const quint64 first =
+      claimed > kMaxTraceEvents ? claimed - kMaxTraceEvents : 0;
+  for (quint64 claim = first; claim < claimed; ++claim) {
+    const TraceSlot& slot = trace_[claim % kMaxTraceEvents];
+    if (slot.sequence.load(std::memory_order_acquire) != claim + 1) continue;
+    const int timer = slot.timer.load(std::memory_order_relaxed);
+    const quint64 thread = slot.thread.load(std::memory_order_relaxed);
+    const qint64 startNs = slot.startNs.load(std::memory_order_relaxed);
+    const qint64 durationNs = slot.durationNs.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != claim + 1) continue;
+    if (timer < 0 || timer >= int(Timer::Count)) continue;
+
+    events.append(QJsonObject{{"name", name(Timer(timer))},
+                              {"cat", "maze"},
+                              {"ph", "X"},
+                              {"ts", startNs / 1000.0},
+                              {"dur", durationNs / 1000.0},
+                              {"pid", 1},
+                              {"tid", qint64(thread)}});
+  }
+  return {{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QtGlobal>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+
+// Process-wide counters and timers for the hot paths.
+//
+// Code is instrumented through the MAZE_* macros at the bottom, which
+// compile to nothing unless MAZE_METRICS is defined (ENABLE_METRICS in
+// CMake). Nothing takes a lock: counters and timer totals are atomics, and
+// every timed scope also lands in a bounded ring of trace events for the
+// Chrome trace dump, its slot claimed with one atomic increment.
+class Metrics {
+ public:
+  enum class Counter {
+    GeneratedRows,
+    GeneratedCells,
+    NodesExpanded,
+    QueueHighWater,  // largest search frontier seen
+    PathRepairs,
+    ParsedBytes,
+    WrittenBytes,
+    ModelResets,
+    ModelRowsInserted,
+    CacheHits,  // mazes and paths, see MazeCache
+    CacheMisses,
+    CacheEvictions,
+    ScheduledTasks,  // see TaskScheduler
+    StolenTasks,
+    CaveCells,  // cells stepped by CaveAutomaton
+    AgentSteps,  // moves made by QLearner episodes
+    AgentEpisodes,
+    Count
+  };
+
+  enum class Timer {
+    Generate,
+    Solve,       // one query someone waits for
+    SolveBatch,  // a batch of queries, see maze_cli solve and MazeServer
+    RepairPath,
+    Parse,
+    Write,
+    ModelReset,
+    CaveStep,
+    Analyze,
+    Count
+  };
+
+  struct TimerStats {
+    quint64 count{0};
+    quint64 totalNs{0};
+    quint64 maxNs{0};
+  };
+
+  static constexpr size_t kMaxTraceEvents = 1 << 16;
+
+  static Metrics& instance();
+  static const char* name(Counter counter);
+  static const char* name(Timer timer);
+  // monotonic, relative to the first use
+  static qint64 nowNs();
+
+  void add(Counter counter, qint64 amount);
+  void raise(Counter counter, qint64 value);
+  void record(Timer timer, qint64 startNs, qint64 durationNs);
+
+  qint64 value(Counter counter) const;
+  TimerStats stats(Timer timer) const;
+  void reset();
+
+  QJsonObject toJson() const;
+  // complete ("X") events in the trace_event format, for chrome://tracing
+  // or Perfetto
+  QJsonObject toChromeTrace() const;
+
+ private:
+  struct AtomicTimer {
+    std::atomic<quint64> count{0};
+    std::atomic<quint64> totalNs{0};
+    std::atomic<quint64> maxNs{0};
+  };
+
+  // a slot of the trace ring; fields are atomics only so a dump may read
+  // a slot while it is rewritten, sequence tells if it got a whole event
+  struct TraceSlot {
+    std::atomic<quint64> sequence{0};  // claim + 1 once written, 0 while not
+    std::atomic<int> timer{0};
+    std::atomic<quint64> thread{0};
+    std::atomic<qint64> startNs{0};
+    std::atomic<qint64> durationNs{0};
+  };
+
+  Metrics();
+
+  std::array<std::atomic<qint64>, size_t(Counter::Count)> counters_{};
+  std::array<AtomicTimer, size_t(Timer::Count)> timers_{};
+
+  std::unique_ptr<TraceSlot[]> trace_;  // claim % kMaxTraceEvents
+  std::atomic<quint64> traceClaimed_{0};
+};
+
+// records the lifetime of the enclosing scope
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(Metrics::Timer timer)
+      : timer_(timer), startNs_(Metrics::nowNs()) {}
+  ~ScopedTimer() {
+    Metrics::instance().record(timer_, startNs_, Metrics::nowNs() - startNs_);
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  Metrics::Timer timer_;
+  qint64 startNs_;
+};
+
+// tallies a hot loop locally and publishes once on scope exit, so the
+// loop itself never touches the shared atomics
+class ScopedTally {
+ public:
+  explicit ScopedTally(Metrics::Counter counter) : counter_(counter) {}
+  ~ScopedTally() {
+    if (count_) Metrics::instance().add(counter_, count_);
+    if (highWater_) Metrics::instance().raise(counter_, highWater_);
+  }
+
+  void add(qint64 amount) { count_ += amount; }
+  void raise(qint64 value) { highWater_ = std::max(highWater_, value); }
+
+  ScopedTally(const ScopedTally&) = delete;
+  ScopedTally& operator=(const ScopedTally&) = delete;
+
+ private:
+  Metrics::Counter counter_;
+  qint64 count_{0};
+  qint64 highWater_{0};
+};
+
+#ifdef MAZE_METRICS
+#define MAZE_METRICS_CONCAT_(a, b) a##b
+#define MAZE_METRICS_CONCAT(a, b) MAZE_METRICS_CONCAT_(a, b)
+#define MAZE_SCOPED_TIMER(timer)                               \
+  ScopedTimer MAZE_METRICS_CONCAT(mazeScopedTimer_, __LINE__)( \
+      Metrics::Timer::timer)
+#define MAZE_COUNT(counter, amount) \
+  Metrics::instance().add(Metrics::Counter::counter, (amount))
+#define MAZE_HIGH_WATER(counter, value) \
+  Metrics::instance().raise(Metrics::Counter::counter, (value))
+// code only needed to feed the metrics, e.g. local tallies
+#define MAZE_METRICS_ONLY(...) __VA_ARGS__
+#else
+#define MAZE_SCOPED_TIMER(timer) static_cast<void>(0)
+#define MAZE_COUNT(counter, amount) static_cast<void>(0)
+#define MAZE_HIGH_WATER(counter, value) static_cast<void>(0)
+#define MAZE_METRICS_ONLY(...)
+#endif
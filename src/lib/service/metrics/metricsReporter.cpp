@@ -0,0 +1,110 @@
+#include "metricsReporter.h"
+
+#include <QJsonDocument>
+#include <QSaveFile>
+
+#include "metrics.h"
+
+namespace {
+bool writeDocument(const QString& path, const QJsonObject& object) {
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) return false;
+  file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+  return file.commit();
+}
+
+double perSecond(qint64 delta, qint64 elapsedNs) {
+  return elapsedNs > 0 ? delta * 1e9 / elapsedNs : 0.0;
+}
+}  // namespace
+
+MetricsReporter::MetricsReporter(QObject* parent) : QObject(parent) {
+  timer_.setInterval(kDefaultIntervalMs);
+  connect(&timer_, &QTimer::timeout, this, &MetricsReporter::sample);
+  lastSampleNs_ = Metrics::nowNs();
+  sample();
+  if (enabled()) timer_.start();
+}
+
+bool MetricsReporter::enabled() const {
+#ifdef MAZE_METRICS
+  return true;
+#else
+  return false;
+#endif
+}
+
+int MetricsReporter::intervalMs() const { return timer_.interval(); }
+
+void MetricsReporter::setIntervalMs(int intervalMs) {
+  intervalMs = qMax(intervalMs, 50);
+  if (intervalMs == timer_.interval()) return;
+  timer_.setInterval(intervalMs);
+  emit intervalMsChanged();
+}
+
+QVariantMap MetricsReporter::counters() const { return counters_; }
+
+QVariantMap MetricsReporter::timers() const { return timers_; }
+
+QVariantMap MetricsReporter::rates() const { return rates_; }
+
+void MetricsReporter::setDumpPath(const QString& path) { dumpPath_ = path; }
+
+void MetricsReporter::sample() {
+  const Metrics& metrics = Metrics::instance();
+  qint64 now = Metrics::nowNs();
+  qint64 elapsed = now - lastSampleNs_;
+  lastSampleNs_ = now;
+
+  auto delta = [&](Metrics::Counter counter) {
+    return metrics.value(counter) -
+           counters_.value(Metrics::name(counter)).toLongLong();
+  };
+  rates_ = {
+      {"generatedRowsPerSec",
+       perSecond(delta(Metrics::Counter::GeneratedRows), elapsed)},
+      {"parsedBytesPerSec",
+       perSecond(delta(Metrics::Counter::ParsedBytes), elapsed)},
+      {"nodesExpandedPerSec",
+       perSecond(delta(Metrics::Counter::NodesExpanded), elapsed)},
+  };
+
+  counters_.clear();
+  for (int i = 0; i < int(Metrics::Counter::Count); ++i) {
+    auto counter = Metrics::Counter(i);
+    counters_.insert(Metrics::name(counter), metrics.value(counter));
+  }
+
+  timers_.clear();
+  for (int i = 0; i < int(Metrics::Timer::Count); ++i) {
+    auto timer = Metrics::Timer(i);
+    Metrics::TimerStats s = metrics.stats(timer);
+    double totalMs = s.totalNs / 1e6;
+    timers_.insert(Metrics::name(timer),
+                   QVariantMap{{"count", s.count},
+                               {"totalMs", totalMs},
+                               {"avgMs", s.count ? totalMs / s.count : 0.0},
+                               {"maxMs", s.maxNs / 1e6}});
+  }
+
+  if (!dumpPath_.isEmpty()) {
+    writeJson(dumpPath_ + ".json");
+    writeChromeTrace(dumpPath_ + ".trace.json");
+  }
+  emit updated();
+}
+
+void MetricsReporter::reset() {
+  Metrics::instance().reset();
+  counters_.clear();
+  sample();
+}
+
+bool MetricsReporter::writeJson(const QString& path) const {
+  return writeDocument(path, Metrics::instance().toJson());
+}
+
+bool MetricsReporter::writeChromeTrace(const QString& path) const {
+  return writeDocument(path, Metrics::instance().toChromeTrace());
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QVariantMap>
+
+// Periodic snapshot of Metrics for QML and for dumps to disk.
+//
+// Every intervalMs the reporter samples the counters, derives rates from
+// the difference to the previous sample and, when a dump path is set,
+// rewrites <path>.json and <path>.trace.json.
+class MetricsReporter : public QObject {
+  Q_OBJECT
+
+  Q_PROPERTY(bool enabled READ enabled CONSTANT)
+  Q_PROPERTY(int intervalMs READ intervalMs WRITE setIntervalMs NOTIFY
+                 intervalMsChanged)
+  Q_PROPERTY(QVariantMap counters READ counters NOTIFY updated)
+  // name -> {count, totalMs, avgMs, maxMs}
+  Q_PROPERTY(QVariantMap timers READ timers NOTIFY updated)
+  // generatedRowsPerSec, parsedBytesPerSec, nodesExpandedPerSec
+  Q_PROPERTY(QVariantMap rates READ rates NOTIFY updated)
+
+ public:
+  static constexpr int kDefaultIntervalMs = 1000;
+
+  explicit MetricsReporter(QObject* parent = nullptr);
+
+  // false when the build has ENABLE_METRICS off, all values stay zero
+  bool enabled() const;
+
+  int intervalMs() const;
+  void setIntervalMs(int intervalMs);
+
+  QVariantMap counters() const;
+  QVariantMap timers() const;
+  QVariantMap rates() const;
+
+  // writes after every sample, empty to stop
+  void setDumpPath(const QString& path);
+
+  Q_INVOKABLE void sample();
+  Q_INVOKABLE void reset();
+  Q_INVOKABLE bool writeJson(const QString& path) const;
+  Q_INVOKABLE bool writeChromeTrace(const QString& path) const;
+
+ signals:
+  void intervalMsChanged();
+  void updated();
+
+ private:
+  QTimer timer_;
+  QString dumpPath_;
+  QVariantMap counters_;
+  QVariantMap timers_;
+  QVariantMap rates_;
+  qint64 lastSampleNs_{0};
+};
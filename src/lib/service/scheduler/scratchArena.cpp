@@ -0,0 +1,36 @@
+#include "scratchArena.h"
+
+#include <algorithm>
+
+void ScratchArena::rewind(const Mark& mark) {
+  current_ = mark.block;
+  offset_ = mark.offset;
+}
+
+size_t ScratchArena::capacity() const {
+  size_t total = 0;
+  for (const Block& block : blocks_) total += block.size;
+  return total;
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+  // first block from the current one on that still fits, else a new one
+  for (; current_ < blocks_.size(); ++current_, offset_ = 0) {
+    Block& block = blocks_[current_];
+    auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+    size_t aligned = (base + offset_ + alignment - 1) / alignment * alignment;
+    size_t start = aligned - base;
+    if (start + bytes <= block.size) {
+      offset_ = start + bytes;
+      return block.data.get() + start;
+    }
+  }
+
+  size_t size = std::max(kBlockBytes, bytes + alignment);
+  blocks_.push_back({std::make_unique<std::byte[]>(size), size});
+  current_ = blocks_.size() - 1;
+  auto base = reinterpret_cast<std::uintptr_t>(blocks_.back().data.get());
+  size_t start = (base + alignment - 1) / alignment * alignment - base;
+  offset_ = start + bytes;
+  return blocks_.back().data.get() + start;
+}
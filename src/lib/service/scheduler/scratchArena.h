@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Bump allocator for short-lived scratch memory.
+//
+// Deallocation is a no-op; rewinding to a mark (or reset) makes everything
+// allocated since then available again, while the blocks themselves stay
+// allocated for the next use. Not thread-safe: every worker of
+// TaskScheduler has its own, see TaskScheduler::scratch().
+class ScratchArena : public std::pmr::memory_resource {
+ public:
+  static constexpr size_t kBlockBytes = size_t(64) << 10;
+
+  struct Mark {
+    size_t block;
+    size_t offset;
+  };
+
+  ScratchArena() = default;
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  Mark mark() const { return {current_, offset_}; }
+  void rewind(const Mark& mark);
+  void reset() { rewind({0, 0}); }
+
+  // bytes held in blocks, in use or not
+  size_t capacity() const;
+
+ private:
+  struct Block {
+    std::unique_ptr<std::byte[]> data;
+    size_t size;
+  };
+
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void*, size_t, size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource& other)
+      const noexcept override {
+    return this == &other;
+  }
+
+  std::vector<Block> blocks_;
+  size_t current_{0};
+  size_t offset_{0};
+};
+
+// rewinds the arena to where it was when the scope began
+class ScratchScope {
+ public:
+  explicit ScratchScope(ScratchArena& arena)
+      : arena_(arena), mark_(arena.mark()) {}
+  ~ScratchScope() { arena_.rewind(mark_); }
+
+  ScratchScope(const ScratchScope&) = delete;
+  ScratchScope& operator=(const ScratchScope&) = delete;
+
+  ScratchArena* resource() const { return &arena_; }
+
+ private:
+  ScratchArena& arena_;
+  ScratchArena::Mark mark_;
+};
@@ -0,0 +1,294 @@
+#include "taskScheduler.h"
+
+#include <QThread>
+#include <algorithm>
+
+#include "src/lib/service/metrics/metrics.h"
+
+namespace {
+const char* const kPriorityNames[] = {"interactive", "render", "bulkIO",
+                                      "batch"};
+static_assert(std::size(kPriorityNames) ==
+              size_t(TaskScheduler::Priority::Count));
+
+std::atomic<int> defaultThreads{0};
+std::atomic<bool> instanceStarted{false};
+
+// the scheduler and worker this thread belongs to, if any
+thread_local TaskScheduler* currentScheduler = nullptr;
+thread_local int currentWorker = -1;
+thread_local TaskScheduler::Priority runningPriority =
+    TaskScheduler::Priority::Batch;
+}  // namespace
+
+TaskScheduler& TaskScheduler::instance() {
+  static TaskScheduler scheduler([]() {
+    instanceStarted = true;
+    int threads = defaultThreads;
+    return threads > 0 ? threads : std::max(2, QThread::idealThreadCount());
+  }());
+  return scheduler;
+}
+
+bool TaskScheduler::setDefaultThreadCount(int threads) {
+  if (instanceStarted) return false;
+  defaultThreads = threads;
+  return true;
+}
+
+TaskScheduler::TaskScheduler(int threads) {
+  threads = std::max(threads, 1);
+  // the last worker stays free for interactive and render work
+  bulkLimit_ = std::max(threads - 1, 1);
+
+  // all workers exist before any of them starts stealing
+  for (int i = 0; i < threads; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (int i = 0; i < threads; ++i) {
+    workers_[i]->thread = std::thread([this, i]() { workerLoop(i); });
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) worker->thread.join();
+}
+
+void TaskScheduler::submit(Priority priority, std::function<void()> task) {
+  size_t level = size_t(priority);
+  if (currentScheduler == this) {
+    Worker& self = *workers_[currentWorker];
+    std::lock_guard<std::mutex> lock(self.mutex);
+    self.queues[level].push_back({priority, std::move(task)});
+  } else {
+    std::lock_guard<std::mutex> lock(mutex_);
+    injected_[level].push_back({priority, std::move(task)});
+  }
+  MAZE_COUNT(ScheduledTasks, 1);
+
+  // counted once queued, so a worker that sees the count finds the task;
+  // a worker taking it first briefly drives the count below zero
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++queued_[level];
+  }
+  wake_.notify_one();
+}
+
+void TaskScheduler::parallelFor(qsizetype count,
+                                const std::function<void(qsizetype)>& body) {
+  if (count <= 0) return;
+  if (count == 1) {
+    body(0);
+    return;
+  }
+
+  // helpers that start after everything was claimed return right away,
+  // so only claimed items are waited for and late helpers are harmless
+  struct Shared {
+    std::atomic<qsizetype> next{0};
+    qsizetype count{0};
+    qsizetype done{0};
+    const std::function<void(qsizetype)>* body{nullptr};
+    std::mutex mutex;
+    std::condition_variable finished;
+  };
+  auto shared = std::make_shared<Shared>();
+  shared->count = count;
+  shared->body = &body;
+
+  auto drain = [](Shared& state) {
+    qsizetype ran = 0;
+    for (qsizetype i = state.next++; i < state.count; i = state.next++) {
+      (*state.body)(i);
+      ++ran;
+    }
+    if (!ran) return;
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.done += ran;
+    if (state.done == state.count) state.finished.notify_all();
+  };
+
+  Priority priority = currentPriority();
+  qsizetype helpers = std::min<qsizetype>(threadCount(), count - 1);
+  for (qsizetype i = 0; i < helpers; ++i) {
+    submit(priority, [shared, drain]() { drain(*shared); });
+  }
+  drain(*shared);
+
+  std::unique_lock<std::mutex> lock(shared->mutex);
+  shared->finished.wait(lock, [&]() { return shared->done == count; });
+}
+
+ScratchArena& TaskScheduler::scratch() {
+  if (currentScheduler) {
+    return currentScheduler->workers_[currentWorker]->scratch;
+  }
+  thread_local ScratchArena arena;
+  return arena;
+}
+
+TaskScheduler::Priority TaskScheduler::currentPriority() {
+  return currentScheduler ? runningPriority : Priority::Batch;
+}
+
+TaskScheduler::Stats TaskScheduler::stats() const {
+  Stats stats;
+  for (size_t i = 0; i < kPriorities; ++i) stats.executed[i] = executed_[i];
+  stats.stolen = stolen_;
+  return stats;
+}
+
+QJsonObject TaskScheduler::toJson() const {
+  Stats s = stats();
+  QJsonObject executed;
+  for (size_t i = 0; i < kPriorities; ++i) {
+    executed.insert(kPriorityNames[i], qint64(s.executed[i]));
+  }
+  return {{"threads", threadCount()},
+          {"executed", executed},
+          {"stolen", qint64(s.stolen)}};
+}
+
+void TaskScheduler::workerLoop(int index) {
+  currentScheduler = this;
+  currentWorker = index;
+  Worker& self = *workers_[index];
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [this]() { return stopping_ || hasRunnableWork(); });
+      if (stopping_) return;
+    }
+
+    Task task;
+    if (!takeTask(index, &task)) continue;  // another worker was faster
+
+    runningPriority = task.priority;
+    task.function();
+    task.function = nullptr;  // captures go before the scratch they used
+    self.scratch.reset();
+    ++executed_[size_t(task.priority)];
+
+    if (isBulk(task.priority)) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --bulkRunning_;
+      }
+      wake_.notify_one();  // queued bulk work may run now
+    }
+  }
+}
+
+bool TaskScheduler::hasRunnableWork() const {
+  for (size_t level = 0; level < kPriorities; ++level) {
+    if (queued_[level] <= 0) continue;
+    if (!isBulk(Priority(level)) || bulkRunning_ < bulkLimit_) return true;
+  }
+  return false;
+}
+
+bool TaskScheduler::takeTask(int index, Task* task) {
+  for (size_t level = 0; level < kPriorities; ++level) {
+    bool bulk = isBulk(Priority(level));
+    {
+      // bulk work reserves its slot before looking for a task
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (queued_[level] <= 0) continue;
+      if (bulk) {
+        if (bulkRunning_ >= bulkLimit_) continue;
+        ++bulkRunning_;
+      }
+    }
+
+    bool stolen = false;
+    bool found = takeFrom(index, level, task, &stolen);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (found) {
+        --queued_[level];
+      } else if (bulk) {
+        --bulkRunning_;
+      }
+    }
+    if (found) {
+      if (stolen) {
+        ++stolen_;
+        MAZE_COUNT(StolenTasks, 1);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TaskScheduler::takeFrom(int index, size_t level, Task* task,
+                             bool* stolen) {
+  // own work newest first, it is likely still in cache
+  {
+    Worker& self = *workers_[index];
+    std::lock_guard<std::mutex> lock(self.mutex);
+    auto& queue = self.queues[level];
+    if (!queue.empty()) {
+      *task = std::move(queue.back());
+      queue.pop_back();
+      return true;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& queue = injected_[level];
+    if (!queue.empty()) {
+      *task = std::move(queue.front());
+      queue.pop_front();
+      return true;
+    }
+  }
+  // others' oldest, the biggest pieces of their work
+  int count = threadCount();
+  for (int i = 1; i < count; ++i) {
+    Worker& victim = *workers_[(index + i) % count];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    auto& queue = victim.queues[level];
+    if (!queue.empty()) {
+      *task = std::move(queue.front());
+      queue.pop_front();
+      *stolen = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler)
+    : scheduler_(scheduler), state_(std::make_shared<State>()) {}
+
+TaskGroup::~TaskGroup() {
+  cancel();
+  wait();
+}
+
+void TaskGroup::submit(TaskScheduler::Priority priority,
+                       std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    ++state_->pending;
+  }
+  scheduler_.submit(priority, [state = state_, token = token_,
+                               task = std::move(task)]() {
+    if (!token.isCancelled()) task();
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (--state->pending == 0) state->idle.notify_all();
+  });
+}
+
+void TaskGroup::wait() {
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->idle.wait(lock, [this]() { return state_->pending == 0; });
+}
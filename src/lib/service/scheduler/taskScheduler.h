@@ -0,0 +1,168 @@
+#pragma once
+
+#include <QFuture>
+#include <QJsonObject>
+#include <QPromise>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "src/lib/service/scheduler/scratchArena.h"
+
+// Set once to ask running and queued work to stop; copies share the flag.
+class CancellationToken {
+ public:
+  CancellationToken() : state_(std::make_shared<std::atomic<bool>>(false)) {}
+
+  void cancel() const { state_->store(true, std::memory_order_relaxed); }
+  bool isCancelled() const {
+    return state_->load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::shared_ptr<std::atomic<bool>> state_;
+};
+
+// Work-stealing pool that runs all background work of the app, the CLI
+// and the server.
+//
+// Every worker keeps a deque per priority: tasks submitted from a worker
+// go to its own deque (taken newest first, stolen oldest first), others to
+// a shared queue. Workers always take the most urgent task they can find,
+// and one worker never takes BulkIO or Batch work, so interactive solves
+// and tiles don't wait behind a long save or generation. Each worker has a
+// scratch arena that is reset after every task.
+class TaskScheduler {
+ public:
+  enum class Priority { Interactive, Render, BulkIO, Batch, Count };
+
+  struct Stats {
+    std::array<quint64, size_t(Priority::Count)> executed{};
+    quint64 stolen{0};
+  };
+
+  // the shared instance, started on first use
+  static TaskScheduler& instance();
+  // for the shared instance; false once it has started
+  static bool setDefaultThreadCount(int threads);
+
+  explicit TaskScheduler(int threads);
+  // finishes the running tasks, queued ones are dropped
+  ~TaskScheduler();
+
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+  int threadCount() const { return int(workers_.size()); }
+
+  void submit(Priority priority, std::function<void()> task);
+
+  // the future finishes with the task; a task whose token was cancelled
+  // before it started is not called and yields a default result
+  template <class F>
+  auto run(Priority priority, F&& function, CancellationToken token = {})
+      -> QFuture<std::invoke_result_t<F>> {
+    using Result = std::invoke_result_t<F>;
+    auto promise = std::make_shared<QPromise<Result>>();
+    QFuture<Result> future = promise->future();
+    promise->start();
+    submit(priority, [promise, token,
+                      function = std::forward<F>(function)]() mutable {
+      if constexpr (std::is_void_v<Result>) {
+        if (!token.isCancelled()) function();
+      } else {
+        promise->addResult(token.isCancelled() ? Result{} : function());
+      }
+      promise->finish();
+    });
+    return future;
+  }
+
+  // body(i) for every i in [0, count) on the workers and the calling
+  // thread, at the priority of the calling task; returns when all are done
+  void parallelFor(qsizetype count,
+                   const std::function<void(qsizetype)>& body);
+
+  // the calling worker's arena, or one for this thread outside the pool;
+  // pair with ScratchScope when used outside a task
+  static ScratchArena& scratch();
+  // of the task running on this thread, Batch outside the pool
+  static Priority currentPriority();
+
+  Stats stats() const;
+  QJsonObject toJson() const;
+
+ private:
+  static constexpr size_t kPriorities = size_t(Priority::Count);
+
+  struct Task {
+    Priority priority;
+    std::function<void()> function;
+  };
+
+  struct Worker {
+    std::mutex mutex;
+    std::array<std::deque<Task>, kPriorities> queues;
+    ScratchArena scratch;
+    std::thread thread;
+  };
+
+  static bool isBulk(Priority priority) {
+    return priority == Priority::BulkIO || priority == Priority::Batch;
+  }
+
+  void workerLoop(int index);
+  bool takeTask(int index, Task* task);
+  bool takeFrom(int index, size_t priority, Task* task, bool* stolen);
+  // with mutex_ held
+  bool hasRunnableWork() const;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::array<std::deque<Task>, kPriorities> injected_;
+  std::array<int, kPriorities> queued_{};  // shared and worker queues
+  int bulkRunning_{0};
+  int bulkLimit_{1};
+  bool stopping_{false};
+
+  std::array<std::atomic<quint64>, kPriorities> executed_{};
+  std::atomic<quint64> stolen_{0};
+};
+
+// Tasks submitted together that can be cancelled and waited for as a
+// whole, e.g. by an object whose tasks post results back to it.
+class TaskGroup {
+ public:
+  explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::instance());
+  // cancels and waits
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  void submit(TaskScheduler::Priority priority, std::function<void()> task);
+  // queued tasks are skipped, running ones can poll token()
+  void cancel() { token_.cancel(); }
+  void wait();
+  const CancellationToken& token() const { return token_; }
+
+ private:
+  struct State {
+    std::mutex mutex;
+    std::condition_variable idle;
+    int pending{0};
+  };
+
+  TaskScheduler& scheduler_;
+  CancellationToken token_;
+  std::shared_ptr<State> state_;
+};
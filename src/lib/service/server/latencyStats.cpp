@@ -0,0 +1,38 @@
+#include "latencyStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+void LatencyStats::record(qint64 ns) {
+  ++count_;
+  max_ = std::max(max_, ns);
+  if (samples_.size() < kMaxSamples) {
+    samples_.push_back(ns);
+  } else {
+    samples_[next_] = ns;
+    next_ = (next_ + 1) % kMaxSamples;
+  }
+}
+
+void LatencyStats::merge(const LatencyStats& other) {
+  quint64 count = count_ + other.count_;
+  for (qint64 ns : other.samples_) record(ns);
+  count_ = count;
+  max_ = std::max(max_, other.max_);
+}
+
+qint64 LatencyStats::percentile(double p) const {
+  if (samples_.empty()) return 0;
+  std::vector<qint64> sorted = samples_;
+  size_t rank = size_t(std::ceil(p / 100.0 * sorted.size()));
+  size_t index = std::clamp<size_t>(rank, 1, sorted.size()) - 1;
+  std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+  return sorted[index];
+}
+
+QJsonObject LatencyStats::toJson() const {
+  return {{"count", qint64(count_)},
+          {"p50Us", percentile(50) / 1e3},
+          {"p99Us", percentile(99) / 1e3},
+          {"maxUs", max_ / 1e3}};
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QtGlobal>
+#include <vector>
+
+// Percentiles over the most recent kMaxSamples latencies. Not
+// synchronised: keep one per thread and merge.
+class LatencyStats {
+ public:
+  static constexpr size_t kMaxSamples = 4096;
+
+  void record(qint64 ns);
+  void merge(const LatencyStats& other);
+
+  quint64 count() const { return count_; }
+  qint64 max() const { return max_; }
+  // nearest-rank percentile in ns, p in [0, 100]; 0 without samples
+  qint64 percentile(double p) const;
+
+  // {count, p50Us, p99Us, maxUs}
+  QJsonObject toJson() const;
+
+ private:
+  std::vector<qint64> samples_;  // ring once full
+  size_t next_{0};
+  quint64 count_{0};
+  qint64 max_{0};
+};
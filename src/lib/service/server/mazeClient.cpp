@@ -0,0 +1,106 @@
+#include "mazeClient.h"
+
+#include <QJsonDocument>
+#include <QLocalSocket>
+
+MazeClient::MazeClient() = default;
+
+MazeClient::~MazeClient() { disconnectFromServer(); }
+
+bool MazeClient::connectToServer(const QString& name, int timeoutMs) {
+  disconnectFromServer();
+  timeoutMs_ = timeoutMs;
+  socket_ = std::make_unique<QLocalSocket>();
+  socket_->connectToServer(name);
+  if (!socket_->waitForConnected(timeoutMs_)) {
+    error_ = "cannot connect to " + name + ": " + socket_->errorString();
+    socket_.reset();
+    return false;
+  }
+  return true;
+}
+
+void MazeClient::disconnectFromServer() {
+  if (!socket_) return;
+  socket_->disconnectFromServer();
+  socket_.reset();
+  buffer_.clear();
+}
+
+quint32 MazeClient::generate(quint32 rows, quint32 cols, quint32 seed) {
+  protocol::Request request;
+  request.type = protocol::MessageType::Generate;
+  request.rows = rows;
+  request.cols = cols;
+  request.seed = seed;
+
+  protocol::Response response;
+  if (!call(request, &response)) return 0;
+  return response.mazeId;
+}
+
+bool MazeClient::solve(quint32 mazeId,
+                       const std::vector<protocol::Query>& queries,
+                       std::vector<std::vector<QPoint>>* paths) {
+  protocol::Request request;
+  request.type = protocol::MessageType::Solve;
+  request.mazeId = mazeId;
+  request.queries = queries;
+
+  protocol::Response response;
+  if (!call(request, &response)) return false;
+  if (response.paths.size() != queries.size()) {
+    error_ = "path count does not match the queries";
+    return false;
+  }
+  *paths = std::move(response.paths);
+  return true;
+}
+
+QJsonObject MazeClient::stats() {
+  protocol::Request request;
+  request.type = protocol::MessageType::Stats;
+
+  protocol::Response response;
+  if (!call(request, &response)) return {};
+  return QJsonDocument::fromJson(response.text).object();
+}
+
+bool MazeClient::call(const protocol::Request& request,
+                      protocol::Response* response) {
+  if (!socket_) {
+    error_ = "not connected";
+    return false;
+  }
+
+  protocol::Request addressed = request;
+  addressed.id = nextId_++;
+  socket_->write(protocol::encode(addressed));
+  if (!socket_->waitForBytesWritten(timeoutMs_)) {
+    error_ = "write failed: " + socket_->errorString();
+    return false;
+  }
+
+  QByteArray payload;
+  bool tooLarge = false;
+  while (!protocol::takeFrame(buffer_, &payload, &tooLarge)) {
+    if (tooLarge || !socket_->waitForReadyRead(timeoutMs_)) {
+      error_ = tooLarge ? "reply too large"
+                        : "no reply: " + socket_->errorString();
+      disconnectFromServer();
+      return false;
+    }
+    buffer_.append(socket_->readAll());
+  }
+
+  if (!protocol::decode(payload, response) || response->id != addressed.id) {
+    error_ = "malformed reply";
+    disconnectFromServer();
+    return false;
+  }
+  if (response->type == protocol::MessageType::Error) {
+    error_ = QString::fromUtf8(response->text);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <memory>
+#include <vector>
+
+#include "src/lib/service/server/protocol.h"
+
+class QLocalSocket;
+
+// Blocking client for MazeServer with one request in flight. Works
+// without an event loop, so load drivers can run one per thread; create
+// it on the thread that uses it.
+class MazeClient {
+ public:
+  static constexpr int kDefaultTimeoutMs = 30000;
+
+  MazeClient();
+  ~MazeClient();
+
+  bool connectToServer(const QString& name,
+                       int timeoutMs = kDefaultTimeoutMs);
+  void disconnectFromServer();
+  const QString& error() const { return error_; }
+
+  // id of the resident maze, 0 on failure
+  quint32 generate(quint32 rows, quint32 cols, quint32 seed);
+  bool solve(quint32 mazeId, const std::vector<protocol::Query>& queries,
+             std::vector<std::vector<QPoint>>* paths);
+  // server stats, empty on failure
+  QJsonObject stats();
+
+ private:
+  bool call(const protocol::Request& request, protocol::Response* response);
+
+  std::unique_ptr<QLocalSocket> socket_;
+  QByteArray buffer_;
+  QString error_;
+  quint32 nextId_{1};
+  int timeoutMs_{kDefaultTimeoutMs};
+};
@@ -0,0 +1,332 @@
+#include "mazeServer.h"
+
+#include <QJsonDocument>
+#include <QLocalSocket>
+#include <QTimer>
+#include <algorithm>
+#include <numeric>
+
+#include "src/lib/service/cache/mazeCache.h"
+#include "src/lib/service/metrics/metrics.h"
+#include "src/lib/service/solver/solver.h"
+
+namespace {
+// answers the queries in order; queries sharing a start share one BFS
+std::vector<std::vector<QPoint>> solveQueries(
+    const MazeData& maze, const std::vector<protocol::Query>& queries) {
+  MAZE_SCOPED_TIMER(SolveBatch);
+  std::vector<size_t> order(queries.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    QPoint sa = queries[a].start, sb = queries[b].start;
+    return std::make_pair(sa.x(), sa.y()) < std::make_pair(sb.x(), sb.y());
+  });
+
+  Solver solver;
+  std::vector<std::vector<QPoint>> paths(queries.size());
+  std::vector<QPoint> ends;
+  for (size_t first = 0; first < order.size();) {
+    QPoint start = queries[order[first]].start;
+    size_t last = first;
+    ends.clear();
+    while (last < order.size() && queries[order[last]].start == start) {
+      ends.push_back(queries[order[last++]].end);
+    }
+
+    auto found = solver.solveFrom(maze, start, ends);
+    for (size_t i = first; i < last; ++i) {
+      paths[order[i]] = std::move(found[i - first]);
+    }
+    first = last;
+  }
+  return paths;
+}
+}  // namespace
+
+MazeServer::MazeServer(QObject* parent) : QObject(parent) {
+  connect(&server_, &QLocalServer::newConnection, this,
+          &MazeServer::onNewConnection);
+}
+
+MazeServer::~MazeServer() {
+  // queued replies to this object are dropped once it is gone
+  tasks_.cancel();
+  tasks_.wait();
+}
+
+bool MazeServer::listen(const QString& name) {
+  QLocalServer::removeServer(name);
+  return server_.listen(name);
+}
+
+QString MazeServer::errorString() const { return server_.errorString(); }
+
+QString MazeServer::fullServerName() const {
+  return server_.fullServerName();
+}
+
+void MazeServer::setWorkerThreads(int threads) {
+  workerThreads_ = qMax(threads, 1);
+}
+
+void MazeServer::setResidentCells(qint64 cells) {
+  maxResidentCells_ = qMax<qint64>(cells, 1);
+}
+
+QJsonObject MazeServer::stats() const {
+  return {{"generate", generateLatency_.toJson()},
+          {"solve", solveLatency_.toJson()},
+          {"batches", qint64(batches_)},
+          {"batchedRequests", qint64(batchedRequests_)},
+          {"batchedQueries", qint64(batchedQueries_)},
+          {"largestBatch", qint64(largestBatch_)},
+          {"residentMazes", qint64(mazes_.size())},
+          {"residentCells", residentCells_},
+          {"evictions", qint64(evictions_)},
+          {"workerThreads", workerThreads_},
+          {"cache", MazeCache::instance().toJson()},
+          {"scheduler", TaskScheduler::instance().toJson()}};
+}
+
+void MazeServer::onNewConnection() {
+  while (QLocalSocket* socket = server_.nextPendingConnection()) {
+    buffers_.insert(socket, {});
+    connect(socket, &QLocalSocket::readyRead, this,
+            [this, socket]() { onReadyRead(socket); });
+    connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+      buffers_.remove(socket);
+      socket->deleteLater();
+    });
+  }
+}
+
+void MazeServer::onReadyRead(QLocalSocket* socket) {
+  QByteArray& buffer = buffers_[socket];
+  buffer.append(socket->readAll());
+
+  QByteArray payload;
+  bool error = false;
+  while (protocol::takeFrame(buffer, &payload, &error)) {
+    Client client{socket, 0, Metrics::nowNs()};
+    protocol::Request request;
+    if (!protocol::decode(payload, &request)) {
+      replyError(client, "malformed request");
+      continue;
+    }
+    client.requestId = request.id;
+
+    switch (request.type) {
+      case protocol::MessageType::Generate:
+        handleGenerate(client, request);
+        break;
+      case protocol::MessageType::Solve:
+        handleSolve(client, std::move(request));
+        break;
+      default: {
+        protocol::Response response;
+        response.type = protocol::MessageType::StatsReply;
+        response.text = QJsonDocument(stats()).toJson(QJsonDocument::Compact);
+        reply(client, response);
+        break;
+      }
+    }
+  }
+
+  if (error) {
+    // the stream can't be resynchronised after a bogus size
+    replyError({socket, 0, Metrics::nowNs()}, "frame too large");
+    buffers_.remove(socket);
+    socket->disconnectFromServer();
+  }
+}
+
+void MazeServer::handleGenerate(const Client& client,
+                                const protocol::Request& request) {
+  if (request.rows < 1 || request.cols < 1 || request.rows > kMaxSide ||
+      request.cols > kMaxSide ||
+      qint64(request.rows) * request.cols > maxResidentCells_) {
+    replyError(client, QString("invalid dimensions: %1x%2")
+                           .arg(request.rows)
+                           .arg(request.cols));
+    return;
+  }
+
+  MazeKey key{request.rows, request.cols, request.seed};
+  auto resident = mazeIds_.find(key);
+  if (resident != mazeIds_.end()) {
+    touchMaze(resident->second);
+    protocol::Response response;
+    response.type = protocol::MessageType::MazeId;
+    response.mazeId = resident->second;
+    reply(client, response);
+    generateLatency_.record(Metrics::nowNs() - client.receivedNs);
+    return;
+  }
+
+  // concurrent requests for the same maze wait for one generation
+  std::vector<Client>& waiting = generating_[key];
+  waiting.push_back(client);
+  if (waiting.size() > 1) return;
+
+  // a maze evicted from the resident set may still be in the cache
+  tasks_.submit(TaskScheduler::Priority::Batch, [this, key]() {
+    auto maze = MazeCache::instance().generate(
+        int(std::get<0>(key)), int(std::get<1>(key)), std::get<2>(key));
+    QMetaObject::invokeMethod(
+        this, [this, key, maze]() { finishGenerate(key, maze); },
+        Qt::QueuedConnection);
+  });
+}
+
+void MazeServer::finishGenerate(const MazeKey& key,
+                                std::shared_ptr<const MazeData> maze) {
+  quint32 mazeId = storeMaze(key, std::move(maze));
+
+  protocol::Response response;
+  response.type = protocol::MessageType::MazeId;
+  response.mazeId = mazeId;
+  qint64 now = Metrics::nowNs();
+  for (const Client& client : generating_[key]) {
+    reply(client, response);
+    generateLatency_.record(now - client.receivedNs);
+  }
+  generating_.erase(key);
+}
+
+void MazeServer::handleSolve(const Client& client,
+                             protocol::Request&& request) {
+  if (!mazes_.contains(request.mazeId)) {
+    replyError(client, QString("unknown maze %1").arg(request.mazeId));
+    return;
+  }
+  pendingSolves_[request.mazeId].push_back(
+      {client, std::move(request.queries)});
+  scheduleBatches();
+}
+
+void MazeServer::scheduleBatches() {
+  // everything already read in this event loop turn joins the batch
+  if (batchesScheduled_) return;
+  batchesScheduled_ = true;
+  QTimer::singleShot(0, this, &MazeServer::startBatches);
+}
+
+void MazeServer::startBatches() {
+  batchesScheduled_ = false;
+
+  for (auto it = pendingSolves_.begin(); it != pendingSolves_.end();) {
+    quint32 mazeId = it.key();
+    std::vector<PendingSolve>& pending = it.value();
+    int& inFlight = batchesInFlight_[mazeId];
+    int idle = workerThreads_ - inFlight;
+    if (idle <= 0) {
+      ++it;  // resumed by finishBatch
+      continue;
+    }
+
+    std::shared_ptr<const MazeData> maze = touchMaze(mazeId);
+    if (!maze) {
+      for (const PendingSolve& solve : pending) {
+        replyError(solve.client, QString("unknown maze %1").arg(mazeId));
+      }
+      it = pendingSolves_.erase(it);
+      continue;
+    }
+
+    // spread the requests over the idle workers, in arrival order
+    size_t count = std::min(pending.size(), size_t(idle));
+    for (size_t i = 0; i < count; ++i) {
+      std::vector<PendingSolve> batch(
+          std::make_move_iterator(pending.begin() + pending.size() * i / count),
+          std::make_move_iterator(pending.begin() +
+                                  pending.size() * (i + 1) / count));
+      ++inFlight;
+
+      // a client is waiting on every batch
+      auto priority = TaskScheduler::Priority::Interactive;
+      tasks_.submit(priority, [this, mazeId, maze,
+                               batch = std::move(batch)]() mutable {
+        std::vector<protocol::Query> queries;
+        for (const PendingSolve& solve : batch) {
+          queries.insert(queries.end(), solve.queries.begin(),
+                         solve.queries.end());
+        }
+        auto paths = solveQueries(*maze, queries);
+        QMetaObject::invokeMethod(
+            this,
+            [this, mazeId, batch = std::move(batch),
+             paths = std::move(paths)]() mutable {
+              finishBatch(mazeId, std::move(batch), std::move(paths));
+            },
+            Qt::QueuedConnection);
+      });
+    }
+    it = pendingSolves_.erase(it);
+  }
+}
+
+void MazeServer::finishBatch(quint32 mazeId, std::vector<PendingSolve> batch,
+                             std::vector<std::vector<QPoint>> paths) {
+  if (--batchesInFlight_[mazeId] == 0) batchesInFlight_.remove(mazeId);
+
+  ++batches_;
+  batchedRequests_ += batch.size();
+  batchedQueries_ += paths.size();
+  largestBatch_ = std::max<quint64>(largestBatch_, batch.size());
+
+  qint64 now = Metrics::nowNs();
+  auto next = std::make_move_iterator(paths.begin());
+  for (const PendingSolve& solve : batch) {
+    protocol::Response response;
+    response.type = protocol::MessageType::Paths;
+    response.paths.assign(next, next + qsizetype(solve.queries.size()));
+    next += qsizetype(solve.queries.size());
+    reply(solve.client, response);
+    solveLatency_.record(now - solve.client.receivedNs);
+  }
+
+  if (pendingSolves_.contains(mazeId)) scheduleBatches();
+}
+
+void MazeServer::reply(const Client& client,
+                       const protocol::Response& response) {
+  if (!client.socket) return;  // gone while we were working
+  protocol::Response addressed = response;
+  addressed.id = client.requestId;
+  client.socket->write(protocol::encode(addressed));
+}
+
+void MazeServer::replyError(const Client& client, const QString& message) {
+  protocol::Response response;
+  response.type = protocol::MessageType::Error;
+  response.text = message.toUtf8();
+  reply(client, response);
+}
+
+quint32 MazeServer::storeMaze(const MazeKey& key,
+                              std::shared_ptr<const MazeData> maze) {
+  quint32 mazeId = nextMazeId_++;
+  residentCells_ += qint64(maze->rows) * maze->cols;
+  lru_.push_front(mazeId);
+  mazes_.insert(mazeId, {key, std::move(maze), lru_.begin()});
+  mazeIds_[key] = mazeId;
+
+  // running batches keep their own reference to an evicted maze
+  while (residentCells_ > maxResidentCells_ && lru_.size() > 1) {
+    quint32 victim = lru_.back();
+    lru_.pop_back();
+    const ResidentMaze& resident = mazes_[victim];
+    residentCells_ -= qint64(resident.maze->rows) * resident.maze->cols;
+    mazeIds_.erase(resident.key);
+    mazes_.remove(victim);
+    ++evictions_;
+  }
+  return mazeId;
+}
+
+std::shared_ptr<const MazeData> MazeServer::touchMaze(quint32 mazeId) {
+  auto it = mazes_.find(mazeId);
+  if (it == mazes_.end()) return {};
+  lru_.splice(lru_.begin(), lru_, it->lru);
+  return it->maze;
+}
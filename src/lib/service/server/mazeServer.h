@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QPointer>
+#include <list>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+#include "src/lib/service/server/latencyStats.h"
+#include "src/lib/service/server/protocol.h"
+
+class QLocalSocket;
+
+// Serves the requests of protocol.h to other processes on this machine.
+//
+// Generation (Batch) and solving (Interactive) run on the shared
+// TaskScheduler; this object's thread only splits frames and routes
+// replies. Solve requests for one maze that arrive while the workers are
+// busy queue up and leave together as a batch, in which queries sharing a
+// start are answered by a single BFS. Generated mazes stay resident until
+// residentCells is exceeded (least recently used first out); asking for
+// the same rows, cols and seed again returns the resident maze.
+class MazeServer : public QObject {
+  Q_OBJECT
+
+ public:
+  static constexpr qint64 kDefaultResidentCells = qint64(1) << 26;
+  static constexpr int kMaxSide = 65536;
+
+  explicit MazeServer(QObject* parent = nullptr);
+  ~MazeServer() override;
+
+  // replaces a stale socket left behind by a crashed server
+  bool listen(const QString& name);
+  QString errorString() const;
+  QString fullServerName() const;
+
+  // scheduler workers it occupies at most, all of them by default
+  void setWorkerThreads(int threads);
+  void setResidentCells(qint64 cells);
+
+  // latency per request type, batching and residency counters
+  QJsonObject stats() const;
+
+ private:
+  using MazeKey = std::tuple<quint32, quint32, quint32>;  // rows, cols, seed
+
+  struct Client {
+    QPointer<QLocalSocket> socket;
+    quint32 requestId{0};
+    qint64 receivedNs{0};
+  };
+
+  struct PendingSolve {
+    Client client;
+    std::vector<protocol::Query> queries;
+  };
+
+  struct ResidentMaze {
+    MazeKey key;
+    std::shared_ptr<const MazeData> maze;
+    std::list<quint32>::iterator lru;
+  };
+
+  void onNewConnection();
+  void onReadyRead(QLocalSocket* socket);
+  void handleGenerate(const Client& client, const protocol::Request& request);
+  void handleSolve(const Client& client, protocol::Request&& request);
+  void scheduleBatches();
+  void startBatches();
+  void finishGenerate(const MazeKey& key, std::shared_ptr<const MazeData> maze);
+  void finishBatch(quint32 mazeId, std::vector<PendingSolve> batch,
+                   std::vector<std::vector<QPoint>> paths);
+
+  void reply(const Client& client, const protocol::Response& response);
+  void replyError(const Client& client, const QString& message);
+  quint32 storeMaze(const MazeKey& key, std::shared_ptr<const MazeData> maze);
+  std::shared_ptr<const MazeData> touchMaze(quint32 mazeId);
+
+  QLocalServer server_;
+  TaskGroup tasks_;
+  int workerThreads_{TaskScheduler::instance().threadCount()};
+  QHash<QLocalSocket*, QByteArray> buffers_;
+
+  QHash<quint32, ResidentMaze> mazes_;
+  std::map<MazeKey, quint32> mazeIds_;
+  std::list<quint32> lru_;  // most recently used first
+  qint64 residentCells_{0};
+  qint64 maxResidentCells_{kDefaultResidentCells};
+  quint32 nextMazeId_{1};
+
+  std::map<MazeKey, std::vector<Client>> generating_;
+  QHash<quint32, std::vector<PendingSolve>> pendingSolves_;
+  QHash<quint32, int> batchesInFlight_;
+  bool batchesScheduled_{false};
+
+  LatencyStats generateLatency_;
+  LatencyStats solveLatency_;
+  quint64 batches_{0};
+  quint64 batchedRequests_{0};
+  quint64 batchedQueries_{0};
+  quint64 largestBatch_{0};
+  quint64 evictions_{0};
+};
@@ -0,0 +1,194 @@
+#include "protocol.h"
+
+#include <QDataStream>
+#include <QIODevice>
+#include <array>
+
+namespace protocol {
+namespace {
+const std::array<QPoint, 4> kSteps = {QPoint(-1, 0), QPoint(0, 1),
+                                      QPoint(1, 0), QPoint(0, -1)};
+
+// size prefix is patched in once the payload is complete
+QByteArray finish(QByteArray payload) {
+  quint32 size = quint32(payload.size() - 4);
+  for (int i = 0; i < 4; ++i) payload[i] = char((size >> (8 * i)) & 0xff);
+  return payload;
+}
+
+QDataStream& begin(QDataStream& out, MessageType type, quint32 id) {
+  out.setByteOrder(QDataStream::LittleEndian);
+  out << quint32(0) << quint8(type) << id;
+  return out;
+}
+
+void writePath(QDataStream& out, const std::vector<QPoint>& path) {
+  out << quint32(path.size());
+  if (path.empty()) return;
+  out << qint32(path.front().x()) << qint32(path.front().y());
+  for (size_t i = 1; i < path.size(); ++i) {
+    QPoint step = path[i] - path[i - 1];
+    quint8 direction = 0;
+    while (direction < 3 && kSteps[direction] != step) ++direction;
+    out << direction;
+  }
+}
+
+bool readPath(QDataStream& in, std::vector<QPoint>* path) {
+  quint32 cells = 0;
+  in >> cells;
+  if (in.status() != QDataStream::Ok || cells > kMaxFrameBytes) return false;
+  path->clear();
+  if (cells == 0) return true;
+
+  qint32 row = 0, col = 0;
+  in >> row >> col;
+  path->reserve(cells);
+  path->emplace_back(row, col);
+  for (quint32 i = 1; i < cells; ++i) {
+    quint8 direction = 0;
+    in >> direction;
+    if (direction > 3) return false;
+    path->push_back(path->back() + kSteps[direction]);
+  }
+  return in.status() == QDataStream::Ok;
+}
+
+void writeText(QDataStream& out, const QByteArray& text) {
+  out << quint32(text.size());
+  out.writeRawData(text.constData(), int(text.size()));
+}
+
+bool readText(QDataStream& in, QByteArray* text) {
+  quint32 size = 0;
+  in >> size;
+  if (in.status() != QDataStream::Ok || size > kMaxFrameBytes) return false;
+  text->resize(size);
+  return in.readRawData(text->data(), int(size)) == int(size);
+}
+}  // namespace
+
+QByteArray encode(const Request& request) {
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  begin(out, request.type, request.id);
+
+  switch (request.type) {
+    case MessageType::Generate:
+      out << request.rows << request.cols << request.seed;
+      break;
+    case MessageType::Solve:
+      out << request.mazeId << quint32(request.queries.size());
+      for (const Query& query : request.queries) {
+        out << qint32(query.start.x()) << qint32(query.start.y())
+            << qint32(query.end.x()) << qint32(query.end.y());
+      }
+      break;
+    default:
+      break;
+  }
+  return finish(payload);
+}
+
+QByteArray encode(const Response& response) {
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  begin(out, response.type, response.id);
+
+  switch (response.type) {
+    case MessageType::MazeId:
+      out << response.mazeId;
+      break;
+    case MessageType::Paths:
+      out << quint32(response.paths.size());
+      for (const auto& path : response.paths) writePath(out, path);
+      break;
+    default:
+      writeText(out, response.text);
+      break;
+  }
+  return finish(payload);
+}
+
+bool decode(const QByteArray& payload, Request* request) {
+  QDataStream in(payload);
+  in.setByteOrder(QDataStream::LittleEndian);
+  quint8 type = 0;
+  in >> type >> request->id;
+  request->type = MessageType(type);
+
+  switch (request->type) {
+    case MessageType::Generate:
+      in >> request->rows >> request->cols >> request->seed;
+      break;
+    case MessageType::Solve: {
+      quint32 count = 0;
+      in >> request->mazeId >> count;
+      // each query takes 16 bytes, reject counts the payload can't hold
+      if (count > quint32(payload.size()) / 16) return false;
+      request->queries.resize(count);
+      for (Query& query : request->queries) {
+        qint32 sr = 0, sc = 0, er = 0, ec = 0;
+        in >> sr >> sc >> er >> ec;
+        query = {{sr, sc}, {er, ec}};
+      }
+      break;
+    }
+    case MessageType::Stats:
+      break;
+    default:
+      return false;
+  }
+  return in.status() == QDataStream::Ok;
+}
+
+bool decode(const QByteArray& payload, Response* response) {
+  QDataStream in(payload);
+  in.setByteOrder(QDataStream::LittleEndian);
+  quint8 type = 0;
+  in >> type >> response->id;
+  response->type = MessageType(type);
+
+  switch (response->type) {
+    case MessageType::MazeId:
+      in >> response->mazeId;
+      break;
+    case MessageType::Paths: {
+      quint32 count = 0;
+      in >> count;
+      // every path takes at least its u32 size
+      if (count > quint32(payload.size()) / 4) return false;
+      response->paths.resize(count);
+      for (auto& path : response->paths) {
+        if (!readPath(in, &path)) return false;
+      }
+      break;
+    }
+    case MessageType::StatsReply:
+    case MessageType::Error:
+      if (!readText(in, &response->text)) return false;
+      break;
+    default:
+      return false;
+  }
+  return in.status() == QDataStream::Ok;
+}
+
+bool takeFrame(QByteArray& buffer, QByteArray* payload, bool* error) {
+  *error = false;
+  if (buffer.size() < 4) return false;
+
+  quint32 size = 0;
+  for (int i = 0; i < 4; ++i) size |= quint32(quint8(buffer[i])) << (8 * i);
+  if (size > kMaxFrameBytes) {
+    *error = true;
+    return false;
+  }
+  if (quint32(buffer.size()) - 4 < size) return false;
+
+  *payload = buffer.mid(4, size);
+  buffer.remove(0, 4 + qsizetype(size));
+  return true;
+}
+
+}  // namespace protocol
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QByteArray>
+#include <QPoint>
+#include <QString>
+#include <vector>
+
+// Wire format of the local maze service, all integers little-endian.
+//
+//   frame     u32 payloadSize, payload
+//   payload   u8 type, u32 requestId, body
+//
+//   Generate  u32 rows, u32 cols, u32 seed    -> MazeId u32 mazeId
+//   Solve     u32 mazeId, u32 count,          -> Paths  u32 count, paths
+//             count x i32 sr, sc, er, ec
+//   Stats     (empty)                         -> StatsReply u32 size, JSON
+//   any                                       -> Error  u32 size, UTF-8
+//
+// A path is u32 cells; when non-zero i32 row, i32 col of the first cell
+// and one direction byte (0 up, 1 right, 2 down, 3 left) per step.
+// Replies carry the requestId of their request and may arrive out of
+// order.
+namespace protocol {
+
+constexpr quint32 kMaxFrameBytes = 64u << 20;
+
+enum class MessageType : quint8 {
+  Generate = 0x01,
+  Solve = 0x02,
+  Stats = 0x03,
+  MazeId = 0x81,
+  Paths = 0x82,
+  StatsReply = 0x83,
+  Error = 0xff,
+};
+
+struct Query {
+  QPoint start;
+  QPoint end;
+};
+
+struct Request {
+  MessageType type{MessageType::Stats};
+  quint32 id{0};
+  quint32 rows{0};
+  quint32 cols{0};
+  quint32 seed{0};
+  quint32 mazeId{0};
+  std::vector<Query> queries;
+};
+
+struct Response {
+  MessageType type{MessageType::Error};
+  quint32 id{0};
+  quint32 mazeId{0};
+  std::vector<std::vector<QPoint>> paths;
+  QByteArray text;  // stats JSON or error message
+};
+
+// payloads with their size prefix, ready to write
+QByteArray encode(const Request& request);
+QByteArray encode(const Response& response);
+
+bool decode(const QByteArray& payload, Request* request);
+bool decode(const QByteArray& payload, Response* response);
+
+// Moves the next complete payload out of buffer. Returns false while the
+// frame is incomplete; sets *error for a frame over kMaxFrameBytes.
+bool takeFrame(QByteArray& buffer, QByteArray* payload, bool* error);
+
+}  // namespace protocol
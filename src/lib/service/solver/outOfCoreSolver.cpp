@@ -0,0 +1,354 @@
+#include "outOfCoreSolver.h"
+
+#include <QDir>
+#include <algorithm>
+#include <iterator>
+
+#include "src/lib/service/metrics/metrics.h"
+
+namespace {
+// per cell: its two walls and the distance and move of the state
+constexpr qint64 kSlotCellBytes = qint64(sizeof(MazeCell)) + 4 + 1;
+
+int opposite(int move) { return (move + 2) & 3; }
+}  // namespace
+
+OutOfCoreSolver::OutOfCoreSolver(qint64 memoryBytes, const QString& workDir)
+    : memoryBytes_(memoryBytes), workDir_(workDir) {}
+
+bool OutOfCoreSolver::open(const QString& archivePath) {
+  error_.clear();
+  slots_.clear();
+  slotOf_.clear();
+  state_.reset();
+  spill_.reset();
+  if (!archive_.open(archivePath)) return fail(archive_.error());
+
+  tileSize_ = archive_.tileSize();
+  tileCols_ = archive_.tileCols();
+  const qint64 tiles = qint64(archive_.tileRows()) * tileCols_;
+  if (tileSize_ > kMaxTileSize || tiles > kMaxTiles) {
+    return fail(QString("tiles of %1 cells don't suit out-of-core solving")
+                    .arg(tileSize_));
+  }
+  tileCells_ = qint64(tileSize_) * tileSize_;
+  stateWritten_.assign(size_t(tiles), false);
+
+  // a quarter for the inboxes, the rest for the slots after the
+  // expansion queue and the seeds of one tile
+  const qint64 slotBytes =
+      tileCells_ * kSlotCellBytes + tileSize_ * qint64(sizeof(MazeCell*) * 3);
+  const qint64 inboxBytes = memoryBytes_ / 4;
+  const qint64 slotsBytes = memoryBytes_ - inboxBytes - tileCells_ * 4;
+  slotLimit_ = int(std::clamp<qint64>(slotsBytes / slotBytes, 2, tiles + 1));
+  inboxLimit_ = std::max<qint64>(inboxBytes / qint64(sizeof(Entry)), 256);
+
+  QString dir = workDir_.isEmpty() ? QDir::tempPath() : workDir_;
+  state_ = std::make_unique<QTemporaryFile>(dir + "/maze_state_XXXXXX");
+  spill_ = std::make_unique<QTemporaryFile>(dir + "/maze_frontier_XXXXXX");
+  if (!state_->open() || !spill_->open()) {
+    return fail("cannot create scratch files in " + dir);
+  }
+  return true;
+}
+
+bool OutOfCoreSolver::solve(QPoint start, QPoint end, PackedPath* path) {
+  MAZE_SCOPED_TIMER(Solve);
+  path->clear();
+  stats_ = {};
+  if (!state_) return fail("no maze archive open");
+  error_.clear();
+
+  if (start.x() < 0 || start.x() >= rows() || start.y() < 0 ||
+      start.y() >= cols() || end.x() < 0 || end.x() >= rows() ||
+      end.y() < 0 || end.y() >= cols()) {
+    return true;
+  }
+  if (start == end) {
+    path->startRow = start.x();
+    path->startCol = start.y();
+    path->cells = 1;
+    return true;
+  }
+
+  reset();
+  const int endTile = tileOf(end.x(), end.y());
+  const quint32 endCell = localOf(end.x(), end.y());
+  quint32 endDist = kUnreached;
+
+  int cursor = tileOf(start.x(), start.y());
+  post(cursor, localOf(start.x(), start.y()), 0, kNoMove);
+  bool up = true;
+  while (!inboxes_.empty() && *inboxMins_.begin() < endDist) {
+    // the next tile with mail in the current direction, else turn
+    auto next = inboxes_.end();
+    if (up) {
+      next = inboxes_.lower_bound(cursor);
+    } else if (auto below = inboxes_.upper_bound(cursor);
+               below != inboxes_.begin()) {
+      next = std::prev(below);
+    }
+    if (next == inboxes_.end()) {
+      up = !up;
+      ++stats_.sweeps;
+      continue;
+    }
+
+    cursor = next->first;
+    if (!process(cursor)) return false;
+    if (cursor == endTile) {
+      Slot* slot = acquire(endTile, false);
+      if (!slot) return false;
+      endDist = slot->dist[endCell];
+    }
+  }
+
+  MAZE_COUNT(NodesExpanded, stats_.expanded);
+  if (endDist == kUnreached) return true;
+  return tracePath(start, end, endDist, path);
+}
+
+void OutOfCoreSolver::reset() {
+  // walls stay valid from solve to solve, the state starts over
+  for (Slot& slot : slots_) slot.hasState = slot.dirty = false;
+  std::fill(stateWritten_.begin(), stateWritten_.end(), false);
+  inboxes_.clear();
+  inboxMins_.clear();
+  buffered_ = 0;
+  spillEnd_ = 0;
+}
+
+OutOfCoreSolver::Slot* OutOfCoreSolver::acquire(int tile, bool withWalls) {
+  Slot* slot = nullptr;
+  if (auto found = slotOf_.find(tile); found != slotOf_.end()) {
+    slot = &slots_[size_t(found->second)];
+  } else {
+    if (int(slots_.size()) < slotLimit_) {
+      slots_.emplace_back();
+      slot = &slots_.back();
+      slot->dist.resize(size_t(tileCells_));
+      slot->move.resize(size_t(tileCells_));
+    } else {
+      slot = &*std::min_element(
+          slots_.begin(), slots_.end(),
+          [](const Slot& a, const Slot& b) { return a.used < b.used; });
+      if (!writeBack(*slot)) return nullptr;
+      slotOf_.erase(slot->tile);
+    }
+    slot->tile = tile;
+    slot->hasWalls = slot->hasState = false;
+    slotOf_[tile] = int(slot - slots_.data());
+  }
+
+  if (!slot->hasState) {
+    if (stateWritten_[size_t(tile)]) {
+      const qint64 distBytes = tileCells_ * 4;
+      if (!state_->seek(stateOffset(tile)) ||
+          state_->read(reinterpret_cast<char*>(slot->dist.data()),
+                       distBytes) != distBytes ||
+          state_->read(reinterpret_cast<char*>(slot->move.data()),
+                       tileCells_) != tileCells_) {
+        fail("cannot read the search state");
+        return nullptr;
+      }
+      ++stats_.stateReads;
+    } else {
+      std::fill(slot->dist.begin(), slot->dist.end(), kUnreached);
+    }
+    slot->hasState = true;
+    slot->dirty = false;
+  }
+
+  if (withWalls && !slot->hasWalls) {
+    if (!archive_.readTile(tile / tileCols_, tile % tileCols_,
+                           &slot->walls)) {
+      fail(QString("damaged archive tile [%1,%2]")
+               .arg(tile / tileCols_)
+               .arg(tile % tileCols_));
+      return nullptr;
+    }
+    slot->hasWalls = true;
+    ++stats_.wallReads;
+  }
+
+  slot->used = ++clock_;
+  return slot;
+}
+
+bool OutOfCoreSolver::writeBack(Slot& slot) {
+  if (!slot.hasState || !slot.dirty) return true;
+  const qint64 distBytes = tileCells_ * 4;
+  if (!state_->seek(stateOffset(slot.tile)) ||
+      state_->write(reinterpret_cast<const char*>(slot.dist.data()),
+                    distBytes) != distBytes ||
+      state_->write(reinterpret_cast<const char*>(slot.move.data()),
+                    tileCells_) != tileCells_) {
+    return fail("cannot write the search state");
+  }
+  stateWritten_[size_t(slot.tile)] = true;
+  slot.dirty = false;
+  ++stats_.stateWrites;
+  return true;
+}
+
+void OutOfCoreSolver::post(int tile, quint32 cell, quint32 dist, int move) {
+  Inbox& inbox = inboxes_[tile];
+  if (dist < inbox.minDist) {
+    if (inbox.minDist != kUnreached) {
+      inboxMins_.erase(inboxMins_.find(inbox.minDist));
+    }
+    inbox.minDist = dist;
+    inboxMins_.insert(dist);
+  }
+  inbox.buffer.push_back({cell | quint32(move) << kMoveShift, dist});
+  ++buffered_;
+}
+
+bool OutOfCoreSolver::spill() {
+  // every buffer at once, in tile order, so the writes are sequential
+  if (!spill_->seek(spillEnd_)) return fail("cannot spill the frontier");
+  for (auto& [tile, inbox] : inboxes_) {
+    if (inbox.buffer.empty()) continue;
+    const qint64 bytes = qint64(inbox.buffer.size() * sizeof(Entry));
+    if (spill_->write(reinterpret_cast<const char*>(inbox.buffer.data()),
+                      bytes) != bytes) {
+      return fail("cannot spill the frontier");
+    }
+    inbox.chunks.push_back({spillEnd_, quint32(inbox.buffer.size())});
+    spillEnd_ += bytes;
+    stats_.spilledEntries += qint64(inbox.buffer.size());
+    std::vector<Entry>().swap(inbox.buffer);
+  }
+  buffered_ = 0;
+  return true;
+}
+
+bool OutOfCoreSolver::process(int tile) {
+  auto taken = inboxes_.extract(tile);
+  Inbox& inbox = taken.mapped();
+  inboxMins_.erase(inboxMins_.find(inbox.minDist));
+  buffered_ -= qint64(inbox.buffer.size());
+  ++stats_.tilesProcessed;
+
+  seeds_.clear();
+  for (const Chunk& chunk : inbox.chunks) {
+    const size_t at = seeds_.size();
+    const qint64 bytes = qint64(chunk.count) * qint64(sizeof(Entry));
+    seeds_.resize(at + chunk.count);
+    if (!spill_->seek(chunk.offset) ||
+        spill_->read(reinterpret_cast<char*>(seeds_.data() + at), bytes) !=
+            bytes) {
+      return fail("cannot read the spilled frontier");
+    }
+  }
+  seeds_.insert(seeds_.end(), inbox.buffer.begin(), inbox.buffer.end());
+  std::sort(seeds_.begin(), seeds_.end(),
+            [](const Entry& a, const Entry& b) { return a.dist < b.dist; });
+  if (inboxes_.empty()) {
+    // nothing else spilled is left, start the file over
+    spillEnd_ = 0;
+  }
+
+  Slot* slot = acquire(tile, true);
+  if (!slot) return false;
+  const MazeData& walls = slot->walls;
+  quint32* dist = slot->dist.data();
+  quint8* arrival = slot->move.data();
+  const int row0 = (tile / tileCols_) * tileSize_;
+  const int col0 = (tile % tileCols_) * tileSize_;
+  const int tileRows = walls.rows;
+  const int tileCols = walls.cols;
+
+  // seeds and expanded cells merged by distance, so every cell is set
+  // once per visit, to its shortest distance from this inbox
+  queue_.clear();
+  size_t seed = 0;
+  size_t head = 0;
+  while (true) {
+    quint32 cell = 0;
+    if (seed < seeds_.size() &&
+        (head == queue_.size() || seeds_[seed].dist <= dist[queue_[head]])) {
+      const Entry& entry = seeds_[seed++];
+      cell = entry.cellMove & kCellMask;
+      const int move = int(entry.cellMove >> kMoveShift);
+      if (entry.dist >= dist[cell]) continue;
+      // walls on the tile's top and left edges belong to this tile, the
+      // sender couldn't check them
+      const MazeCell& here = walls.cells[cell / tileSize_][cell % tileSize_];
+      if ((move == 0 && here.bottomWall) || (move == 3 && here.rightWall)) {
+        continue;
+      }
+      dist[cell] = entry.dist;
+      arrival[cell] = quint8(move);
+    } else if (head < queue_.size()) {
+      cell = queue_[head++];
+    } else {
+      break;
+    }
+
+    ++stats_.expanded;
+    const int r = int(cell) / tileSize_;
+    const int c = int(cell) % tileSize_;
+    const quint32 next = dist[cell] + 1;
+    const int back = arrival[cell] == kNoMove ? -1 : opposite(arrival[cell]);
+    const MazeCell& here = walls.cells[r][c];
+    auto reach = [&](int move, int nr, int nc) {
+      if (nr >= 0 && nr < tileRows && nc >= 0 && nc < tileCols) {
+        const quint32 to = quint32(nr * tileSize_ + nc);
+        if (next < dist[to]) {
+          dist[to] = next;
+          arrival[to] = quint8(move);
+          queue_.push_back(to);
+        }
+        return;
+      }
+      const int row = row0 + nr;
+      const int col = col0 + nc;
+      if (row < 0 || row >= rows() || col < 0 || col >= cols()) return;
+      post(tileOf(row, col), localOf(row, col), next, move);
+    };
+    if (back != 0 && (r == 0 || !walls.cells[r - 1][c].bottomWall)) {
+      reach(0, r - 1, c);
+    }
+    if (back != 1 && !here.rightWall) reach(1, r, c + 1);
+    if (back != 2 && !here.bottomWall) reach(2, r + 1, c);
+    if (back != 3 && (c == 0 || !walls.cells[r][c - 1].rightWall)) {
+      reach(3, r, c - 1);
+    }
+  }
+  slot->dirty = true;
+
+  if (buffered_ > inboxLimit_) return spill();
+  return true;
+}
+
+bool OutOfCoreSolver::tracePath(QPoint start, QPoint end, quint32 dist,
+                                PackedPath* path) {
+  // backwards along the arrival moves, filling the moves from the last
+  path->startRow = start.x();
+  path->startCol = start.y();
+  path->cells = dist + 1;
+  path->moves.assign(PackedPath::moveBytes(path->cells), 0);
+
+  int row = end.x();
+  int col = end.y();
+  for (size_t step = dist; step-- > 0;) {
+    Slot* slot = acquire(tileOf(row, col), false);
+    if (!slot) return false;
+    const int move = slot->move[localOf(row, col)];
+    if (move >= kNoMove) break;
+    path->moves[step >> 2] |= quint8(move << (step & 3) * 2);
+    row -= PathCodec::kRowStep[size_t(move)];
+    col -= PathCodec::kColStep[size_t(move)];
+  }
+  if (QPoint(row, col) != start) {
+    path->clear();
+    return fail("inconsistent search state");
+  }
+  return true;
+}
+
+bool OutOfCoreSolver::fail(const QString& message) {
+  error_ = message;
+  return false;
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <QPoint>
+#include <QString>
+#include <QTemporaryFile>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "src/core/mazeData.h"
+#include "src/core/packedPath.h"
+#include "src/lib/service/ioParser/tiledArchive.h"
+
+struct OutOfCoreStats {
+  qint64 tilesProcessed{0};  // inboxes taken
+  qint64 wallReads{0};       // tiles decoded from the archive
+  qint64 stateReads{0};
+  qint64 stateWrites{0};
+  qint64 spilledEntries{0};
+  qint64 sweeps{0};    // turns of the elevator
+  qint64 expanded{0};  // cells expanded, corrections included
+};
+
+// Shortest paths in a tiled archive (*.mza) too large to load, within a
+// fixed memory budget.
+//
+// The search goes tile by tile. A tile's walls are decoded from the
+// memory-mapped archive into a slot next to its search state, the
+// distance and arrival move of every cell; slots are reused least
+// recently used first, dirty state written to a scratch file at the
+// tile's fixed offset. Steps out of a tile land in the neighbour's inbox,
+// buffered in memory and spilled to a second scratch file when the inboxes
+// outgrow their quarter of the budget. Tiles with mail are taken in file
+// order, sweeping up and down like a disk elevator, so the archive and the
+// state are read mostly sequentially.
+//
+// A tile expands everything its inbox reaches before it is left, so a
+// shorter route arriving later corrects labels already set; distances are
+// exact, and the search ends once no inbox holds a distance below the
+// end's. On perfect mazes the path is the one Solver finds, the only one;
+// with loops it is as short, ties may go another way. The packed path is
+// the only thing that grows with the maze, a quarter byte a path cell.
+class OutOfCoreSolver {
+ public:
+  static constexpr qint64 kDefaultMemoryBytes = qint64(256) << 20;
+  // a local cell index and a move share 32 bits in the inboxes
+  static constexpr int kMaxTileSize = 4096;
+  static constexpr qint64 kMaxTiles = qint64(1) << 24;
+
+  // the scratch files go to workDir, the system temp dir when empty; any
+  // budget gets at least two tile slots
+  explicit OutOfCoreSolver(qint64 memoryBytes = kDefaultMemoryBytes,
+                           const QString& workDir = {});
+
+  bool open(const QString& archivePath);
+  const QString& error() const { return error_; }
+
+  int rows() const { return archive_.rows(); }
+  int cols() const { return archive_.cols(); }
+  int slotCount() const { return slotLimit_; }
+
+  // shortest path from start to end, empty without one or for endpoints
+  // outside the maze; false with error() set after an I/O failure
+  bool solve(QPoint start, QPoint end, PackedPath* path);
+  // of the last solve
+  const OutOfCoreStats& stats() const { return stats_; }
+
+ private:
+  static constexpr quint32 kUnreached = 0xFFFFFFFFu;
+  static constexpr int kMoveShift = 24;
+  static constexpr quint32 kCellMask = (1u << kMoveShift) - 1;
+  static constexpr int kNoMove = 4;  // the start
+
+  // a cell entering a tile: local index, the move that got there above it
+  struct Entry {
+    quint32 cellMove;
+    quint32 dist;
+  };
+  struct Chunk {
+    qint64 offset;
+    quint32 count;
+  };
+  struct Inbox {
+    std::vector<Entry> buffer;
+    std::vector<Chunk> chunks;  // spilled
+    quint32 minDist{kUnreached};
+  };
+  // cells by local index, row * tileSize + col inside the tile
+  struct Slot {
+    int tile{-1};
+    bool hasWalls{false};
+    bool hasState{false};
+    bool dirty{false};
+    quint64 used{0};
+    MazeData walls;
+    std::vector<quint32> dist;
+    std::vector<quint8> move;
+  };
+
+  void reset();
+  // nullptr after an I/O failure
+  Slot* acquire(int tile, bool withWalls);
+  bool writeBack(Slot& slot);
+  void post(int tile, quint32 cell, quint32 dist, int move);
+  bool spill();
+  bool process(int tile);
+  bool tracePath(QPoint start, QPoint end, quint32 dist, PackedPath* path);
+  bool fail(const QString& message);
+
+  int tileOf(int row, int col) const {
+    return (row / tileSize_) * tileCols_ + col / tileSize_;
+  }
+  quint32 localOf(int row, int col) const {
+    return quint32((row % tileSize_) * tileSize_ + col % tileSize_);
+  }
+  qint64 stateOffset(int tile) const {
+    return qint64(tile) * tileCells_ * qint64(sizeof(quint32) + 1);
+  }
+
+  qint64 memoryBytes_;
+  QString workDir_;
+  QString error_;
+  TiledArchiveReader archive_;
+  std::unique_ptr<QTemporaryFile> state_;
+  std::unique_ptr<QTemporaryFile> spill_;
+  int tileSize_{0};
+  int tileCols_{0};
+  qint64 tileCells_{0};
+  int slotLimit_{0};
+  qint64 inboxLimit_{0};  // entries held in memory
+
+  std::vector<Slot> slots_;
+  std::unordered_map<int, int> slotOf_;
+  std::vector<bool> stateWritten_;
+  quint64 clock_{0};
+
+  // by tile, so sweeps walk them in file order
+  std::map<int, Inbox> inboxes_;
+  std::multiset<quint32> inboxMins_;
+  qint64 buffered_{0};
+  qint64 spillEnd_{0};
+
+  std::vector<Entry> seeds_;
+  std::vector<quint32> queue_;
+  OutOfCoreStats stats_;
+};
@@ -0,0 +1,51 @@
+#include "searchTrace.h"
+
+#include <algorithm>
+#include <bit>
+
+void SearchTrace::reset(int cols, size_t capacity) {
+  capacity = std::bit_ceil(std::max<size_t>(capacity, 1));
+  if (cells_.size() < capacity) {
+    cells_.assign(capacity, 0);
+    layerStarts_.assign(capacity, 0);
+  }
+  // a larger buffer is kept, the mask uses all of it
+  mask_ = quint32(cells_.size() - 1);
+  cols_ = cols;
+  clear();
+}
+
+void SearchTrace::clear() {
+  count_ = 0;
+  layers_ = 0;
+  depth_ = -1;
+}
+
+quint32 SearchTrace::firstLayer() const {
+  const quint32 held = quint32(cells_.size());
+  quint32 first = layers_ > held ? layers_ - held : 0;
+  if (count_ <= held) return first;
+  // layer starts grow, find the first one not overwritten
+  const quint32 oldest = count_ - held;
+  quint32 last = layers_;
+  while (first < last) {
+    quint32 mid = first + (last - first) / 2;
+    if (layerStarts_[mid & mask_] < oldest) {
+      first = mid + 1;
+    } else {
+      last = mid;
+    }
+  }
+  return first;
+}
+
+int SearchTrace::layerCount() const { return int(layers_ - firstLayer()); }
+
+quint32 SearchTrace::layerBegin(int layer) const {
+  return layerStarts_[(firstLayer() + quint32(layer)) & mask_];
+}
+
+quint32 SearchTrace::layerEnd(int layer) const {
+  quint32 next = firstLayer() + quint32(layer) + 1;
+  return next == layers_ ? count_ : layerStarts_[next & mask_];
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QtGlobal>
+#include <vector>
+
+// Cells in the order a breadth-first search expanded them, cut into
+// layers of equal distance from the start.
+//
+// Both the cells (flat ids, row * cols + col) and the layer starts live in
+// rings allocated by reset(), so recording a search is a store and an
+// increment per cell. A search expanding more cells than the capacity
+// keeps the latest ones; layers whose start was overwritten are dropped.
+// Not synchronised: one writer, readers after it finished.
+class SearchTrace {
+ public:
+  // starts over for a maze with cols columns, holding up to capacity cells
+  // (rounded up to a power of two); keeps the buffers when large enough
+  void reset(int cols, size_t capacity);
+  // forgets the recorded search, keeps the buffers
+  void clear();
+
+  // cell expanded at distance depth from the start; depths begin at 0
+  // and grow by one from layer to layer
+  void record(int cell, int depth) {
+    if (depth != depth_) {
+      layerStarts_[layers_ & mask_] = count_;
+      ++layers_;
+      depth_ = depth;
+    }
+    cells_[count_ & mask_] = quint32(cell);
+    ++count_;
+  }
+
+  bool isEmpty() const { return layerCount() == 0; }
+  size_t capacity() const { return cells_.size(); }
+  int cols() const { return cols_; }
+  // cells recorded, including those overwritten
+  quint32 recorded() const { return count_; }
+
+  // layers still held, the oldest first
+  int layerCount() const;
+  // distance from the start of layer 0, > 0 once the ring wrapped
+  int firstDepth() const { return int(firstLayer()); }
+  // [begin, end) sequence numbers of a held layer's cells
+  quint32 layerBegin(int layer) const;
+  quint32 layerEnd(int layer) const;
+  // flat id of a held cell by sequence number
+  quint32 cell(quint32 seq) const { return cells_[seq & mask_]; }
+
+ private:
+  // index of the oldest layer whose cells are all held
+  quint32 firstLayer() const;
+
+  std::vector<quint32> cells_;
+  std::vector<quint32> layerStarts_;  // sequence number of the first cell
+  quint32 mask_{0};
+  quint32 count_{0};
+  quint32 layers_{0};
+  int depth_{-1};
+  int cols_{0};
+};
@@ -1,122 +1,620 @@
 #include "solver.h"
 
+#include <QFutureWatcher>
 #include <QQueue>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <limits>
+#include <queue>
 #include <unordered_map>
 
+#include "src/core/mazeBfs.h"
 #include "src/lib/model/maze.h"
+#include "src/lib/service/cache/mazeCache.h"
+#include "src/lib/service/metrics/metrics.h"
 
 namespace {
-// hash for QPoint to use in unordered_map
-struct QPointHash {
-  size_t operator()(const QPoint& p) const {
-    return std::hash<int>()(p.x()) ^ (std::hash<int>()(p.y()) << 16);
-  }
+const std::array<QPoint, 4> kDirections = {
+    QPoint(0, 1),   // right
+    QPoint(0, -1),  // left
+    QPoint(1, 0),   // down
+    QPoint(-1, 0)   // up
 };
-}  // namespace
-
-Solver::Solver(QObject* parent) : QObject(parent) {}
 
-void Solver::setMazeData(const MazeData* maze) { maze_ = maze; }
+// search bound when there is no path to beat
+constexpr int kUnbounded = std::numeric_limits<int>::max() / 2;
 
-bool Solver::canMove(const MazeData& maze, QPoint from, QPoint to) const {
-  int fr = from.x(), fc = from.y();
-  int tr = to.x(), tc = to.y();
+int manhattan(QPoint a, QPoint b) {
+  return std::abs(a.x() - b.x()) + std::abs(a.y() - b.y());
+}
 
-  // bounds check
-  if (tr < 0 || tr >= maze.rows || tc < 0 || tc >= maze.cols) {
-    return false;
-  }
+bool sameEdge(QPoint a, QPoint b, const std::pair<QPoint, QPoint>& edge) {
+  return (a == edge.first && b == edge.second) ||
+         (a == edge.second && b == edge.first);
+}
 
-  // moving right: check right wall of current cell
-  if (tr == fr && tc == fc + 1) {
-    return !maze.cells[fr][fc].rightWall;
-  }
-  // moving left: check right wall of target cell
-  if (tr == fr && tc == fc - 1) {
-    return !maze.cells[tr][tc].rightWall;
-  }
-  // moving down: check bottom wall of current cell
-  if (tc == fc && tr == fr + 1) {
-    return !maze.cells[fr][fc].bottomWall;
-  }
-  // moving up: check bottom wall of target cell
-  if (tc == fc && tr == fr - 1) {
-    return !maze.cells[tr][tc].bottomWall;
-  }
+void setSingleCell(QPoint cell, std::vector<QPoint>* path) {
+  path->assign(1, cell);
+}
 
-  return false;
+void setSingleCell(QPoint cell, PackedPath* path) {
+  path->clear();
+  path->startRow = cell.x();
+  path->startCol = cell.y();
+  path->cells = 1;
 }
 
-std::vector<QPoint> Solver::solve(const MazeData& maze, QPoint start,
-                                  QPoint end) {
-  if (!maze.isGenerated) return {};
+// Solver::solve into a list of cells or a packed path
+template <class Out>
+void solveInto(const MazeData& maze, QPoint start, QPoint end, Out* path) {
+  path->clear();
+  if (!maze.isGenerated) return;
 
   // validate bounds
   if (start.x() < 0 || start.x() >= maze.rows || start.y() < 0 ||
       start.y() >= maze.cols || end.x() < 0 || end.x() >= maze.rows ||
       end.y() < 0 || end.y() >= maze.cols) {
-    return {};
+    return;
   }
 
-  if (start == end) return {start};
+  if (start == end) {
+    setSingleCell(start, path);
+    return;
+  }
 
-  // bfs
-  QQueue<QPoint> queue;
-  std::unordered_map<QPoint, QPoint, QPointHash> parent;
+  // the search state lives in the thread's scratch arena, so repeated
+  // solves of one size don't touch the heap
+  ScratchScope scratch(TaskScheduler::scratch());
+  std::pmr::vector<int> parent(scratch.resource());
+  std::pmr::vector<int> queue(scratch.resource());
+  MAZE_METRICS_ONLY(ScopedTally expanded(Metrics::Counter::NodesExpanded);
+                    ScopedTally frontier(Metrics::Counter::QueueHighWater);)
 
-  queue.enqueue(start);
-  parent[start] = QPoint(-1, -1);  // sentinel for start
+  // common sizes run a compile-time kernel with its state on the stack
+  MazeBfs::findPath(maze, start.x() * maze.cols + start.y(),
+                    end.x() * maze.cols + end.y(), parent, queue, path,
+                    [&](int, size_t queued) {
+                      MAZE_METRICS_ONLY(frontier.raise(qint64(queued));
+                                        expanded.add(1);)
+                      Q_UNUSED(queued);
+                    });
+}
 
-  const std::array<QPoint, 4> directions = {
-      QPoint(0, 1),   // right
-      QPoint(0, -1),  // left
-      QPoint(1, 0),   // down
-      QPoint(-1, 0)   // up
-  };
+// breadth-first distances from one cell, visit(id, label) as each cell is
+// expanded
+template <class Visit>
+void floodLabels(const MazeData& maze, QPoint from, std::vector<int>& labels,
+                 Visit&& visit) {
+  labels.assign(static_cast<size_t>(maze.rows) * maze.cols, -1);
+
+  QQueue<QPoint> queue;
+  queue.enqueue(from);
+  labels[from.x() * maze.cols + from.y()] = 0;
+  MAZE_METRICS_ONLY(ScopedTally expanded(Metrics::Counter::NodesExpanded);
+                    ScopedTally frontier(Metrics::Counter::QueueHighWater);)
 
   while (!queue.isEmpty()) {
+    MAZE_METRICS_ONLY(frontier.raise(queue.size()); expanded.add(1);)
     QPoint current = queue.dequeue();
-
-    if (current == end) {
-      // reconstruct path
-      std::vector<QPoint> path;
-      for (QPoint p = end; p != QPoint(-1, -1); p = parent[p]) {
-        path.push_back(p);
-      }
-      std::reverse(path.begin(), path.end());
-      return path;
+    int id = current.x() * maze.cols + current.y();
+    int label = labels[id];
+    visit(id, label);
+    for (const auto& dir : kDirections) {
+      QPoint next(current.x() + dir.x(), current.y() + dir.y());
+      if (!Solver::canMove(maze, current, next)) continue;
+      int& nextLabel = labels[next.x() * maze.cols + next.y()];
+      if (nextLabel >= 0) continue;
+      nextLabel = label + 1;
+      queue.enqueue(next);
     }
+  }
+}
+}  // namespace
 
-    for (const auto& dir : directions) {
-      QPoint next(current.x() + dir.x(), current.y() + dir.y());
+Solver::Solver(QObject* parent) : QObject(parent) {}
 
-      if (parent.find(next) == parent.end() && canMove(maze, current, next)) {
-        parent[next] = current;
-        queue.enqueue(next);
-      }
+void Solver::setMazeData(const MazeData* maze) {
+  cancelSolve();
+  maze_ = maze;
+  model_ = nullptr;
+  fingerprint_.reset();
+}
+
+void Solver::setMazeModel(const MazeModel* model) {
+  cancelSolve();
+  maze_ = nullptr;
+  model_ = model;
+  fingerprint_.reset();
+}
+
+const MazeData* Solver::maze() const {
+  return model_ ? &model_->mazeData() : maze_;
+}
+
+bool Solver::canMove(const MazeData& maze, QPoint from, QPoint to) {
+  return MazeBfs::canMove(maze, from.x(), from.y(), to.x(), to.y());
+}
+
+std::vector<QPoint> Solver::solve(const MazeData& maze, QPoint start,
+                                  QPoint end) {
+  std::vector<QPoint> path;
+  solve(maze, start, end, &path);
+  return path;
+}
+
+void Solver::solve(const MazeData& maze, QPoint start, QPoint end,
+                   std::vector<QPoint>* path) {
+  solveInto(maze, start, end, path);
+}
+
+void Solver::solve(const MazeData& maze, QPoint start, QPoint end,
+                   PackedPath* path) {
+  solveInto(maze, start, end, path);
+}
+
+std::vector<std::vector<QPoint>> Solver::solveFrom(
+    const MazeData& maze, QPoint start, const std::vector<QPoint>& ends) const {
+  std::vector<std::vector<QPoint>> paths(ends.size());
+  auto inside = [&](QPoint p) {
+    return p.x() >= 0 && p.x() < maze.rows && p.y() >= 0 && p.y() < maze.cols;
+  };
+  if (!maze.isGenerated || !inside(start)) return paths;
+
+  // one search for all ends; the per-search state lives in the thread's
+  // scratch arena
+  ScratchScope scratch(TaskScheduler::scratch());
+  auto id = [&](QPoint p) { return p.x() * maze.cols + p.y(); };
+  std::pmr::vector<char> wanted(static_cast<size_t>(maze.rows) * maze.cols, 0,
+                                scratch.resource());
+  int remaining = 0;
+  for (const QPoint& end : ends) {
+    if (inside(end) && !wanted[id(end)]) {
+      wanted[id(end)] = 1;
+      ++remaining;
     }
   }
 
-  return {};  // no path found
+  std::pmr::vector<int> parent(scratch.resource());
+  std::pmr::vector<int> queue(scratch.resource());
+  MAZE_METRICS_ONLY(ScopedTally expanded(Metrics::Counter::NodesExpanded);
+                    ScopedTally frontier(Metrics::Counter::QueueHighWater);)
+  if (remaining > 0) {
+    MazeBfs::search(maze, id(start), parent, queue,
+                    [&](int cell, size_t queued) {
+                      MAZE_METRICS_ONLY(frontier.raise(qint64(queued));
+                                        expanded.add(1);)
+                      Q_UNUSED(queued);
+                      if (wanted[cell]) --remaining;
+                      return remaining == 0;
+                    });
+  }
+
+  for (size_t i = 0; i < ends.size(); ++i) {
+    if (!inside(ends[i]) || parent[id(ends[i])] == -2) continue;
+    MazeBfs::path(parent, maze.cols, id(ends[i]), &paths[i]);
+  }
+  return paths;
 }
 
 void Solver::solveMaze(int startRow, int startCol, int endRow, int endCol) {
-  if (!maze_) {
-    currentPath_.clear();
+  MAZE_SCOPED_TIMER(Solve);
+  cancelSolve();
+
+  if (setEndpoints({startRow, startCol}, {endRow, endCol})) {
+    MazeCache& cache = MazeCache::instance();
+    // a recorded solve always searches, a cached path has nothing to show
+    if (!recordSearch_ &&
+        cache.findPath(mazeFingerprint(), start_, end_, &currentPath_)) {
+      labelsPending_ = true;
+    } else {
+      computePath();
+      cache.insertPath(mazeFingerprint(), start_, end_, currentPath_);
+    }
+  }
+
+  emit pathChanged();
+  if (recordSearch_) emit searchTraceChanged();
+}
+
+void Solver::solveMazeAsync(int startRow, int startCol, int endRow,
+                            int endCol) {
+  cancelSolve();
+  bool valid = setEndpoints({startRow, startCol}, {endRow, endCol});
+  if (recordSearch_) emit searchTraceChanged();  // the old one is gone
+  if (!valid) {
+    emit pathChanged();
+    return;
+  }
+  if (!recordSearch_ && MazeCache::instance().findPath(
+                            mazeFingerprint(), start_, end_, &currentPath_)) {
+    labelsPending_ = true;
     emit pathChanged();
     return;
   }
 
-  currentPath_ =
-      solve(*maze_, QPoint(startRow, startCol), QPoint(endRow, endCol));
-  emit pathChanged();
+  int token = solveToken_;
+
+  auto* watcher = new QFutureWatcher<Solution>(this);
+  connect(watcher, &QFutureWatcher<Solution>::finished, this,
+          [this, watcher, token, fingerprint = mazeFingerprint()]() {
+            watcher->deleteLater();
+            if (token != solveToken_) return;  // superseded meanwhile
+            Solution solution = watcher->result();
+            MazeCache::instance().insertPath(fingerprint, start_, end_,
+                                             solution.path);
+            currentPath_ = std::move(solution.path);
+            fromStart_ = std::move(solution.fromStart);
+            toEnd_ = std::move(solution.toEnd);
+            setSolving(false);
+            emit pathChanged();
+            // recording may have been switched off meanwhile
+            if (recordSearch_) {
+              trace_ = std::move(solution.trace);
+              emit searchTraceChanged();
+            }
+          });
+
+  // the worker gets a snapshot, edits don't have to wait for it; it
+  // records into the trace buffers of the last search and hands them back
+  std::shared_ptr<const MazeData> maze =
+      model_ ? model_->snapshot() : std::make_shared<const MazeData>(*maze_);
+  setSolving(true);
+  emit pathChanged();  // the old path is gone
+  watcher->setFuture(TaskScheduler::instance().run(
+      TaskScheduler::Priority::Interactive,
+      [maze, start = start_, end = end_, record = recordSearch_,
+       trace = std::exchange(trace_, {})]() mutable {
+        MAZE_SCOPED_TIMER(Solve);
+        Solver solver;
+        solver.setMazeData(maze.get());
+        solver.start_ = start;
+        solver.end_ = end;
+        solver.recordSearch_ = record;
+        solver.trace_ = std::move(trace);
+        solver.computePath();
+        return Solution{std::move(solver.currentPath_),
+                        std::move(solver.fromStart_),
+                        std::move(solver.toEnd_), std::move(solver.trace_)};
+      },
+      solveCancel_));
+}
+
+void Solver::cancelSolve() {
+  ++solveToken_;
+  solveCancel_.cancel();
+  solveCancel_ = CancellationToken();
+  setSolving(false);
+}
+
+bool Solver::setEndpoints(QPoint start, QPoint end) {
+  start_ = start;
+  end_ = end;
+  currentPath_.clear();
+  fromStart_.clear();
+  toEnd_.clear();
+  labelsPending_ = false;
+  trace_.clear();
+
+  const MazeData* maze = this->maze();
+  return maze && maze->isGenerated && start_.x() >= 0 &&
+         start_.x() < maze->rows && start_.y() >= 0 &&
+         start_.y() < maze->cols && end_.x() >= 0 && end_.x() < maze->rows &&
+         end_.y() >= 0 && end_.y() < maze->cols;
+}
+
+void Solver::setSolving(bool solving) {
+  if (solving_ == solving) return;
+  solving_ = solving;
+  emit solvingChanged();
+}
+
+void Solver::setRecordSearch(bool record) {
+  if (recordSearch_ == record) return;
+  recordSearch_ = record;
+  if (!record) {
+    trace_ = SearchTrace();
+    emit searchTraceChanged();
+  }
+  emit recordSearchChanged();
+}
+
+void Solver::computePath() {
+  const MazeData& maze = *this->maze();
+  if (recordSearch_) {
+    size_t cells = static_cast<size_t>(maze.rows) * maze.cols;
+    trace_.reset(maze.cols, std::min(kMaxTraceCells, cells));
+  }
+  labelDistances(start_, fromStart_, recordSearch_ ? &trace_ : nullptr);
+  labelDistances(end_, toEnd_);
+  labelsPending_ = false;
+
+  // walk down the labels from the start
+  currentPath_.clear();
+  int cols = maze.cols;
+  if (toEnd_[start_.x() * cols + start_.y()] < 0) return;
+  for (QPoint p = start_; p != end_;) {
+    currentPath_.push_back(p);
+    int label = toEnd_[p.x() * cols + p.y()];
+    for (const auto& dir : kDirections) {
+      QPoint next(p.x() + dir.x(), p.y() + dir.y());
+      if (canMove(maze, p, next) &&
+          toEnd_[next.x() * cols + next.y()] == label - 1) {
+        p = next;
+        break;
+      }
+    }
+  }
+  currentPath_.push_back(end_);
+}
+
+quint64 Solver::mazeFingerprint() {
+  if (!fingerprint_) fingerprint_ = MazeCache::fingerprint(*maze());
+  return *fingerprint_;
+}
+
+void Solver::resolve() {
+  fingerprint_.reset();
+  if (start_.x() < 0 || end_.x() < 0) return;
+  solveMazeAsync(start_.x(), start_.y(), end_.x(), end_.y());
 }
 
 void Solver::clearPath() {
+  cancelSolve();
   currentPath_.clear();
+  start_ = end_ = QPoint(-1, -1);
+  fromStart_.clear();
+  toEnd_.clear();
+  labelsPending_ = false;
+  trace_.clear();
+  emit pathChanged();
+  if (recordSearch_) emit searchTraceChanged();
+}
+
+void Solver::labelDistances(QPoint from, std::vector<int>& labels,
+                            SearchTrace* trace) const {
+  // decided once per search, the loop without a trace records nothing
+  if (trace) {
+    floodLabels(*maze(), from, labels,
+                [trace](int cell, int label) { trace->record(cell, label); });
+  } else {
+    floodLabels(*maze(), from, labels, [](int, int) {});
+  }
+}
+
+// Labels differing by at most one across every passage never overestimate.
+// A new passage can break that only by allowing smaller labels; they are
+// pushed outwards from it, touching just the cells that get closer.
+void Solver::lowerLabels(std::vector<int>& labels,
+                         const Edge& passage) const {
+  const MazeData& maze = *this->maze();
+  auto at = [&](QPoint p) -> int& { return labels[p.x() * maze.cols + p.y()]; };
+  auto relax = [&](QPoint from, QPoint to, QQueue<QPoint>& queue) {
+    int label = at(from);
+    int& toLabel = at(to);
+    if (label < 0 || (toLabel >= 0 && toLabel <= label + 1)) return;
+    toLabel = label + 1;
+    queue.enqueue(to);
+  };
+
+  QQueue<QPoint> queue;
+  relax(passage.first, passage.second, queue);
+  relax(passage.second, passage.first, queue);
+
+  while (!queue.isEmpty()) {
+    QPoint current = queue.dequeue();
+    for (const auto& dir : kDirections) {
+      QPoint next(current.x() + dir.x(), current.y() + dir.y());
+      if (canMove(maze, current, next)) relax(current, next, queue);
+    }
+  }
+}
+
+void Solver::repairPath(QPoint cell, QPoint neighbour, bool blocked) {
+  fingerprint_.reset();
+  if (!maze() || !maze()->isGenerated) return;
+  if (solving_) {
+    // the copy being solved is out of date
+    resolve();
+    return;
+  }
+  if (labelsPending_) {
+    // the path came from the cache, label the edited maze from scratch
+    MAZE_SCOPED_TIMER(Solve);
+    computePath();
+    emit pathChanged();
+    if (recordSearch_) emit searchTraceChanged();
+    return;
+  }
+  if (toEnd_.empty()) return;
+  MAZE_SCOPED_TIMER(RepairPath);
+  MAZE_COUNT(PathRepairs, 1);
+
+  if (blocked) {
+    // labels stay lower bounds when a passage closes
+    if (!currentPath_.empty()) bypassWall({cell, neighbour});
+  } else {
+    tryShortcut({cell, neighbour});
+    lowerLabels(fromStart_, {cell, neighbour});
+    lowerLabels(toEnd_, {cell, neighbour});
+  }
+}
+
+// A wall on the path cuts it in two. The prefix distances stay exact, so
+// the shortest way from any prefix cell to the end is the repaired path.
+// A wall elsewhere can't make the current (shortest) path any shorter.
+void Solver::bypassWall(const Edge& wall) {
+  size_t cut = 0;
+  while (cut + 1 < currentPath_.size() &&
+         !sameEdge(currentPath_[cut], currentPath_[cut + 1], wall)) {
+    ++cut;
+  }
+  if (cut + 1 >= currentPath_.size()) return;
+
+  std::vector<std::pair<QPoint, int>> seeds;
+  seeds.reserve(cut + 1);
+  for (size_t i = 0; i <= cut; ++i) {
+    seeds.emplace_back(currentPath_[i], static_cast<int>(i));
+  }
+
+  int dist = 0;
+  auto route = search(seeds, end_, toEnd_, kUnbounded, {}, &dist);
+  if (route.empty()) {
+    currentPath_.clear();
+  } else {
+    size_t from = static_cast<size_t>(dist) - (route.size() - 1);
+    currentPath_.resize(from);
+    currentPath_.insert(currentPath_.end(), route.begin(), route.end());
+  }
+  emit pathChanged();
+}
+
+// An opened passage helps only if going through it beats the current
+// length. The labels (still those of the maze without it) bound that from
+// below, so most edits are rejected without searching; otherwise both
+// halves are searched exactly, guided by the labels.
+void Solver::tryShortcut(const Edge& passage) {
+  auto label = [&](const std::vector<int>& labels, QPoint p) {
+    return labels[p.x() * maze()->cols + p.y()];
+  };
+  int bestLength = currentPath_.empty()
+                       ? kUnbounded
+                       : static_cast<int>(currentPath_.size()) - 1;
+
+  std::vector<QPoint> bestHead;
+  std::vector<QPoint> bestTail;
+
+  for (const auto& [entry, exit] :
+       {passage, Edge(passage.second, passage.first)}) {
+    int toEntry = label(fromStart_, entry);
+    int fromExit = label(toEnd_, exit);
+    if (toEntry < 0 || fromExit < 0 || toEntry + 1 + fromExit >= bestLength) {
+      continue;
+    }
+
+    int headDist = 0;
+    auto head = search({{entry, 0}}, start_, fromStart_,
+                       bestLength - 2 - fromExit, passage, &headDist);
+    if (head.empty()) continue;
+
+    int tailDist = 0;
+    auto tail = search({{exit, 0}}, end_, toEnd_, bestLength - 2 - headDist,
+                       passage, &tailDist);
+    if (tail.empty()) continue;
+
+    bestLength = headDist + 1 + tailDist;
+    bestHead = std::move(head);
+    bestTail = std::move(tail);
+  }
+
+  if (bestHead.empty()) return;
+
+  // the head runs from the passage back to the start
+  currentPath_.assign(bestHead.rbegin(), bestHead.rend());
+  currentPath_.insert(currentPath_.end(), bestTail.begin(), bestTail.end());
   emit pathChanged();
 }
 
+std::vector<QPoint> Solver::search(
+    const std::vector<std::pair<QPoint, int>>& seeds, QPoint target,
+    std::vector<int>& labels, int maxDist, const Edge& skip, int* dist) const {
+  const MazeData& maze = *this->maze();
+  auto id = [&](QPoint p) { return p.x() * maze.cols + p.y(); };
+
+  // labels are lower bounds of the distance to target, an unlabelled cell
+  // can't reach it at all
+  auto heuristic = [&](QPoint p) {
+    int label = labels[id(p)];
+    return label < 0 ? -1 : std::max(label, manhattan(p, target));
+  };
+
+  struct Entry {
+    int f;
+    int g;
+    QPoint cell;
+    // smallest f first, deepest first among equals
+    bool operator>(const Entry& other) const {
+      return f > other.f || (f == other.f && g < other.g);
+    }
+  };
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> open;
+  std::unordered_map<int, std::pair<int, int>> best;  // id -> {g, parent}
+  std::vector<std::pair<int, int>> closed;  // id, g
+  bool exhaustive = true;
+
+  for (const auto& [cell, g] : seeds) {
+    int h = heuristic(cell);
+    if (h < 0) continue;
+    if (g + h > maxDist) {
+      exhaustive = false;
+      continue;
+    }
+    auto [it, inserted] = best.try_emplace(id(cell), g, -1);
+    if (!inserted) {
+      if (it->second.first <= g) continue;
+      it->second = {g, -1};
+    }
+    open.push({g + h, g, cell});
+  }
+
+  MAZE_METRICS_ONLY(ScopedTally expanded(Metrics::Counter::NodesExpanded);
+                    ScopedTally frontier(Metrics::Counter::QueueHighWater);)
+
+  while (!open.empty()) {
+    MAZE_METRICS_ONLY(frontier.raise(open.size());)
+    Entry entry = open.top();
+    open.pop();
+    if (entry.g != best[id(entry.cell)].first) continue;  // stale
+
+    if (entry.cell == target) {
+      // g of an expanded cell is exact, so the target is at least
+      // (cost - g) away from it; raising the labels keeps them consistent
+      // and the next search around here narrower (adaptive A*)
+      for (const auto& [at, g] : closed) {
+        labels[at] = std::max(labels[at], entry.g - g);
+      }
+
+      std::vector<QPoint> route;
+      for (int at = id(target); at >= 0; at = best[at].second) {
+        route.emplace_back(at / maze.cols, at % maze.cols);
+      }
+      std::reverse(route.begin(), route.end());
+      *dist = entry.g;
+      return route;
+    }
+    closed.emplace_back(id(entry.cell), entry.g);
+    MAZE_METRICS_ONLY(expanded.add(1);)
+
+    for (const auto& dir : kDirections) {
+      QPoint next(entry.cell.x() + dir.x(), entry.cell.y() + dir.y());
+      if (!canMove(maze, entry.cell, next) ||
+          sameEdge(entry.cell, next, skip)) {
+        continue;
+      }
+      int g = entry.g + 1;
+      int h = heuristic(next);
+      if (h < 0) continue;
+      if (g + h > maxDist) {
+        exhaustive = false;
+        continue;
+      }
+
+      auto [it, inserted] = best.try_emplace(id(next), g, id(entry.cell));
+      if (!inserted) {
+        if (it->second.first <= g) continue;
+        it->second = {g, id(entry.cell)};
+      }
+      open.push({g + h, g, next});
+    }
+  }
+
+  // nothing seen can reach target, so later searches skip it right away
+  if (exhaustive) {
+    for (const auto& [at, state] : best) labels[at] = -1;
+  }
+  return {};
+}
+
 QVariantList Solver::path() const {
   QVariantList result;
   for (const auto& p : currentPath_) {
@@ -126,3 +624,9 @@ QVariantList Solver::path() const {
 }
 
 bool Solver::hasSolution() const { return !currentPath_.empty(); }
+
+bool Solver::solving() const { return solving_; }
+
+int Solver::pathLength() const {
+  return static_cast<int>(currentPath_.size());
+}
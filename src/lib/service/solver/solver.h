@@ -3,37 +3,152 @@
 #include <QObject>
 #include <QPoint>
 #include <QVariantList>
+#include <optional>
+#include <utility>
 #include <vector>
 
+#include "src/core/packedPath.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+#include "src/lib/service/solver/searchTrace.h"
+
 struct MazeData;
+class MazeModel;
 
 class Solver : public QObject {
   Q_OBJECT
 
   Q_PROPERTY(QVariantList path READ path NOTIFY pathChanged)
   Q_PROPERTY(bool hasSolution READ hasSolution NOTIFY pathChanged)
+  Q_PROPERTY(int pathLength READ pathLength NOTIFY pathChanged)
+  Q_PROPERTY(bool solving READ solving NOTIFY solvingChanged)
+  // while set, solveMaze and solveMazeAsync record the search for playback
+  Q_PROPERTY(bool recordSearch READ recordSearch WRITE setRecordSearch NOTIFY
+                 recordSearchChanged)
+  Q_PROPERTY(int searchLayers READ searchLayers NOTIFY searchTraceChanged)
 
  public:
+  // cells a recorded search keeps, the latest ones on larger mazes
+  static constexpr size_t kMaxTraceCells = size_t(1) << 22;
+
   explicit Solver(QObject* parent = nullptr);
 
+  // The solve and solveFrom overloads are the building blocks of batches
+  // and count their nodes, but are not timed one by one; callers time the
+  // batch (Metrics::Timer::SolveBatch).
+
   // returns path as vector of {row, col} points, empty if no solution
   std::vector<QPoint> solve(const MazeData& maze, QPoint start, QPoint end);
+  // same, into path; reusing one path and one thread, repeated solves do
+  // no heap allocation
+  void solve(const MazeData& maze, QPoint start, QPoint end,
+             std::vector<QPoint>* path);
+  // same, packed from the search's parent links without a cell list, a
+  // quarter byte a cell; batch solves keep these
+  void solve(const MazeData& maze, QPoint start, QPoint end, PackedPath* path);
+  // one BFS for every end sharing the start, paths in the order of ends
+  std::vector<std::vector<QPoint>> solveFrom(
+      const MazeData& maze, QPoint start,
+      const std::vector<QPoint>& ends) const;
 
+  // also labels every cell with its distance to start and end, which
+  // repairPath keeps as lower bounds; a path found in MazeCache is used
+  // as is and the labels wait for the first edit
   Q_INVOKABLE void solveMaze(int startRow, int startCol, int endRow,
                              int endCol);
+  // as solveMaze, but a cache miss is solved by an Interactive task, on
+  // MazeModel::snapshot or a copy of a bare maze; the path arrives with
+  // pathChanged and edits made meanwhile start it over
+  Q_INVOKABLE void solveMazeAsync(int startRow, int startCol, int endRow,
+                                  int endCol);
+  // solves again for the last endpoints, after bulk edits
+  Q_INVOKABLE void resolve();
   Q_INVOKABLE void clearPath();
 
+  // Keeps the current path shortest after the wall between two adjacent
+  // cells was added (blocked) or removed. Only the region around the edit
+  // is searched: A* seeded with the distances along the existing path and
+  // guided by the distance labels.
+  void repairPath(QPoint cell, QPoint neighbour, bool blocked);
+
   QVariantList path() const;
   bool hasSolution() const;
+  int pathLength() const;
+  bool solving() const;
+
+  bool recordSearch() const { return recordSearch_; }
+  // off drops the trace and its buffers
+  void setRecordSearch(bool record);
+  int searchLayers() const { return trace_.layerCount(); }
+  // the labelling search from the start behind the current path; empty
+  // when not recording or the path came from MazeCache
+  const SearchTrace& searchTrace() const { return trace_; }
+
+  // packed {row, col} points for native views, no QVariant conversion
+  const std::vector<QPoint>& currentPath() const { return currentPath_; }
 
   void setMazeData(const MazeData* maze);
+  // follows the model's maze through its edits, workers get snapshots
+  void setMazeModel(const MazeModel* model);
+
+  // false for walls and cells outside the maze; to must be adjacent
+  static bool canMove(const MazeData& maze, QPoint from, QPoint to);
 
  signals:
   void pathChanged();
+  void solvingChanged();
+  void recordSearchChanged();
+  void searchTraceChanged();
 
  private:
-  bool canMove(const MazeData& maze, QPoint from, QPoint to) const;
+  using Edge = std::pair<QPoint, QPoint>;
+
+  struct Solution {
+    std::vector<QPoint> path;
+    std::vector<int> fromStart;
+    std::vector<int> toEnd;
+    SearchTrace trace;
+  };
+
+  // labels and path for start_ and end_ from scratch, recording the search
+  // from the start into trace_ if recordSearch_
+  void computePath();
+  // false if the endpoints are outside the maze; clears path and labels
+  bool setEndpoints(QPoint start, QPoint end);
+  void setSolving(bool solving);
+  // drops the result of the asynchronous solve in flight, if any
+  void cancelSolve();
+  quint64 mazeFingerprint();
+  const MazeData* maze() const;
+  void labelDistances(QPoint from, std::vector<int>& labels,
+                      SearchTrace* trace = nullptr) const;
+  void lowerLabels(std::vector<int>& labels, const Edge& passage) const;
+  // shortest route from one of the seeds (cell, known distance) to target
+  // not longer than maxDist, seed first; labels are lower bounds of the
+  // distance to target (cleared for cells found cut off from it) and skip
+  // is treated as a wall
+  std::vector<QPoint> search(const std::vector<std::pair<QPoint, int>>& seeds,
+                             QPoint target, std::vector<int>& labels,
+                             int maxDist, const Edge& skip, int* dist) const;
+  void bypassWall(const Edge& wall);
+  void tryShortcut(const Edge& passage);
 
   const MazeData* maze_ = nullptr;
+  const MazeModel* model_ = nullptr;  // instead of maze_
   std::vector<QPoint> currentPath_;
+
+  QPoint start_{-1, -1};
+  QPoint end_{-1, -1};
+  // distance per cell (-1 unreachable), exact after solveMaze and lower
+  // bounds once walls were edited
+  std::vector<int> fromStart_;
+  std::vector<int> toEnd_;
+  bool labelsPending_ = false;
+  // results of older asynchronous solves are dropped
+  int solveToken_ = 0;
+  CancellationToken solveCancel_;
+  bool solving_ = false;
+  // of the maze as last solved, dropped on every edit
+  std::optional<quint64> fingerprint_;
+  bool recordSearch_ = false;
+  SearchTrace trace_;
 };
@@ -0,0 +1,507 @@
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#include "src/core/packedPath.h"
+#include "src/lib/model/maze.h"
+#include "src/lib/service/agent/qLearner.h"
+#include "src/lib/service/analytics/mazeAnalytics.h"
+#include "src/lib/service/cache/mazeCache.h"
+#include "src/lib/service/cave/caveAutomaton.h"
+#include "src/lib/service/generator/generator.h"
+#include "src/lib/service/ioParser/asyncIOParser.h"
+#include "src/lib/service/ioParser/mazeImage.h"
+#include "src/lib/service/ioParser/tiledArchive.h"
+#include "src/lib/service/solver/outOfCoreSolver.h"
+#include "src/lib/service/solver/solver.h"
+
+// Throughput benchmarks for the generator, solver, parsers and model.
+//
+// Besides the usual QBENCHMARK output every row is run once more by hand to
+// record cells/s, ns per cell, peak RSS and heap allocations; generate and
+// solve reuse their buffers and must not allocate at all. Environment:
+//   MAZE_BENCH_LARGE=1       also run 10000x10000 (several GB of RAM)
+//   MAZE_BENCH_JSON=path     write the samples as JSON
+//   MAZE_BENCH_BASELINE=path compare against an earlier JSON file and fail
+//                            on rows slower by more than the tolerance
+//   MAZE_BENCH_TOLERANCE=x   allowed slowdown, default 0.15 (15%)
+
+namespace {
+std::atomic<quint64> allocationCount{0};
+std::atomic<quint64> allocatedBytes{0};
+
+void* countedAlloc(std::size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+// peak resident set size of the process so far, -1 if unknown
+qint64 peakRssKb() {
+#ifdef Q_OS_UNIX
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef Q_OS_MACOS
+  return usage.ru_maxrss / 1024;  // bytes on macOS
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return -1;
+#endif
+}
+}  // namespace
+
+// count every heap allocation made by the benchmarked code
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+class BenchMaze : public QObject {
+  Q_OBJECT
+
+ private:
+  struct Sample {
+    QString name;
+    qint64 cells;
+    qint64 nsecs;
+    qint64 peakRssKb;
+    quint64 allocations;
+    quint64 allocatedBytes;
+
+    double nsPerCell() const { return double(nsecs) / double(cells); }
+    double cellsPerSecond() const { return 1e9 * double(cells) / nsecs; }
+  };
+
+  // one extra timed pass of body, outside QBENCHMARK
+  template <typename F>
+  void record(qint64 cells, F&& body) {
+    quint64 allocsBefore = allocationCount.load();
+    quint64 bytesBefore = allocatedBytes.load();
+    QElapsedTimer timer;
+    timer.start();
+    body();
+    qint64 nsecs = std::max<qint64>(timer.nsecsElapsed(), 1);
+
+    QString name = QString::fromLatin1(QTest::currentTestFunction()) + '/' +
+                   QString::fromLatin1(QTest::currentDataTag());
+    samples_.push_back({name, cells, nsecs, peakRssKb(),
+                        allocationCount.load() - allocsBefore,
+                        allocatedBytes.load() - bytesBefore});
+  }
+
+  void addSizes() {
+    QTest::addColumn<int>("size");
+    for (int size : {10, 100, 1000}) {
+      QTest::newRow(qPrintable(QString("%1x%1").arg(size))) << size;
+    }
+    if (qEnvironmentVariableIntValue("MAZE_BENCH_LARGE")) {
+      QTest::newRow("10000x10000") << 10000;
+    }
+  }
+
+  MazeData generated(int size) {
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, size, size);
+    return maze;
+  }
+
+  QJsonDocument samplesJson() const {
+    QJsonArray rows;
+    for (const auto& s : samples_) {
+      rows.append(QJsonObject{{"name", s.name},
+                              {"cells", s.cells},
+                              {"nsecs", s.nsecs},
+                              {"nsPerCell", s.nsPerCell()},
+                              {"cellsPerSecond", s.cellsPerSecond()},
+                              {"peakRssKb", s.peakRssKb},
+                              {"allocations", qint64(s.allocations)},
+                              {"allocatedBytes", qint64(s.allocatedBytes)}});
+    }
+    return QJsonDocument(QJsonObject{{"samples", rows}});
+  }
+
+  // rows slower than the baseline by more than the tolerance
+  QStringList regressions(const QString& baselinePath) const {
+    QFile file(baselinePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+      return {QString("cannot open baseline %1").arg(baselinePath)};
+    }
+
+    QHash<QString, double> baseline;
+    const auto rows = QJsonDocument::fromJson(file.readAll())
+                          .object()
+                          .value("samples")
+                          .toArray();
+    for (const auto& row : rows) {
+      QJsonObject sample = row.toObject();
+      baseline.insert(sample.value("name").toString(),
+                      sample.value("nsPerCell").toDouble());
+    }
+
+    bool ok = false;
+    double tolerance =
+        qEnvironmentVariable("MAZE_BENCH_TOLERANCE").toDouble(&ok);
+    if (!ok) tolerance = 0.15;
+
+    QStringList slower;
+    for (const auto& s : samples_) {
+      double before = baseline.value(s.name, 0.0);
+      if (before <= 0) continue;
+      double ratio = s.nsPerCell() / before;
+      qInfo("%-32s %8.2f -> %8.2f ns/cell (%+.1f%%)", qPrintable(s.name),
+            before, s.nsPerCell(), (ratio - 1) * 100);
+      if (ratio > 1 + tolerance) {
+        slower << QString("%1 %2x slower").arg(s.name).arg(ratio, 0, 'f', 2);
+      }
+    }
+    return slower;
+  }
+
+  std::vector<Sample> samples_;
+  QTemporaryDir dir_;
+
+ private slots:
+  void cleanupTestCase() {
+    qInfo("%-32s %12s %10s %12s %12s", "benchmark", "cells/s", "ns/cell",
+          "peak RSS KB", "allocations");
+    for (const auto& s : samples_) {
+      qInfo("%-32s %12.0f %10.2f %12lld %12llu", qPrintable(s.name),
+            s.cellsPerSecond(), s.nsPerCell(), s.peakRssKb, s.allocations);
+    }
+
+    QString jsonPath = qEnvironmentVariable("MAZE_BENCH_JSON");
+    if (!jsonPath.isEmpty()) {
+      QFile file(jsonPath);
+      QVERIFY2(file.open(QIODevice::WriteOnly | QIODevice::Truncate),
+               qPrintable(jsonPath));
+      file.write(samplesJson().toJson());
+    }
+
+    QString baselinePath = qEnvironmentVariable("MAZE_BENCH_BASELINE");
+    if (!baselinePath.isEmpty()) {
+      QStringList slower = regressions(baselinePath);
+      QVERIFY2(slower.isEmpty(), qPrintable(slower.join("; ")));
+    }
+  }
+
+  void generate_data() { addSizes(); }
+  void generate() {
+    QFETCH(int, size);
+    Generator gen;
+    MazeData maze;
+
+    QBENCHMARK { gen.generate(maze, size, size); }
+    record(qint64(size) * size, [&]() { gen.generate(maze, size, size); });
+    // steady state: the grid and the generator's buffers are reused
+    QCOMPARE(samples_.back().allocations, quint64(0));
+  }
+
+  void generateAlgorithm_data() {
+    QTest::addColumn<QString>("algorithm");
+    QTest::addColumn<int>("size");
+    QList<int> sizes{100, 1000};
+    if (qEnvironmentVariableIntValue("MAZE_BENCH_LARGE")) sizes << 10000;
+    for (const QString& name : Generator::algorithmNames()) {
+      for (int size : sizes) {
+        QTest::newRow(qPrintable(QString("%1 %2x%2").arg(name).arg(size)))
+            << name << size;
+      }
+    }
+  }
+  void generateAlgorithm() {
+    QFETCH(QString, algorithm);
+    QFETCH(int, size);
+    Generator gen(*MazeGenerator::parse(algorithm.toStdString()));
+    MazeData maze;
+
+    // parallel Kruskal hands tasks to the scheduler, so no allocation check
+    QBENCHMARK { gen.generate(maze, size, size); }
+    record(qint64(size) * size, [&]() { gen.generate(maze, size, size); });
+  }
+
+  void solve_data() { addSizes(); }
+  void solve() {
+    QFETCH(int, size);
+    MazeData maze = generated(size);
+    Solver solver;
+    QPoint start(0, 0);
+    QPoint end(size - 1, size - 1);
+
+    std::vector<QPoint> path;
+
+    QBENCHMARK { solver.solve(maze, start, end, &path); }
+    record(qint64(size) * size, [&]() {
+      solver.solve(maze, start, end, &path);
+      QVERIFY(!path.empty());
+    });
+    // steady state: search state comes from the scratch arena, the path
+    // buffer is reused
+    QCOMPARE(samples_.back().allocations, quint64(0));
+  }
+
+  // batch solves keep the path packed, straight from the parent links
+  void solvePacked_data() { addSizes(); }
+  void solvePacked() {
+    QFETCH(int, size);
+    MazeData maze = generated(size);
+    Solver solver;
+    QPoint start(0, 0);
+    QPoint end(size - 1, size - 1);
+
+    PackedPath path;
+
+    QBENCHMARK { solver.solve(maze, start, end, &path); }
+    record(qint64(size) * size, [&]() {
+      solver.solve(maze, start, end, &path);
+      QVERIFY(!path.empty());
+    });
+    QCOMPARE(samples_.back().allocations, quint64(0));
+  }
+
+  // a long path packed and unpacked again; cells are path cells here
+  void pathCodec() {
+    MazeData maze = generated(1000);
+    std::vector<QPoint> path;
+    Solver().solve(maze, {0, 0}, {999, 999}, &path);
+    std::vector<QPoint> decoded;
+    PackedPath packed;
+    auto roundTrip = [&]() {
+      PathCodec::encode(path, &packed);
+      PathCodec::decode(packed, &decoded);
+    };
+
+    QBENCHMARK { roundTrip(); }
+    record(qint64(path.size()), [&]() {
+      roundTrip();
+      QVERIFY(decoded == path);
+    });
+  }
+
+  // corner to corner through the archive in a 16 MiB budget, next to
+  // `solve` on the loaded maze
+  void solveOutOfCore_data() {
+    QTest::addColumn<int>("size");
+    QList<int> sizes{1000};
+    if (qEnvironmentVariableIntValue("MAZE_BENCH_LARGE")) sizes << 10000;
+    for (int size : sizes) {
+      QTest::newRow(qPrintable(QString("%1x%1").arg(size))) << size;
+    }
+  }
+  void solveOutOfCore() {
+    QFETCH(int, size);
+    QString path = dir_.filePath("outOfCore.mza");
+    QVERIFY(TiledArchive::write(path, generated(size), 64).isValid());
+    OutOfCoreSolver solver(qint64(16) << 20, dir_.path());
+    QVERIFY(solver.open(path));
+    PackedPath packed;
+
+    QBENCHMARK { solver.solve({0, 0}, {size - 1, size - 1}, &packed); }
+    record(qint64(size) * size, [&]() {
+      QVERIFY(solver.solve({0, 0}, {size - 1, size - 1}, &packed));
+      QVERIFY(!packed.empty());
+    });
+  }
+
+  // the labelling solve behind the app's path, with the search recorded
+  // for playback and without; the cache is emptied so both search
+  void solveMaze_data() {
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("recorded");
+    for (int size : {100, 1000}) {
+      for (bool recorded : {false, true}) {
+        QTest::newRow(qPrintable(QString("%1x%1%2").arg(size).arg(
+            recorded ? " recorded" : "")))
+            << size << recorded;
+      }
+    }
+  }
+  void solveMaze() {
+    QFETCH(int, size);
+    QFETCH(bool, recorded);
+    MazeData maze = generated(size);
+    Solver solver;
+    solver.setMazeData(&maze);
+    solver.setRecordSearch(recorded);
+    auto solve = [&]() {
+      MazeCache::instance().clear();
+      solver.solveMaze(0, 0, size - 1, size - 1);
+    };
+
+    QBENCHMARK { solve(); }
+    record(qint64(size) * size, [&]() {
+      solve();
+      QVERIFY(solver.hasSolution());
+    });
+  }
+
+  void writeMazeFile_data() { addSizes(); }
+  void writeMazeFile() {
+    QFETCH(int, size);
+    MazeData maze = generated(size);
+    QString path = dir_.filePath("write.txt");
+
+    QBENCHMARK { AsyncIOParser::writeMazeFile(path, maze); }
+    record(qint64(size) * size, [&]() {
+      QVERIFY(AsyncIOParser::writeMazeFile(path, maze).isValid());
+    });
+  }
+
+  // the text format stops at 50x50, bigger mazes go through archives
+  void parseMazeFile_data() {
+    QTest::addColumn<int>("size");
+    QTest::newRow("10x10") << 10;
+    QTest::newRow("50x50") << 50;
+  }
+  void parseMazeFile() {
+    QFETCH(int, size);
+    QString path = dir_.filePath("parse.txt");
+    QVERIFY(AsyncIOParser::writeMazeFile(path, generated(size)).isValid());
+
+    QBENCHMARK { AsyncIOParser::parseMazeFile(path); }
+    record(qint64(size) * size, [&]() {
+      QVERIFY(AsyncIOParser::parseMazeFile(path).isValid());
+    });
+  }
+
+  void writeMazeArchive_data() { addSizes(); }
+  void writeMazeArchive() {
+    QFETCH(int, size);
+    MazeData maze = generated(size);
+    QString path = dir_.filePath("write.mza");
+
+    QBENCHMARK { AsyncIOParser::writeMazeArchive(path, maze); }
+    record(qint64(size) * size, [&]() {
+      QVERIFY(AsyncIOParser::writeMazeArchive(path, maze).isValid());
+    });
+  }
+
+  void parseMazeArchive_data() { addSizes(); }
+  void parseMazeArchive() {
+    QFETCH(int, size);
+    QString path = dir_.filePath("parse.mza");
+    QVERIFY(AsyncIOParser::writeMazeArchive(path, generated(size)).isValid());
+
+    QBENCHMARK { AsyncIOParser::parseMazeArchive(path); }
+    record(qint64(size) * size, [&]() {
+      QVERIFY(AsyncIOParser::parseMazeArchive(path).isValid());
+    });
+  }
+
+  void writeMazeImage_data() { addSizes(); }
+  void writeMazeImage() {
+    QFETCH(int, size);
+    QString path = dir_.filePath("bench.png");
+    MazeData maze = generated(size);
+
+    QBENCHMARK { QVERIFY(MazeImage::write(path, maze).isValid()); }
+    record(qint64(size) * size, [&]() { MazeImage::write(path, maze); });
+  }
+
+  // one automaton generation, bands spread over the scheduler
+  void caveStep_data() {
+    QTest::addColumn<int>("size");
+    QTest::newRow("1024x1024") << 1024;
+    QTest::newRow("4096x4096") << 4096;
+  }
+  void caveStep() {
+    QFETCH(int, size);
+    CaveGrid grid(size, size);
+    grid.fillRandom(45, 1);
+    CaveGrid next;
+    CaveRule rule = CaveRule::classic();
+
+    QBENCHMARK {
+      CaveAutomaton::step(grid, &next, rule);
+      std::swap(grid, next);
+    }
+    record(qint64(size) * size, [&]() {
+      CaveAutomaton::step(grid, &next, rule);
+      std::swap(grid, next);
+    });
+  }
+
+  // one analytics pass: walls, corridors, two sweeps and 1000 pairs
+  void analyze_data() { addSizes(); }
+  void analyze() {
+    QFETCH(int, size);
+    MazeData maze = generated(size);
+    MazeAnalysis analysis;
+
+    QBENCHMARK { analysis = MazeAnalytics::analyze(maze); }
+    record(qint64(size) * size,
+           [&]() { analysis = MazeAnalytics::analyze(maze); });
+    QVERIFY(analysis.perfect);
+  }
+
+  // Q-learning episodes spread over the scheduler; the row counts agent
+  // steps rather than cells
+  void qLearning() {
+    MazeData maze = generated(50);
+    QLearningOptions options;
+    options.episodes = 2000;
+    options.stopWhenConverged = false;
+    QLearningReport report;
+    auto train = [&]() {
+      QLearner learner(maze, QPoint(49, 49));
+      report = learner.train(QPoint(0, 0), options);
+    };
+
+    QBENCHMARK { train(); }
+    record(0, train);
+    samples_.back().cells = report.steps;
+    QVERIFY(report.steps > 0);
+  }
+
+  // progressive population: generation on a worker, rows streamed in
+  void modelGenerate_data() { addSizes(); }
+  void modelGenerate() {
+    QFETCH(int, size);
+    MazeModel model;
+    QSignalSpy finished(&model, &MazeModel::generationFinished);
+    auto populate = [&]() {
+      model.generate(size, size);
+      while (!model.isGenerated()) QVERIFY(finished.wait(600000));
+    };
+
+    QBENCHMARK { populate(); }
+    record(qint64(size) * size, populate);
+  }
+
+  // load path, includes copying the source maze
+  void modelSetMazeData_data() { addSizes(); }
+  void modelSetMazeData() {
+    QFETCH(int, size);
+    MazeData maze = generated(size);
+    MazeModel model;
+
+    QBENCHMARK {
+      MazeData copy = maze;
+      model.setMazeData(std::move(copy));
+    }
+    record(qint64(size) * size, [&]() {
+      MazeData copy = maze;
+      model.setMazeData(std::move(copy));
+    });
+  }
+};
+
+QTEST_MAIN(BenchMaze)
+#include "bench_maze.moc"
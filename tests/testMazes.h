@@ -0,0 +1,13 @@
+#pragma once
+
+#include "src/core/mazeData.h"
+#include "src/lib/service/generator/generator.h"
+
+// the same perfect maze for the same seed, from the default algorithm
+inline MazeData seededMaze(int rows, int cols, quint32 seed) {
+  Generator gen;
+  gen.setSeed(seed);
+  MazeData maze;
+  gen.generate(maze, rows, cols);
+  return maze;
+}
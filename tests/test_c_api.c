@@ -0,0 +1,124 @@
+// The C interface from plain C, linked against the shared maze_c.
+#include <stdio.h>
+#include <string.h>
+
+#include "src/core/mazeCApi.h"
+
+static int failures = 0;
+
+#define CHECK(condition)                                              \
+  do {                                                                \
+    if (!(condition)) {                                               \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+      ++failures;                                                     \
+    }                                                                 \
+  } while (0)
+
+static void testGenerateAndSolve(void) {
+  maze_t* maze = maze_create();
+  CHECK(maze != NULL);
+  CHECK(maze_rows(maze) == 0);
+  CHECK(maze_is_perfect(maze) == -1);
+  CHECK(maze_generate(maze, 0, 5, 1) == MAZE_ERROR_ARGUMENT);
+  CHECK(strlen(maze_last_error(maze)) > 0);
+
+  CHECK(maze_generate(maze, 20, 30, 42) == MAZE_OK);
+  CHECK(strcmp(maze_last_error(maze), "") == 0);
+  CHECK(maze_rows(maze) == 20 && maze_cols(maze) == 30);
+  CHECK(maze_is_perfect(maze) == 1);
+  // the outer border is closed
+  CHECK(maze_has_wall(maze, 5, 29, MAZE_WALL_RIGHT) == 1);
+  CHECK(maze_has_wall(maze, 19, 7, MAZE_WALL_BOTTOM) == 1);
+  CHECK(maze_has_wall(maze, 20, 0, MAZE_WALL_RIGHT) == -1);
+
+  int32_t path[600];
+  size_t length = 0;
+  CHECK(maze_solve(maze, 0, 0, 19, 29, path, 600, &length) == MAZE_OK);
+  CHECK(length >= 49);
+  CHECK(path[0] == 0 && path[length - 1] == 19 * 30 + 29);
+  for (size_t i = 1; i < length; ++i) {
+    int step = path[i] - path[i - 1];
+    CHECK(step == 1 || step == -1 || step == 30 || step == -30);
+  }
+
+  // too small a buffer reports the size needed
+  size_t needed = 0;
+  CHECK(maze_solve(maze, 0, 0, 19, 29, path, 3, &needed) ==
+        MAZE_ERROR_BUFFER);
+  CHECK(needed == length);
+  CHECK(maze_solve(maze, 0, 0, 20, 29, path, 600, &needed) ==
+        MAZE_ERROR_ARGUMENT);
+
+  // walling in the start leaves no path
+  CHECK(maze_set_wall(maze, 0, 0, MAZE_WALL_RIGHT, 1) == MAZE_OK);
+  CHECK(maze_set_wall(maze, 0, 0, MAZE_WALL_BOTTOM, 1) == MAZE_OK);
+  CHECK(maze_solve(maze, 0, 0, 19, 29, path, 600, &needed) ==
+        MAZE_ERROR_NO_PATH);
+  CHECK(maze_is_perfect(maze) == 0);
+  maze_destroy(maze);
+}
+
+static void testSeeded(void) {
+  maze_t* a = maze_create();
+  maze_t* b = maze_create();
+  CHECK(maze_generate(a, 15, 15, 7) == MAZE_OK);
+  CHECK(maze_generate(b, 15, 15, 7) == MAZE_OK);
+  int same = 1;
+  for (int r = 0; r < 15; ++r) {
+    for (int c = 0; c < 15; ++c) {
+      same &= maze_has_wall(a, r, c, MAZE_WALL_RIGHT) ==
+              maze_has_wall(b, r, c, MAZE_WALL_RIGHT);
+      same &= maze_has_wall(a, r, c, MAZE_WALL_BOTTOM) ==
+              maze_has_wall(b, r, c, MAZE_WALL_BOTTOM);
+    }
+  }
+  CHECK(same);
+  maze_destroy(a);
+  maze_destroy(b);
+}
+
+static void testText(void) {
+  const char text[] =
+      "2 3\n"
+      "0 0 1\n"
+      "0 0 1\n"
+      "\n"
+      "1 1 0\n"
+      "1 1 1\n";
+  maze_t* maze = maze_create();
+  CHECK(maze_parse_text(maze, text, sizeof text - 1) == MAZE_OK);
+  CHECK(maze_rows(maze) == 2 && maze_cols(maze) == 3);
+  CHECK(maze_has_wall(maze, 1, 2, MAZE_WALL_RIGHT) == 1);
+  CHECK(maze_has_wall(maze, 0, 2, MAZE_WALL_BOTTOM) == 0);
+  CHECK(maze_is_perfect(maze) == 1);
+
+  char buffer[64];
+  size_t length = 0;
+  CHECK(maze_format_text(maze, buffer, sizeof buffer, &length) == MAZE_OK);
+  CHECK(length == sizeof text - 1 && strcmp(buffer, text) == 0);
+  CHECK(maze_format_text(maze, buffer, 4, &length) == MAZE_ERROR_BUFFER);
+  CHECK(length == sizeof text - 1);
+
+  // a failed parse keeps the maze and says why
+  const char broken[] = "2 3\n0 0 1\n1 2 1\n";
+  CHECK(maze_parse_text(maze, broken, sizeof broken - 1) ==
+        MAZE_ERROR_FORMAT);
+  CHECK(strcmp(maze_last_error(maze), "invalid value 2 at right wall [1,1]") ==
+        0);
+  CHECK(maze_parse_text(maze, "60 3", 4) == MAZE_ERROR_FORMAT);
+  CHECK(strcmp(maze_last_error(maze), "invalid dimensions: 60x3 (max 50x50)") ==
+        0);
+  CHECK(maze_rows(maze) == 2);
+
+  CHECK(maze_load_text(maze, "/nonexistent/maze.txt") == MAZE_ERROR_IO);
+  maze_destroy(maze);
+}
+
+int main(void) {
+  CHECK(maze_api_version() == MAZE_API_VERSION);
+  testGenerateAndSolve();
+  testSeeded();
+  testText();
+  if (failures) fprintf(stderr, "%d checks failed\n", failures);
+  return failures ? 1 : 0;
+}
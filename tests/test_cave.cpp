@@ -0,0 +1,176 @@
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <QtTest/QtTest>
+
+#include "src/lib/service/cave/caveAutomaton.h"
+#include "src/lib/service/cave/caveEngine.h"
+#include "src/lib/service/ioParser/asyncIOParser.h"
+
+class TestCave : public QObject {
+  Q_OBJECT
+
+ private:
+  // cell by cell, outside the grid counts as rock
+  static CaveGrid referenceStep(const CaveGrid& from, const CaveRule& rule) {
+    CaveGrid to(from.rows(), from.cols());
+    for (int r = 0; r < from.rows(); ++r) {
+      for (int c = 0; c < from.cols(); ++c) {
+        int rocks = 0;
+        for (int dr = -1; dr <= 1; ++dr) {
+          for (int dc = -1; dc <= 1; ++dc) {
+            if (dr == 0 && dc == 0) continue;
+            int nr = r + dr, nc = c + dc;
+            bool outside =
+                nr < 0 || nr >= from.rows() || nc < 0 || nc >= from.cols();
+            rocks += outside || from.rock(nr, nc);
+          }
+        }
+        quint16 set = from.rock(r, c) ? rule.survival : rule.birth;
+        to.setRock(r, c, set & (1u << rocks));
+      }
+    }
+    return to;
+  }
+
+ private slots:
+  void testRuleParsing() {
+    bool ok = false;
+    QCOMPARE(CaveRule::parse("B678/S345678", &ok), CaveRule::classic());
+    QVERIFY(ok);
+    QCOMPARE(CaveRule::classic().toString(), QString("B678/S345678"));
+
+    CaveRule life = CaveRule::parse(" b3 / s23 ", &ok);
+    QVERIFY(ok);
+    QCOMPARE(life.birth, quint16(1 << 3));
+    QCOMPARE(life.survival, quint16((1 << 2) | (1 << 3)));
+
+    QCOMPARE(CaveRule::parse("B/S", &ok), CaveRule{});
+    QVERIFY(ok);
+    CaveRule::parse("B9/S1", &ok);
+    QVERIFY(!ok);
+    CaveRule::parse("345678", &ok);
+    QVERIFY(!ok);
+  }
+
+  void testStepMatchesReference_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<QString>("rule");
+    QTest::newRow("classic") << 150 << 130 << "B678/S345678";
+    QTest::newRow("life") << 70 << 64 << "B3/S23";
+    QTest::newRow("narrow") << 9 << 5 << "B5678/S45678";
+    QTest::newRow("one row") << 1 << 200 << "B1/S012345678";
+  }
+  void testStepMatchesReference() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(QString, rule);
+    CaveRule parsed = CaveRule::parse(rule);
+
+    CaveGrid grid(rows, cols);
+    grid.fillRandom(45, 11);
+    CaveGrid next;
+    for (int step = 0; step < 4; ++step) {
+      CaveGrid expected = referenceStep(grid, parsed);
+      CaveAutomaton::step(grid, &next, parsed);
+      QVERIFY2(next == expected, qPrintable(QString("step %1").arg(step)));
+      std::swap(grid, next);
+    }
+  }
+
+  void testFillRandomIsSeeded() {
+    CaveGrid a(100, 100), b(100, 100), c(100, 100);
+    a.fillRandom(45, 3);
+    b.fillRandom(45, 3);
+    c.fillRandom(45, 4);
+    QVERIFY(a == b);
+    QVERIFY(!(a == c));
+    QVERIFY(a.rockCount() > 4000 && a.rockCount() < 5000);
+
+    CaveGrid full(3, 70);
+    full.fillRandom(100, 1);
+    QCOMPARE(full.rockCount(), qint64(3 * 70));  // padding stays clear
+  }
+
+  void testSaveAndLoad() {
+    QTemporaryDir dir;
+    QString path = dir.filePath("cave.cave");
+    CaveGrid grid(37, 333);
+    grid.fillRandom(50, 8);
+    CaveRule rule = CaveRule::parse("B5678/S45678");
+
+    QVERIFY(AsyncIOParser::writeCaveFile(path, grid, rule).isValid());
+    CaveParseResult loaded = AsyncIOParser::parseCaveFile(path);
+    QVERIFY2(loaded.isValid(), qPrintable(loaded.error));
+    QVERIFY(loaded.grid == grid);
+    QCOMPARE(loaded.rule, rule);
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 8));
+    file.close();
+    QVERIFY(!AsyncIOParser::parseCaveFile(path).isValid());
+    QVERIFY(!AsyncIOParser::parseCaveFile(dir.filePath("none.cave"))
+                 .isValid());
+    QVERIFY(!AsyncIOParser::writeCaveFile(path, {}, rule).isValid());
+  }
+
+  void testRejectsOversizedHeader() {
+    QTemporaryDir dir;
+    QString path = dir.filePath("short.cave");
+    CaveGrid grid(4, 4);
+    QVERIFY(AsyncIOParser::writeCaveFile(path, grid, CaveRule::classic())
+                .isValid());
+
+    // the header claims the largest grid, the file holds four rows
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray bytes = file.readAll();
+    qToLittleEndian<quint32>(CaveGrid::kMaxDimension, bytes.data() + 8);
+    qToLittleEndian<quint32>(CaveGrid::kMaxDimension, bytes.data() + 12);
+    file.seek(0);
+    file.write(bytes);
+    file.close();
+
+    CaveParseResult loaded = AsyncIOParser::parseCaveFile(path);
+    QVERIFY(!loaded.isValid());
+    QCOMPARE(loaded.error,
+             QString("cave file size does not match its dimensions"));
+  }
+
+  void testEngineStepsAndRuns() {
+    CaveEngine engine;
+    QSignalSpy stepped(&engine, &CaveEngine::stepped);
+    engine.generate(200, 300, 45, 5);
+    QCOMPARE(engine.rows(), 200);
+    QCOMPARE(engine.cols(), 300);
+    QCOMPARE(engine.generation(), 0);
+
+    CaveGrid expected = engine.grid();
+    CaveGrid next;
+    for (int i = 0; i < 3; ++i) {
+      CaveAutomaton::step(expected, &next, engine.caveRule());
+      std::swap(expected, next);
+    }
+    engine.step(3);
+    QCOMPARE(engine.generation(), 3);
+    QVERIFY(engine.grid() == expected);
+
+    engine.setRule("nonsense");
+    QCOMPARE(engine.rule(), QString("B678/S345678"));
+    engine.setRule("B3/S23");
+    QCOMPARE(engine.rule(), QString("B3/S23"));
+
+    // well above the frame rate several steps land per tick
+    engine.setStepsPerSecond(500);
+    engine.setRunning(true);
+    int before = stepped.count();
+    QTRY_VERIFY_WITH_TIMEOUT(engine.generation() >= 30, 5000);
+    engine.setRunning(false);
+    QVERIFY(stepped.count() - before < engine.generation() - 3);
+  }
+};
+
+QTEST_MAIN(TestCave)
+#include "test_cave.moc"
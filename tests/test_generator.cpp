@@ -284,6 +284,193 @@ class TestGenerator : public QObject {
              "two generated mazes should differ (randomness check)");
   }
 
+  void testSeedReproducesMaze() {
+    Generator gen1, gen2;
+    gen1.setSeed(42);
+    gen2.setSeed(42);
+    MazeData maze1, maze2;
+
+    gen1.generate(maze1, 30, 20);
+    gen2.generate(maze2, 30, 20);
+
+    for (int r = 0; r < 30; ++r) {
+      for (int c = 0; c < 20; ++c) {
+        QCOMPARE(maze1.cells[r][c].rightWall, maze2.cells[r][c].rightWall);
+        QCOMPARE(maze1.cells[r][c].bottomWall, maze2.cells[r][c].bottomWall);
+      }
+    }
+    QCOMPARE(countPassages(maze1), 30 * 20 - 1);
+  }
+
+  void testReusedMazeMatchesFresh() {
+    Generator reused, fresh;
+    MazeData maze;
+    reused.generate(maze, 40, 60);  // larger and dirty before the reuse
+
+    reused.setSeed(7);
+    fresh.setSeed(7);
+    MazeData expected;
+    reused.generate(maze, 25, 35);
+    fresh.generate(expected, 25, 35);
+
+    QCOMPARE(maze.rows, 25);
+    QCOMPARE(maze.cols, 35);
+    QCOMPARE(maze.cells.size(), size_t(25));
+    for (int r = 0; r < 25; ++r) {
+      QCOMPARE(maze.cells[r].size(), size_t(35));
+      for (int c = 0; c < 35; ++c) {
+        QCOMPARE(maze.cells[r][c].rightWall, expected.cells[r][c].rightWall);
+        QCOMPARE(maze.cells[r][c].bottomWall,
+                 expected.cells[r][c].bottomWall);
+      }
+    }
+    QCOMPARE(countPassages(maze), 25 * 35 - 1);
+  }
+
+  void testSeededMazesUnchanged_data() {
+    QTest::addColumn<int>("side");
+    QTest::addColumn<quint32>("seed");
+    QTest::addColumn<quint32>("fingerprint");
+    // taken before the fixed-size kernels, 37 has none
+    QTest::newRow("10 seed 1") << 10 << 1u << 0x9be5c80fu;
+    QTest::newRow("10 seed 2024") << 10 << 2024u << 0xdd31928eu;
+    QTest::newRow("20 seed 7") << 20 << 7u << 0x3ce208e9u;
+    QTest::newRow("50 seed 1") << 50 << 1u << 0x7c09fd25u;
+    QTest::newRow("50 seed 2024") << 50 << 2024u << 0x031ad607u;
+    QTest::newRow("37 seed 7") << 37 << 7u << 0x29aed7e2u;
+  }
+  void testSeededMazesUnchanged() {
+    QFETCH(int, side);
+    QFETCH(quint32, seed);
+    QFETCH(quint32, fingerprint);
+    Generator gen;
+    gen.setSeed(seed);
+    MazeData maze;
+    gen.generate(maze, side, side);
+
+    // fnv-1a over (right, bottom) per cell, row by row
+    quint32 hash = 2166136261u;
+    for (const auto& row : maze.cells) {
+      for (const MazeCell& cell : row) {
+        hash = (hash ^ quint32(cell.rightWall * 2 + cell.bottomWall)) *
+               16777619u;
+      }
+    }
+    QCOMPARE(hash, fingerprint);
+  }
+
+  void testStopsEarlyAtFixedSize() {
+    Generator gen;
+    gen.setSeed(3);
+    MazeData maze;
+    int rows = 0;
+    gen.generate(maze, 20, 20, [&](int row) {
+      rows = row + 1;
+      return row < 4;
+    });
+    QCOMPARE(rows, 5);
+    QVERIFY(!maze.isGenerated);
+  }
+
+  void testEveryAlgorithmIsPerfect_data() {
+    QTest::addColumn<QString>("algorithm");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    for (const QString& name : Generator::algorithmNames()) {
+      QTest::newRow(qPrintable(name + " 1x1")) << name << 1 << 1;
+      QTest::newRow(qPrintable(name + " 1x17")) << name << 1 << 17;
+      QTest::newRow(qPrintable(name + " 13x1")) << name << 13 << 1;
+      QTest::newRow(qPrintable(name + " 15x8")) << name << 15 << 8;
+      QTest::newRow(qPrintable(name + " 50x50")) << name << 50 << 50;
+      QTest::newRow(qPrintable(name + " 120x90")) << name << 120 << 90;
+    }
+  }
+  void testEveryAlgorithmIsPerfect() {
+    QFETCH(QString, algorithm);
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    Generator gen(*MazeGenerator::parse(algorithm.toStdString()));
+    QCOMPARE(gen.algorithmName(), algorithm);
+
+    MazeData maze;
+    int reported = 0;
+    gen.generate(maze, rows, cols, [&](int row) {
+      // rows arrive in order, each once; QCOMPARE can't return a bool, a
+      // wrong row fails the test and stops the generation
+      if (!QTest::qCompare(row, reported, "row", "reported", __FILE__,
+                           __LINE__)) {
+        return false;
+      }
+      ++reported;
+      return true;
+    });
+    QVERIFY(maze.isGenerated);
+    QCOMPARE(reported, rows);
+    QVERIFY(boundaryWallsIntact(maze));
+    QCOMPARE(countReachableCells(maze), rows * cols);
+    QCOMPARE(countPassages(maze), rows * cols - 1);
+  }
+
+  void testEveryAlgorithmFollowsSeed_data() {
+    QTest::addColumn<QString>("algorithm");
+    for (const QString& name : Generator::algorithmNames()) {
+      QTest::newRow(qPrintable(name)) << name;
+    }
+  }
+  void testEveryAlgorithmFollowsSeed() {
+    QFETCH(QString, algorithm);
+    const MazeAlgorithm kind = *MazeGenerator::parse(algorithm.toStdString());
+    Generator gen1(kind), gen2(kind), other(kind);
+    gen1.setSeed(11);
+    gen2.setSeed(11);
+    other.setSeed(12);
+    // large enough for Kruskal to split its edges across tasks
+    MazeData maze1, maze2, maze3;
+    gen1.generate(maze1, 300, 200);
+    gen2.generate(maze2, 300, 200);
+    other.generate(maze3, 300, 200);
+
+    int differences = 0;
+    for (int r = 0; r < 300; ++r) {
+      for (int c = 0; c < 200; ++c) {
+        QCOMPARE(maze1.cells[r][c].rightWall, maze2.cells[r][c].rightWall);
+        QCOMPARE(maze1.cells[r][c].bottomWall, maze2.cells[r][c].bottomWall);
+        differences += maze1.cells[r][c].rightWall !=
+                       maze3.cells[r][c].rightWall;
+      }
+    }
+    QVERIFY(differences > 0);
+  }
+
+  void testAlgorithmNames() {
+    const QStringList names = Generator::algorithmNames();
+    QCOMPARE(names.first(), QString(Generator::kAlgorithm));
+    QCOMPARE(names.size(), int(std::size(MazeGenerator::kAlgorithms)));
+    for (const QString& name : names) {
+      QVERIFY(MazeGenerator::parse(name.toStdString()).has_value());
+    }
+    QVERIFY(!MazeGenerator::parse("bogus").has_value());
+    QVERIFY(!MazeGenerator::parse("").has_value());
+
+    Generator gen;
+    QCOMPARE(gen.algorithm(), MazeAlgorithm::Eller);
+    gen.setSeed(5);
+    gen.setAlgorithm(MazeAlgorithm::Wilson);
+    Generator seeded(MazeAlgorithm::Wilson);
+    seeded.setSeed(5);
+    // the seed carries over to the new algorithm
+    MazeData maze, expected;
+    gen.generate(maze, 12, 12);
+    seeded.generate(expected, 12, 12);
+    for (int r = 0; r < 12; ++r) {
+      for (int c = 0; c < 12; ++c) {
+        QCOMPARE(maze.cells[r][c].rightWall, expected.cells[r][c].rightWall);
+        QCOMPARE(maze.cells[r][c].bottomWall,
+                 expected.cells[r][c].bottomWall);
+      }
+    }
+  }
+
   void testMultipleGenerations() {
     // stress test: generate many mazes, all should be valid
     Generator gen;
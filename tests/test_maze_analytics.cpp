@@ -0,0 +1,189 @@
+#include <QRandomGenerator>
+#include <QSignalSpy>
+#include <QtTest/QtTest>
+#include <algorithm>
+#include <numeric>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/analytics/analyticsReporter.h"
+#include "src/lib/service/analytics/mazeAnalytics.h"
+#include "src/lib/service/solver/solver.h"
+#include "tests/testMazes.h"
+
+class TestMazeAnalytics : public QObject {
+  Q_OBJECT
+
+ private:
+  // the solution lengths analyze() samples, found by the solver
+  static std::vector<int> solvedSamples(const MazeData& maze, int samples,
+                                        quint32 seed, int* unreachable) {
+    QRandomGenerator random(seed);
+    Solver solver;
+    std::vector<int> lengths;
+    *unreachable = 0;
+    quint32 cells = quint32(maze.rows * maze.cols);
+    for (int i = 0; i < samples; ++i) {
+      int a = int(random.bounded(cells));
+      int b = int(random.bounded(cells));
+      std::vector<QPoint> path =
+          solver.solve(maze, QPoint(a / maze.cols, a % maze.cols),
+                       QPoint(b / maze.cols, b % maze.cols));
+      if (path.empty()) {
+        ++*unreachable;
+      } else {
+        lengths.push_back(int(path.size()));
+      }
+    }
+    std::sort(lengths.begin(), lengths.end());
+    return lengths;
+  }
+
+  static void compareSamples(const MazeAnalysis& analysis,
+                             const std::vector<int>& lengths,
+                             int unreachable) {
+    QCOMPARE(analysis.unreachablePairs, unreachable);
+    QVERIFY(!lengths.empty());
+    QCOMPARE(analysis.minSolution, lengths.front());
+    QCOMPARE(analysis.maxSolution, lengths.back());
+    QCOMPARE(analysis.p50Solution, lengths[lengths.size() / 2]);
+    double mean = std::accumulate(lengths.begin(), lengths.end(), 0.0) /
+                  double(lengths.size());
+    QVERIFY(qAbs(analysis.meanSolution - mean) < 1e-9);
+    qint64 histogram = std::accumulate(analysis.solutionHistogram.begin(),
+                                       analysis.solutionHistogram.end(),
+                                       qint64(0));
+    QCOMPARE(histogram, qint64(lengths.size()));
+  }
+
+ private slots:
+  void testSerpentine() {
+    // one corridor snaking through a 3x3 maze
+    MazeData maze;
+    maze.rows = maze.cols = 3;
+    maze.isGenerated = true;
+    maze.cells.assign(3, std::vector<MazeCell>(3, MazeCell{true, true}));
+    maze.cells[0][0].rightWall = maze.cells[0][1].rightWall = false;
+    maze.cells[0][2].bottomWall = false;
+    maze.cells[1][0].rightWall = maze.cells[1][1].rightWall = false;
+    maze.cells[1][0].bottomWall = false;
+    maze.cells[2][0].rightWall = maze.cells[2][1].rightWall = false;
+
+    MazeAnalysis analysis = MazeAnalytics::analyze(maze, {200, 4});
+    QCOMPARE(analysis.passages, qint64(8));
+    QCOMPARE(analysis.deadEnds, qint64(2));
+    QCOMPARE(analysis.junctions, qint64(0));
+    QCOMPARE(analysis.corridors, qint64(1));
+    QCOMPARE(analysis.longestCorridor, 7);
+    QCOMPARE(analysis.corridorLengths[7], qint64(1));
+    QCOMPARE(analysis.diameter, 9);
+    QVERIFY(analysis.perfect);
+    QCOMPARE(analysis.reachableCells, qint64(9));
+    QVERIFY((analysis.diameterStart == QPoint(0, 0) &&
+             analysis.diameterEnd == QPoint(2, 2)) ||
+            (analysis.diameterStart == QPoint(2, 2) &&
+             analysis.diameterEnd == QPoint(0, 0)));
+    QCOMPARE(analysis.samples, 200);
+    QVERIFY(analysis.minSolution >= 1 && analysis.maxSolution <= 9);
+  }
+
+  void testPerfectMazeMatchesSolver() {
+    MazeData maze = seededMaze(30, 40, 9);
+    MazeAnalysis analysis = MazeAnalytics::analyze(maze, {300, 17});
+    QVERIFY(analysis.perfect);
+    QCOMPARE(analysis.passages, qint64(30 * 40 - 1));
+
+    // the diameter ends are as far apart as any two cells get
+    Solver solver;
+    std::vector<QPoint> all;
+    for (int r = 0; r < 30; ++r) {
+      for (int c = 0; c < 40; ++c) all.emplace_back(r, c);
+    }
+    size_t longest = 0;
+    for (const auto& path :
+         solver.solveFrom(maze, analysis.diameterEnd, all)) {
+      longest = std::max(longest, path.size());
+    }
+    QCOMPARE(analysis.diameter, int(longest));
+    QCOMPARE(int(solver.solve(maze, analysis.diameterStart,
+                              analysis.diameterEnd).size()),
+             analysis.diameter);
+
+    qint64 deadEnds = 0, corridorCells = 0;
+    for (int r = 0; r < 30; ++r) {
+      for (int c = 0; c < 40; ++c) {
+        int degree = 0;
+        for (QPoint step : {QPoint(0, 1), QPoint(0, -1), QPoint(1, 0),
+                            QPoint(-1, 0)}) {
+          degree += Solver::canMove(maze, {r, c}, QPoint(r, c) + step);
+        }
+        deadEnds += degree == 1;
+        corridorCells += degree == 2;
+      }
+    }
+    QCOMPARE(analysis.deadEnds, deadEnds);
+    qint64 counted = 0;
+    for (int length = 1; length < MazeAnalysis::kMaxCorridorLength; ++length) {
+      counted += length * analysis.corridorLengths[length];
+    }
+    QCOMPARE(counted, corridorCells);
+
+    int unreachable = 0;
+    std::vector<int> lengths = solvedSamples(maze, 300, 17, &unreachable);
+    compareSamples(analysis, lengths, unreachable);
+  }
+
+  void testLoopsAndIslands() {
+    MazeData maze = seededMaze(20, 20, 5);
+    // a few loops, and a walled-in cell
+    maze.cells[4][4].rightWall = maze.cells[10][7].bottomWall = false;
+    maze.cells[15][2].rightWall = false;
+    maze.cells[19][19].rightWall = maze.cells[19][19].bottomWall = true;
+    maze.cells[19][18].rightWall = maze.cells[18][19].bottomWall = true;
+
+    MazeAnalysis analysis = MazeAnalytics::analyze(maze, {200, 3});
+    QVERIFY(!analysis.perfect);
+    QVERIFY(analysis.isolatedCells >= 1);
+    QVERIFY(analysis.reachableCells < 20 * 20);
+
+    int unreachable = 0;
+    std::vector<int> lengths = solvedSamples(maze, 200, 3, &unreachable);
+    compareSamples(analysis, lengths, unreachable);
+  }
+
+  void testBatchMatchesSingle() {
+    std::vector<MazeData> mazes;
+    for (quint32 seed = 1; seed <= 6; ++seed) {
+      mazes.push_back(seededMaze(10 + int(seed), 25, seed));
+    }
+    mazes.emplace_back();  // not generated
+    std::vector<const MazeData*> pointers;
+    for (const MazeData& maze : mazes) pointers.push_back(&maze);
+
+    std::vector<MazeAnalysis> batch = MazeAnalytics::analyzeBatch(pointers);
+    QCOMPARE(batch.size(), mazes.size());
+    for (size_t i = 0; i < mazes.size(); ++i) {
+      QCOMPARE(batch[i].toJson(), MazeAnalytics::analyze(mazes[i]).toJson());
+    }
+    QCOMPARE(batch.back().rows, 0);
+  }
+
+  void testReporterFollowsEdits() {
+    MazeData maze = seededMaze(12, 12, 2);
+    AnalyticsReporter reporter;
+    QSignalSpy changed(&reporter, &AnalyticsReporter::statsChanged);
+    reporter.setMazeData(&maze);
+    QVERIFY(reporter.stats().isEmpty());  // inactive
+
+    reporter.setActive(true);
+    QTRY_VERIFY(!reporter.analyzing() && !reporter.stats().isEmpty());
+    QCOMPARE(reporter.stats().value("perfect").toBool(), true);
+
+    maze.cells[3][3].rightWall = !maze.cells[3][3].rightWall;
+    reporter.invalidate();
+    QTRY_VERIFY(!reporter.analyzing() &&
+                !reporter.stats().value("perfect").toBool());
+  }
+};
+
+QTEST_MAIN(TestMazeAnalytics)
+#include "test_maze_analytics.moc"
@@ -0,0 +1,213 @@
+#include <QSignalSpy>
+#include <QtTest/QtTest>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/cache/gridPool.h"
+#include "src/lib/service/cache/mazeCache.h"
+#include "src/lib/service/generator/generator.h"
+#include "src/lib/service/solver/solver.h"
+#include "tests/testMazes.h"
+
+class TestMazeCache : public QObject {
+  Q_OBJECT
+
+ private:
+  static qint64 bytesOf(int rows, int cols) {
+    return qint64(sizeof(MazeData)) +
+           qint64(rows) * qint64(sizeof(std::vector<MazeCell>)) +
+           qint64(rows) * cols * qint64(sizeof(MazeCell));
+  }
+
+ private slots:
+  void init() {
+    MazeCache::instance().clear();
+    MazeCache::instance().setBudget(MazeCache::kDefaultMazeBytes,
+                                    MazeCache::kDefaultPathBytes);
+  }
+
+  void testGenerateHitsAfterMiss() {
+    MazeCache cache;
+    auto first = cache.generate(20, 30, 9);
+    auto second = cache.generate(20, 30, 9);
+    auto other = cache.generate(20, 30, 10);
+
+    QCOMPARE(second.get(), first.get());
+    QVERIFY(other.get() != first.get());
+    MazeCache::Stats stats = cache.stats();
+    QCOMPARE(stats.mazeHits, quint64(1));
+    QCOMPARE(stats.mazeMisses, quint64(2));
+    QCOMPARE(stats.mazeBytes, 2 * bytesOf(20, 30));
+
+    // same seed without the cache, same walls
+    QCOMPARE(MazeCache::fingerprint(seededMaze(20, 30, 9)),
+             MazeCache::fingerprint(*first));
+  }
+
+  void testAlgorithmKeysMazes() {
+    MazeCache cache;
+    auto eller = cache.generate(20, 30, 9);
+    auto kruskal = cache.generate(20, 30, 9, "kruskal");
+    auto fallback = cache.generate(20, 30, 9, "bogus");
+
+    QVERIFY(kruskal.get() != eller.get());
+    QCOMPARE(fallback.get(), eller.get());
+    QCOMPARE(cache.generate(20, 30, 9, "kruskal").get(), kruskal.get());
+
+    Generator gen(MazeAlgorithm::Kruskal);
+    gen.setSeed(9);
+    MazeData maze;
+    gen.generate(maze, 20, 30);
+    QCOMPARE(MazeCache::fingerprint(maze), MazeCache::fingerprint(*kruskal));
+  }
+
+  void testEvictsLeastRecentlyUsed() {
+    MazeCache cache;
+    cache.setBudget(2 * bytesOf(10, 10), MazeCache::kDefaultPathBytes);
+    auto first = cache.generate(10, 10, 1);
+    cache.generate(10, 10, 2);
+    QVERIFY(cache.findMaze(10, 10, 1, Generator::kAlgorithm));  // now newest
+    cache.generate(10, 10, 3);
+
+    QVERIFY(cache.findMaze(10, 10, 1, Generator::kAlgorithm));
+    QVERIFY(!cache.findMaze(10, 10, 2, Generator::kAlgorithm));
+    QCOMPARE(cache.stats().evictions, quint64(1));
+    QCOMPARE(cache.stats().mazeBytes, 2 * bytesOf(10, 10));
+
+    // too big for the budget at all: not cached, nothing evicted
+    cache.generate(100, 100, 4);
+    QCOMPARE(cache.stats().evictions, quint64(1));
+    QVERIFY(!cache.findMaze(100, 100, 4, Generator::kAlgorithm));
+  }
+
+  void testFingerprintFollowsWalls() {
+    MazeCache cache;
+    MazeData maze = *cache.generate(17, 40, 3);
+    quint64 original = MazeCache::fingerprint(maze);
+
+    maze.cells[5][33].rightWall = !maze.cells[5][33].rightWall;
+    QVERIFY(MazeCache::fingerprint(maze) != original);
+    maze.cells[5][33].rightWall = !maze.cells[5][33].rightWall;
+    QCOMPARE(MazeCache::fingerprint(maze), original);
+
+    maze.cells[16][0].bottomWall = !maze.cells[16][0].bottomWall;
+    QVERIFY(MazeCache::fingerprint(maze) != original);
+  }
+
+  void testPathsKeyedByFingerprintAndEnds() {
+    MazeCache cache;
+    std::vector<QPoint> path;
+    QVERIFY(!cache.findPath(42, {0, 0}, {1, 1}, &path));
+
+    cache.insertPath(42, {0, 0}, {1, 1}, {{0, 0}, {0, 1}, {1, 1}});
+    cache.insertPath(42, {0, 0}, {2, 2}, {});  // no path is an answer too
+    QVERIFY(cache.findPath(42, {0, 0}, {1, 1}, &path));
+    QCOMPARE(path.size(), size_t(3));
+    QVERIFY(cache.findPath(42, {0, 0}, {2, 2}, &path));
+    QVERIFY(path.empty());
+    QVERIFY(!cache.findPath(43, {0, 0}, {1, 1}, &path));
+    QVERIFY(!cache.findPath(42, {1, 1}, {0, 0}, &path));
+
+    MazeCache::Stats stats = cache.stats();
+    QCOMPARE(stats.pathHits, quint64(2));
+    QCOMPARE(stats.pathMisses, quint64(3));
+  }
+
+  void testSolverReusesPathAndRepairsAfterEdit() {
+    MazeData maze = *MazeCache::instance().generate(15, 15, 5);
+
+    Solver first;
+    first.setMazeData(&maze);
+    first.solveMaze(0, 0, 14, 14);
+    Solver second;
+    second.setMazeData(&maze);
+    second.solveMaze(0, 0, 14, 14);
+    QCOMPARE(MazeCache::instance().stats().pathHits, quint64(1));
+    QVERIFY(second.currentPath() == first.currentPath());
+
+    // cut the cached path; the labels it skipped are built on demand
+    std::vector<QPoint> original = second.currentPath();
+    QPoint a = original[original.size() / 2];
+    QPoint b = original[original.size() / 2 + 1];
+    QPoint cell(std::min(a.x(), b.x()), std::min(a.y(), b.y()));
+    bool& wall = a.x() == b.x() ? maze.cells[cell.x()][cell.y()].rightWall
+                                : maze.cells[cell.x()][cell.y()].bottomWall;
+    wall = true;
+    second.repairPath(a, b, true);
+    QVERIFY(!second.hasSolution());
+
+    wall = false;
+    second.repairPath(a, b, false);
+    QVERIFY(second.currentPath() == original);
+  }
+
+  void testModelReusesCachedMaze() {
+    MazeModel model;
+    QSignalSpy finished(&model, &MazeModel::generationFinished);
+    model.generate(30, 20, 77);
+    QCOMPARE(model.seed(), qint64(77));
+    QVERIFY(finished.wait(5000));
+    quint64 generated = MazeCache::fingerprint(model.mazeData());
+
+    model.clear();
+    model.generate(30, 20, 77);
+    QCOMPARE(finished.count(), 2);  // no streaming this time
+    QVERIFY(model.isGenerated());
+    QVERIFY(!model.generating());
+    QCOMPARE(model.rowCount(), 30 * 20);
+    QCOMPARE(MazeCache::fingerprint(model.mazeData()), generated);
+    QCOMPARE(MazeCache::instance().stats().mazeHits, quint64(1));
+    auto cached = MazeCache::instance().findMaze(30, 20, 77,
+                                                 Generator::kAlgorithm);
+    QCOMPARE(&model.mazeData(), cached.get());  // shared, not copied
+
+    // edits stay in the model
+    QVERIFY(model.toggleWall(3, 3, MazeModel::RightWall));
+    QVERIFY(&model.mazeData() != cached.get());
+    QCOMPARE(MazeCache::fingerprint(*cached), generated);
+  }
+
+  void testGeneratedMazeSharedWithCache() {
+    MazeModel model;
+    QSignalSpy finished(&model, &MazeModel::generationFinished);
+    model.generate(25, 15, 78);
+    QVERIFY(finished.wait(5000));
+
+    // the cache holds the model's maze itself, the first edit copies it
+    auto cached = MazeCache::instance().findMaze(25, 15, 78,
+                                                 Generator::kAlgorithm);
+    QVERIFY(cached);
+    QCOMPARE(cached.get(), &model.mazeData());
+    quint64 generated = MazeCache::fingerprint(*cached);
+    QVERIFY(model.toggleWall(2, 2, MazeModel::BottomWall));
+    QVERIFY(cached.get() != &model.mazeData());
+    QCOMPARE(MazeCache::fingerprint(*cached), generated);
+  }
+
+  void testGridPoolReusesSameSize() {
+    GridPool pool;
+    MazeData grid = pool.acquire(8, 12, {true, false});
+    QCOMPARE(grid.rows, 8);
+    QCOMPARE(grid.cells[7][11].rightWall, true);
+    QCOMPARE(grid.cells[7][11].bottomWall, false);
+    const MazeCell* rowBuffer = grid.cells[3].data();
+    grid.cells[3][4] = {false, true};
+    pool.release(std::move(grid));
+
+    QCOMPARE(pool.acquire(12, 8, {false, false}).rows, 12);  // other shape
+    MazeData again = pool.acquire(8, 12, {false, false});
+    QCOMPARE(again.cells[3].data(), rowBuffer);
+    QCOMPARE(again.cells[3][4].bottomWall, false);  // refilled
+    QCOMPARE(pool.stats().reused, quint64(1));
+    QCOMPARE(pool.stats().allocated, quint64(2));
+
+    // over budget: not kept
+    pool.setBudget(0);
+    pool.release(std::move(again));
+    QCOMPARE(pool.stats().bytes, qint64(0));
+    pool.acquire(8, 12, {false, false});
+    QCOMPARE(pool.stats().reused, quint64(1));
+  }
+};
+
+QTEST_MAIN(TestMazeCache)
+#include "test_maze_cache.moc"
@@ -0,0 +1,167 @@
+#include <QBuffer>
+#include <QImage>
+#include <QPainter>
+#include <QSvgRenderer>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+#include <set>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/ioParser/mazeImage.h"
+#include "src/lib/service/solver/solver.h"
+#include "tests/testMazes.h"
+
+class TestMazeImage : public QObject {
+  Q_OBJECT
+
+ private:
+  enum class Ink { Background, Wall, Path, Other };
+
+  static Ink ink(QRgb pixel) {
+    if (qRed(pixel) > 200 && qGreen(pixel) < 120) return Ink::Path;
+    if (qGray(pixel) < 64) return Ink::Wall;
+    if (qGray(pixel) > 192) return Ink::Background;
+    return Ink::Other;
+  }
+
+  // empty when every wall and path cell shows where the options put it:
+  // grid lines at multiples of the cell size, path squares centred
+  // between them
+  QString checkPicture(const QImage& image, const MazeData& maze,
+                       const MazeImageOptions& options) {
+    const int cell = options.cellSize;
+    const int wall = options.wallWidth;
+    if (image.size() != QSize(maze.cols * cell + wall,
+                              maze.rows * cell + wall)) {
+      return "wrong size";
+    }
+    const int pathWidth = std::max(1, (cell - wall) / 3);
+    const int offset = wall + (cell - wall - pathWidth) / 2;
+    std::set<std::pair<int, int>> onPath;
+    for (const QPoint& p : options.path) onPath.insert({p.x(), p.y()});
+
+    for (int r = 0; r < maze.rows; ++r) {
+      for (int c = 0; c < maze.cols; ++c) {
+        const MazeCell& here = maze.cells[r][c];
+        Ink right = ink(image.pixel((c + 1) * cell, r * cell + wall));
+        Ink bottom = ink(image.pixel(c * cell + wall, (r + 1) * cell));
+        Ink centre = ink(image.pixel(c * cell + offset, r * cell + offset));
+        if ((right == Ink::Wall) != here.rightWall ||
+            (bottom == Ink::Wall) != here.bottomWall) {
+          return QString("walls of %1,%2").arg(r).arg(c);
+        }
+        Ink expected = onPath.count({r, c}) ? Ink::Path : Ink::Background;
+        if (centre != expected) return QString("centre of %1,%2").arg(r).arg(c);
+      }
+    }
+    return {};
+  }
+
+  QTemporaryDir dir_;
+
+ private slots:
+  void testPngShowsWallsAndPath_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("cellSize");
+    QTest::addColumn<int>("wallWidth");
+
+    QTest::newRow("small") << 12 << 9 << 8 << 1;
+    QTest::newRow("thick walls") << 10 << 10 << 9 << 3;
+    QTest::newRow("single cell") << 1 << 1 << 4 << 1;
+    QTest::newRow("wide cells") << 6 << 5 << 40 << 4;
+    // taller than one strip, so several deflate streams are joined
+    QTest::newRow("strips") << 200 << 150 << 16 << 2;
+  }
+
+  void testPngShowsWallsAndPath() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, cellSize);
+    QFETCH(int, wallWidth);
+
+    MazeData data = seededMaze(rows, cols, 5);
+    MazeImageOptions options;
+    options.cellSize = cellSize;
+    options.wallWidth = wallWidth;
+    options.path = Solver().solve(data, {0, 0}, {rows - 1, cols - 1});
+    QVERIFY(!options.path.empty());
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    SaveResult result = MazeImage::writePng(buffer, data, options);
+    QVERIFY2(result.isValid(), qPrintable(result.error));
+
+    QImage image = QImage::fromData(buffer.data(), "PNG");
+    QVERIFY(!image.isNull());
+    QString error = checkPicture(image, data, options);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+  }
+
+  void testSvgMatchesPng() {
+    MazeData data = seededMaze(30, 40, 5);
+    MazeImageOptions options;
+    options.cellSize = 10;
+    options.wallWidth = 2;
+    options.path = Solver().solve(data, {3, 1}, {27, 38});
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    SaveResult result = MazeImage::writeSvg(buffer, data, options);
+    QVERIFY2(result.isValid(), qPrintable(result.error));
+
+    QSvgRenderer renderer(buffer.data());
+    QVERIFY(renderer.isValid());
+    QCOMPARE(renderer.defaultSize(), QSize(402, 302));
+    QImage image(renderer.defaultSize(), QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    renderer.render(&painter);
+    painter.end();
+
+    QString error = checkPicture(image, data, options);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+  }
+
+  void testWritesByExtension() {
+    MazeData data = seededMaze(20, 20, 5);
+    QString png = dir_.filePath("maze.png");
+    QString svg = dir_.filePath("maze.SVG");
+    QVERIFY(MazeImage::write(png, data).isValid());
+    QVERIFY(MazeImage::write(svg, data).isValid());
+
+    QCOMPARE(QImage(png).size(), QSize(161, 161));
+    QFile file(svg);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.readAll().contains("<svg"));
+
+    QVERIFY(!MazeImage::write(dir_.filePath("maze.txt"), data).isValid());
+    QVERIFY(MazeImage::isImagePath("a/b.Png"));
+    QVERIFY(!MazeImage::isImagePath("a/b.mza"));
+  }
+
+  void testRejectsBadOptions() {
+    MazeData data = seededMaze(5, 5, 5);
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+
+    MazeImageOptions options;
+    options.cellSize = 1;
+    QVERIFY(!MazeImage::writePng(buffer, data, options).isValid());
+    options.cellSize = 4;
+    options.wallWidth = 4;
+    QVERIFY(!MazeImage::writePng(buffer, data, options).isValid());
+    options.wallWidth = 1;
+    options.pathWidth = 4;
+    QVERIFY(!MazeImage::writeSvg(buffer, data, options).isValid());
+    options.pathWidth = 0;
+    options.path = {{0, 0}, {0, 5}};
+    QVERIFY(!MazeImage::writePng(buffer, data, options).isValid());
+    QCOMPARE(buffer.size(), qint64(0));
+
+    QVERIFY(!MazeImage::writePng(buffer, MazeData{}).isValid());
+  }
+};
+
+QTEST_GUILESS_MAIN(TestMazeImage)
+#include "test_maze_image.moc"
@@ -0,0 +1,288 @@
+#include <QSignalSpy>
+#include <QtTest/QtTest>
+
+#include "src/core/validator.h"
+#include "src/lib/model/maze.h"
+#include "src/lib/service/generator/generator.h"
+
+class TestMazeModel : public QObject {
+  Q_OBJECT
+
+ private:
+  // open 3x4 grid with only the outer frame
+  MazeData openMaze() {
+    MazeData maze;
+    maze.rows = 3;
+    maze.cols = 4;
+    maze.isGenerated = true;
+    maze.cells.assign(3, std::vector<MazeCell>(4, {false, false}));
+    for (auto& row : maze.cells) row.back().rightWall = true;
+    for (auto& cell : maze.cells.back()) cell.bottomWall = true;
+    return maze;
+  }
+
+ private slots:
+  void testGenerateLaysOutGridImmediately() {
+    MazeModel model;
+    model.generate(40, 30);
+
+    QCOMPARE(model.rows(), 40);
+    QCOMPARE(model.cols(), 30);
+    QVERIFY(model.generating());
+    QVERIFY(!model.isGenerated());
+
+    QSignalSpy finished(&model, &MazeModel::generationFinished);
+    QVERIFY(finished.wait(5000));
+  }
+
+  void testRowsStreamInOrder() {
+    MazeModel model;
+    QSignalSpy inserted(&model, &MazeModel::rowsInserted);
+    QSignalSpy finished(&model, &MazeModel::generationFinished);
+
+    model.generate(200, 50);
+    QVERIFY(finished.wait(5000));
+
+    // batches are contiguous, non-empty and cover the whole grid
+    QVERIFY(inserted.count() >= 2);
+    int expectedFirst = 0;
+    for (const auto& args : inserted) {
+      int first = args.at(1).toInt();
+      int last = args.at(2).toInt();
+      QCOMPARE(first, expectedFirst);
+      QVERIFY(last >= first);
+      QCOMPARE((last + 1) % 50, 0);
+      expectedFirst = last + 1;
+    }
+    QCOMPARE(expectedFirst, 200 * 50);
+
+    QVERIFY(model.isGenerated());
+    QVERIFY(!model.generating());
+    QCOMPARE(model.generatedRows(), 200);
+    QCOMPARE(model.rowCount(), 200 * 50);
+  }
+
+  void testGeneratedMazeIsPerfect() {
+    MazeModel model;
+    QSignalSpy finished(&model, &MazeModel::generationFinished);
+    model.generate(60, 45);
+    QVERIFY(finished.wait(5000));
+
+    QVERIFY(MazeValidator::validate(model.mazeData()).isPerfect());
+  }
+
+  void testGeneratesWithChosenAlgorithm() {
+    MazeModel model;
+    QCOMPARE(MazeModel::algorithms(), Generator::algorithmNames());
+    QSignalSpy finished(&model, &MazeModel::generationFinished);
+
+    model.generate(60, 45, 3, "wilson");
+    QCOMPARE(model.algorithm(), QString("wilson"));
+    QVERIFY(finished.wait(5000));
+    QVERIFY(MazeValidator::validate(model.mazeData()).isPerfect());
+
+    Generator gen(MazeAlgorithm::Wilson);
+    gen.setSeed(3);
+    MazeData expected;
+    gen.generate(expected, 60, 45);
+    for (int r = 0; r < 60; ++r) {
+      for (int c = 0; c < 45; ++c) {
+        QCOMPARE(model.mazeData().cells[r][c].rightWall,
+                 expected.cells[r][c].rightWall);
+      }
+    }
+
+    // unknown names fall back to the default
+    model.generate(10, 10, 3, "bogus");
+    QCOMPARE(model.algorithm(), QString(Generator::kAlgorithm));
+    QVERIFY(finished.wait(5000));
+  }
+
+  void testRejectsOversizedSides() {
+    MazeModel model;
+    QCOMPARE(model.maxSide(), MazeModel::kMaxSide);
+    model.generate(MazeModel::kMaxSide + 1, 10);
+    QVERIFY(!model.generating());
+    QCOMPARE(model.rowCount(), 0);
+  }
+
+  void testRegenerateCancelsPrevious() {
+    MazeModel model;
+    QSignalSpy finished(&model, &MazeModel::generationFinished);
+
+    model.generate(2000, 2000);
+    model.generate(10, 12);
+    QVERIFY(finished.wait(5000));
+
+    // nothing from the first run may land after the second one finished
+    QTest::qWait(50);
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(model.rows(), 10);
+    QCOMPARE(model.cols(), 12);
+    QCOMPARE(model.rowCount(), 10 * 12);
+    QVERIFY(model.isGenerated());
+  }
+
+  void testClearCancels() {
+    MazeModel model;
+    QSignalSpy finished(&model, &MazeModel::generationFinished);
+
+    model.generate(2000, 2000);
+    model.clear();
+    QVERIFY(!model.generating());
+    QTest::qWait(50);
+
+    QCOMPARE(finished.count(), 0);
+    QCOMPARE(model.rowCount(), 0);
+    QVERIFY(!model.isGenerated());
+  }
+
+  void testSetWallBatchesDataChanged() {
+    MazeModel model;
+    model.setMazeData(openMaze());
+    QSignalSpy changed(&model, &MazeModel::dataChanged);
+    QSignalSpy walls(&model, &MazeModel::wallsChanged);
+
+    QVERIFY(model.setWall(0, 1, MazeModel::RightWall, true));
+    QVERIFY(model.setWall(0, 2, MazeModel::RightWall, true));
+    QVERIFY(!model.setWall(0, 2, MazeModel::RightWall, true));  // unchanged
+    QCOMPARE(changed.count(), 0);  // not before the frame is over
+
+    QVERIFY(walls.wait(1000));
+    QCOMPARE(walls.count(), 1);
+    QCOMPARE(walls.first().at(0).toRect(), QRect(1, 0, 2, 1));
+
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed.first().at(0).value<QModelIndex>().row(), 1);
+    QCOMPARE(changed.first().at(1).value<QModelIndex>().row(), 2);
+    auto roles = changed.first().at(2).value<QList<int>>();
+    QCOMPARE(roles, QList<int>{MazeModel::RightWallRole});
+
+    QVERIFY(model.wall(0, 1, MazeModel::RightWall));
+    QVERIFY(!model.wall(0, 1, MazeModel::BottomWall));
+  }
+
+  void testToggleWallReportsEdit() {
+    MazeModel model;
+    model.setMazeData(openMaze());
+    QSignalSpy edited(&model, &MazeModel::wallEdited);
+
+    QVERIFY(model.toggleWall(1, 2, MazeModel::BottomWall));
+    QVERIFY(model.wall(1, 2, MazeModel::BottomWall));
+    QVERIFY(model.toggleWall(1, 2, MazeModel::BottomWall));
+    QVERIFY(!model.wall(1, 2, MazeModel::BottomWall));
+
+    // reported right away, not with the batched dataChanged
+    QCOMPARE(edited.count(), 2);
+    QCOMPARE(edited.at(0).at(0).toInt(), 1);
+    QCOMPARE(edited.at(0).at(1).toInt(), 2);
+    QCOMPARE(edited.at(0).at(3).toBool(), true);
+    QCOMPARE(edited.at(1).at(3).toBool(), false);
+  }
+
+  void testBorderWallsAreFixed() {
+    MazeModel model;
+    model.setMazeData(openMaze());
+
+    QVERIFY(!model.setWall(1, 3, MazeModel::RightWall, false));
+    QVERIFY(!model.setWall(2, 0, MazeModel::BottomWall, false));
+    QVERIFY(!model.setWall(5, 0, MazeModel::BottomWall, true));
+    QVERIFY(model.wall(1, 3, MazeModel::RightWall));
+  }
+
+  void testRegionSpansRows() {
+    MazeModel model;
+    model.setMazeData(openMaze());
+    QSignalSpy changed(&model, &MazeModel::dataChanged);
+    QSignalSpy walls(&model, &MazeModel::wallsChanged);
+
+    std::vector<std::vector<MazeCell>> block(2, {{true, true}, {true, true}});
+    QVERIFY(model.setRegion(0, 1, block));
+    QVERIFY(walls.wait(1000));
+
+    // one range per touched row, the cells in between are untouched
+    QCOMPARE(changed.count(), 2);
+    QCOMPARE(changed.at(1).at(0).value<QModelIndex>().row(), 5);
+    QCOMPARE(changed.at(1).at(1).value<QModelIndex>().row(), 6);
+    QVERIFY(model.wall(1, 2, MazeModel::BottomWall));
+    QVERIFY(!model.wall(1, 3, MazeModel::BottomWall));
+  }
+
+  void testDistantEditsStayApart() {
+    MazeModel model;
+    model.setMazeData(openMaze());
+    QSignalSpy changed(&model, &MazeModel::dataChanged);
+    QSignalSpy walls(&model, &MazeModel::wallsChanged);
+
+    QVERIFY(model.setWall(0, 0, MazeModel::RightWall, true));
+    QVERIFY(model.setWall(2, 2, MazeModel::RightWall, true));
+    QVERIFY(walls.wait(1000));
+
+    // the row between them is not reported
+    QCOMPARE(walls.count(), 2);
+    QCOMPARE(walls.at(0).at(0).toRect(), QRect(0, 0, 1, 1));
+    QCOMPARE(walls.at(1).at(0).toRect(), QRect(2, 2, 1, 1));
+    QCOMPARE(changed.count(), 2);
+    QCOMPARE(changed.at(0).at(0).value<QModelIndex>().row(), 0);
+    QCOMPARE(changed.at(0).at(1).value<QModelIndex>().row(), 0);
+    QCOMPARE(changed.at(1).at(0).value<QModelIndex>().row(), 10);
+    QCOMPARE(changed.at(1).at(1).value<QModelIndex>().row(), 10);
+  }
+
+  void testSnapshotSurvivesEdits() {
+    MazeModel model;
+    model.setMazeData(openMaze());
+
+    // no copy until an edit, then the snapshot keeps the old walls
+    std::shared_ptr<const MazeData> before = model.snapshot();
+    QCOMPARE(before.get(), &model.mazeData());
+    QVERIFY(model.setWall(0, 0, MazeModel::RightWall, true));
+    QVERIFY(before.get() != &model.mazeData());
+    QVERIFY(!before->cells[0][0].rightWall);
+    QVERIFY(model.mazeData().cells[0][0].rightWall);
+
+    // unshared again, written in place
+    before.reset();
+    const MazeData* current = &model.mazeData();
+    QVERIFY(model.setWall(0, 1, MazeModel::RightWall, true));
+    QCOMPARE(&model.mazeData(), current);
+  }
+
+  void testWallBits() {
+    MazeModel model;
+    model.setMazeData(openMaze());
+    model.setWall(1, 1, MazeModel::BottomWall, true);
+
+    QByteArray bits = model.wallBits(1, 1, 10, 10);  // clipped to 2x3
+    QCOMPARE(bits.size(), 6);
+    QCOMPARE(quint8(bits[0]), MazeModel::kBottomWallBit);
+    QCOMPARE(quint8(bits[2]), MazeModel::kRightWallBit);
+    QCOMPARE(quint8(bits[5]),
+             quint8(MazeModel::kRightWallBit | MazeModel::kBottomWallBit));
+    QVERIFY(model.wallBits(3, 0, 1, 1).isEmpty());
+  }
+
+  void testSameSizeDataSkipsReset() {
+    MazeModel model;
+    model.setMazeData(openMaze());
+    QSignalSpy reset(&model, &MazeModel::modelReset);
+    QSignalSpy changed(&model, &MazeModel::dataChanged);
+
+    MazeData maze = openMaze();
+    maze.cells[0][0].rightWall = true;
+    model.setMazeData(std::move(maze));
+
+    QCOMPARE(reset.count(), 0);
+    QCOMPARE(changed.count(), 1);
+    QVERIFY(model.wall(0, 0, MazeModel::RightWall));
+  }
+
+  void testDestroyWhileGenerating() {
+    auto* model = new MazeModel;
+    model->generate(2000, 2000);
+    delete model;  // must wait for the worker, not crash
+  }
+};
+
+QTEST_MAIN(TestMazeModel)
+#include "test_maze_model.moc"
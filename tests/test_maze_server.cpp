@@ -0,0 +1,205 @@
+#include <QCoreApplication>
+#include <QtConcurrent>
+#include <QtTest/QtTest>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/generator/generator.h"
+#include "src/lib/service/server/latencyStats.h"
+#include "src/lib/service/server/mazeClient.h"
+#include "src/lib/service/server/mazeServer.h"
+#include "src/lib/service/server/protocol.h"
+#include "src/lib/service/solver/solver.h"
+
+class TestMazeServer : public QObject {
+  Q_OBJECT
+
+ private:
+  QString serverName() const {
+    return QString("test_maze_server_%1_%2")
+        .arg(QCoreApplication::applicationPid())
+        .arg(QTest::currentTestFunction());
+  }
+
+  // clients block, so they run on workers while the server's loop spins
+  template <class F>
+  auto runClient(F&& function) {
+    QFuture<std::invoke_result_t<F>> future =
+        QtConcurrent::run(std::forward<F>(function));
+    if (!QTest::qWaitFor([&]() { return future.isFinished(); }, 30000)) {
+      qFatal("client timed out");
+    }
+    return future.result();
+  }
+
+ private slots:
+  void testProtocolRoundTrip() {
+    protocol::Request request;
+    request.type = protocol::MessageType::Solve;
+    request.id = 7;
+    request.mazeId = 3;
+    request.queries = {{{0, 1}, {2, 3}}, {{4, 5}, {6, 7}}};
+
+    // frames may arrive in pieces
+    QByteArray wire = protocol::encode(request);
+    QByteArray buffer = wire.left(5);
+    QByteArray payload;
+    bool error = false;
+    QVERIFY(!protocol::takeFrame(buffer, &payload, &error));
+    QVERIFY(!error);
+    buffer.append(wire.mid(5));
+    QVERIFY(protocol::takeFrame(buffer, &payload, &error));
+    QVERIFY(buffer.isEmpty());
+
+    protocol::Request decoded;
+    QVERIFY(protocol::decode(payload, &decoded));
+    QCOMPARE(decoded.id, quint32(7));
+    QCOMPARE(decoded.mazeId, quint32(3));
+    QCOMPARE(decoded.queries.size(), size_t(2));
+    QCOMPARE(decoded.queries[1].end, QPoint(6, 7));
+
+    protocol::Response response;
+    response.type = protocol::MessageType::Paths;
+    response.id = 7;
+    response.paths = {{{1, 1}, {1, 2}, {2, 2}, {2, 1}, {1, 1}, {0, 1}}, {}};
+    buffer = protocol::encode(response);
+    QVERIFY(protocol::takeFrame(buffer, &payload, &error));
+
+    protocol::Response decodedResponse;
+    QVERIFY(protocol::decode(payload, &decodedResponse));
+    QVERIFY(decodedResponse.paths == response.paths);
+  }
+
+  void testRejectsOversizedFrame() {
+    QByteArray buffer(4, char(0xff));
+    QByteArray payload;
+    bool error = false;
+    QVERIFY(!protocol::takeFrame(buffer, &payload, &error));
+    QVERIFY(error);
+  }
+
+  void testLatencyPercentiles() {
+    LatencyStats stats;
+    for (int i = 1; i <= 100; ++i) stats.record(i * 1000);
+    QCOMPARE(stats.percentile(50), qint64(50000));
+    QCOMPARE(stats.percentile(99), qint64(99000));
+    QCOMPARE(stats.max(), qint64(100000));
+
+    LatencyStats other;
+    other.record(500000);
+    stats.merge(other);
+    QCOMPARE(stats.count(), quint64(101));
+    QCOMPARE(stats.max(), qint64(500000));
+  }
+
+  void testGenerateAndSolve() {
+    MazeServer server;
+    QVERIFY(server.listen(serverName()));
+    QString name = serverName();
+
+    auto [first, second, paths] = runClient([name]() {
+      MazeClient client;
+      std::vector<std::vector<QPoint>> paths;
+      if (!client.connectToServer(name)) {
+        return std::make_tuple(0u, 0u, paths);
+      }
+      quint32 first = client.generate(30, 40, 5);
+      quint32 second = client.generate(30, 40, 5);
+      client.solve(first, {{{0, 0}, {29, 39}}, {{0, 0}, {10, 10}}}, &paths);
+      return std::make_tuple(first, second, paths);
+    });
+
+    QVERIFY(first != 0);
+    QCOMPARE(second, first);  // resident, not generated again
+    QCOMPARE(paths.size(), size_t(2));
+
+    // same seed, same maze
+    Generator gen;
+    gen.setSeed(5);
+    MazeData maze;
+    gen.generate(maze, 30, 40);
+    Solver solver;
+    QVERIFY(paths[0] == solver.solve(maze, {0, 0}, {29, 39}));
+    QVERIFY(paths[1] == solver.solve(maze, {0, 0}, {10, 10}));
+  }
+
+  void testConcurrentClientsAreBatched() {
+    MazeServer server;
+    server.setWorkerThreads(1);
+    QVERIFY(server.listen(serverName()));
+    QString name = serverName();
+
+    constexpr int kClients = 8;
+    constexpr int kRequests = 20;
+    int failures = runClient([name]() {
+      MazeClient setup;
+      if (!setup.connectToServer(name)) return -1;
+      quint32 mazeId = setup.generate(64, 64, 1);
+
+      std::vector<int> clients(kClients);
+      std::atomic<int> failures{0};
+      QThreadPool pool;
+      pool.setMaxThreadCount(kClients);
+      QtConcurrent::blockingMap(&pool, clients, [&](int&) {
+        MazeClient client;
+        if (!client.connectToServer(name)) {
+          ++failures;
+          return;
+        }
+        std::vector<std::vector<QPoint>> paths;
+        for (int i = 0; i < kRequests; ++i) {
+          bool ok = client.solve(mazeId, {{{0, 0}, {63, 63}}}, &paths);
+          if (!ok || paths[0].empty() || paths[0].back() != QPoint(63, 63)) {
+            ++failures;
+          }
+        }
+      });
+      return failures.load();
+    });
+
+    QCOMPARE(failures, 0);
+    QJsonObject stats = server.stats();
+    QCOMPARE(stats.value("batchedRequests").toInt(), kClients * kRequests);
+    QVERIFY(stats.value("batches").toInt() <= kClients * kRequests);
+    QCOMPARE(stats.value("solve").toObject().value("count").toInt(),
+             kClients * kRequests);
+  }
+
+  void testEvictsLeastRecentlyUsed() {
+    MazeServer server;
+    server.setResidentCells(2 * 20 * 20);
+    QVERIFY(server.listen(serverName()));
+    QString name = serverName();
+
+    QString error = runClient([name]() {
+      MazeClient client;
+      if (!client.connectToServer(name)) return client.error();
+      quint32 first = client.generate(20, 20, 1);
+      client.generate(20, 20, 2);
+      client.generate(20, 20, 3);
+
+      std::vector<std::vector<QPoint>> paths;
+      if (client.solve(first, {{{0, 0}, {1, 1}}}, &paths)) return QString();
+      return client.error();
+    });
+
+    QVERIFY(error.contains("unknown maze"));
+    QCOMPARE(server.stats().value("evictions").toInt(), 1);
+    QCOMPARE(server.stats().value("residentMazes").toInt(), 2);
+  }
+
+  void testRejectsInvalidDimensions() {
+    MazeServer server;
+    QVERIFY(server.listen(serverName()));
+    QString name = serverName();
+
+    QString error = runClient([name]() {
+      MazeClient client;
+      if (!client.connectToServer(name)) return client.error();
+      return client.generate(0, 10, 1) ? QString() : client.error();
+    });
+    QVERIFY(error.contains("invalid dimensions"));
+  }
+};
+
+QTEST_MAIN(TestMazeServer)
+#include "test_maze_server.moc"
@@ -0,0 +1,153 @@
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/generator/generator.h"
+#include "src/lib/service/metrics/metrics.h"
+#include "src/lib/service/metrics/metricsReporter.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+#include "src/lib/service/solver/solver.h"
+
+class TestMetrics : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void init() { Metrics::instance().reset(); }
+
+  void testCountersAndHighWater() {
+    Metrics& metrics = Metrics::instance();
+    metrics.add(Metrics::Counter::ParsedBytes, 10);
+    metrics.add(Metrics::Counter::ParsedBytes, 5);
+    metrics.raise(Metrics::Counter::QueueHighWater, 7);
+    metrics.raise(Metrics::Counter::QueueHighWater, 3);
+
+    QCOMPARE(metrics.value(Metrics::Counter::ParsedBytes), qint64(15));
+    QCOMPARE(metrics.value(Metrics::Counter::QueueHighWater), qint64(7));
+
+    {
+      ScopedTally tally(Metrics::Counter::NodesExpanded);
+      tally.add(2);
+      tally.add(3);
+      QCOMPARE(metrics.value(Metrics::Counter::NodesExpanded), qint64(0));
+    }
+    QCOMPARE(metrics.value(Metrics::Counter::NodesExpanded), qint64(5));
+
+    metrics.reset();
+    QCOMPARE(metrics.value(Metrics::Counter::ParsedBytes), qint64(0));
+  }
+
+  void testScopedTimer() {
+    { ScopedTimer timer(Metrics::Timer::Parse); }
+    { ScopedTimer timer(Metrics::Timer::Parse); }
+
+    Metrics::TimerStats stats =
+        Metrics::instance().stats(Metrics::Timer::Parse);
+    QCOMPARE(stats.count, quint64(2));
+    QVERIFY(stats.maxNs <= stats.totalNs);
+  }
+
+  void testInstrumentedHotPaths() {
+#ifndef MAZE_METRICS
+    QSKIP("built without ENABLE_METRICS");
+#endif
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 20, 30);
+
+    Metrics& metrics = Metrics::instance();
+    QCOMPARE(metrics.value(Metrics::Counter::GeneratedRows), qint64(20));
+    QCOMPARE(metrics.value(Metrics::Counter::GeneratedCells), qint64(600));
+    QCOMPARE(metrics.stats(Metrics::Timer::Generate).count, quint64(1));
+
+    Solver solver;
+    std::vector<QPoint> path = solver.solve(maze, {0, 0}, {19, 29});
+    QVERIFY(!path.empty());
+    QVERIFY(metrics.value(Metrics::Counter::NodesExpanded) >=
+            qint64(path.size()));
+    QVERIFY(metrics.value(Metrics::Counter::QueueHighWater) > 0);
+
+    // batch building blocks are timed per batch by their callers, the
+    // solve a user waits for on its own
+    QCOMPARE(metrics.stats(Metrics::Timer::Solve).count, quint64(0));
+    solver.setMazeData(&maze);
+    solver.solveMaze(0, 0, 19, 29);
+    QVERIFY(solver.hasSolution());
+    QCOMPARE(metrics.stats(Metrics::Timer::Solve).count, quint64(1));
+  }
+
+  void testTraceFromManyThreads() {
+    // scopes closing on every worker at once all land in the ring
+    constexpr int kScopes = 4000;
+    TaskScheduler::instance().parallelFor(kScopes, [](qsizetype) {
+      ScopedTimer timer(Metrics::Timer::SolveBatch);
+    });
+
+    QCOMPARE(Metrics::instance().stats(Metrics::Timer::SolveBatch).count,
+             quint64(kScopes));
+    QJsonArray events =
+        Metrics::instance().toChromeTrace().value("traceEvents").toArray();
+    QCOMPARE(events.size(), kScopes);
+    for (const QJsonValue& event : events) {
+      QCOMPARE(event.toObject().value("name").toString(),
+               QString("solveBatch"));
+    }
+  }
+
+  void testJsonShape() {
+    Metrics::instance().add(Metrics::Counter::WrittenBytes, 42);
+    { ScopedTimer timer(Metrics::Timer::Write); }
+
+    QJsonObject json = Metrics::instance().toJson();
+    QCOMPARE(json.value("counters").toObject().value("writtenBytes").toInt(),
+             42);
+    QJsonObject write =
+        json.value("timers").toObject().value("write").toObject();
+    QCOMPARE(write.value("count").toInt(), 1);
+    QVERIFY(write.contains("totalNs"));
+    QVERIFY(write.contains("maxNs"));
+  }
+
+  void testChromeTrace() {
+    { ScopedTimer timer(Metrics::Timer::Solve); }
+    { ScopedTimer timer(Metrics::Timer::Generate); }
+
+    QJsonArray events =
+        Metrics::instance().toChromeTrace().value("traceEvents").toArray();
+    QCOMPARE(events.size(), 2);
+    QJsonObject first = events.at(0).toObject();
+    QCOMPARE(first.value("name").toString(), QString("solve"));
+    QCOMPARE(first.value("ph").toString(), QString("X"));
+    QVERIFY(first.contains("ts"));
+    QVERIFY(first.contains("dur"));
+    QVERIFY(first.value("ts").toDouble() <=
+            events.at(1).toObject().value("ts").toDouble());
+  }
+
+  void testReporterDump() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    MetricsReporter reporter;
+    Metrics::instance().add(Metrics::Counter::GeneratedRows, 3);
+    reporter.setDumpPath(dir.filePath("metrics"));
+    QSignalSpy updated(&reporter, &MetricsReporter::updated);
+    reporter.sample();
+
+    QCOMPARE(updated.count(), 1);
+    QCOMPARE(reporter.counters().value("generatedRows").toLongLong(),
+             qint64(3));
+    QVERIFY(reporter.timers().contains("generate"));
+
+    QFile json(dir.filePath("metrics.json"));
+    QVERIFY(json.open(QIODevice::ReadOnly));
+    QVERIFY(QJsonDocument::fromJson(json.readAll()).isObject());
+    QVERIFY(QFile::exists(dir.filePath("metrics.trace.json")));
+  }
+};
+
+QTEST_MAIN(TestMetrics)
+#include "test_metrics.moc"
@@ -0,0 +1,151 @@
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include "src/core/packedPath.h"
+#include "src/lib/model/maze.h"
+#include "src/lib/service/ioParser/tiledArchive.h"
+#include "src/lib/service/solver/outOfCoreSolver.h"
+#include "src/lib/service/solver/solver.h"
+#include "tests/testMazes.h"
+
+class TestOutOfCore : public QObject {
+  Q_OBJECT
+
+ private:
+  // seeded, with loops walls knocked out on top
+  static MazeData maze(int rows, int cols, int loops) {
+    MazeData maze = seededMaze(rows, cols, 17);
+    QRandomGenerator rng(3);
+    for (int i = 0; i < loops; ++i) {
+      maze.cells[rng.bounded(rows)][rng.bounded(cols - 1)].rightWall = false;
+      maze.cells[rng.bounded(rows - 1)][rng.bounded(cols)].bottomWall = false;
+    }
+    return maze;
+  }
+
+  // false when two cells in a row are not open neighbours
+  static bool walkable(const MazeData& maze, const std::vector<QPoint>& path) {
+    for (size_t i = 1; i < path.size(); ++i) {
+      QPoint a = path[i - 1];
+      QPoint b = path[i];
+      QPoint low = a.x() + a.y() < b.x() + b.y() ? a : b;
+      const MazeCell& cell = maze.cells[low.x()][low.y()];
+      if ((a - b).manhattanLength() != 1 ||
+          (a.x() == b.x() ? cell.rightWall : cell.bottomWall)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  QTemporaryDir dir_;
+
+ private slots:
+  void testMatchesInMemorySolve_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("tileSize");
+    QTest::addColumn<int>("loops");
+    QTest::addColumn<qint64>("memory");
+
+    // two slots and a few hundred inbox entries: evictions and spills
+    QTest::newRow("perfect, tight") << 150 << 130 << 16 << 0 << qint64(4000);
+    QTest::newRow("perfect, roomy") << 150 << 130 << 16 << 0 << qint64(1 << 24);
+    QTest::newRow("loops, tight") << 150 << 130 << 16 << 800 << qint64(4000);
+    QTest::newRow("ragged tiles") << 101 << 77 << 32 << 200 << qint64(40000);
+    QTest::newRow("one tile") << 40 << 50 << 256 << 50 << qint64(1 << 20);
+  }
+
+  void testMatchesInMemorySolve() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, tileSize);
+    QFETCH(int, loops);
+    QFETCH(qint64, memory);
+
+    MazeData data = maze(rows, cols, loops);
+    QString file = dir_.filePath("maze.mza");
+    QVERIFY(TiledArchive::write(file, data, tileSize).isValid());
+
+    OutOfCoreSolver external(memory, dir_.path());
+    QVERIFY2(external.open(file), qPrintable(external.error()));
+    Solver solver;
+    QRandomGenerator rng(9);
+    std::vector<QPoint> cells;
+    for (int i = 0; i < 40; ++i) {
+      QPoint start(rng.bounded(rows), rng.bounded(cols));
+      QPoint end(rng.bounded(rows), rng.bounded(cols));
+      if (i == 0) end = QPoint(rows - 1, cols - 1);
+      PackedPath packed;
+      QVERIFY2(external.solve(start, end, &packed),
+               qPrintable(external.error()));
+      PackedPath expected;
+      solver.solve(data, start, end, &expected);
+
+      if (loops == 0) {
+        // a perfect maze has one path
+        QVERIFY(packed == expected);
+        continue;
+      }
+      // with loops any shortest path will do
+      QCOMPARE(packed.cells, expected.cells);
+      PathCodec::decode(packed, &cells);
+      QCOMPARE(cells.front(), start);
+      QCOMPARE(cells.back(), end);
+      QVERIFY(walkable(data, cells));
+    }
+  }
+
+  void testStaysInBudget() {
+    MazeData data = maze(200, 200, 0);
+    QString file = dir_.filePath("budget.mza");
+    QVERIFY(TiledArchive::write(file, data, 20).isValid());
+
+    OutOfCoreSolver external(8000, dir_.path());
+    QVERIFY(external.open(file));
+    QCOMPARE(external.slotCount(), 2);
+    PackedPath packed;
+    QVERIFY(external.solve({0, 0}, {199, 199}, &packed));
+    QVERIFY(packed == [&] {
+      PackedPath expected;
+      Solver().solve(data, {0, 0}, {199, 199}, &expected);
+      return expected;
+    }());
+
+    // 100 tiles through two slots: the state went to disk and back, and
+    // the frontier spilled
+    const OutOfCoreStats& stats = external.stats();
+    QVERIFY(stats.stateWrites > 0);
+    QVERIFY(stats.stateReads > 0);
+    QVERIFY(stats.spilledEntries > 0);
+    QVERIFY(stats.expanded >= qint64(packed.cells));
+  }
+
+  void testEdgeCases() {
+    MazeData data = maze(30, 30, 0);
+    // a walled-in corner has no way out
+    data.cells[29][28].rightWall = true;
+    data.cells[28][29].bottomWall = true;
+    QString file = dir_.filePath("edges.mza");
+    QVERIFY(TiledArchive::write(file, data, 8).isValid());
+
+    OutOfCoreSolver external(1 << 20, dir_.path());
+    PackedPath packed;
+    QVERIFY(!external.solve({0, 0}, {1, 1}, &packed));
+    QVERIFY(external.open(file));
+
+    QVERIFY(external.solve({0, 0}, {29, 29}, &packed));
+    QVERIFY(packed.empty());
+    QVERIFY(external.solve({5, 5}, {5, 5}, &packed));
+    QCOMPARE(packed.cells, quint32(1));
+    QVERIFY(external.solve({0, 0}, {30, 0}, &packed));
+    QVERIFY(packed.empty());
+
+    QVERIFY(!external.open(dir_.filePath("missing.mza")));
+    QVERIFY(!external.error().isEmpty());
+  }
+};
+
+QTEST_GUILESS_MAIN(TestOutOfCore)
+#include "test_out_of_core.moc"
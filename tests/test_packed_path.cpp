@@ -0,0 +1,246 @@
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+#include <map>
+
+#include "src/core/packedPath.h"
+#include "src/lib/model/maze.h"
+#include "src/lib/service/cache/mazeCache.h"
+#include "src/lib/service/ioParser/pathResults.h"
+#include "src/lib/service/scheduler/taskScheduler.h"
+#include "src/lib/service/solver/solver.h"
+#include "tests/testMazes.h"
+
+class TestPackedPath : public QObject {
+  Q_OBJECT
+
+ private:
+  // a random walk of steps moves, revisits allowed
+  static std::vector<QPoint> walk(QRandomGenerator& rng, int steps) {
+    std::vector<QPoint> path{{rng.bounded(100), rng.bounded(100)}};
+    for (int i = 0; i < steps; ++i) {
+      int move = rng.bounded(4);
+      path.push_back(path.back() + QPoint(PathCodec::kRowStep[move],
+                                          PathCodec::kColStep[move]));
+    }
+    return path;
+  }
+
+  // query i of a test batch, its path from a solve of maze
+  static PathResult answer(const MazeData& maze, quint64 query) {
+    QRandomGenerator rng(quint32(query) + 1);
+    PathResult result;
+    result.query = query;
+    result.start = {rng.bounded(maze.rows), rng.bounded(maze.cols)};
+    result.end = {rng.bounded(maze.rows), rng.bounded(maze.cols)};
+    Solver().solve(maze, result.start, result.end, &result.path);
+    return result;
+  }
+
+  QTemporaryDir dir_;
+
+ private slots:
+  void testCodecRoundTrip() {
+    QRandomGenerator rng(11);
+    std::vector<QPoint> decoded;
+    std::vector<std::int32_t> ids;
+    for (int steps = 0; steps < 70; ++steps) {
+      std::vector<QPoint> path = walk(rng, steps);
+      PackedPath packed;
+      QVERIFY(PathCodec::encode(path, &packed));
+      QCOMPARE(packed.cells, quint32(path.size()));
+      QCOMPARE(packed.moves.size(), PackedPath::moveBytes(packed.cells));
+
+      PathCodec::decode(packed, &decoded);
+      QVERIFY(decoded == path);
+
+      const int cols = 300;
+      ids.assign(path.size(), -1);
+      PathCodec::decodeIds(packed, cols, ids.data());
+      for (size_t i = 0; i < path.size(); ++i) {
+        QCOMPARE(ids[i], path[i].x() * cols + path[i].y());
+      }
+    }
+
+    PackedPath none;
+    QVERIFY(PathCodec::encode(std::vector<QPoint>{}, &none));
+    QVERIFY(none.empty());
+    PathCodec::decode(none, &decoded);
+    QVERIFY(decoded.empty());
+  }
+
+  void testEncodeRejectsNonNeighbours() {
+    PackedPath packed;
+    QVERIFY(!PathCodec::encode(
+        std::vector<QPoint>{{0, 0}, {0, 1}, {1, 2}, {1, 3}}, &packed));
+    QVERIFY(packed.empty());
+    QVERIFY(!PathCodec::encode(std::vector<QPoint>{{4, 4}, {4, 4}}, &packed));
+    QVERIFY(!PathCodec::encode(std::vector<QPoint>{{0, 0}, {0, 2}}, &packed));
+
+    // not kept by the cache either
+    MazeCache cache;
+    cache.insertPath(7, {0, 0}, {0, 2}, {{0, 0}, {0, 2}});
+    std::vector<QPoint> path;
+    QVERIFY(!cache.findPath(7, {0, 0}, {0, 2}, &path));
+  }
+
+  void testSolverPackedMatchesCells_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+
+    // the first three run the fixed-size kernels
+    QTest::newRow("10x10") << 10 << 10;
+    QTest::newRow("20x20") << 20 << 20;
+    QTest::newRow("50x50") << 50 << 50;
+    QTest::newRow("37x53") << 37 << 53;
+    QTest::newRow("single column") << 40 << 1;
+  }
+
+  void testSolverPackedMatchesCells() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+
+    MazeData data = seededMaze(rows, cols, 3);
+    Solver solver;
+    QRandomGenerator rng(5);
+    std::vector<QPoint> cells;
+    for (int i = 0; i < 200; ++i) {
+      QPoint start(rng.bounded(rows), rng.bounded(cols));
+      QPoint end(rng.bounded(rows), rng.bounded(cols));
+      solver.solve(data, start, end, &cells);
+      PackedPath packed;
+      solver.solve(data, start, end, &packed);
+
+      PackedPath expected;
+      QVERIFY(PathCodec::encode(cells, &expected));
+      QVERIFY(packed == expected);
+    }
+
+    // outside the maze there is no path
+    PackedPath packed;
+    solver.solve(data, {0, 0}, {rows, 0}, &packed);
+    QVERIFY(packed.empty());
+  }
+
+  void testCacheKeepsPackedPaths() {
+    MazeCache cache;
+    MazeData data = seededMaze(30, 30, 3);
+    std::vector<QPoint> cells = Solver().solve(data, {0, 0}, {29, 29});
+    cache.insertPath(1, {0, 0}, {29, 29}, cells);
+
+    PackedPath packed;
+    QVERIFY(cache.findPackedPath(1, {0, 0}, {29, 29}, &packed));
+    QCOMPARE(packed.cells, quint32(cells.size()));
+    std::vector<QPoint> found;
+    QVERIFY(cache.findPath(1, {0, 0}, {29, 29}, &found));
+    QVERIFY(found == cells);
+
+    PackedPath shorter;
+    Solver().solve(data, {0, 0}, {5, 5}, &shorter);
+    cache.insertPackedPath(1, {0, 0}, {5, 5}, shorter);
+    QVERIFY(cache.findPath(1, {0, 0}, {5, 5}, &found));
+    QVERIFY(found == Solver().solve(data, {0, 0}, {5, 5}));
+  }
+
+  void testResultsAppendedFromThreads() {
+    MazeData data = seededMaze(64, 48, 3);
+    QString file = dir_.filePath("threads.mzr");
+    PathResultWriter writer;
+    QVERIFY(writer.open(file, 64, 48, 99).isValid());
+
+    // small blocks, so the threads interleave
+    constexpr int kQueries = 2000;
+    constexpr int kSlices = 8;
+    TaskScheduler::instance().parallelFor(kSlices, [&](qsizetype slice) {
+      PathResultBlock block;
+      for (int q = int(slice); q < kQueries; q += kSlices) {
+        PathResult r = answer(data, quint64(q));
+        block.add(r.query, r.start, r.end, r.path);
+        if (block.records() == 17) writer.append(block);
+      }
+      writer.append(block);
+    });
+    QVERIFY(writer.close().isValid());
+
+    PathResultReader reader;
+    QVERIFY2(reader.open(file), qPrintable(reader.error()));
+    QCOMPARE(reader.rows(), 64);
+    QCOMPARE(reader.cols(), 48);
+    QCOMPARE(reader.fingerprint(), quint64(99));
+
+    std::map<quint64, PathResult> read;
+    PathResult result;
+    while (reader.next(&result)) read[result.query] = result;
+    QVERIFY2(reader.error().isEmpty(), qPrintable(reader.error()));
+    QCOMPARE(int(read.size()), kQueries);
+    for (const auto& [query, got] : read) {
+      PathResult expected = answer(data, query);
+      QCOMPARE(got.start, expected.start);
+      QCOMPARE(got.end, expected.end);
+      QVERIFY(got.path == expected.path);
+    }
+  }
+
+  void testReaderStopsBeforeDamagedTail() {
+    MazeData data = seededMaze(20, 20, 3);
+    QString file = dir_.filePath("torn.mzr");
+    PathResultWriter writer;
+    QVERIFY(writer.open(file, 20, 20, 1).isValid());
+    PathResultBlock block;
+    for (int q = 0; q < 30; ++q) {
+      PathResult r = answer(data, quint64(q));
+      block.add(r.query, r.start, r.end, r.path);
+      if (q % 10 == 9) QVERIFY(writer.append(block));
+    }
+    QVERIFY(writer.close().isValid());
+
+    QFile raw(file);
+    QVERIFY(raw.open(QIODevice::ReadWrite));
+    const qint64 size = raw.size();
+
+    // records read back and whether the reader stopped at damage
+    auto readBack = [&](bool* damaged) {
+      PathResultReader reader;
+      int count = 0;
+      PathResult result;
+      if (reader.open(file)) {
+        while (reader.next(&result)) ++count;
+      }
+      *damaged = !reader.error().isEmpty();
+      return count;
+    };
+    bool damaged = true;
+    QCOMPARE(readBack(&damaged), 30);
+    QVERIFY(!damaged);
+
+    // a flipped byte in the last block fails its checksum
+    auto flipLast = [&]() {
+      char last = 0;
+      return raw.seek(size - 1) && raw.getChar(&last) && raw.seek(size - 1) &&
+             raw.putChar(char(last ^ 0x40)) && raw.flush();
+    };
+    QVERIFY(flipLast());
+    QCOMPARE(readBack(&damaged), 20);
+    QVERIFY(damaged);
+    QVERIFY(flipLast());
+    QCOMPARE(readBack(&damaged), 30);
+    QVERIFY(!damaged);
+
+    // a crash mid-block leaves the blocks before it readable
+    QVERIFY(raw.resize(size - 5));
+    QCOMPARE(readBack(&damaged), 20);
+    QVERIFY(damaged);
+
+    QFile other(dir_.filePath("other.mzr"));
+    QVERIFY(other.open(QIODevice::WriteOnly));
+    other.write("S21MZA not a results file");
+    other.close();
+    PathResultReader reader;
+    QVERIFY(!reader.open(other.fileName()));
+    QVERIFY(!reader.error().isEmpty());
+  }
+};
+
+QTEST_GUILESS_MAIN(TestPackedPath)
+#include "test_packed_path.moc"
@@ -0,0 +1,152 @@
+#include <QSignalSpy>
+#include <QtTest/QtTest>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/agent/agentTrainer.h"
+#include "src/lib/service/agent/qLearner.h"
+#include "src/lib/service/solver/solver.h"
+#include "tests/testMazes.h"
+
+class TestQLearner : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void testTableBestAction() {
+    QTable table(6);
+    QCOMPARE(table.cells(), 6);
+    QCOMPARE(table.value(3, 5), 0.0f);
+
+    table.setValue(0, 2, -5.0f);
+    table.setValue(1, 2, -2.0f);
+    table.setValue(3, 2, -1.0f);
+    QCOMPARE(table.value(1, 2), -2.0f);
+    QCOMPARE(table.value(1, 3), 0.0f);  // neighbouring cell untouched
+
+    QCOMPARE(table.bestAction(2, 0b0011), 1);
+    QCOMPARE(table.bestAction(2, 0b1011), 3);
+    QCOMPARE(table.bestValue(2, 0b1011), -1.0f);
+    QCOMPARE(table.bestAction(2, 0b0100), 2);
+    QCOMPARE(table.bestAction(2, 0), -1);
+    QCOMPARE(table.bestValue(2, 0), 0.0f);
+  }
+
+  void testConvergesToShortestRoute_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::newRow("8x8") << 8 << 8;
+    QTest::newRow("20x20") << 20 << 20;
+    QTest::newRow("50x50") << 50 << 50;
+    QTest::newRow("5x60") << 5 << 60;
+  }
+  void testConvergesToShortestRoute() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    MazeData maze = seededMaze(rows, cols, 11);
+    QPoint start(0, 0);
+    QPoint goal(rows - 1, cols - 1);
+
+    QLearner learner(maze, goal);
+    QLearningOptions options;
+    options.episodes = 50000;
+    options.seed = 5;
+    QLearningReport report = learner.train(start, options);
+
+    Solver solver;
+    std::vector<QPoint> shortest = solver.solve(maze, start, goal);
+    QCOMPARE(report.shortestLength, int(shortest.size()));
+    QVERIFY(report.convergedAt > 0);
+    QVERIFY(report.episodes < options.episodes);  // stopped once converged
+    QCOMPARE(report.greedyLength, report.shortestLength);
+    QVERIFY(report.successes > 0);
+    QVERIFY(report.steps > 0);
+    QCOMPARE(qsizetype(report.meanSteps.size()),
+             qsizetype((report.episodes + QLearner::kBatchEpisodes - 1) /
+                       QLearner::kBatchEpisodes));
+    // a perfect maze has one simple route
+    QVERIFY(learner.greedyRoute(start) == shortest);
+  }
+
+  void testSequentialTrainingIsSeeded() {
+    MazeData maze = seededMaze(15, 15, 3);
+    QLearningOptions options;
+    options.episodes = 1000;
+    options.parallel = false;
+    options.stopWhenConverged = false;
+
+    QLearner a(maze, QPoint(14, 0));
+    QLearner b(maze, QPoint(14, 0));
+    QLearningReport first = a.train(QPoint(0, 14), options);
+    QLearningReport second = b.train(QPoint(0, 14), options);
+    QCOMPARE(first.episodes, qint64(1000));
+    QCOMPARE(first.steps, second.steps);
+    QCOMPARE(first.successes, second.successes);
+    for (int action = 0; action < QTable::kActions; ++action) {
+      for (int cell = 0; cell < a.table().cells(); ++cell) {
+        QCOMPARE(a.table().value(action, cell), b.table().value(action, cell));
+      }
+    }
+
+    options.seed = 2;
+    QLearner c(maze, QPoint(14, 0));
+    QVERIFY(c.train(QPoint(0, 14), options).steps != first.steps);
+  }
+
+  void testUnreachableGoal() {
+    MazeData maze;
+    maze.rows = 4;
+    maze.cols = 4;
+    maze.isGenerated = true;
+    maze.cells.assign(4, std::vector<MazeCell>(4, MazeCell{true, true}));
+
+    QLearner learner(maze, QPoint(3, 3));
+    QLearningOptions options;
+    options.episodes = 600;
+    QLearningReport report = learner.train(QPoint(0, 0), options);
+    QCOMPARE(report.episodes, qint64(600));
+    QCOMPARE(report.shortestLength, 0);
+    QCOMPARE(report.greedyLength, 0);
+    QCOMPARE(report.convergedAt, qint64(-1));
+    QCOMPARE(learner.greedyRoute(QPoint(0, 0)).size(), size_t(1));
+
+    // outside the maze nothing is trained
+    QCOMPARE(learner.train(QPoint(4, 0), options).episodes, qint64(0));
+  }
+
+  void testTrainerDeliversRoute() {
+    MazeData maze = seededMaze(30, 30, 7);
+    AgentTrainer trainer;
+    QSignalSpy routeChanged(&trainer, &AgentTrainer::routeChanged);
+
+    trainer.train(0, 0, 29, 29);  // no maze yet
+    QVERIFY(!trainer.training());
+    QCOMPARE(trainer.routeLength(), 0);
+
+    trainer.setMazeData(&maze);
+    trainer.train(0, 0, 29, 29, 50000, 3);
+    QVERIFY(trainer.training());
+    QTRY_VERIFY_WITH_TIMEOUT(!trainer.training(), 30000);
+
+    Solver solver;
+    std::vector<QPoint> shortest = solver.solve(maze, {0, 0}, {29, 29});
+    QVERIFY(trainer.reachedGoal());
+    QVERIFY(trainer.currentRoute() == shortest);
+    QCOMPARE(trainer.route().size(), qsizetype(shortest.size()));
+    QCOMPARE(trainer.report().value("shortestLength").toInt(),
+             int(shortest.size()));
+
+    int before = routeChanged.count();
+    trainer.clear();
+    QCOMPARE(trainer.routeLength(), 0);
+    QCOMPARE(routeChanged.count(), before + 1);
+
+    // a cancelled training never delivers
+    trainer.train(0, 0, 29, 29, 50000, 3);
+    trainer.cancel();
+    QVERIFY(!trainer.training());
+    QTest::qWait(200);
+    QCOMPARE(trainer.routeLength(), 0);
+  }
+};
+
+QTEST_MAIN(TestQLearner)
+#include "test_q_learner.moc"
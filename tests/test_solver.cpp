@@ -1,7 +1,10 @@
 #include <QPoint>
 #include <QtTest/QtTest>
+#include <random>
 
+#include "src/core/mazeBfs.h"
 #include "src/lib/model/maze.h"
+#include "src/lib/service/cache/mazeCache.h"
 #include "src/lib/service/generator/generator.h"
 #include "src/lib/service/solver/solver.h"
 
@@ -273,9 +276,275 @@ class TestSolver : public QObject {
     QCOMPARE(lastPoint["row"].toInt(), 4);
     QCOMPARE(lastPoint["col"].toInt(), 4);
 
+    // packed view matches the QVariant one
+    QCOMPARE(solver.pathLength(), static_cast<int>(pathList.size()));
+    QCOMPARE(solver.currentPath().front(), QPoint(0, 0));
+    QCOMPARE(solver.currentPath().back(), QPoint(4, 4));
+
     solver.clearPath();
     QVERIFY(!solver.hasSolution());
     QVERIFY(solver.path().isEmpty());
+    QCOMPARE(solver.pathLength(), 0);
+  }
+
+  void testRepairAfterCuttingPerfectMaze() {
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 15, 15);
+
+    Solver solver;
+    solver.setMazeData(&maze);
+    solver.solveMaze(0, 0, 14, 14);
+    auto original = solver.currentPath();
+    QVERIFY(original.size() > 2);
+
+    // a perfect maze has one route, walling it off disconnects the ends
+    QPoint a = original[original.size() / 2];
+    QPoint b = original[original.size() / 2 + 1];
+    QPoint cell(std::min(a.x(), b.x()), std::min(a.y(), b.y()));
+    bool right = a.x() == b.x();
+    bool& wall = right ? maze.cells[cell.x()][cell.y()].rightWall
+                       : maze.cells[cell.x()][cell.y()].bottomWall;
+
+    wall = true;
+    solver.repairPath(a, b, true);
+    QVERIFY(!solver.hasSolution());
+
+    wall = false;
+    solver.repairPath(a, b, false);
+    QVERIFY(solver.currentPath() == original);
+  }
+
+  void testRepairMatchesFullSolve() {
+    std::mt19937 rng(21);
+
+    for (int trial = 0; trial < 20; ++trial) {
+      int rows = 5 + rng() % 20;
+      int cols = 5 + rng() % 20;
+      Generator gen;
+      MazeData maze;
+      gen.generate(maze, rows, cols);
+      // open some walls so there are loops and detours
+      for (int k = 0; k < rows * cols / 4; ++k) {
+        int r = rng() % rows;
+        int c = rng() % cols;
+        if (c < cols - 1) maze.cells[r][c].rightWall = false;
+      }
+
+      Solver solver;
+      solver.setMazeData(&maze);
+      QPoint start(rng() % rows, rng() % cols);
+      QPoint end(rng() % rows, rng() % cols);
+      solver.solveMaze(start.x(), start.y(), end.x(), end.y());
+
+      for (int edit = 0; edit < 100; ++edit) {
+        int r = rng() % rows;
+        int c = rng() % cols;
+        bool right = rng() % 2;
+        if (right ? c == cols - 1 : r == rows - 1) continue;
+
+        bool& wall = right ? maze.cells[r][c].rightWall
+                           : maze.cells[r][c].bottomWall;
+        wall = !wall;
+        solver.repairPath(QPoint(r, c),
+                          right ? QPoint(r, c + 1) : QPoint(r + 1, c), wall);
+
+        // still a shortest path after every single edit
+        auto expected = solver.solve(maze, start, end);
+        const auto& path = solver.currentPath();
+        QCOMPARE(path.size(), expected.size());
+        QVERIFY(isPathValid(maze, path));
+        if (!path.empty()) {
+          QCOMPARE(path.front(), start);
+          QCOMPARE(path.back(), end);
+        }
+      }
+    }
+  }
+
+  void testSolveFromMatchesSolve() {
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 25, 30);
+    // a loop, so shortest paths are not the only ones
+    maze.cells[10][10].rightWall = false;
+    maze.cells[10][10].bottomWall = false;
+
+    Solver solver;
+    QPoint start(3, 4);
+    std::vector<QPoint> ends = {{0, 0}, {24, 29}, {3, 4}, {12, 17},
+                                {24, 29}, {-1, 5}};
+    auto paths = solver.solveFrom(maze, start, ends);
+
+    QCOMPARE(paths.size(), ends.size());
+    for (size_t i = 0; i + 1 < ends.size(); ++i) {
+      std::vector<QPoint> expected = solver.solve(maze, start, ends[i]);
+      QCOMPARE(paths[i].size(), expected.size());
+      QCOMPARE(paths[i].front(), start);
+      QCOMPARE(paths[i].back(), ends[i]);
+      QVERIFY(isPathValid(maze, paths[i]));
+    }
+    QVERIFY(paths.back().empty());  // outside the maze
+  }
+
+  void testFixedKernelMatchesSearch_data() {
+    QTest::addColumn<int>("side");
+    QTest::newRow("10") << 10;
+    QTest::newRow("20") << 20;
+    QTest::newRow("50") << 50;
+  }
+  void testFixedKernelMatchesSearch() {
+    QFETCH(int, side);
+    std::mt19937 rng(side);
+    Generator gen;
+    MazeData maze;
+    for (int round = 0; round < 50; ++round) {
+      gen.setSeed(round);
+      gen.generate(maze, side, side);
+      // loops and walled-off cells, border passages included
+      for (int e = 0; e < side * 3; ++e) {
+        MazeCell& cell = maze.cells[rng() % side][rng() % side];
+        if (rng() & 1) {
+          cell.rightWall = !cell.rightWall;
+        } else {
+          cell.bottomWall = !cell.bottomWall;
+        }
+      }
+
+      int start = int(rng() % (side * side));
+      int target = int(rng() % (side * side));
+      std::pmr::vector<int> parent, queue;
+      std::vector<QPoint> kernel, generic;
+      int kernelVisits = 0, genericVisits = 0;
+      bool found = MazeBfs::findPath(maze, start, target, parent, queue,
+                                     &kernel,
+                                     [&](int, size_t) { ++kernelVisits; });
+      bool reached = false;
+      MazeBfs::search(maze, start, parent, queue, [&](int cell, size_t) {
+        ++genericVisits;
+        reached = cell == target;
+        return reached;
+      });
+      if (reached) MazeBfs::path(parent, side, target, &generic);
+
+      QCOMPARE(found, reached);
+      QCOMPARE(kernelVisits, genericVisits);
+      QVERIFY(kernel == generic);
+    }
+  }
+
+  void testAsyncSolveMatchesSync() {
+    MazeCache::instance().clear();
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 40, 40);
+
+    Solver sync;
+    sync.setMazeData(&maze);
+    sync.solveMaze(0, 0, 39, 39);
+    MazeCache::instance().clear();
+
+    Solver solver;
+    solver.setMazeData(&maze);
+    solver.solveMazeAsync(0, 0, 39, 39);
+    QVERIFY(solver.solving());
+    QTRY_VERIFY_WITH_TIMEOUT(!solver.solving(), 5000);
+    QVERIFY(solver.hasSolution());
+    QVERIFY(solver.currentPath() == sync.currentPath());
+
+    // a newer request replaces one still running
+    solver.solveMazeAsync(0, 0, 20, 20);
+    solver.solveMazeAsync(0, 0, 39, 0);
+    QTRY_VERIFY_WITH_TIMEOUT(!solver.solving(), 5000);
+    QVERIFY(solver.currentPath() == solver.solve(maze, {0, 0}, {39, 0}));
+  }
+
+  void testRecordsSearchLayers() {
+    MazeCache::instance().clear();
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 30, 30);
+
+    // reference distances from the start
+    std::pmr::vector<int> parent;
+    std::pmr::vector<int> queue;
+    std::vector<int> depth(30 * 30, 0);
+    MazeBfs::search(maze, 0, parent, queue, [&](int cell, size_t) {
+      if (parent[cell] >= 0) depth[cell] = depth[parent[cell]] + 1;
+      return false;
+    });
+
+    Solver solver;
+    solver.setMazeData(&maze);
+    solver.solveMaze(0, 0, 29, 29);
+    QVERIFY(solver.searchTrace().isEmpty());  // off by default
+
+    QSignalSpy traceSpy(&solver, &Solver::searchTraceChanged);
+    solver.setRecordSearch(true);
+    // cached by now, yet searched again to be recorded
+    solver.solveMaze(0, 0, 29, 29);
+    QCOMPARE(traceSpy.count(), 1);
+
+    const SearchTrace& trace = solver.searchTrace();
+    QCOMPARE(trace.recorded(), quint32(30 * 30));
+    QCOMPARE(trace.firstDepth(), 0);
+    QCOMPARE(solver.searchLayers(),
+             *std::max_element(depth.begin(), depth.end()) + 1);
+    QCOMPARE(trace.layerEnd(0) - trace.layerBegin(0), quint32(1));
+    for (int layer = 0; layer < trace.layerCount(); ++layer) {
+      for (quint32 seq = trace.layerBegin(layer); seq < trace.layerEnd(layer);
+           ++seq) {
+        QCOMPARE(depth[trace.cell(seq)], layer);
+      }
+    }
+    QCOMPARE(solver.pathLength(), depth[30 * 30 - 1] + 1);
+
+    // the asynchronous solve hands the same trace back
+    std::vector<quint32> cells;
+    for (quint32 seq = 0; seq < trace.recorded(); ++seq) {
+      cells.push_back(trace.cell(seq));
+    }
+    solver.solveMazeAsync(0, 0, 29, 29);
+    QVERIFY(solver.searchTrace().isEmpty());
+    QTRY_VERIFY_WITH_TIMEOUT(!solver.solving(), 5000);
+    QCOMPARE(solver.searchTrace().recorded(), quint32(cells.size()));
+    for (quint32 seq = 0; seq < quint32(cells.size()); ++seq) {
+      QCOMPARE(solver.searchTrace().cell(seq), cells[seq]);
+    }
+
+    solver.setRecordSearch(false);
+    QCOMPARE(solver.searchLayers(), 0);
+    QCOMPARE(solver.searchTrace().capacity(), size_t(0));
+  }
+
+  void testSearchTraceKeepsLatestLayers() {
+    SearchTrace trace;
+    trace.reset(10, 6);  // rounded up to 8
+    QCOMPARE(trace.capacity(), size_t(8));
+
+    // layers of 1, 3, 4 and 2 cells: the first two cells are overwritten,
+    // which drops the first two layers
+    const int sizes[] = {1, 3, 4, 2};
+    int cell = 0;
+    for (int depth = 0; depth < 4; ++depth) {
+      for (int i = 0; i < sizes[depth]; ++i) trace.record(cell++, depth);
+    }
+    QCOMPARE(trace.recorded(), quint32(10));
+    QCOMPARE(trace.layerCount(), 2);
+    QCOMPARE(trace.firstDepth(), 2);
+    QCOMPARE(trace.layerBegin(0), quint32(4));
+    QCOMPARE(trace.layerEnd(0), quint32(8));
+    QCOMPARE(trace.layerEnd(1), quint32(10));
+    QCOMPARE(trace.cell(9), quint32(9));
+
+    // the buffers are kept for a smaller search
+    trace.reset(10, 2);
+    QCOMPARE(trace.capacity(), size_t(8));
+    QVERIFY(trace.isEmpty());
+    trace.record(3, 0);
+    QCOMPARE(trace.layerCount(), 1);
+    trace.clear();
+    QVERIFY(trace.isEmpty());
   }
 
   void testSolverWithNullMaze() {
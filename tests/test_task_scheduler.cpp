@@ -0,0 +1,120 @@
+#include <QtTest/QtTest>
+#include <atomic>
+#include <future>
+#include <memory_resource>
+
+#include "src/lib/service/scheduler/taskScheduler.h"
+
+class TestTaskScheduler : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void testInteractiveNotBlockedByBulk() {
+    TaskScheduler scheduler(2);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> bulkStarted{0};
+    for (int i = 0; i < 2; ++i) {
+      scheduler.submit(TaskScheduler::Priority::Batch, [&, released]() {
+        ++bulkStarted;
+        released.wait();
+      });
+    }
+
+    // one worker holds the batch task, the other stays free
+    QFuture<int> solve = scheduler.run(TaskScheduler::Priority::Interactive,
+                                       []() { return 42; });
+    QTRY_VERIFY_WITH_TIMEOUT(solve.isFinished(), 5000);
+    QCOMPARE(solve.result(), 42);
+    QCOMPARE(bulkStarted.load(), 1);
+
+    release.set_value();
+    QTRY_COMPARE_WITH_TIMEOUT(bulkStarted.load(), 2, 5000);
+  }
+
+  void testParallelForCoversAllIndices() {
+    TaskScheduler scheduler(4);
+    std::vector<std::atomic<int>> hits(1000);
+    scheduler.parallelFor(qsizetype(hits.size()),
+                          [&](qsizetype i) { ++hits[i]; });
+    for (const auto& hit : hits) QCOMPARE(hit.load(), 1);
+
+    // nested loops run from inside tasks without waiting on each other
+    std::vector<std::atomic<int>> cells(16 * 64);
+    scheduler.parallelFor(16, [&](qsizetype row) {
+      scheduler.parallelFor(64,
+                            [&](qsizetype col) { ++cells[row * 64 + col]; });
+    });
+    for (const auto& cell : cells) QCOMPARE(cell.load(), 1);
+  }
+
+  void testCancelledTaskIsSkipped() {
+    TaskScheduler scheduler(1);
+    std::promise<void> release;
+    scheduler.submit(TaskScheduler::Priority::Interactive,
+                     [released = release.get_future().share()]() {
+                       released.wait();
+                     });
+
+    CancellationToken token;
+    bool called = false;
+    QFuture<int> skipped = scheduler.run(
+        TaskScheduler::Priority::Interactive,
+        [&called]() {
+          called = true;
+          return 7;
+        },
+        token);
+    token.cancel();
+    release.set_value();
+
+    skipped.waitForFinished();
+    QVERIFY(!called);
+    QCOMPARE(skipped.result(), 0);
+  }
+
+  void testGroupWaitsForItsTasks() {
+    TaskScheduler scheduler(3);
+    std::atomic<int> done{0};
+    {
+      TaskGroup group(scheduler);
+      for (int i = 0; i < 20; ++i) {
+        group.submit(TaskScheduler::Priority::Render, [&done]() {
+          QThread::msleep(1);
+          ++done;
+        });
+      }
+      group.wait();
+      QCOMPARE(done.load(), 20);
+
+      group.cancel();
+      group.submit(TaskScheduler::Priority::Render, [&done]() { ++done; });
+    }
+    QCOMPARE(done.load(), 20);
+    QCOMPARE(scheduler.stats().executed[size_t(
+                 TaskScheduler::Priority::Render)],
+             quint64(21));
+  }
+
+  void testScratchArenaReusesBlocks() {
+    ScratchArena arena;
+    {
+      ScratchScope scope(arena);
+      std::pmr::vector<int> values(scope.resource());
+      values.resize(100000);
+    }
+    size_t capacity = arena.capacity();
+    QVERIFY(capacity >= 100000 * sizeof(int));
+
+    for (int round = 0; round < 10; ++round) {
+      ScratchScope scope(arena);
+      std::pmr::vector<int> values(scope.resource());
+      values.reserve(100000);
+      values.assign(100000, round);
+    }
+    QCOMPARE(arena.capacity(), capacity);
+  }
+};
+
+QTEST_MAIN(TestTaskScheduler)
+#include "test_task_scheduler.moc"
@@ -0,0 +1,229 @@
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <QtTest/QtTest>
+
+#include "src/lib/model/maze.h"
+#include "src/lib/service/generator/generator.h"
+#include "src/lib/service/ioParser/asyncIOParser.h"
+#include "src/lib/service/ioParser/tiledArchive.h"
+
+class TestTiledArchive : public QObject {
+  Q_OBJECT
+
+ private:
+  // helper: compare a region of `full` with `part` cell by cell
+  bool regionMatches(const MazeData& full, const MazeData& part, int row,
+                     int col) {
+    for (int r = 0; r < part.rows; ++r) {
+      for (int c = 0; c < part.cols; ++c) {
+        const auto& a = full.cells[row + r][col + c];
+        const auto& b = part.cells[r][c];
+        if (a.rightWall != b.rightWall || a.bottomWall != b.bottomWall) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  QTemporaryDir dir_;
+
+ private slots:
+  void testRoundTrip_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("tileSize");
+
+    QTest::newRow("single_tile") << 20 << 30 << 256;
+    QTest::newRow("exact_tiles") << 64 << 64 << 16;
+    QTest::newRow("ragged_tiles") << 50 << 37 << 8;
+    QTest::newRow("single_cell") << 1 << 1 << 4;
+    QTest::newRow("thin") << 1 << 300 << 32;
+  }
+
+  void testRoundTrip() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, tileSize);
+
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, rows, cols);
+
+    QString path = dir_.filePath("roundtrip.mza");
+    QVERIFY(TiledArchive::write(path, maze, tileSize).isValid());
+
+    TiledArchiveReader reader;
+    QVERIFY2(reader.open(path), qPrintable(reader.error()));
+    QCOMPARE(reader.rows(), rows);
+    QCOMPARE(reader.cols(), cols);
+
+    ParseResult result = reader.readAll();
+    QVERIFY2(result.isValid(), qPrintable(result.error));
+    QCOMPARE(result.data.rows, rows);
+    QCOMPARE(result.data.cols, cols);
+    QVERIFY(result.data.isGenerated);
+    QVERIFY(regionMatches(maze, result.data, 0, 0));
+  }
+
+  void testRegionRead() {
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 100, 90);
+
+    QString path = dir_.filePath("region.mza");
+    QVERIFY(TiledArchive::write(path, maze, 16).isValid());
+
+    TiledArchiveReader reader;
+    QVERIFY(reader.open(path));
+    QCOMPARE(reader.tileRows(), 7);
+    QCOMPARE(reader.tileCols(), 6);
+
+    // straddles tile borders on every side
+    ParseResult result = reader.readRegion(10, 20, 35, 41);
+    QVERIFY2(result.isValid(), qPrintable(result.error));
+    QCOMPARE(result.data.rows, 35);
+    QCOMPARE(result.data.cols, 41);
+    QVERIFY(regionMatches(maze, result.data, 10, 20));
+
+    // clamped to the maze
+    result = reader.readRegion(80, 80, 50, 50);
+    QVERIFY(result.isValid());
+    QCOMPARE(result.data.rows, 20);
+    QCOMPARE(result.data.cols, 10);
+    QVERIFY(regionMatches(maze, result.data, 80, 80));
+
+    result = reader.readRegion(200, 0, 5, 5);
+    QVERIFY(!result.isValid());
+  }
+
+  void testReadTile() {
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 70, 45);
+
+    QString path = dir_.filePath("tiles.mza");
+    QVERIFY(TiledArchive::write(path, maze, 32).isValid());
+
+    TiledArchiveReader reader;
+    QVERIFY(reader.open(path));
+    MazeData tile;
+    for (int tr = 0; tr < reader.tileRows(); ++tr) {
+      for (int tc = 0; tc < reader.tileCols(); ++tc) {
+        QVERIFY(reader.readTile(tr, tc, &tile));
+        TileRect rect = reader.tileRect(tr, tc);
+        QCOMPARE(tile.rows, rect.rows);
+        QCOMPARE(tile.cols, rect.cols);
+        QVERIFY(regionMatches(maze, tile, rect.row, rect.col));
+      }
+    }
+    QVERIFY(!reader.readTile(reader.tileRows(), 0, &tile));
+  }
+
+  void testSmallerThanBitplanes() {
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 300, 300);
+
+    QString path = dir_.filePath("size.mza");
+    QVERIFY(TiledArchive::write(path, maze).isValid());
+
+    // two raw bitplanes: 2 bits per cell
+    qint64 rawBytes = 300 * 300 * 2 / 8;
+    QVERIFY2(QFileInfo(path).size() < rawBytes,
+             "archive should beat raw wall bitplanes");
+  }
+
+  void testCorruptTileDetected() {
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 40, 40);
+
+    QString path = dir_.filePath("corrupt.mza");
+    QVERIFY(TiledArchive::write(path, maze, 8).isValid());
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray bytes = file.readAll();
+    // flip bits in the first tile payload, right after the 20-byte header
+    bytes[21] = static_cast<char>(bytes[21] ^ 0x5A);
+    bytes[22] = static_cast<char>(bytes[22] ^ 0xA5);
+    file.seek(0);
+    file.write(bytes);
+    file.close();
+
+    TiledArchiveReader reader;
+    QVERIFY(reader.open(path));
+    QVERIFY(!reader.readAll().isValid());
+  }
+
+  void testRejectsWrappingIndex() {
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 40, 40);
+
+    QString path = dir_.filePath("wrapping.mza");
+    QVERIFY(TiledArchive::write(path, maze, 8).isValid());
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray bytes = file.readAll();
+    // the first entry's offset so close to 2^64 that offset + size wraps
+    quint64 indexOffset =
+        qFromLittleEndian<quint64>(bytes.constData() + bytes.size() - 16);
+    qToLittleEndian<quint64>(~quint64(0) - 7, bytes.data() + indexOffset);
+    qToLittleEndian<quint32>(16, bytes.data() + indexOffset + 8);
+    file.seek(0);
+    file.write(bytes);
+    file.close();
+
+    TiledArchiveReader reader;
+    QVERIFY(!reader.open(path));
+    QCOMPARE(reader.error(), QString("corrupt archive index"));
+  }
+
+  void testWriteRejectsUnreadableDimensions() {
+    // only the dimensions are looked at before the refusal
+    MazeData maze;
+    maze.rows = TiledArchive::kMaxDimension + 1;
+    maze.cols = 1;
+    maze.isGenerated = true;
+    QVERIFY(!TiledArchive::write(dir_.filePath("huge.mza"), maze, 64)
+                 .isValid());
+    QVERIFY(!QFile::exists(dir_.filePath("huge.mza")));
+  }
+
+  void testRejectsNonArchive() {
+    QString path = dir_.filePath("plain.mza");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("4 4\n0 0 1 0\n");
+    file.close();
+
+    TiledArchiveReader reader;
+    QVERIFY(!reader.open(path));
+    QVERIFY(!reader.error().isEmpty());
+    QVERIFY(!AsyncIOParser::parseMazeArchive(path).isValid());
+  }
+
+  void testParserSaveMode() {
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 25, 25);
+
+    QVERIFY(AsyncIOParser::isArchivePath("maze.mza"));
+    QVERIFY(AsyncIOParser::isArchivePath("MAZE.MZA"));
+    QVERIFY(!AsyncIOParser::isArchivePath("maze.txt"));
+
+    QString path = dir_.filePath("parser.mza");
+    QVERIFY(AsyncIOParser::writeMazeArchive(path, maze).isValid());
+
+    ParseResult result = AsyncIOParser::parseMazeArchive(path);
+    QVERIFY(result.isValid());
+    QVERIFY(regionMatches(maze, result.data, 0, 0));
+  }
+};
+
+QTEST_MAIN(TestTiledArchive)
+#include "test_tiled_archive.moc"
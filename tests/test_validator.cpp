@@ -0,0 +1,127 @@
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtTest/QtTest>
+
+#include "src/core/validator.h"
+#include "src/lib/model/maze.h"
+#include "src/lib/service/generator/generator.h"
+#include "src/lib/service/ioParser/asyncIOParser.h"
+
+class TestValidator : public QObject {
+  Q_OBJECT
+
+ private:
+  MazeData createMaze(int rows, int cols, bool walls) {
+    MazeData maze;
+    maze.rows = rows;
+    maze.cols = cols;
+    maze.isGenerated = true;
+    maze.cells.assign(rows, std::vector<MazeCell>(cols, {walls, walls}));
+    return maze;
+  }
+
+  QString writeFile(const QString& name, const QString& content) {
+    QString path = dir_.filePath(name);
+    QFile file(path);
+    file.open(QIODevice::WriteOnly | QIODevice::Text);
+    QTextStream(&file) << content;
+    return path;
+  }
+
+  QTemporaryDir dir_;
+
+ private slots:
+  void testGeneratedMazeIsPerfect_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+
+    QTest::newRow("1x1") << 1 << 1;
+    QTest::newRow("5x5") << 5 << 5;
+    QTest::newRow("7x13") << 7 << 13;
+    QTest::newRow("50x50") << 50 << 50;
+  }
+
+  void testGeneratedMazeIsPerfect() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, rows, cols);
+
+    MazeValidation v = MazeValidator::validate(maze);
+    QCOMPARE(v.components, 1);
+    QCOMPARE(v.loops, 0);
+    QCOMPARE(v.unreachableCells, 0);
+    QVERIFY(v.isPerfect());
+  }
+
+  void testIsolatedCells() {
+    MazeValidation v = MazeValidator::validate(createMaze(2, 3, true));
+
+    QCOMPARE(v.components, 6);
+    QCOMPARE(v.loops, 0);
+    QCOMPARE(v.unreachableCells, 5);
+    QVERIFY(!v.isConnected());
+  }
+
+  void testOpenGridLoops() {
+    // no interior walls: E = 2*r*c - r - c, loops = E - (V - 1)
+    MazeValidation v = MazeValidator::validate(createMaze(4, 5, false));
+
+    QCOMPARE(v.components, 1);
+    QCOMPARE(v.loops, (2 * 4 * 5 - 4 - 5) - (4 * 5 - 1));
+    QVERIFY(v.isConnected());
+    QVERIFY(!v.isPerfect());
+  }
+
+  void testBorderPassagesIgnored() {
+    MazeData maze = createMaze(1, 2, true);
+    maze.cells[0][0].rightWall = false;
+    maze.cells[0][1].rightWall = false;  // outer border
+    maze.cells[0][1].bottomWall = false;
+
+    MazeValidation v = MazeValidator::validate(maze);
+    QVERIFY(v.isPerfect());
+  }
+
+  void testParseReportsValidation() {
+    // right half cut off, left half has one loop
+    QString path = writeFile("split.txt",
+                             "2 3\n"
+                             "0 1 1\n"
+                             "0 1 1\n"
+                             "\n"
+                             "0 0 0\n"
+                             "1 1 1\n");
+
+    ParseResult result = AsyncIOParser::parseMazeFile(path);
+    QVERIFY2(result.isValid(), qPrintable(result.error));
+    QCOMPARE(result.validation.components, 2);
+    QCOMPARE(result.validation.loops, 1);
+    QCOMPARE(result.validation.unreachableCells, 2);
+  }
+
+  void testParseMatchesBatchValidation() {
+    Generator gen;
+    MazeData maze;
+    gen.generate(maze, 30, 40);
+    maze.cells[3][4].rightWall = !maze.cells[3][4].rightWall;
+    maze.cells[10][10].bottomWall = !maze.cells[10][10].bottomWall;
+
+    QString path = dir_.filePath("edited.txt");
+    QVERIFY(AsyncIOParser::writeMazeFile(path, maze).isValid());
+
+    ParseResult result = AsyncIOParser::parseMazeFile(path);
+    QVERIFY(result.isValid());
+
+    MazeValidation expected = MazeValidator::validate(maze);
+    QCOMPARE(result.validation.components, expected.components);
+    QCOMPARE(result.validation.loops, expected.loops);
+    QCOMPARE(result.validation.unreachableCells, expected.unreachableCells);
+  }
+};
+
+QTEST_MAIN(TestValidator)
+#include "test_validator.moc"